@@ -0,0 +1,57 @@
+# ***************************************************************************
+# *                                                                         *
+# *   Copyright : (C) 2026 The Kst developers                               *
+# *                                                                         *
+# *   This program is free software; you can redistribute it and/or modify  *
+# *   it under the terms of the GNU General Public License as published by  *
+# *   the Free Software Foundation; either version 2 of the License, or     *
+# *   (at your option) any later version.                                   *
+# *                                                                         *
+# ***************************************************************************
+
+# Modern FindZstd.cmake
+# Usage: find_package(Zstd)
+# Sets: ZSTD_FOUND, ZSTD_INCLUDE_DIR, ZSTD_LIBRARIES
+
+include(FindPackageHandleStandardArgs)
+
+# Try pkg-config first
+find_package(PkgConfig QUIET)
+if(PKG_CONFIG_FOUND)
+    pkg_check_modules(ZSTD_PKG QUIET libzstd)
+endif()
+
+# Find headers
+find_path(ZSTD_INCLUDE_DIR
+    NAMES zstd.h
+    HINTS ${ZSTD_PKG_INCLUDE_DIRS}
+    PATHS ENV ZSTD_DIR
+    PATH_SUFFIXES include
+)
+
+# Find libraries
+find_library(ZSTD_LIBRARY
+    NAMES zstd
+    HINTS ${ZSTD_PKG_LIBRARY_DIRS}
+    PATHS ENV ZSTD_DIR
+    PATH_SUFFIXES lib
+)
+
+set(ZSTD_LIBRARIES)
+if(ZSTD_LIBRARY)
+    list(APPEND ZSTD_LIBRARIES ${ZSTD_LIBRARY})
+endif()
+
+# Handle standard args and set _FOUND variable
+find_package_handle_standard_args(Zstd
+    REQUIRED_VARS ZSTD_INCLUDE_DIR ZSTD_LIBRARIES
+    HANDLE_COMPONENTS
+)
+
+if(Zstd_FOUND)
+    add_library(Zstd::Zstd UNKNOWN IMPORTED)
+    set_target_properties(Zstd::Zstd PROPERTIES
+        IMPORTED_LOCATION "${ZSTD_LIBRARIES}"
+        INTERFACE_INCLUDE_DIRECTORIES "${ZSTD_INCLUDE_DIR}"
+    )
+endif()
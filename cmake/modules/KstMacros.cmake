@@ -147,7 +147,7 @@ macro(kst_init_plugin dir)
 endmacro()
 
 function(kst_add_plugin folder name)
-    cmake_parse_arguments(ARG "" "" "LINK_LIBRARIES" ${ARGN})
+    cmake_parse_arguments(ARG "" "" "LINK_LIBRARIES;COMPILE_DEFINITIONS" ${ARGN})
 
 	message("Building plugin ${folder}/${name}")
     set(_name ${kst_plugin_prefix}${folder}_${name})
@@ -173,6 +173,9 @@ function(kst_add_plugin folder name)
         Qt6::Concurrent
         ${ARG_LINK_LIBRARIES}
     )
+    if(ARG_COMPILE_DEFINITIONS)
+        target_compile_definitions(${_name} PRIVATE ${ARG_COMPILE_DEFINITIONS})
+    endif()
     
     # Set RPATH so plugins can find private libraries
     set_target_properties(${_name} PROPERTIES
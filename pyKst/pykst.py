@@ -231,6 +231,73 @@ class Client(object):
         """
         self.send("cleanupLayout("+b2str(columns)+")")
 
+    def begin_bulk(self):
+        """ Start making many objects at once.
+
+        Until the matching end_bulk(), kst does not update objects, or lay
+        out plots added with the automatic layout, as each is made: it does
+        so once, at end_bulk().  Calls nest.  Making hundreds of curves is
+        far faster this way.
+        """
+        self.send("beginBulk()")
+
+    def end_bulk(self):
+        """ Update, and lay out, what was made since begin_bulk(). """
+        self.send("endBulk()")
+
+    def memory_usage(self):
+        """ Returns the memory held by vectors and matrices in kst.
+
+        The result is (used, limit, objects), where objects is a list of
+        (name, type, bytes) tuples, largest first.  All sizes are in bytes,
+        and a limit of 0 means there is none.
+        """
+        lines = bytes(self.send("getMemoryUsage()")).decode("utf-8").split("\n")
+        total = lines[0].split("|")
+        objects = []
+        for line in lines[1:]:
+            name, typ, size = line.rsplit("|", 2)
+            objects.append((name, typ, int(size)))
+        return int(total[2]), int(total[1]), objects
+
+    def set_memory_limit(self, megabytes):
+        """ Sets the most memory vectors and matrices may hold, in MB.
+
+        Data vectors which would go over the limit are read with skip
+        instead.  0 removes the limit.  This also changes the setting in
+        the application's settings dialog.
+        """
+        self.send("setMemoryLimit("+b2str(int(megabytes))+")")
+
+    def timing_summary(self):
+        """ Returns where kst has spent its time recently.
+
+        The result is a list of (kind, name, count, total, max, samples,
+        bytes) tuples, most total time first, with times in seconds.  Kinds
+        are "tick" (an update pass), "update" (one object), "read" (a data
+        source read), "paint" (a curve or image) and "render" (a plot).
+        """
+        reply = bytes(self.send("getTimingSummary()")).decode("utf-8")
+        summary = []
+        for line in reply.split("\n"):
+            if not line:
+                continue
+            kind, rest = line.split("|", 1)
+            name, count, total, tmax, samples, nbytes = rest.rsplit("|", 5)
+            summary.append((kind, name, int(count), int(total)*1.0e-9,
+                            int(tmax)*1.0e-9, int(samples), int(nbytes)))
+        return summary
+
+    def save_trace(self, filename):
+        """ Saves recent timing as a Chrome trace (for chrome://tracing
+        or https://ui.perfetto.dev).
+        """
+        self.send("saveTrace("+b2str(filename)+")")
+
+    def clear_trace(self):
+        """ Forgets the timing recorded so far. """
+        self.send("clearTrace()")
+
     def get_scalar_list(self):
         """ returns the scalar names from kst """
 
@@ -1311,6 +1378,18 @@ class DataVector(VectorBase):
         """  True if boxcar filtering has been applied before skipping. """
         return self.client.send_si(self.handle, "boxcarFirst()")
 
+    def set_compact_storage(self, compact=True):
+        """ Hold the samples in the narrowest type which represents them exactly.
+
+        int16 or float32 fields then use 1/4 or 1/2 of the memory.  The
+        values seen by curves, equations and statistics do not change.
+        """
+        self.client.send_si(self.handle, "setCompactStorage("+b2str(compact)+")")
+
+    def storage_type(self):
+        """  Returns the sample type used for storage, eg, 'int16' or 'float64'. """
+        return self.client.send_si(self.handle, "storageType()")
+
 class GeneratedVector(VectorBase):
     """ Create a generated vector in kst.
 
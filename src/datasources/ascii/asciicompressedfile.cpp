@@ -0,0 +1,703 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "asciicompressedfile.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <string.h>
+
+#ifdef KST_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef KST_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+
+//-------------------------------------------------------------------------------------------
+static const qint64 SeekSpan = 1024 * 1024; // decoded bytes between seek points
+static const int WindowSize = 32768;        // deflate history needed to restart
+static const int InputChunk = 64 * 1024;
+static const int BufferSize = 64 * 1024;
+static const int MaxCachedIndexes = 16;
+
+//-------------------------------------------------------------------------------------------
+struct AsciiCompressedFile::SeekPoint
+{
+  qint64 out;         // offset in the decoded data
+  qint64 in;          // offset in the compressed file
+  int bits;           // gzip: bits of the byte before 'in' still to be decoded
+  QByteArray window;  // gzip: the decoded data just before 'out'.  Empty at the start of the file.
+};
+
+//-------------------------------------------------------------------------------------------
+struct AsciiCompressedFile::Index
+{
+  qint64 compressedSize;
+  QDateTime modified;
+  qint64 size;
+  QVector<SeekPoint> points;
+};
+
+//-------------------------------------------------------------------------------------------
+struct AsciiCompressedFile::Stream
+{
+  Stream() : eof(false)
+  {
+#ifdef KST_HAVE_ZLIB
+    memset(&z, 0, sizeof(z));
+    zInit = false;
+    raw = false;
+    skipIn = 0;
+#endif
+#ifdef KST_HAVE_ZSTD
+    zstd = 0;
+    zin.src = 0;
+    zin.size = zin.pos = 0;
+#endif
+    in.resize(InputChunk);
+  }
+
+  ~Stream()
+  {
+#ifdef KST_HAVE_ZLIB
+    if (zInit) {
+      inflateEnd(&z);
+    }
+#endif
+#ifdef KST_HAVE_ZSTD
+    ZSTD_freeDStream(zstd);
+#endif
+  }
+
+#ifdef KST_HAVE_ZLIB
+  z_stream z;
+  bool zInit;
+  bool raw;     // raw deflate, after restarting at a seek point
+  int skipIn;   // bytes of a gzip member trailer still to skip
+#endif
+#ifdef KST_HAVE_ZSTD
+  ZSTD_DStream* zstd;
+  ZSTD_inBuffer zin;
+#endif
+  QByteArray in;
+  bool eof;
+};
+
+//-------------------------------------------------------------------------------------------
+AsciiCompressedFile::AsciiCompressedFile(const QString& fileName) :
+  _file(fileName), _format(Plain), _stream(0),
+  _pos(0), _decodePos(-1), _bufferPos(0), _bufferLen(0)
+{
+}
+
+//-------------------------------------------------------------------------------------------
+AsciiCompressedFile::~AsciiCompressedFile()
+{
+  close();
+}
+
+//-------------------------------------------------------------------------------------------
+AsciiCompressedFile::Format AsciiCompressedFile::format(const QString& fileName)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return Plain;
+  }
+  const QByteArray magic = file.read(4);
+  if (magic.size() >= 2 && uchar(magic[0]) == 0x1f && uchar(magic[1]) == 0x8b) {
+    return Gzip;
+  }
+  if (magic.size() == 4 && uchar(magic[0]) == 0x28 && uchar(magic[1]) == 0xb5 &&
+      uchar(magic[2]) == 0x2f && uchar(magic[3]) == 0xfd) {
+    return Zstd;
+  }
+  return Plain;
+}
+
+//-------------------------------------------------------------------------------------------
+bool AsciiCompressedFile::isSupported(Format format)
+{
+  switch (format) {
+  case Plain:
+    return true;
+  case Gzip:
+#ifdef KST_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+  case Zstd:
+#ifdef KST_HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+  }
+  return false;
+}
+
+//-------------------------------------------------------------------------------------------
+bool AsciiCompressedFile::open(OpenMode mode)
+{
+  if (isOpen() || (mode & QIODevice::WriteOnly)) {
+    return false;
+  }
+  _format = format(_file.fileName());
+  if (_format == Plain || !isSupported(_format)) {
+    setErrorString(QString("%1 is not a supported compressed file").arg(_file.fileName()));
+    return false;
+  }
+  if (!_file.open(QIODevice::ReadOnly)) {
+    setErrorString(_file.errorString());
+    return false;
+  }
+
+  _stream = new Stream;
+  _buffer.resize(BufferSize);
+  _pos = 0;
+  _decodePos = -1;
+  _bufferPos = 0;
+  _bufferLen = 0;
+
+  // we buffer decoded data ourselves
+  return QIODevice::open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+//-------------------------------------------------------------------------------------------
+void AsciiCompressedFile::close()
+{
+  if (isOpen()) {
+    QIODevice::close();
+  }
+  _file.close();
+  delete _stream;
+  _stream = 0;
+  _index.clear();
+  _buffer.clear();
+  _bufferLen = 0;
+  _decodePos = -1;
+}
+
+//-------------------------------------------------------------------------------------------
+qint64 AsciiCompressedFile::size() const
+{
+  if (!isOpen() || !ensureIndex()) {
+    return 0;
+  }
+  return _index->size;
+}
+
+//-------------------------------------------------------------------------------------------
+bool AsciiCompressedFile::seek(qint64 pos)
+{
+  if (pos < 0 || !QIODevice::seek(pos)) {
+    return false;
+  }
+  _pos = pos;
+  return true;
+}
+
+//-------------------------------------------------------------------------------------------
+bool AsciiCompressedFile::atEnd() const
+{
+  if (!isOpen()) {
+    return true;
+  }
+  if (_index) {
+    return _pos >= _index->size;
+  }
+  if (_pos >= _bufferPos && _pos < _bufferPos + _bufferLen) {
+    return false;
+  }
+  // no index yet: don't build one just for this, see if there is more to decode.
+  AsciiCompressedFile* self = const_cast<AsciiCompressedFile*>(this);
+  if (!self->moveTo(_pos)) {
+    return true;
+  }
+  const qint64 n = self->decode(self->_buffer.data(), self->_buffer.size());
+  if (n <= 0) {
+    return true;
+  }
+  self->_bufferPos = _pos;
+  self->_bufferLen = n;
+  return false;
+}
+
+//-------------------------------------------------------------------------------------------
+qint64 AsciiCompressedFile::bytesAvailable() const
+{
+  if (_index) {
+    return qMax(_index->size - _pos, qint64(0));
+  }
+  if (_pos >= _bufferPos && _pos < _bufferPos + _bufferLen) {
+    return _bufferPos + _bufferLen - _pos;
+  }
+  return 0;
+}
+
+//-------------------------------------------------------------------------------------------
+int AsciiCompressedFile::seekPoints() const
+{
+  return _index ? _index->points.size() : 0;
+}
+
+//-------------------------------------------------------------------------------------------
+qint64 AsciiCompressedFile::writeData(const char*, qint64)
+{
+  return -1;
+}
+
+//-------------------------------------------------------------------------------------------
+qint64 AsciiCompressedFile::readData(char* data, qint64 maxSize)
+{
+  qint64 done = 0;
+  while (done < maxSize) {
+    if (_pos >= _bufferPos && _pos < _bufferPos + _bufferLen) {
+      const qint64 n = qMin(maxSize - done, _bufferPos + _bufferLen - _pos);
+      memcpy(data + done, _buffer.constData() + (_pos - _bufferPos), n);
+      done += n;
+      _pos += n;
+      continue;
+    }
+
+    if (!moveTo(_pos)) {
+      break;
+    }
+    if (maxSize - done >= _buffer.size()) {
+      // big reads go straight to the caller
+      const qint64 n = decode(data + done, maxSize - done);
+      if (n <= 0) {
+        break;
+      }
+      done += n;
+      _pos += n;
+    } else {
+      const qint64 n = decode(_buffer.data(), _buffer.size());
+      if (n <= 0) {
+        break;
+      }
+      _bufferPos = _pos;
+      _bufferLen = n;
+    }
+  }
+  return done;
+}
+
+//-------------------------------------------------------------------------------------------
+bool AsciiCompressedFile::moveTo(qint64 pos)
+{
+  if (!_stream) {
+    return false;
+  }
+  if (pos == _decodePos) {
+    return true;
+  }
+
+  // restart unless we can get there quickly by decoding forward
+  if (_decodePos < 0 || pos < _decodePos || pos - _decodePos > SeekSpan) {
+    // a device is opened for every read of a source: past the start, even
+    // its first move goes by the index, shared with the devices before it
+    const SeekPoint* point = 0;
+    if (pos > 0 && ensureIndex()) {
+      const QVector<SeekPoint>& points = _index->points;
+      QVector<SeekPoint>::const_iterator it = std::upper_bound(points.constBegin(), points.constEnd(), pos,
+          [](qint64 p, const SeekPoint& sp) { return p < sp.out; });
+      if (it != points.constBegin()) {
+        point = &*(it - 1);
+      }
+    }
+    if (!point) {
+      static const SeekPoint start = { 0, 0, 0, QByteArray() };
+      point = &start;
+    }
+    if (_decodePos < 0 || pos < _decodePos || point->out > _decodePos) {
+      if (!restart(*point)) {
+        return false;
+      }
+    }
+  }
+
+  // decode up to pos, keeping the last block in the buffer
+  while (_decodePos < pos) {
+    const qint64 start = _decodePos;
+    const qint64 n = decode(_buffer.data(), qMin<qint64>(_buffer.size(), pos - _decodePos));
+    if (n <= 0) {
+      return false;
+    }
+    _bufferPos = start;
+    _bufferLen = n;
+  }
+  return true;
+}
+
+//-------------------------------------------------------------------------------------------
+bool AsciiCompressedFile::refill()
+{
+  const qint64 n = _file.read(_stream->in.data(), _stream->in.size());
+  if (n <= 0) {
+    return false;
+  }
+  switch (_format) {
+#ifdef KST_HAVE_ZLIB
+  case Gzip:
+    _stream->z.next_in = reinterpret_cast<Bytef*>(_stream->in.data());
+    _stream->z.avail_in = uInt(n);
+    break;
+#endif
+#ifdef KST_HAVE_ZSTD
+  case Zstd:
+    _stream->zin.src = _stream->in.constData();
+    _stream->zin.size = size_t(n);
+    _stream->zin.pos = 0;
+    break;
+#endif
+  default:
+    return false;
+  }
+  return true;
+}
+
+//-------------------------------------------------------------------------------------------
+bool AsciiCompressedFile::restart(const SeekPoint& point)
+{
+  Stream& s = *_stream;
+  s.eof = false;
+  _decodePos = -1;
+
+  switch (_format) {
+#ifdef KST_HAVE_ZLIB
+  case Gzip:
+    if (s.zInit) {
+      inflateEnd(&s.z);
+      s.zInit = false;
+    }
+    memset(&s.z, 0, sizeof(s.z));
+    s.skipIn = 0;
+    if (point.window.isEmpty()) {
+      // the start of the file: gzip or zlib header
+      if (inflateInit2(&s.z, 15 + 32) != Z_OK || !_file.seek(0)) {
+        return false;
+      }
+      s.zInit = true;
+      s.raw = false;
+    } else {
+      // the middle of a deflate stream
+      if (inflateInit2(&s.z, -15) != Z_OK) {
+        return false;
+      }
+      s.zInit = true;
+      s.raw = true;
+      if (!_file.seek(point.in - (point.bits ? 1 : 0)) || !refill()) {
+        return false;
+      }
+      if (point.bits) {
+        const int c = *s.z.next_in;
+        ++s.z.next_in;
+        --s.z.avail_in;
+        inflatePrime(&s.z, point.bits, c >> (8 - point.bits));
+      }
+      inflateSetDictionary(&s.z, reinterpret_cast<const Bytef*>(point.window.constData()), uInt(point.window.size()));
+    }
+    break;
+#endif
+#ifdef KST_HAVE_ZSTD
+  case Zstd:
+    if (!s.zstd) {
+      s.zstd = ZSTD_createDStream();
+      if (!s.zstd) {
+        return false;
+      }
+    }
+    ZSTD_DCtx_reset(s.zstd, ZSTD_reset_session_only);
+    s.zin.src = s.in.constData();
+    s.zin.size = s.zin.pos = 0;
+    if (!_file.seek(point.in)) {
+      return false;
+    }
+    break;
+#endif
+  default:
+    return false;
+  }
+
+  _decodePos = point.out;
+  return true;
+}
+
+//-------------------------------------------------------------------------------------------
+qint64 AsciiCompressedFile::decode(char* dst, qint64 maxSize)
+{
+  Stream& s = *_stream;
+  qint64 done = 0;
+
+  while (done < maxSize && !s.eof) {
+    switch (_format) {
+#ifdef KST_HAVE_ZLIB
+    case Gzip: {
+      if (s.z.avail_in == 0 && !refill()) {
+        s.eof = true;
+        break;
+      }
+      if (s.skipIn > 0) {
+        const int n = qMin<int>(s.skipIn, s.z.avail_in);
+        s.z.next_in += n;
+        s.z.avail_in -= n;
+        s.skipIn -= n;
+        break;
+      }
+      s.z.next_out = reinterpret_cast<Bytef*>(dst + done);
+      s.z.avail_out = uInt(qMin<qint64>(maxSize - done, 1 << 30));
+      const uInt before = s.z.avail_out;
+      const int ret = inflate(&s.z, Z_NO_FLUSH);
+      done += before - s.z.avail_out;
+      if (ret == Z_STREAM_END) {
+        // another gzip member may follow
+        if (s.raw) {
+          s.skipIn = 8; // crc and length
+          s.raw = false;
+          inflateReset2(&s.z, 15 + 16);
+        } else {
+          inflateReset(&s.z);
+        }
+      } else if (ret != Z_OK && !(ret == Z_BUF_ERROR && s.z.avail_in == 0)) {
+        // corrupt, or garbage after the last member: that's the end
+        s.eof = true;
+      }
+      break;
+    }
+#endif
+#ifdef KST_HAVE_ZSTD
+    case Zstd: {
+      if (s.zin.pos == s.zin.size && !refill()) {
+        s.eof = true;
+        break;
+      }
+      ZSTD_outBuffer zout = { dst + done, size_t(maxSize - done), 0 };
+      const size_t ret = ZSTD_decompressStream(s.zstd, &zout, &s.zin);
+      done += zout.pos;
+      if (ZSTD_isError(ret)) {
+        s.eof = true;
+      }
+      break;
+    }
+#endif
+    default:
+      s.eof = true;
+      break;
+    }
+  }
+
+  _decodePos += done;
+  return done;
+}
+
+//-------------------------------------------------------------------------------------------
+QHash<QString, QSharedPointer<const AsciiCompressedFile::Index> >& AsciiCompressedFile::indexCache()
+{
+  static QHash<QString, QSharedPointer<const Index> > cache;
+  return cache;
+}
+
+//-------------------------------------------------------------------------------------------
+QMutex& AsciiCompressedFile::indexCacheMutex()
+{
+  static QMutex mutex;
+  return mutex;
+}
+
+//-------------------------------------------------------------------------------------------
+bool AsciiCompressedFile::ensureIndex() const
+{
+  if (_index) {
+    return true;
+  }
+
+  const QFileInfo info(_file.fileName());
+  const QString key = info.absoluteFilePath();
+  {
+    QMutexLocker lock(&indexCacheMutex());
+    QSharedPointer<const Index> index = indexCache().value(key);
+    if (index && index->compressedSize == info.size() && index->modified == info.lastModified()) {
+      _index = index;
+      return true;
+    }
+  }
+
+  Index* index = new Index;
+  index->compressedSize = info.size();
+  index->modified = info.lastModified();
+  if (!buildIndex(*index)) {
+    delete index;
+    return false;
+  }
+  _index = QSharedPointer<const Index>(index);
+
+  QMutexLocker lock(&indexCacheMutex());
+  if (indexCache().size() >= MaxCachedIndexes) {
+    indexCache().clear();
+  }
+  indexCache().insert(key, _index);
+  return true;
+}
+
+//-------------------------------------------------------------------------------------------
+bool AsciiCompressedFile::buildIndex(Index& index) const
+{
+  // use our own file, so reads in progress are not disturbed
+  QFile file(_file.fileName());
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+  index.size = 0;
+  index.points.clear();
+  SeekPoint start = { 0, 0, 0, QByteArray() };
+  index.points.append(start);
+
+  switch (_format) {
+  case Gzip:
+    return buildGzipIndex(file, index);
+  case Zstd:
+    return buildZstdIndex(file, index);
+  default:
+    return false;
+  }
+}
+
+//-------------------------------------------------------------------------------------------
+bool AsciiCompressedFile::buildGzipIndex(QFile& file, Index& index) const
+{
+#ifdef KST_HAVE_ZLIB
+  z_stream z;
+  memset(&z, 0, sizeof(z));
+  if (inflateInit2(&z, 15 + 32) != Z_OK) {
+    return false;
+  }
+
+  QByteArray in(InputChunk, 0);
+  QByteArray window(WindowSize, 0); // decoded data goes round and round in here
+  qint64 totalIn = 0;
+  qint64 totalOut = 0;
+  qint64 last = 0;
+
+  for (;;) {
+    if (z.avail_in == 0) {
+      const qint64 n = file.read(in.data(), in.size());
+      if (n <= 0) {
+        break;
+      }
+      z.next_in = reinterpret_cast<Bytef*>(in.data());
+      z.avail_in = uInt(n);
+    }
+    if (z.avail_out == 0) {
+      z.next_out = reinterpret_cast<Bytef*>(window.data());
+      z.avail_out = WindowSize;
+    }
+
+    totalIn += z.avail_in;
+    totalOut += z.avail_out;
+    // stop at the end of each deflate block
+    const int ret = inflate(&z, Z_BLOCK);
+    totalIn -= z.avail_in;
+    totalOut -= z.avail_out;
+
+    if (ret == Z_STREAM_END) {
+      inflateReset(&z); // another gzip member may follow
+      continue;
+    }
+    if (ret != Z_OK) {
+      if (ret == Z_BUF_ERROR && z.avail_in == 0) {
+        continue;
+      }
+      break; // same as decode(): the data so far is the file
+    }
+
+    // at a block boundary, other than after the last block
+    if ((z.data_type & 128) && !(z.data_type & 64) && totalOut - last >= SeekSpan) {
+      SeekPoint point;
+      point.out = totalOut;
+      point.in = totalIn;
+      point.bits = z.data_type & 7;
+      const int left = z.avail_out;
+      point.window.resize(WindowSize);
+      memcpy(point.window.data(), window.constData() + WindowSize - left, left);
+      memcpy(point.window.data() + left, window.constData(), WindowSize - left);
+      index.points.append(point);
+      last = totalOut;
+    }
+  }
+
+  inflateEnd(&z);
+  index.size = totalOut;
+  return true;
+#else
+  Q_UNUSED(file)
+  Q_UNUSED(index)
+  return false;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------
+bool AsciiCompressedFile::buildZstdIndex(QFile& file, Index& index) const
+{
+#ifdef KST_HAVE_ZSTD
+  ZSTD_DStream* zstd = ZSTD_createDStream();
+  if (!zstd) {
+    return false;
+  }
+
+  QByteArray in(InputChunk, 0);
+  QByteArray out(BufferSize, 0);
+  ZSTD_inBuffer zin = { in.constData(), 0, 0 };
+  qint64 inBase = 0; // file offset of in[0]
+  qint64 totalOut = 0;
+  qint64 last = 0;
+
+  for (;;) {
+    if (zin.pos == zin.size) {
+      const qint64 n = file.read(in.data(), in.size());
+      if (n <= 0) {
+        break;
+      }
+      inBase += zin.size;
+      zin.size = size_t(n);
+      zin.pos = 0;
+    }
+    ZSTD_outBuffer zout = { out.data(), size_t(out.size()), 0 };
+    const size_t ret = ZSTD_decompressStream(zstd, &zout, &zin);
+    if (ZSTD_isError(ret)) {
+      break;
+    }
+    totalOut += zout.pos;
+    // a frame is complete: the next one can be decoded on its own
+    if (ret == 0 && totalOut - last >= SeekSpan) {
+      SeekPoint point = { totalOut, inBase + qint64(zin.pos), 0, QByteArray() };
+      index.points.append(point);
+      last = totalOut;
+    }
+  }
+
+  ZSTD_freeDStream(zstd);
+  index.size = totalOut;
+  return true;
+#else
+  Q_UNUSED(file)
+  Q_UNUSED(index)
+  return false;
+#endif
+}
+
+// vim: ts=2 sw=2 et
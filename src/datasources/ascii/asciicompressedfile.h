@@ -0,0 +1,97 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef ASCII_COMPRESSED_FILE_H
+#define ASCII_COMPRESSED_FILE_H
+
+#include <QFile>
+#include <QHash>
+#include <QSharedPointer>
+#include <QVector>
+
+class QMutex;
+
+// Read only, random access view of the uncompressed contents of a gzip or
+// zstd file.
+//
+// The first time the size is needed, the file is decompressed once to find
+// it, and seek points are recorded on the way: every MB or so at a deflate
+// block boundary for gzip (with the 32k window needed to restart there, as
+// in zlib's zran.c), and at frame boundaries for zstd.  A later read of a
+// range only decompresses from the seek point before it.  The index is
+// shared by every AsciiCompressedFile of the same file, as long as the file
+// is unchanged.
+//
+// Single frame zstd files have no seek points past the start; compress
+// with a frame size limit (eg, zstd's seekable format) to read them
+// quickly out of order.
+class AsciiCompressedFile : public QIODevice
+{
+public:
+  enum Format { Plain, Gzip, Zstd };
+
+  explicit AsciiCompressedFile(const QString& fileName);
+  ~AsciiCompressedFile();
+
+  // from the magic number at the start of the file
+  static Format format(const QString& fileName);
+  // whether kst was built with the library for this format
+  static bool isSupported(Format format);
+
+  QString fileName() const { return _file.fileName(); }
+
+  bool open(OpenMode mode) override;
+  void close() override;
+  bool isSequential() const override { return false; }
+  qint64 size() const override;
+  bool seek(qint64 pos) override;
+  bool atEnd() const override;
+  qint64 bytesAvailable() const override;
+
+  // number of seek points in the index; 0 if not yet built
+  int seekPoints() const;
+
+protected:
+  qint64 readData(char* data, qint64 maxSize) override;
+  qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+  struct SeekPoint;
+  struct Index;
+  struct Stream;
+
+  QFile _file;
+  Format _format;
+  mutable QSharedPointer<const Index> _index;
+  Stream* _stream;
+
+  qint64 _pos;         // where the next read starts
+  qint64 _decodePos;   // what the stream decodes next, -1 if not started
+  QByteArray _buffer;  // decoded data from _bufferPos
+  qint64 _bufferPos;
+  qint64 _bufferLen;
+
+  bool ensureIndex() const;
+  bool buildIndex(Index& index) const;
+  bool buildGzipIndex(QFile& file, Index& index) const;
+  bool buildZstdIndex(QFile& file, Index& index) const;
+
+  bool moveTo(qint64 pos);
+  bool restart(const SeekPoint& point);
+  qint64 decode(char* dst, qint64 maxSize);
+  bool refill();
+
+  static QHash<QString, QSharedPointer<const Index> >& indexCache();
+  static QMutex& indexCacheMutex();
+};
+
+#endif
+// vim: ts=2 sw=2 et
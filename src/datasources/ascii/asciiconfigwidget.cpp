@@ -17,6 +17,7 @@
 
 #include <QFile>
 #include <QFileInfo>
+#include <QScopedPointer>
 #include <QButtonGroup>
 #include <QPlainTextEdit>
 #include <QMessageBox>
@@ -96,13 +97,13 @@ void AsciiConfigWidgetInternal::showPreviewWindow()
 
 void AsciiConfigWidgetInternal::showBeginning(QPlainTextEdit* widget, int numberOfLines)
 {
-  QFile file(_filename);
-  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+  QScopedPointer<QIODevice> file(AsciiFileBuffer::createFile(_filename));
+  if (!file->open(QIODevice::ReadOnly | QIODevice::Text)) {
     return;
   }
 
   int lines_read = 1;
-  QTextStream in(&file);
+  QTextStream in(file.data());
   QStringList lines;
   while (!in.atEnd() && lines_read <= numberOfLines) {
     lines << QString("%1: ").arg(lines_read, 3) + readLine(in, 1000);
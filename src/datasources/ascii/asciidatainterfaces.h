@@ -39,12 +39,12 @@ public:
   void prepareRead(int);
   void readingDone();
   // read one element
-  int read(const QString&, DataVector::ReadInfo&);
+  qint64 read(const QString&, DataVector::ReadInfo&);
 
   // named elements
-  QStringList list() const { return ascii._fieldList; }
-  bool isListComplete() const { return ascii._fieldListComplete; }
-  bool isValid(const QString& field) const { return ascii._fieldLookup.contains( field ); }
+  QStringList list() const { QMutexLocker locker(&ascii._listMutex); return ascii._fieldList; }
+  bool isListComplete() const { QMutexLocker locker(&ascii._listMutex); return ascii._fieldListComplete; }
+  bool isValid(const QString& field) const { QMutexLocker locker(&ascii._listMutex); return ascii._fieldLookup.contains( field ); }
 
   // T specific
   const DataVector::DataInfo dataInfo(const QString&, double frame = 0) const;
@@ -63,10 +63,11 @@ public:
 const DataVector::DataInfo DataInterfaceAsciiVector::dataInfo(const QString &field, double frame) const
 {
   Q_UNUSED(frame)
+  QMutexLocker locker(&ascii._listMutex);
   if (!ascii._fieldLookup.contains(field))
     return DataVector::DataInfo();
 
-  return DataVector::DataInfo(ascii._reader.numberOfFrames(), 1);
+  return DataVector::DataInfo(ascii._frameCount, 1);
 }
 
 //-------------------------------------------------------------------------------------------
@@ -82,7 +83,7 @@ void DataInterfaceAsciiVector::readingDone()
 }
 
 //-------------------------------------------------------------------------------------------
-int DataInterfaceAsciiVector::read(const QString& field, DataVector::ReadInfo& p)
+qint64 DataInterfaceAsciiVector::read(const QString& field, DataVector::ReadInfo& p)
 {
   return ascii.readField(p.data, field, p.startingFrame, p.numberOfFrames);
 }
@@ -93,13 +94,15 @@ int DataInterfaceAsciiVector::read(const QString& field, DataVector::ReadInfo& p
 QMap<QString, double> DataInterfaceAsciiVector::metaScalars(const QString&)
 {
   QMap<QString, double> m;
-  m["FRAMES"] = ascii._reader.numberOfFrames();
+  QMutexLocker locker(&ascii._listMutex);
+  m["FRAMES"] = ascii._frameCount;
   return m;
 }
 
 QMap<QString, QString> DataInterfaceAsciiVector::metaStrings(const QString& field)
 {
   QMap<QString, QString> m;
+  QMutexLocker locker(&ascii._listMutex);
   if (ascii._fieldUnits.contains(field)) {
     m["units"] = ascii._fieldUnits[field];
   }
@@ -118,10 +121,10 @@ public:
   explicit DataInterfaceAsciiString(AsciiSource& s) : ascii(s) {}
 
   // read one element
-  int read(const QString&, DataString::ReadInfo&);
+  qint64 read(const QString&, DataString::ReadInfo&);
 
   // named elements
-  QStringList list() const { return ascii._strings.keys(); }
+  QStringList list() const { QMutexLocker locker(&ascii._listMutex); return ascii._strings.keys(); }
   bool isListComplete() const { return true; }
   bool isValid(const QString&) const;
 
@@ -140,9 +143,10 @@ private:
 
 
 //-------------------------------------------------------------------------------------------
-int DataInterfaceAsciiString::read(const QString& string, DataString::ReadInfo& p)
+qint64 DataInterfaceAsciiString::read(const QString& string, DataString::ReadInfo& p)
 {
-  if (isValid(string) && p.value) {
+  QMutexLocker locker(&ascii._listMutex);
+  if (ascii._strings.contains(string) && p.value) {
     *p.value = ascii._strings[string];
     return 1;
   }
@@ -153,6 +157,7 @@ int DataInterfaceAsciiString::read(const QString& string, DataString::ReadInfo&
 //-------------------------------------------------------------------------------------------
 bool DataInterfaceAsciiString::isValid(const QString& string) const
 {
+  QMutexLocker locker(&ascii._listMutex);
   return  ascii._strings.contains( string );
 }
 
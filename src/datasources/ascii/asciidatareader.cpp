@@ -76,7 +76,7 @@ void AsciiDataReader::setRow0Begin(qint64 begin)
 }
 
 //-------------------------------------------------------------------------------------------
-void AsciiDataReader::detectLineEndingType(QFile& file)
+void AsciiDataReader::detectLineEndingType(QIODevice& file)
 {
   QByteArray line;
   int line_size = 0;
@@ -121,7 +121,7 @@ void AsciiDataReader::toDouble(const LexicalCast& lexc, const char* buffer, qint
 }
 
 //-------------------------------------------------------------------------------------------
-bool AsciiDataReader::findAllDataRows(bool read_completely, QFile* file, qint64 byteLength, int col_count)
+bool AsciiDataReader::findAllDataRows(bool read_completely, QIODevice* file, qint64 byteLength, int col_count)
 {
   detectLineEndingType(*file);
 
@@ -235,7 +235,7 @@ bool AsciiDataReader::findDataRows(const Buffer& buffer, qint64 bufstart, qint64
 }
 
 //-------------------------------------------------------------------------------------------
-int AsciiDataReader::readFieldFromChunk(const AsciiFileData& chunk, int col, double *v, qint64 start, const QString& field)
+qint64 AsciiDataReader::readFieldFromChunk(const AsciiFileData& chunk, int col, double *v, qint64 start, const QString& field)
 {
   Q_ASSERT(chunk.rowBegin() >= start);
   return readField(chunk, col, v + chunk.rowBegin() - start, field, chunk.rowBegin(), chunk.rowsRead());
@@ -256,18 +256,18 @@ qint64 AsciiDataReader::progressRows()
 }
 
 //-------------------------------------------------------------------------------------------
-int AsciiDataReader::readField(const AsciiFileData& buf, int col, double *v, const QString& field, qint64 s, qint64 n)
+qint64 AsciiDataReader::readField(const AsciiFileData& buf, int col, double *v, const QString& field, qint64 s, qint64 n)
 {
   (void)field; // remove unused parameter warning.  This reads by column number (int col), not field name.
   if (_config._columnType == AsciiSourceConfig::Fixed) {
     //MeasureTime t("AsciiSource::readField: same width for all columns");
-    const LexicalCast& lexc = LexicalCast::instance();
+    const LexicalCast& lexc = _lexc;
     // buf[0] points to some row start, _rowIndex[i] is absolute, so we have to subtract buf.begin().
     const char*const col_start = &buf.checkedData()[0] + _config._columnWidth * (col - 1) - buf.begin();
     for (qint64 i = 0; i < n; ++i) {
       v[i] = lexc.toDouble(col_start + _rowIndex[i + s] );
     }
-    return (int)n;
+    return n;
   } else if (_config._columnType == AsciiSourceConfig::Custom) {
     if (_config._columnDelimiter.value().size() == 1) {
       //MeasureTime t("AsciiSource::readField: 1 custom column delimiter");
@@ -292,7 +292,7 @@ int AsciiDataReader::readField(const AsciiFileData& buf, int col, double *v, con
 
 //-------------------------------------------------------------------------------------------
 template<class Buffer, typename ColumnDelimiter>
-int AsciiDataReader::readColumns(double* v, const Buffer& buffer, qint64 bufstart, qint64 bufread, int col, qint64 s, qint64 n,
+qint64 AsciiDataReader::readColumns(double* v, const Buffer& buffer, qint64 bufstart, qint64 bufread, int col, qint64 s, qint64 n,
                                  const LineEndingType& lineending, const ColumnDelimiter& column_del) const
 {
   if (_config._delimiters.value().size() == 0) {
@@ -310,7 +310,7 @@ int AsciiDataReader::readColumns(double* v, const Buffer& buffer, qint64 bufstar
 
 //-------------------------------------------------------------------------------------------
 template<class Buffer, typename ColumnDelimiter, typename CommentDelimiter>
-int AsciiDataReader::readColumns(double* v, const Buffer& buffer, qint64 bufstart, qint64 bufread, int col, qint64 s, qint64 n,
+qint64 AsciiDataReader::readColumns(double* v, const Buffer& buffer, qint64 bufstart, qint64 bufread, int col, qint64 s, qint64 n,
                                  const LineEndingType& lineending, const ColumnDelimiter& column_del, const CommentDelimiter& comment_del) const
 {
   if (_config._columnWidthIsConst) {
@@ -332,12 +332,12 @@ int AsciiDataReader::readColumns(double* v, const Buffer& buffer, qint64 bufstar
 
 //-------------------------------------------------------------------------------------------
 template<class Buffer, typename IsLineBreak, typename ColumnDelimiter, typename CommentDelimiter, typename ColumnWidthsAreConst>
-int AsciiDataReader::readColumns(double* v, const Buffer& buffer, qint64 bufstart, qint64 bufread, int col, qint64 s, qint64 n,
+qint64 AsciiDataReader::readColumns(double* v, const Buffer& buffer, qint64 bufstart, qint64 bufread, int col, qint64 s, qint64 n,
                                  const IsLineBreak& isLineBreak,
                                  const ColumnDelimiter& column_del, const CommentDelimiter& comment_del,
                                  const ColumnWidthsAreConst& are_column_widths_const) const
 {
-  const LexicalCast& lexc = LexicalCast::instance();
+  const LexicalCast& lexc = _lexc;
 
   const QString delimiters = _config._delimiters.value();
 
@@ -15,12 +15,12 @@
 
 #include "asciifilebuffer.h"
 #include "asciicharactertraits.h"
+#include "kst_atof.h"
 
 #include <QVarLengthArray>
 #include <QMutex>
 
-class QFile;
-class LexicalCast;
+class QIODevice;
 class AsciiSourceConfig;
 
 
@@ -38,11 +38,11 @@ class AsciiDataReader
     // where
     const AsciiFileBuffer::RowIndex& rowIndex() const { return _rowIndex; }
     
-    void detectLineEndingType(QFile& file);
+    void detectLineEndingType(QIODevice& file);
 
-    bool findAllDataRows(bool read_completely, QFile* file, qint64 _byteLength, int col_count);
-    int readField(const AsciiFileData &buf, int col, double *v, const QString& field, qint64 start, qint64 n);
-    int readFieldFromChunk(const AsciiFileData& chunk, int col, double *v, qint64 start, const QString& field);
+    bool findAllDataRows(bool read_completely, QIODevice* file, qint64 _byteLength, int col_count);
+    qint64 readField(const AsciiFileData &buf, int col, double *v, const QString& field, qint64 start, qint64 n);
+    qint64 readFieldFromChunk(const AsciiFileData& chunk, int col, double *v, qint64 start, const QString& field);
 
     template<typename ColumnDelimiter>
     static int splitColumns(const QByteArray& line, const ColumnDelimiter& column_del, QStringList* cols = 0);
@@ -50,6 +50,9 @@ class AsciiDataReader
     double progressValue();
     qint64 progressRows();
 
+    /** how this source's text becomes numbers; set up before each read */
+    LexicalCast& lexicalCast() { return _lexc; }
+
   private:
     QMutex _progressMutex;
     double _progressValue;
@@ -69,15 +72,15 @@ class AsciiDataReader
     bool resizeBuffer(T& buffer, qint64 bytes);
 
     template<class Buffer, typename ColumnDelimiter>
-    int readColumns(double* v, const Buffer& buffer, qint64 bufstart, qint64 bufread, int col, qint64 s, qint64 n,
+    qint64 readColumns(double* v, const Buffer& buffer, qint64 bufstart, qint64 bufread, int col, qint64 s, qint64 n,
                     const AsciiCharacterTraits::LineEndingType&, const ColumnDelimiter&) const;
 
     template<class Buffer, typename ColumnDelimiter, typename CommentDelimiter>
-    int readColumns(double* v, const Buffer& buffer, qint64 bufstart, qint64 bufread, int col, qint64 s, qint64 n,
+    qint64 readColumns(double* v, const Buffer& buffer, qint64 bufstart, qint64 bufread, int col, qint64 s, qint64 n,
                     const AsciiCharacterTraits::LineEndingType&, const ColumnDelimiter&, const CommentDelimiter&) const;
 
     template<class Buffer, typename IsLineBreak, typename ColumnDelimiter, typename CommentDelimiter, typename ColumnWidthsAreConst>
-    int readColumns(double* v, const Buffer& buffer, qint64 bufstart, qint64 bufread, int col, qint64 s, qint64 n,
+    qint64 readColumns(double* v, const Buffer& buffer, qint64 bufstart, qint64 bufread, int col, qint64 s, qint64 n,
                     const IsLineBreak&, const ColumnDelimiter&, const CommentDelimiter&, const ColumnWidthsAreConst&) const;
 
     template<class Buffer, typename IsLineBreak, typename CommentDelimiter>
@@ -85,7 +88,7 @@ class AsciiDataReader
 
     void toDouble(const LexicalCast& lexc, const char* buffer, qint64 bufread, qint64 ch, double* v, int row) const;
 
-    mutable QMutex _localeMutex;
+    LexicalCast _lexc;
 };
 
 
@@ -11,6 +11,7 @@
  ***************************************************************************/
 
 #include "asciifilebuffer.h"
+#include "asciicompressedfile.h"
 #include "debug.h"
 
 #include <QFile>
@@ -35,14 +36,24 @@ AsciiFileBuffer::~AsciiFileBuffer()
 }
 
 //-------------------------------------------------------------------------------------------
-void AsciiFileBuffer::setFile(QFile* file)
+void AsciiFileBuffer::setFile(QIODevice* file)
 {
   delete _file;
   _file = file; 
 }
 
 //-------------------------------------------------------------------------------------------
-bool AsciiFileBuffer::openFile(QFile &file) 
+QIODevice* AsciiFileBuffer::createFile(const QString& fileName)
+{
+  const AsciiCompressedFile::Format format = AsciiCompressedFile::format(fileName);
+  if (format != AsciiCompressedFile::Plain && AsciiCompressedFile::isSupported(format)) {
+    return new AsciiCompressedFile(fileName);
+  }
+  return new QFile(fileName);
+}
+
+//-------------------------------------------------------------------------------------------
+bool AsciiFileBuffer::openFile(QIODevice &file)
 {
   // Don't use 'QIODevice::Text'!
   // Because CR LF line ending breaks row offset calculation
@@ -50,7 +61,7 @@ bool AsciiFileBuffer::openFile(QFile &file)
 }
 
 //-------------------------------------------------------------------------------------------
-bool AsciiFileBuffer::reOpenFile(QFile &file)
+bool AsciiFileBuffer::reOpenFile(QIODevice &file)
 {
   // Don't use 'QIODevice::Text'!
   // Because CR LF line ending breaks row offset calculation
@@ -31,7 +31,7 @@ public:
   
   void clear();
 
-  void setFile(QFile* file);
+  void setFile(QIODevice* file);
   bool readWindow(QVector<AsciiFileData>& window) const;
 
   void useOneWindowWithChunks(const RowIndex& rowIndex, qint64 start, qint64 bytesToRead, int numChunks);
@@ -40,11 +40,13 @@ public:
 
   QVector<QVector<AsciiFileData> >& fileData() { return _fileData; }
 
-  static bool openFile(QFile &file);
-  static bool reOpenFile(QFile &file);
+  // a QFile, or an AsciiCompressedFile for gzip and zstd files
+  static QIODevice* createFile(const QString& fileName);
+  static bool openFile(QIODevice &file);
+  static bool reOpenFile(QIODevice &file);
 
 private:
-  QFile* _file;
+  QIODevice* _file;
   QVector<QVector<AsciiFileData> > _fileData;
 
   qint64 _begin;
@@ -135,7 +135,7 @@ void AsciiFileData::clear(bool forceDeletingArray)
 }
 
 //-------------------------------------------------------------------------------------------
-qint64 AsciiFileData::read(QFile& file, qint64 start, qint64 bytesToRead, qint64 maximalBytes)
+qint64 AsciiFileData::read(QIODevice& file, qint64 start, qint64 bytesToRead, qint64 maximalBytes)
 {
   _begin = -1;
   _bytesRead = 0;
@@ -171,7 +171,7 @@ bool AsciiFileData::read()
     return true;
   }
 
-  if (!_file || _file->openMode() != QIODevice::ReadOnly) {
+  if (!_file || !_file->isReadable()) {
     return false;
   }
 
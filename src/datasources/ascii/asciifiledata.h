@@ -17,7 +17,7 @@
 #include <QSharedPointer>
 #include <QVarLengthArray>
 
-class QFile;
+class QIODevice;
 
 class AsciiFileData
 {
@@ -47,9 +47,9 @@ public:
   inline void setBegin(qint64 begin) { _begin = begin; }
   inline void setBytesRead(qint64 read) { _bytesRead = read; }
 
-  inline void setFile(QFile* file) { _file = file; }
+  inline void setFile(QIODevice* file) { _file = file; }
   bool read();
-  qint64 read(QFile&, qint64 start, qint64 numberOfBytes, qint64 maximalBytes = -1);
+  qint64 read(QIODevice&, qint64 start, qint64 numberOfBytes, qint64 maximalBytes = -1);
 
   char* data();
   const char* constPointer() const;
@@ -71,7 +71,7 @@ public:
 
 private:
   QSharedPointer<Array> _array;
-  QFile* _file;
+  QIODevice* _file;
   bool _fileRead;
   bool _reread;
   qint64 _begin;
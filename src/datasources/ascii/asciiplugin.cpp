@@ -17,6 +17,7 @@
 
 #include <QFile>
 #include <QFileInfo>
+#include <QScopedPointer>
 #include <QButtonGroup>
 #include <QPlainTextEdit>
 #include <QMessageBox>
@@ -168,8 +169,8 @@ int AsciiPlugin::understands(QSettings *cfg, const QString& filename) const {
     }
   }
 
-  QFile f(filename);
-  if (f.open(QIODevice::ReadOnly)) {    
+  QScopedPointer<QIODevice> f(AsciiFileBuffer::createFile(filename));
+  if (f->open(QIODevice::ReadOnly)) {
 
     QRegularExpression commentRE;
     QRegularExpression dataRE;
@@ -184,7 +185,7 @@ int AsciiPlugin::understands(QSettings *cfg, const QString& filename) const {
     int skip = config._dataLine;
     bool done = false;
     while (!done) {
-      const QByteArray line = f.readLine(max_line_length);
+      const QByteArray line = f->readLine(max_line_length);
       const int rc = line.size();
       if (skip > 0) {
         --skip;
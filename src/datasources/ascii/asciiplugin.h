@@ -21,7 +21,7 @@ class AsciiPlugin : public QObject, public Kst::DataSourcePluginInterface
 {
     Q_OBJECT
     Q_INTERFACES(Kst::DataSourcePluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.3")
 
   public:
     virtual ~AsciiPlugin() {}
@@ -26,6 +26,7 @@
 #include <QFile>
 #include <QRegularExpression>
 #include <QFileInfo>
+#include <QScopedPointer>
 #include <QMessageBox>
 #include <QThread>
 #include <QFutureSynchronizer>
@@ -94,9 +95,17 @@ AsciiSource::AsciiSource(Kst::ObjectStore *store, QSettings *cfg, const QString&
   // TODO only works for local files
   AsciiSource::setUpdateType((UpdateCheckType)_config._updateType.value());
 
+  // the row index and buffers are per source, and progress is only
+  // reported through signals
+  _concurrentUpdate = true;
+
   _valid = true;
   registerChange();
-  AsciiSource::internalDataSourceUpdate();
+  // in a session being loaded, the header is read with the rows, in a
+  // worker thread
+  if (!store->deferSourceScans) {
+    AsciiSource::internalDataSourceUpdate();
+  }
   _progressTimer.restart();
 }
 
@@ -119,23 +128,27 @@ void AsciiSource::reset()
   _fileSize = 0;
   _lastFileSize = 0;
   _haveHeader = false;
-  _fieldListComplete = false;
-
-  _fieldList.clear();
-  _fieldLookup.clear();
-  _scalarList.clear();
-  _strings.clear();
 
   Object::reset();
 
   _indexFieldProps.clear();
-  _strings = fileMetas();
+  const QMap<QString, QString> strings = fileMetas();
+
+  {
+    QMutexLocker locker(&_listMutex);
+    _fieldListComplete = false;
+    _fieldList.clear();
+    _fieldLookup.clear();
+    _scalarList.clear();
+    _strings = strings;
+    _frameCount = 0;
+  }
 
   prepareRead(0);
 }
 
 //-------------------------------------------------------------------------------------------
-bool AsciiSource::initRowIndex(QFile *file)
+bool AsciiSource::initRowIndex(QIODevice *file)
 {
   _reader.clear();
   //_fileSize = 0;
@@ -155,6 +168,7 @@ bool AsciiSource::initRowIndex(QFile *file)
       }
       --left;
       if (header_row != _config._fieldsLine && header_row != _config._unitsLine) {
+        QMutexLocker locker(&_listMutex);
         _strings[QString("Header %1").arg(header_row, 2, 10, QChar('0'))] = QString::fromLatin1(line).trimmed();
       }
       header_row++;
@@ -167,26 +181,32 @@ bool AsciiSource::initRowIndex(QFile *file)
 
 //-------------------------------------------------------------------------------------------
 void AsciiSource::updateLists() {
-  _fieldList = fieldListFor(_filename, _config);
+  const QStringList fieldList = fieldListFor(_filename, _config);
+  QMap<QString, QString> fieldUnits = _fieldUnits;
   QStringList units;
   if (_config._readUnits) {
     units += unitListFor(_filename, _config);
-    for (int index = 0; index < _fieldList.size(); ++index) {
+    for (int index = 0; index < fieldList.size(); ++index) {
       if (index >= units.size()) {
         break; // Missing units => the user's fault, but at least don't crash
       }
-      _fieldUnits[_fieldList[index]] = units[index];
+      fieldUnits[fieldList[index]] = units[index];
     }
   }
-  _fieldListComplete = _fieldList.count() > 1;
 
-  _fieldLookup.clear();
-  for (int i = 0; i < _fieldList.size(); i++)
-      _fieldLookup[_fieldList[i]] = i;
+  QHash<QString, int> fieldLookup;
+  for (int i = 0; i < fieldList.size(); i++)
+      fieldLookup[fieldList[i]] = i;
 
   // Re-update the scalar list
-  _scalarList = scalarListFor(_filename, _config);
+  const QStringList scalarList = scalarListFor(_filename, _config);
 
+  QMutexLocker locker(&_listMutex);
+  _fieldList = fieldList;
+  _fieldUnits = fieldUnits;
+  _fieldListComplete = _fieldList.count() > 1;
+  _fieldLookup = fieldLookup;
+  _scalarList = scalarList;
 }
 
 //-------------------------------------------------------------------------------------------
@@ -205,9 +225,9 @@ Kst::Object::UpdateType AsciiSource::internalDataSourceUpdate(bool read_complete
     return NoChange;
 
   // verify the file exists, and see if it has shrunk (so it needs a reset)
-  QFile file(_filename);
+  QScopedPointer<QIODevice> file(AsciiFileBuffer::createFile(_filename));
 
-  if (!AsciiFileBuffer::openFile(file)) {
+  if (!AsciiFileBuffer::openFile(*file)) {
     // Qt: If the device is closed, the size returned will not reflect the actual size of the device.
     return NoChange;
   }
@@ -217,13 +237,13 @@ Kst::Object::UpdateType AsciiSource::internalDataSourceUpdate(bool read_complete
     _fileSize = 0;
     force_update = true;
   } else {
-    _fileSize = file.size();
+    _fileSize = file->size();
     if (_fileSize < _lastFileSize) { // file has shrunk!
-      if (!AsciiFileBuffer::reOpenFile(file)) {
+      if (!AsciiFileBuffer::reOpenFile(*file)) {
          return NoChange;
       }
       AsciiSource::reset();
-      _fileSize = file.size();
+      _fileSize = file->size();
     } else {
       force_update=false;
     }
@@ -233,7 +253,7 @@ Kst::Object::UpdateType AsciiSource::internalDataSourceUpdate(bool read_complete
   _fileBuffer.clear();
 
   if (!_haveHeader) {
-    _haveHeader = initRowIndex(&file);
+    _haveHeader = initRowIndex(file.data());
 
     if (!_haveHeader) {
       return NoChange;
@@ -241,7 +261,7 @@ Kst::Object::UpdateType AsciiSource::internalDataSourceUpdate(bool read_complete
   }
   updateLists();
 
-  _fileCreationTime_t = QFileInfo(file).birthTime().toSecsSinceEpoch();
+  _fileCreationTime_t = QFileInfo(_filename).birthTime().toSecsSinceEpoch();
 
   int col_count = _fieldList.size() - 1; // minus INDEX
 
@@ -251,7 +271,7 @@ Kst::Object::UpdateType AsciiSource::internalDataSourceUpdate(bool read_complete
     _showFieldProgress = true;
     emitProgress(1, tr("Parsing '%1' ...").arg(_filename));
     QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-    QFuture<bool> future = QtConcurrent::run(&AsciiDataReader::findAllDataRows, &_reader, read_completely, &file, _fileSize, col_count);
+    QFuture<bool> future = QtConcurrent::run(&AsciiDataReader::findAllDataRows, &_reader, read_completely, file.data(), _fileSize, col_count);
     _busy = true;
     while (_busy) {
       if (future.isFinished()) {
@@ -270,10 +290,14 @@ Kst::Object::UpdateType AsciiSource::internalDataSourceUpdate(bool read_complete
     }
   } else {
     _showFieldProgress = false;
-    new_data = _reader.findAllDataRows(read_completely, &file, _fileSize, col_count);
+    new_data = _reader.findAllDataRows(read_completely, file.data(), _fileSize, col_count);
   }
 
   _lastFileSize = _fileSize;
+  {
+    QMutexLocker locker(&_listMutex);
+    _frameCount = _reader.numberOfFrames();
+  }
 
   Kst::Object::UpdateType update_type;
   if (new_data || force_update) {
@@ -315,7 +339,7 @@ bool AsciiSource::useSlidingWindow(qint64 bytesToRead)  const
 
 
 //-------------------------------------------------------------------------------------------
-int AsciiSource::readField(double *v, const QString& field, double s, double n)
+qint64 AsciiSource::readField(double *v, const QString& field, double s, double n)
 {
   _actualField = field;
   if (n>BIG_READ) {
@@ -326,7 +350,7 @@ int AsciiSource::readField(double *v, const QString& field, double s, double n)
   // FIXME: Debug::trace() here is a memory leak, which is serious for large quickly updating files.
   //Debug::trace(QString("AsciiSource::readField() %1  s=%2  n=%3").arg(field.leftJustified(15)).arg(QString("%1").arg(s, 10)).arg(n));
 
-  int read = tryReadField(v, field, s, n);
+  qint64 read = tryReadField(v, field, s, n);
 
   bool field_is_time = false;
   for (const IndexFieldProperties& ifp : indexFieldProperties()) {
@@ -345,7 +369,7 @@ int AsciiSource::readField(double *v, const QString& field, double s, double n)
         rate = 1.0;
       }
 
-      for (int i=0; i<read; i++) {
+      for (qint64 i=0; i<read; i++) {
         v[i] *= rate;
       }
     }
@@ -359,7 +383,7 @@ int AsciiSource::readField(double *v, const QString& field, double s, double n)
       dT = _fileCreationTime_t;
     }
 
-    for (int i=0; i<read; i++) {
+    for (qint64 i=0; i<read; i++) {
       v[i] += dT;
     }
 
@@ -414,7 +438,7 @@ void AsciiSource::readingDone()
 }
 
 //-------------------------------------------------------------------------------------------
-int AsciiSource::tryReadField(double *v, const QString& field, double s, double n)
+qint64 AsciiSource::tryReadField(double *v, const QString& field, double s, double n)
 {
   const qint64 s64 = (qint64)s;
   qint64 n64 = (qint64)n;
@@ -429,7 +453,7 @@ int AsciiSource::tryReadField(double *v, const QString& field, double s, double
     if (n64>BIG_READ) {
       updateFieldMessage(tr("INDEX created"));
     }
-    return (int)n64;
+    return n64;
   }
 
   int col = columnOfField(field);
@@ -442,7 +466,7 @@ int AsciiSource::tryReadField(double *v, const QString& field, double s, double
   const qint64 begin = _reader.beginOfRow(s64);
   const qint64 bytesToRead = _reader.beginOfRow(s64 + n64) - begin;
   if ((begin != _fileBuffer.begin()) || (bytesToRead != _fileBuffer.bytesRead())) {
-    QFile* file = new QFile(_filename);
+    QIODevice* file = AsciiFileBuffer::createFile(_filename);
     if (!AsciiFileBuffer::openFile(*file)) {
       delete file;
       _read_count_max = -1;
@@ -490,15 +514,17 @@ int AsciiSource::tryReadField(double *v, const QString& field, double s, double
 #endif
   default:nanMode = LexicalCast::NullValue; break;
   }
-  LexicalCast::AutoReset useDot(_config._useDot, nanMode);
-
-
+  LexicalCast& lexc = _reader.lexicalCast();
+  lexc.setUseDotAsDecimalSeparator(_config._useDot);
+  lexc.setNaNMode(nanMode);
   if (field == _config._indexVector && _config._indexInterpretation == AsciiSourceConfig::FormattedTime) {
-    LexicalCast::instance().setTimeFormat(_config._timeAsciiFormatString);
+    lexc.setTimeFormat(_config._timeAsciiFormatString);
+  } else {
+    lexc.setTimeFormat(QString());
   }
 
   QVector<QVector<AsciiFileData> >& slidingWindow = _fileBuffer.fileData();
-  int sampleRead = 0;
+  qint64 sampleRead = 0;
 
   _progressSteps = 0;
   for (int i = 0; i < slidingWindow.size(); i++) {
@@ -512,7 +538,7 @@ int AsciiSource::tryReadField(double *v, const QString& field, double s, double
 
   for (int i = 0; i < slidingWindow.size(); i++) {
 
-    int read;
+    qint64 read;
     if (useThreads())
       read = parseWindowMultithreaded(slidingWindow[i], col, v, s64, field);
     else
@@ -544,9 +570,9 @@ int AsciiSource::tryReadField(double *v, const QString& field, double s, double
 
 
 //-------------------------------------------------------------------------------------------
-int AsciiSource::parseWindowSinglethreaded(QVector<AsciiFileData>& window, int col, double* v, qint64 start, const QString& field, int sRead)
+qint64 AsciiSource::parseWindowSinglethreaded(QVector<AsciiFileData>& window, int col, double* v, qint64 start, const QString& field, qint64 sRead)
 {
-  int read = 0;
+  qint64 read = 0;
   for (int i = 0; i < window.size(); i++) {
     Q_ASSERT(sRead + start ==  window[i].rowBegin());
     if (!window[i].read() || window[i].bytesRead() == 0)
@@ -560,7 +586,7 @@ int AsciiSource::parseWindowSinglethreaded(QVector<AsciiFileData>& window, int c
 
 
 //-------------------------------------------------------------------------------------------
-int AsciiSource::parseWindowMultithreaded(QVector<AsciiFileData>& window, int col, double* v, qint64 start, const QString& field)
+qint64 AsciiSource::parseWindowMultithreaded(QVector<AsciiFileData>& window, int col, double* v, qint64 start, const QString& field)
 {
   updateFieldProgress(tr("reading ..."));
   for (int i = 0; i < window.size(); i++) {
@@ -572,16 +598,16 @@ int AsciiSource::parseWindowMultithreaded(QVector<AsciiFileData>& window, int co
   }
 
   updateFieldProgress(tr("parsing ..."));
-  QFutureSynchronizer<int> readFutures;
+  QFutureSynchronizer<qint64> readFutures;
   foreach (const AsciiFileData& chunk, window) {
-    QFuture<int> future = QtConcurrent::run(&AsciiDataReader::readFieldFromChunk, &_reader, chunk, col, v, start, field);
+    QFuture<qint64> future = QtConcurrent::run(&AsciiDataReader::readFieldFromChunk, &_reader, chunk, col, v, start, field);
     readFutures.addFuture(future);
   }
   readFutures.waitForFinished();
   _progress += window.size();
   updateFieldProgress(tr("parsing ..."));
-  int sampleRead = 0;
-  foreach (const QFuture<int> future, readFutures.futures()) {
+  qint64 sampleRead = 0;
+  foreach (const QFuture<qint64> future, readFutures.futures()) {
     sampleRead += future.result();
   }
   return sampleRead;
@@ -639,15 +665,16 @@ void AsciiSource::setUpdateType(UpdateCheckType updateType)
 //-------------------------------------------------------------------------------------------
 bool AsciiSource::isEmpty() const
 {
-  return _reader.numberOfFrames() < 1;
+  QMutexLocker locker(&_listMutex);
+  return _frameCount < 1;
 }
 
 
 //-------------------------------------------------------------------------------------------
 QStringList AsciiSource::scalarListFor(const QString& filename, AsciiSourceConfig)
 {
-  QFile file(filename);
-  if (!AsciiFileBuffer::openFile(file)) {
+  QScopedPointer<QIODevice> file(AsciiFileBuffer::createFile(filename));
+  if (!AsciiFileBuffer::openFile(*file)) {
     return QStringList();
   }
   return QStringList() << "FRAMES";
@@ -657,8 +684,8 @@ QStringList AsciiSource::scalarListFor(const QString& filename, AsciiSourceConfi
 //-------------------------------------------------------------------------------------------
 QStringList AsciiSource::stringListFor(const QString& filename, AsciiSourceConfig)
 {
-  QFile file(filename);
-  if (!AsciiFileBuffer::openFile(file)) {
+  QScopedPointer<QIODevice> file(AsciiFileBuffer::createFile(filename));
+  if (!AsciiFileBuffer::openFile(*file)) {
     return QStringList();
   }
   return QStringList() << "FILE";
@@ -725,8 +752,8 @@ const QList<Kst::IndexFieldProperties>& AsciiSource::indexFieldProperties() {
 //-------------------------------------------------------------------------------------------
 QStringList AsciiSource::fieldListFor(const QString& filename, AsciiSourceConfig cfg)
 {
-  QFile file(filename);
-  if (!AsciiFileBuffer::openFile(file)) {
+  QScopedPointer<QIODevice> file(AsciiFileBuffer::createFile(filename));
+  if (!AsciiFileBuffer::openFile(*file)) {
     return QStringList();
   }
 
@@ -737,7 +764,7 @@ QStringList AsciiSource::fieldListFor(const QString& filename, AsciiSourceConfig
     int fieldsLine = cfg._fieldsLine;
     int currentLine = 0; // Explicit line counter, to make the code easier to understand
     while (currentLine < cfg._dataLine) {
-      const QByteArray line = file.readLine();
+      const QByteArray line = file->readLine();
       int r = line.size();
       if (currentLine == fieldsLine && r >= 0) {
         QStringList parts;
@@ -777,8 +804,8 @@ QStringList AsciiSource::fieldListFor(const QString& filename, AsciiSourceConfig
   int cnt;
   int nextscan = 0;
   int curscan = 0;
-  while (!file.atEnd() && !done && (nextscan < 200)) {
-    QByteArray line = file.readLine();
+  while (!file->atEnd() && !done && (nextscan < 200)) {
+    QByteArray line = file->readLine();
     int r = line.size();
     if (skip > 0) { //keep skipping until desired line
       --skip;
@@ -821,8 +848,8 @@ QStringList AsciiSource::fieldListFor(const QString& filename, AsciiSourceConfig
 //-------------------------------------------------------------------------------------------
 QStringList AsciiSource::unitListFor(const QString& filename, AsciiSourceConfig cfg)
 {
-  QFile file(filename);
-  if (!AsciiFileBuffer::openFile(file)) {
+  QScopedPointer<QIODevice> file(AsciiFileBuffer::createFile(filename));
+  if (!AsciiFileBuffer::openFile(*file)) {
     return QStringList();
   }
 
@@ -832,7 +859,7 @@ QStringList AsciiSource::unitListFor(const QString& filename, AsciiSourceConfig
   int unitsLine = cfg._unitsLine;
   int currentLine = 0;
   while (currentLine < cfg._dataLine) {
-    const QByteArray line = file.readLine();
+    const QByteArray line = file->readLine();
     int r = line.size();
     if (currentLine == unitsLine && r >= 0) {
       QStringList parts;
@@ -863,7 +890,9 @@ void AsciiSource::parseProperties(QXmlStreamAttributes &properties)
 {
   _config.parseProperties(properties);
   reset();
-  internalDataSourceUpdate();
+  if (!store() || !store()->deferSourceScans) {
+    internalDataSourceUpdate();
+  }
 }
 
 
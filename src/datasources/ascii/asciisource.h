@@ -19,11 +19,12 @@
 #include "datasource.h"
 #include "dataplugin.h"
 
+#include <QMutex>
 #include <QTime>
 #include <QElapsedTimer>
 
 
-class QFile;
+class QIODevice;
 class DataInterfaceAsciiString;
 class DataInterfaceAsciiVector;
 class QProgressBar;
@@ -37,7 +38,7 @@ class AsciiSource : public Kst::DataSource
     AsciiSource(Kst::ObjectStore *store, QSettings *cfg, const QString& filename, const QString& type, const QDomElement& e = QDomElement());
     ~AsciiSource();
 
-    bool initRowIndex(QFile *file);
+    bool initRowIndex(QIODevice *file);
 
     virtual const QList<Kst::IndexFieldProperties>& indexFieldProperties() override;
 
@@ -47,7 +48,7 @@ class AsciiSource : public Kst::DataSource
 
     void prepareRead(int count);
     void readingDone();
-    int readField(double *v, const QString &field, double s, double n);
+    qint64 readField(double *v, const QString &field, double s, double n);
 
     QString fileType() const;
     void setUpdateType(UpdateCheckType);
@@ -118,12 +119,17 @@ private:
     QHash<QString, int> _fieldLookup;
     QMap<QString, QString> _fieldUnits;
 
+    // what other readers see of the lists above, and of the rows, is
+    // published under this: the read ahead updates them under the read lock
+    mutable QMutex _listMutex;
+    qint64 _frameCount;
+
     bool useThreads() const;
     bool useSlidingWindow(qint64 bytesToRead)  const;
 
-    int tryReadField(double *v, const QString &field, double s, double n);
-    int parseWindowSinglethreaded(QVector<AsciiFileData>& fileData, int col, double* v, qint64 start, const QString& field, int sRead);
-    int parseWindowMultithreaded(QVector<AsciiFileData>& fileData, int col, double* v, qint64 start, const QString& field);
+    qint64 tryReadField(double *v, const QString &field, double s, double n);
+    qint64 parseWindowSinglethreaded(QVector<AsciiFileData>& fileData, int col, double* v, qint64 start, const QString& field, qint64 sRead);
+    qint64 parseWindowMultithreaded(QVector<AsciiFileData>& fileData, int col, double* v, qint64 start, const QString& field);
 
     int columnOfField(const QString& field) const;
     static int splitHeaderLine(const QByteArray& line, const AsciiSourceConfig& cfg, QStringList* parts = 0);
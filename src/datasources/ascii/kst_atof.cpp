@@ -10,15 +10,20 @@
  *                                                                         *
  ***************************************************************************/
 
-// patched BSD V7 code
-// http://www.bsdlover.cn/study/UnixTree/V7/usr/src/libc/gen/atof.c.html
+// Numbers with at most 19 significant digits are converted exactly with
+// Clinger's fast path or the Eisel-Lemire algorithm, see
+//   D. Lemire, "Number Parsing at a Gigabyte per Second", 2021,
+//   https://arxiv.org/abs/2101.11408
+// Anything else goes to QByteArray::toDouble(), which, unlike strtod,
+// doesn't depend on the locale.
 
 #include "kst_atof.h"
 #include "math_kst.h"
 
 #include <math.h>
 #include <ctype.h>
-#include <locale.h>
+#include <string.h>
+#include <limits>
 
 #include <QLocale>
 #include <QTime>
@@ -26,125 +31,328 @@
 #include <QDebug>
 #include <QTimeZone>
 
-#define LOGHUGE 39
 
+//-------------------------------------------------------------------------------------------
+static const int SmallestPowerOfTen = -342;
+static const int LargestPowerOfTen = 308;
 
 //-------------------------------------------------------------------------------------------
-#ifdef KST_USE_KST_ATOF
-double LexicalCast::fromDouble(const char* signedp) const
+// 128 bit approximations of 5^q, q = -342..308, normalized so the top bit is
+// set: truncated for q >= 0, rounded up reciprocals for q < 0.  Computed once
+// with a small bignum rather than shipping a table of 1302 constants.
+namespace {
+
+typedef QVector<quint32> BigNum; // little endian 32 bit words
+
+void bigMul(BigNum& a, quint32 m)
 {
-  unsigned char* p = (unsigned char*)signedp;
-  unsigned char c;
-  double fl, flexp, exp5;
-  double big = 72057594037927936.;  /*2^56*/
-  int nd;
-  int eexp, exp, neg, negexp, bexp;
-
-  neg = 1;
-  while((c = *p++) == ' ')
-    ;
-  if (c == '-')
-    neg = -1;
-  else if (c=='+')
-    ;
-  else
-    --p;
+  quint64 carry = 0;
+  for (int i = 0; i < a.size(); ++i) {
+    const quint64 t = quint64(a[i]) * m + carry;
+    a[i] = quint32(t);
+    carry = t >> 32;
+  }
+  if (carry) {
+    a.append(quint32(carry));
+  }
+}
 
-  if (_nanMode != NullValue && c != '-' && c != '+' && c != _separator && !isDigit(c)) {
-    return nanValue();
+void bigDiv(BigNum& a, quint32 d)
+{
+  quint64 rem = 0;
+  for (int i = a.size() - 1; i >= 0; --i) {
+    const quint64 cur = (rem << 32) | a[i];
+    a[i] = quint32(cur / d);
+    rem = cur % d;
   }
+  while (!a.isEmpty() && a.last() == 0) {
+    a.removeLast();
+  }
+}
 
+void bigAddOne(BigNum& a)
+{
+  for (int i = 0; i < a.size(); ++i) {
+    if (++a[i] != 0) {
+      return;
+    }
+  }
+  a.append(1);
+}
 
-  exp = 0;
-  fl = 0;
-  nd = 0;
-  while ((c = *p++), isDigit(c)) {
-    if (fl<big)
-      fl = 10*fl + (c-'0');
-    else
-      exp++;
-    nd++;
+int bigBits(const BigNum& a)
+{
+  if (a.isEmpty()) {
+    return 0;
   }
+  int bits = 32 * (a.size() - 1);
+  for (quint32 top = a.last(); top; top >>= 1) {
+    ++bits;
+  }
+  return bits;
+}
 
-  if (c == _separator) {
-    while ((c = *p++), isDigit(c)) {
-      if (fl<big) {
-        fl = 10*fl + (c-'0');
-        exp--;
-      }
-    nd++;
+// bits [low, low + 64) of a; bits below 0 are zero
+quint64 bigSlice(const BigNum& a, int low)
+{
+  quint64 r = 0;
+  for (int b = 63; b >= 0; --b) {
+    const int bit = low + b;
+    r <<= 1;
+    if (bit >= 0 && (bit >> 5) < a.size() && ((a[bit >> 5] >> (bit & 31)) & 1)) {
+      r |= 1;
     }
   }
+  return r;
+}
 
-  negexp = 1;
-  eexp = 0;
-  if ((c == 'E') || (c == 'e')) {
-    if ((c= *p++) == '+')
-      ;
-    else if (c=='-')
-      negexp = -1;
-    else
-      --p;
+struct PowersOfFive
+{
+  quint64 value[2 * (LargestPowerOfTen - SmallestPowerOfTen + 1)];
+
+  PowersOfFive()
+  {
+    BigNum p5;
+    p5.append(1);
+    for (int k = 1; k <= -SmallestPowerOfTen; ++k) {
+      bigMul(p5, 5);
+      const int z = bigBits(p5); // 2^(z-1) < 5^k < 2^z
+      const int b = (k <= 27) ? z + 127 : 2 * z + 128;
+      BigNum c(b / 32 + 1, 0);
+      c[b / 32] = quint32(1) << (b % 32);
+      int left = k;
+      for (; left >= 13; left -= 13) {
+        bigDiv(c, 1220703125); // 5^13
+      }
+      quint32 rest = 1;
+      while (left-- > 0) {
+        rest *= 5;
+      }
+      bigDiv(c, rest);
+      bigAddOne(c);
+      set(-k, c);
+    }
 
-    while ((c = *p++), isDigit(c)) {
-      eexp = 10*eexp+(c-'0');
+    p5.clear();
+    p5.append(1);
+    for (int q = 0; q <= LargestPowerOfTen; ++q) {
+      set(q, p5);
+      bigMul(p5, 5);
     }
-    if (negexp<0)
-      eexp = -eexp;
-    exp = exp + eexp;
   }
 
-  negexp = 1;
-  if (exp<0) {
-    negexp = -1;
-    exp = -exp;
+  void set(int q, const BigNum& a)
+  {
+    const int low = bigBits(a) - 128;
+    value[2 * (q - SmallestPowerOfTen)] = bigSlice(a, low + 64);
+    value[2 * (q - SmallestPowerOfTen) + 1] = bigSlice(a, low);
   }
+};
 
+const quint64* powersOfFive()
+{
+  static const PowersOfFive table;
+  return table.value;
+}
 
-  if((nd+exp*negexp) < -LOGHUGE){
-    fl = 0;
-    exp = 0;
-  }
-  flexp = 1;
-  exp5 = 5;
-  bexp = exp;
-  for (;;) {
-    if (exp&01)
-      flexp *= exp5;
-    exp >>= 1;
-    if (exp==0)
-      break;
-    exp5 *= exp5;
-  }
-  if (negexp<0)
-    fl /= flexp;
-  else
-    fl *= flexp;
-  fl = ldexp(fl, negexp*bexp);
-  if (neg<0)
-    fl = -fl;
-  _previousValue = fl;
-  return(fl);
+inline void multiply(quint64 a, quint64 b, quint64* hi, quint64* lo)
+{
+  const quint64 a0 = a & 0xFFFFFFFF, a1 = a >> 32;
+  const quint64 b0 = b & 0xFFFFFFFF, b1 = b >> 32;
+  const quint64 p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+  const quint64 mid = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+  *lo = (mid << 32) | (p00 & 0xFFFFFFFF);
+  *hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
 }
-#endif
 
+inline int leadingZeros(quint64 x)
+{
+  int n = 0;
+  if (!(x >> 32)) { n += 32; x <<= 32; }
+  if (!(x >> 48)) { n += 16; x <<= 16; }
+  if (!(x >> 56)) { n += 8;  x <<= 8; }
+  if (!(x >> 60)) { n += 4;  x <<= 4; }
+  if (!(x >> 62)) { n += 2;  x <<= 2; }
+  if (!(x >> 63)) { n += 1; }
+  return n;
+}
 
-//-------------------------------------------------------------------------------------------
-LexicalCast::AutoReset::AutoReset(bool useDot, NaNMode mode)
+inline double fromBits(quint64 mantissa, int power2)
+{
+  const quint64 word = mantissa | (quint64(power2) << 52);
+  double d;
+  memcpy(&d, &word, sizeof(d));
+  return d;
+}
+
+// w * 10^q for w != 0 and less than 20 digits.  False if it can't be
+// decided without more precision.
+bool eiselLemire(quint64 w, int q, double* result)
+{
+  if (q < SmallestPowerOfTen) {
+    *result = 0;
+    return true;
+  }
+  if (q > LargestPowerOfTen) {
+    *result = std::numeric_limits<double>::infinity();
+    return true;
+  }
+
+  const int lz = leadingZeros(w);
+  w <<= lz;
+
+  const quint64* pow5 = powersOfFive() + 2 * (q - SmallestPowerOfTen);
+  quint64 hi, lo;
+  multiply(w, pow5[0], &hi, &lo);
+  const quint64 precisionMask = quint64(0xFFFFFFFFFFFFFFFFULL) >> 55;
+  if ((hi & precisionMask) == precisionMask) {
+    quint64 hi2, lo2;
+    multiply(w, pow5[1], &hi2, &lo2);
+    lo += hi2;
+    if (hi2 > lo) {
+      ++hi;
+    }
+    if (lo == quint64(0xFFFFFFFFFFFFFFFFULL) && (q < -27 || q > 55)) {
+      return false;
+    }
+  }
+
+  const int upperbit = int(hi >> 63);
+  const int shift = upperbit + 64 - 52 - 3;
+  quint64 mantissa = hi >> shift;
+  int power2 = int(((152170 + 65536) * q) >> 16) + 63 + upperbit - lz + 1023;
+
+  if (power2 <= 0) {
+    // subnormal
+    if (-power2 + 1 >= 64) {
+      *result = 0;
+      return true;
+    }
+    mantissa >>= -power2 + 1;
+    mantissa += (mantissa & 1);
+    mantissa >>= 1;
+    power2 = (mantissa < (quint64(1) << 52)) ? 0 : 1;
+    *result = fromBits(mantissa, power2);
+    return true;
+  }
+
+  // exactly half way between two doubles: round to even
+  if (lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1) {
+    if ((mantissa << shift) == hi) {
+      mantissa &= ~quint64(1);
+    }
+  }
+  mantissa += (mantissa & 1);
+  mantissa >>= 1;
+  if (mantissa >= (quint64(2) << 52)) {
+    mantissa = quint64(1) << 52;
+    ++power2;
+  }
+  mantissa &= ~(quint64(1) << 52);
+  if (power2 >= 0x7FF) {
+    *result = std::numeric_limits<double>::infinity();
+    return true;
+  }
+  *result = fromBits(mantissa, power2);
+  return true;
+}
+
+const double exactPowersOfTen[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// the number in [begin, end), with separator as the decimal separator
+double fromText(const unsigned char* begin, const unsigned char* end, char separator)
 {
-  instance().setUseDotAsDecimalSeparator(useDot);
-  instance()._nanMode = mode;
+  QByteArray text((const char*)begin, int(end - begin));
+  if (separator != '.') {
+    text.replace(separator, '.');
+  }
+  return text.toDouble();
+}
+
 }
 
+
 //-------------------------------------------------------------------------------------------
-LexicalCast::AutoReset::~AutoReset()
+double LexicalCast::fromDouble(const char* signedp) const
 {
-  instance().resetLocal();
-  instance()._isFormattedTime = false;
-  instance()._timeFormat.clear();
-  instance()._nanMode = NullValue;
+  const unsigned char* p = (const unsigned char*)signedp;
+
+  while (*p == ' ')
+    ++p;
+
+  const unsigned char c = *p;
+  if (_nanMode != NullValue && c != '-' && c != '+' && c != _separator && !isDigit(c)) {
+    return nanValue();
+  }
+  const bool neg = (c == '-');
+  if (c == '-' || c == '+')
+    ++p;
+  const unsigned char* number = p;
+
+  // mantissa digits, without leading zeros
+  quint64 w = 0;
+  int nd = 0;
+  int exp = 0;
+  while (isDigit(*p)) {
+    if (w || *p != '0') {
+      w = 10 * w + (*p - '0');
+      ++nd;
+    }
+    ++p;
+  }
+  if (*p == _separator) {
+    ++p;
+    while (isDigit(*p)) {
+      if (w || *p != '0') {
+        w = 10 * w + (*p - '0');
+        ++nd;
+      }
+      --exp;
+      ++p;
+    }
+  }
+
+  if ((*p == 'E') || (*p == 'e')) {
+    ++p;
+    bool negexp = false;
+    if (*p == '+') {
+      ++p;
+    } else if (*p == '-') {
+      negexp = true;
+      ++p;
+    }
+    int eexp = 0;
+    while (isDigit(*p)) {
+      if (eexp < 100000)
+        eexp = 10 * eexp + (*p - '0');
+      ++p;
+    }
+    exp += negexp ? -eexp : eexp;
+  }
+
+  double fl;
+  if (w == 0) {
+    fl = 0;
+  } else if (nd > 19) {
+    // w overflowed: take the long way
+    fl = fromText(number, p, _separator);
+  } else if (w <= (quint64(1) << 53) && exp >= -22 && exp <= 22) {
+    // w and 10^|exp| are exact doubles, so one rounding gives the answer
+    fl = exp < 0 ? double(w) / exactPowersOfTen[-exp] : double(w) * exactPowersOfTen[exp];
+  } else if (!eiselLemire(w, exp, &fl)) {
+    fl = fromText(number, p, _separator);
+  }
+
+  if (neg)
+    fl = -fl;
+  _previousValue = fl;
+  return fl;
 }
 
+
 //-------------------------------------------------------------------------------------------
 LexicalCast& LexicalCast::instance()
 {
@@ -155,6 +363,8 @@ LexicalCast& LexicalCast::instance()
 //-------------------------------------------------------------------------------------------
 LexicalCast::LexicalCast() :
   _nanMode(NullValue),
+  _separator('.'),
+  _timeFormatLength(0),
   _isFormattedTime(false),
   _timeWithDate(false)
 {
@@ -165,49 +375,123 @@ KST_THREAD_LOCAL double LexicalCast::_previousValue = 0;
 //-------------------------------------------------------------------------------------------
 LexicalCast::~LexicalCast() 
 {
-  resetLocal();
 }
 
 //-------------------------------------------------------------------------------------------
-void LexicalCast::resetLocal() 
+void LexicalCast::setUseDotAsDecimalSeparator(bool useDot)
 {
-  if (!_originalLocal.isEmpty()) {
-    setlocale(LC_NUMERIC, _originalLocal.constData());
-    _originalLocal.clear();
-  }
+  _separator = useDot ? '.' : ',';
 }
 
 //-------------------------------------------------------------------------------------------
-void LexicalCast::setUseDotAsDecimalSeparator(bool useDot)
+void LexicalCast::setTimeFormat(const QString& format)
 {
-  useDot ? _separator = '.' : _separator = ',';
+  _timeFormat = format.trimmed(); // remove space at start/end
+  _isFormattedTime = !format.isEmpty();
+  _timeWithDate = format.contains("d") || format.contains("M") || format.contains("y");
+  _timeFormatLength = _timeFormat.size();
+  compileTimeFormat();
+}
 
-  if (_separator != localSeparator()) {
-    _originalLocal = QByteArray((const char*) setlocale(LC_NUMERIC, 0));
-    if (useDot) {
-      setlocale(LC_NUMERIC, "C");
+//-------------------------------------------------------------------------------------------
+void LexicalCast::compileTimeFormat()
+{
+  // Only fixed width numbers: yyyy MM dd hh HH mm ss zzz.  Everything else
+  // which means something to QDateTime (names, am/pm, quotes, time zones,
+  // variable widths) is left to QDateTime.
+  _timeFields.clear();
+  const QByteArray fmt = _timeFormat.toLatin1();
+  for (int i = 0; i < fmt.size();) {
+    const char c = fmt[i];
+    int n = 1;
+    while (i + n < fmt.size() && fmt[i + n] == c) {
+      ++n;
+    }
+    TimeField field;
+    if (c == 'y' || c == 'M' || c == 'd' || c == 'h' || c == 'H' || c == 'm' || c == 's' || c == 'z') {
+      const int width = (c == 'y') ? 4 : (c == 'z') ? 3 : 2;
+      if (n != width) {
+        _timeFields.clear();
+        return;
+      }
+      field.type = (c == 'H') ? 'h' : c;
+      field.width = char(width);
+      _timeFields.append(field);
+      i += n;
+    } else if (c == 'A' || c == 'a' || c == 'P' || c == 'p' || c == 't' || c == '\'' || uchar(c) >= 128) {
+      _timeFields.clear();
+      return;
     } else {
-      setlocale(LC_NUMERIC, "de");
+      field.type = 0;
+      field.width = c;
+      _timeFields.append(field);
+      ++i;
     }
-  } else {
-    resetLocal();
   }
 }
 
 //-------------------------------------------------------------------------------------------
-char LexicalCast::localSeparator() const
+static qint64 daysSinceEpoch(int y, int m, int d)
 {
-  return *setlocale(LC_NUMERIC, 0);
+  // proleptic Gregorian calendar, as QDate
+  y -= m <= 2;
+  const int era = (y >= 0 ? y : y - 399) / 400;
+  const int yoe = y - era * 400;
+  const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return qint64(era) * 146097 + doe - 719468;
 }
 
 //-------------------------------------------------------------------------------------------
-void LexicalCast::setTimeFormat(const QString& format)
+bool LexicalCast::fromTimeFields(const char* p, double* sec) const
 {
-  _timeFormat = format.trimmed(); // remove space at start/end
-  _isFormattedTime = !format.isEmpty();
-  _timeWithDate = format.contains("d") || format.contains("M") || format.contains("y");
-  _timeFormatLength = _timeFormat.size();
-} 
+  if (_timeFields.isEmpty()) {
+    return false;
+  }
+
+  // QDateTime::fromString defaults
+  int year = 1900, month = 1, day = 1, hour = 0, minute = 0, second = 0, msec = 0;
+  for (const TimeField& field : _timeFields) {
+    if (field.type == 0) {
+      if (*p++ != field.width) {
+        return false;
+      }
+      continue;
+    }
+    int v = 0;
+    for (int i = 0; i < field.width; ++i, ++p) {
+      if (!isDigit(*p)) {
+        return false;
+      }
+      v = 10 * v + (*p - '0');
+    }
+    switch (field.type) {
+      case 'y': year = v; break;
+      case 'M': month = v; break;
+      case 'd': day = v; break;
+      case 'h': hour = v; break;
+      case 'm': minute = v; break;
+      case 's': second = v; break;
+      case 'z': msec = v; break;
+    }
+  }
+
+  static const int daysInMonth[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+  if (year < 1 || month < 1 || month > 12 || day < 1 || hour > 23 || minute > 59 || second > 59) {
+    return false;
+  }
+  const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+  if (day > daysInMonth[month - 1] + (month == 2 && leap ? 1 : 0)) {
+    return false;
+  }
+
+  qint64 msecs = ((hour * 60 + minute) * 60 + second) * qint64(1000) + msec;
+  if (_timeWithDate) {
+    msecs += daysSinceEpoch(year, month, day) * qint64(86400000);
+  }
+  *sec = msecs / 1000.0;
+  return true;
+}
 
 //-------------------------------------------------------------------------------------------
 double LexicalCast::fromTime(const char* p) const
@@ -217,8 +501,14 @@ double LexicalCast::fromTime(const char* p) const
       return nanValue();
   }
 
+  double sec;
+  if (fromTimeFields(p, &sec)) {
+    _previousValue = sec;
+    return sec;
+  }
+
   const QString time = QString::fromLatin1(p, _timeFormatLength);
-  double sec = nanValue();
+  sec = nanValue();
   if (_timeWithDate) {
     QDateTime t = QDateTime::fromString(time, _timeFormat);
     if (!t.isValid()) {
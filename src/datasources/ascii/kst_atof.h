@@ -15,6 +15,7 @@
 
 #include <QByteArray>
 #include <QString>
+#include <QVector>
 #include <stdlib.h>
 
 #include "math_kst.h"
@@ -29,10 +30,18 @@
   #endif
 #endif
 
+/** How the text of one ascii source is turned into numbers: its decimal
+    separator, what a field that isn't a number reads as, and the format of
+    a time index.  Each source has its own, so sources parsed at the same
+    time in different threads don't see each other's settings; the locale
+    is never changed. */
 class LexicalCast
 {
 public:
+  LexicalCast();
+  ~LexicalCast();
 
+  /** one for those that don't keep their own */
   static LexicalCast& instance();
 
 
@@ -42,42 +51,38 @@ public:
     PreviousValue
   };
 
-  struct AutoReset {
-    AutoReset(bool useDot, NaNMode);
-    ~AutoReset();
-  };
-
   void setUseDotAsDecimalSeparator(bool useDot);
+  void setNaNMode(NaNMode mode) { _nanMode = mode; }
 
-  char localSeparator() const;
-
-#ifdef KST_USE_KST_ATOF
   double fromDouble(const char* p) const;
-#else
-  inline double fromDouble(const char* p) const { return atof(p); }
-#endif
   double fromTime(const char*) const;
   inline double toDouble(const char* p) const { return _isFormattedTime ? fromTime(p) : fromDouble(p); }
 
+  /** an empty format reads the field as a number */
   void setTimeFormat(const QString& format);
   
   double nanValue() const;
 
 private:
-  LexicalCast();
-  ~LexicalCast();
-
   NaNMode _nanMode;
   static KST_THREAD_LOCAL double _previousValue;
   char _separator;
 
-  QByteArray _originalLocal;
   QString _timeFormat;
   int _timeFormatLength;
   bool _isFormattedTime;
   bool _timeWithDate;
 
-  void resetLocal();
+  // _timeFormat split into fixed width numbers and literal characters,
+  // empty if it has anything fromTimeFields() can't handle.
+  struct TimeField {
+    char type;   // one of yMdhmsz, or 0 for a literal
+    char width;  // digits, or the literal character
+  };
+  QVector<TimeField> _timeFields;
+
+  void compileTimeFormat();
+  bool fromTimeFields(const char* p, double* sec) const;
 
   inline bool isDigit(const char c) const {
     return (c >= 48) && (c <= 57) ? true : false;
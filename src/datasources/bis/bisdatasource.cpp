@@ -15,6 +15,7 @@
 #include "bis.h"
 
 #include <QFileInfo>
+#include <QSysInfo>
 
 using namespace Kst;
 
@@ -57,7 +58,7 @@ public:
   DataInterfaceBISMatrix(BISSource& bis) : _bis(bis) {}
 
   // read one element
-  int read(const QString&, DataMatrix::ReadInfo&);
+  qint64 read(const QString&, DataMatrix::ReadInfo&);
 
   // named elements
   QStringList list() const { return _bis._matrixHash.keys(); }
@@ -119,7 +120,7 @@ const DataMatrix::DataInfo DataInterfaceBISMatrix::dataInfo(const QString& matri
 }
 
 
-int DataInterfaceBISMatrix::read(const QString& field, DataMatrix::ReadInfo& p)
+qint64 DataInterfaceBISMatrix::read(const QString& field, DataMatrix::ReadInfo& p)
 {
 
   int y0 = p.yStart;
@@ -180,7 +181,7 @@ public:
   DataInterfaceBISVector(BISSource& bis) : _bis(bis) {}
 
   // read one element
-  int read(const QString&, DataVector::ReadInfo&);
+  qint64 read(const QString&, DataVector::ReadInfo&);
 
   // named elements
   QStringList list() const { return _bis._vectorList; }
@@ -226,7 +227,7 @@ const DataVector::DataInfo DataInterfaceBISVector::dataInfo(const QString& vecto
 }
 
 
-int DataInterfaceBISVector::read(const QString& field, DataVector::ReadInfo& p)
+qint64 DataInterfaceBISVector::read(const QString& field, DataVector::ReadInfo& p)
 {
 
   qint64 f0 = (qint64)p.startingFrame;
@@ -560,6 +561,15 @@ QStringList BISSourcePlugin::provides() const {
 }
 
 
+QStringList BISSourcePlugin::signatures() const {
+  // the format word, 0xe6b0, is read in the host's byte order
+  if (QSysInfo::ByteOrder == QSysInfo::LittleEndian) {
+    return QStringList() << "magic:0:b0e6";
+  }
+  return QStringList() << "magic:0:e6b0";
+}
+
+
 // Request for this plugins configuration widget.  
 Kst::DataSourceConfigWidget *BISSourcePlugin::configWidget(QSettings *cfg, const QString& filename) const {
   Q_UNUSED(cfg)
@@ -67,7 +67,7 @@ class BISSource : public Kst::DataSource {
 class BISSourcePlugin : public QObject, public Kst::DataSourcePluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataSourcePluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.3")
   public:
     virtual ~BISSourcePlugin() {}
 
@@ -112,6 +112,8 @@ class BISSourcePlugin : public QObject, public Kst::DataSourcePluginInterface {
 
     virtual QStringList provides() const;
 
+    virtual QStringList signatures() const;
+
     virtual Kst::DataSourceConfigWidget *configWidget(QSettings *cfg, const QString& filename) const;
 };
 
@@ -21,6 +21,10 @@
 #include <QXmlStreamWriter>
 #include <QFileSystemWatcher>
 #include <QDir>
+#include <QAtomicInt>
+#include <QMutexLocker>
+#include <QThread>
+#include <QtConcurrentMap>
 
 using namespace Kst;
 
@@ -55,12 +59,12 @@ public:
   DataInterfaceDirFileScalar(DirFileSource& d) : dir(d) {}
 
   // read one element
-  int read(const QString&, DataScalar::ReadInfo&);
+  qint64 read(const QString&, DataScalar::ReadInfo&);
 
   // named elements
-  QStringList list() const { return dir._scalarList; }
+  QStringList list() const { QMutexLocker locker(&dir._mutex); return dir._scalarList; }
   bool isListComplete() const { return true; }
-  bool isValid(const QString& field) const { return dir._scalarList.contains( field ); }
+  bool isValid(const QString& field) const { QMutexLocker locker(&dir._mutex); return dir._scalarList.contains( field ); }
 
   // T specific: not used for scalars
   const DataScalar::DataInfo dataInfo(const QString&, double frame = 0) const { Q_UNUSED(frame) return DataScalar::DataInfo(); }
@@ -74,7 +78,7 @@ public:
   DirFileSource& dir;
 };
 
-int DataInterfaceDirFileScalar::read(const QString& field, DataScalar::ReadInfo& p)
+qint64 DataInterfaceDirFileScalar::read(const QString& field, DataScalar::ReadInfo& p)
 {
   return dir.readScalar(*p.value, field);
 }
@@ -88,12 +92,12 @@ public:
   DataInterfaceDirFileString(DirFileSource& d) : dir(d) {}
 
   // read one element
-  int read(const QString&, DataString::ReadInfo&);
+  qint64 read(const QString&, DataString::ReadInfo&);
 
   // named elements
-  QStringList list() const { return dir._stringList; }
+  QStringList list() const { QMutexLocker locker(&dir._mutex); return dir._stringList; }
   bool isListComplete() const { return true; }
-  bool isValid(const QString& field) const { return dir._stringList.contains( field ); }
+  bool isValid(const QString& field) const { QMutexLocker locker(&dir._mutex); return dir._stringList.contains( field ); }
 
   // T specific: not used for Strings
   virtual const DataString::DataInfo dataInfo(const QString&, double frame=0) const;
@@ -107,7 +111,7 @@ public:
   DirFileSource& dir;
 };
 
-int DataInterfaceDirFileString::read(const QString& field, DataString::ReadInfo& p)
+qint64 DataInterfaceDirFileString::read(const QString& field, DataString::ReadInfo& p)
 {
   if (dir.isStringStream(field)) {
     return dir.readSindir(*p.value, field, p.frame);
@@ -137,12 +141,15 @@ public:
   DataInterfaceDirFileVector(DirFileSource& d) : dir(d) {}
 
   // read one element
-  int read(const QString&, DataVector::ReadInfo&);
+  qint64 read(const QString&, DataVector::ReadInfo&);
+
+  // read on several handles at once
+  void readBatch(QList<BatchRead>& reads);
 
   // named elements
-  QStringList list() const { return dir._fieldList; }
+  QStringList list() const { QMutexLocker locker(&dir._mutex); return dir._fieldList; }
   bool isListComplete() const { return true; }
-  bool isValid(const QString& field) const { return dir._fieldList.contains( field ); }
+  bool isValid(const QString& field) const { QMutexLocker locker(&dir._mutex); return dir._fieldList.contains( field ); }
 
   // T specific
   const DataVector::DataInfo dataInfo(const QString&, double frame = 0) const;
@@ -161,6 +168,7 @@ public:
 const DataVector::DataInfo DataInterfaceDirFileVector::dataInfo(const QString &field, double frame) const
 {
   Q_UNUSED(frame)
+  QMutexLocker locker(&dir._mutex);
   if (!dir._fieldList.contains(field))
     return DataVector::DataInfo();
 
@@ -168,12 +176,36 @@ const DataVector::DataInfo DataInterfaceDirFileVector::dataInfo(const QString &f
 }
 
 
-int DataInterfaceDirFileVector::read(const QString& field, DataVector::ReadInfo& p)
+qint64 DataInterfaceDirFileVector::read(const QString& field, DataVector::ReadInfo& p)
 {
   return dir.readField(p.data, field, p.startingFrame, p.numberOfFrames);
 }
 
 
+// Each field is in its own file, so the reads of a batch are independent:
+// every handle takes the next unread one until none are left.  The main
+// handle is left to those looking at the source meanwhile.
+void DataInterfaceDirFileVector::readBatch(QList<BatchRead>& reads)
+{
+  const int handles = qMin(reads.size(), QThread::idealThreadCount());
+  if (handles < 2 || !dir.openReaders(handles)) {
+    DataSource::DataInterface<DataVector>::readBatch(reads);
+    return;
+  }
+
+  BatchRead *batch = reads.data();
+  const int count = reads.size();
+  QAtomicInt next(0);
+  const QList<Dirfile*> dirfiles = dir._readers.mid(0, handles);
+  QtConcurrent::blockingMap(dirfiles, [&](Dirfile *dirfile) {
+    for (int i = next.fetchAndAddRelaxed(1); i < count; i = next.fetchAndAddRelaxed(1)) {
+      DataVector::ReadInfo& p = batch[i].info;
+      batch[i].samples = dir.readField(dirfile, p.data, batch[i].name, p.startingFrame, p.numberOfFrames);
+    }
+  });
+}
+
+
 QMap<QString, double> DataInterfaceDirFileVector::metaScalars(const QString& field)
 {
   QStringList keys = dir.fieldScalars(field);
@@ -216,6 +248,10 @@ DirFileSource::DirFileSource(Kst::ObjectStore *store, QSettings *cfg, const QStr
 
   setUpdateType(None);
 
+  // getdata is safe to use from a worker thread, one caller at a time, so
+  // slow (network) dirfiles are updated and read ahead off the GUI thread
+  _concurrentUpdate = true;
+
   _valid = false;
   if (!type.isEmpty() && type != dirfileTypeString) {
     return;
@@ -243,15 +279,18 @@ DirFileSource::~DirFileSource()
   _config = 0L;
   delete _dirfile;
   _dirfile = 0L;
+  closeReaders();
 }
 
 
 void DirFileSource::reset()
 {
+  QMutexLocker locker(&_mutex);
   resetFileWatcher();
   if (_dirfile) {
     delete _dirfile;
   }
+  closeReaders();
 
   init();
   Object::reset();
@@ -259,6 +298,7 @@ void DirFileSource::reset()
 
 
 bool DirFileSource::init() {
+  QMutexLocker locker(&_mutex);
   _fieldList.clear();
   _scalarList.clear();
   _stringList.clear();
@@ -308,7 +348,8 @@ bool DirFileSource::init() {
 
 
 Kst::Object::UpdateType DirFileSource::internalDataSourceUpdate() {
-  int newNF = _dirfile->NFrames();
+  QMutexLocker locker(&_mutex);
+  qint64 newNF = _dirfile->NFrames();
   bool isnew = newNF != _frameCount;
 
   _resetNeeded |= (_frameCount>newNF);
@@ -322,17 +363,23 @@ Kst::Object::UpdateType DirFileSource::internalDataSourceUpdate() {
   return (isnew ? Updated : NoChange);
 }
 
-int DirFileSource::readField(double *v, const QString& field, double s, double n) {
+qint64 DirFileSource::readField(double *v, const QString& field, double s, double n) {
+  QMutexLocker locker(&_mutex);
+  return readField(_dirfile, v, field, s, n);
+}
+
+
+qint64 DirFileSource::readField(Dirfile *dirfile, double *v, const QString& field, double s, double n) {
   qint64 s64 = (qint64)s;
   qint64 n64 = (qint64)n;
 
   if (n64 < 0) {
-    return _dirfile->GetData(field.toUtf8().constData(),
+    return dirfile->GetData(field.toUtf8().constData(),
                    s64, 0, /* 1st sframe, 1st samp */
                    0, 1, /* num sframes, num samps */
                    Float64, (void*)v);
   } else {
-    return _dirfile->GetData(field.toUtf8().constData(),
+    return dirfile->GetData(field.toUtf8().constData(),
                    s64, 0, /* 1st sframe, 1st samp */
                    n64, 0, /* num sframes, num samps */
                    Float64, (void*)v);
@@ -340,6 +387,25 @@ int DirFileSource::readField(double *v, const QString& field, double s, double n
 }
 
 
+bool DirFileSource::openReaders(int count) {
+  while (_readers.count() < count) {
+    Dirfile *reader = new Dirfile(_directoryName.toLatin1(), GD_RDONLY);
+    if (reader->Error() != GD_E_OK) {
+      delete reader;
+      return false;
+    }
+    _readers.append(reader);
+  }
+  return true;
+}
+
+
+void DirFileSource::closeReaders() {
+  qDeleteAll(_readers);
+  _readers.clear();
+}
+
+
 // int DirFileSource::writeField(const double *v, const QString& field, int s, int n) {
 //   int err = 0;
 //
@@ -352,17 +418,20 @@ int DirFileSource::readField(double *v, const QString& field, double s, double n
 
 
 int DirFileSource::samplesPerFrame(const QString &field) {
+  QMutexLocker locker(&_mutex);
   return int(_dirfile->SamplesPerFrame(field.toUtf8().constData()));
 }
 
 
-int DirFileSource::frameCount(const QString& field) const {
+qint64 DirFileSource::frameCount(const QString& field) const {
   Q_UNUSED(field)
+  QMutexLocker locker(&_mutex);
   return _frameCount;
 }
 
 
 bool DirFileSource::isEmpty() const {
+  QMutexLocker locker(&_mutex);
   return _frameCount < 1;
 }
 
@@ -378,6 +447,7 @@ void DirFileSource::save(QXmlStreamWriter &streamWriter) {
 
 
 int DirFileSource::readScalar(double &S, const QString& scalar) {
+  QMutexLocker locker(&_mutex);
   if (scalar == "FRAMES") {
     S = _frameCount;
     return 1;
@@ -393,6 +463,7 @@ int DirFileSource::readScalar(double &S, const QString& scalar) {
 
 
 int DirFileSource::readString(QString &S, const QString& string) {
+  QMutexLocker locker(&_mutex);
   if (string == "FILE") {
     S = _filename;
     return 1;
@@ -409,6 +480,7 @@ int DirFileSource::readString(QString &S, const QString& string) {
 }
 
 int DirFileSource::readSindir(QString &S, const QString &field, int frame) {
+  QMutexLocker locker(&_mutex);
   const char *tmpstr[1];
 
   _dirfile->GetData(field.toUtf8().constData(), frame, 0, 0, 1, tmpstr);
@@ -423,6 +495,7 @@ int DirFileSource::readSindir(QString &S, const QString &field, int frame) {
 //QStringList fieldScalars(const QString& field);
 
 QStringList DirFileSource::fieldScalars(const QString& field) {
+  QMutexLocker locker(&_mutex);
   const char **mflist = _dirfile->MFieldListByType(field.toLatin1(), ConstEntryType);
   if (!mflist) {
     return QStringList();
@@ -435,6 +508,7 @@ QStringList DirFileSource::fieldScalars(const QString& field) {
 }
 
 int DirFileSource::readFieldScalars(QList<double> &v, const QString& field, bool init) {
+  QMutexLocker locker(&_mutex);
   int nc=0;
   if (init) { // only update if we need to initialize.  Otherwise preserve old values.
     v.clear();
@@ -449,6 +523,7 @@ int DirFileSource::readFieldScalars(QList<double> &v, const QString& field, bool
 
 
 QStringList DirFileSource::fieldStrings(const QString& field) {
+  QMutexLocker locker(&_mutex);
   const char **mflist = _dirfile->MFieldListByType(field.toLatin1(), StringEntryType);
   if (!mflist) {
     return QStringList();
@@ -461,6 +536,7 @@ QStringList DirFileSource::fieldStrings(const QString& field) {
 }
 
 int DirFileSource::readFieldStrings(QStringList &v, const QString& field, bool init) {
+  QMutexLocker locker(&_mutex);
   int nc=0;
   if (init) { // only update if we need to initialize.  Otherwise preserve old values.
     v.clear();
@@ -514,6 +590,7 @@ QString DirFileSource::typeString() const {
 
 bool DirFileSource::isStringStream(QString field)
 {
+  QMutexLocker locker(&_mutex);
   if (_sindirList.contains(field)) {
     return true;
   } else {
@@ -22,6 +22,8 @@
 #include <dataplugin.h>
 #include <getdata/dirfile.h>
 
+#include <QRecursiveMutex>
+
 using namespace GetData;
 
 class QFileSystemWatcher;
@@ -41,13 +43,14 @@ class DirFileSource : public Kst::DataSource {
 
     virtual UpdateType internalDataSourceUpdate();
 
-    int readField(double *v, const QString &field, double s, double n);
+    qint64 readField(double *v, const QString &field, double s, double n);
+    qint64 readField(Dirfile *dirfile, double *v, const QString &field, double s, double n);
 
 //     int writeField(const double *v, const QString &field, int s, int n);
 
     int samplesPerFrame(const QString &field);
 
-    int frameCount(const QString& field = QString()) const;
+    qint64 frameCount(const QString& field = QString()) const;
 
     QString fileType() const;
 
@@ -82,14 +85,22 @@ class DirFileSource : public Kst::DataSource {
 
   private:
     QString _directoryName;
+    // the read ahead updates the source under the read lock only, while
+    // others may look at it: _dirfile, the lists and the frame count are
+    // used under this
+    mutable QRecursiveMutex _mutex;
     Dirfile *_dirfile;
+    // extra handles for parallel reads: getdata allows one caller per handle
+    QList<Dirfile*> _readers;
+    bool openReaders(int count);
+    void closeReaders();
 
     QStringList _scalarList;
     QStringList _stringList;
     QStringList _sindirList; // string stream
     QStringList _fieldList;
 
-    int _frameCount;
+    qint64 _frameCount;
     mutable Config *_config;
 
     DataInterfaceDirFileVector* iv;
@@ -106,7 +117,7 @@ class DirFileSource : public Kst::DataSource {
 class DirFilePlugin : public QObject, public Kst::DataSourcePluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataSourcePluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.3")
   public:
     virtual ~DirFilePlugin() {}
 
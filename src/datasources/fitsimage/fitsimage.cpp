@@ -57,7 +57,7 @@ public:
   DataInterfaceFitsImageString(FitsImageSource& s) : source(s) {}
 
   // read one element
-  int read(const QString&, DataString::ReadInfo&);
+  qint64 read(const QString&, DataString::ReadInfo&);
 
   // named elements
   QStringList list() const { return source._strings.keys(); }
@@ -79,7 +79,7 @@ private:
 
 
 //-------------------------------------------------------------------------------------------
-int DataInterfaceFitsImageString::read(const QString& string, DataString::ReadInfo& p)
+qint64 DataInterfaceFitsImageString::read(const QString& string, DataString::ReadInfo& p)
 {
   // TODO read strings from file
   if (isValid(string) && p.value) {
@@ -110,7 +110,7 @@ public:
   DataInterfaceFitsImageMatrix(fitsfile **fitsfileptr) : _fitsfileptr(fitsfileptr) {}
 
   // read one element
-  int read(const QString&, DataMatrix::ReadInfo&);
+  qint64 read(const QString&, DataMatrix::ReadInfo&);
 
   // named elements
   QStringList list() const { return _matrixHash.keys(); }
@@ -257,7 +257,7 @@ QMap<QString, QString> DataInterfaceFitsImageMatrix::metaStrings(const QString &
   return M;
 }
 
-int DataInterfaceFitsImageMatrix::read(const QString& field, DataMatrix::ReadInfo& p) {
+qint64 DataInterfaceFitsImageMatrix::read(const QString& field, DataMatrix::ReadInfo& p) {
   long n_axes[2],  fpixel[2] = {1, 1};
   double nullval = NAN;
   double blank = 0.0;
@@ -396,7 +396,7 @@ public:
   DataInterfaceFitsImageVector(fitsfile **fitsfileptr) : _fitsfileptr(fitsfileptr) {}
 
   // read one element
-  int read(const QString&, DataVector::ReadInfo&);
+  qint64 read(const QString&, DataVector::ReadInfo&);
 
   // named elements
   QStringList list() const { return _vectorList; }
@@ -530,7 +530,7 @@ bool DataInterfaceFitsImageVector::isValid(const QString& field) const {
 }
 
 
-int DataInterfaceFitsImageVector::read(const QString& field, DataVector::ReadInfo& p)
+qint64 DataInterfaceFitsImageVector::read(const QString& field, DataVector::ReadInfo& p)
 {
   if (!*_fitsfileptr) {
     return 0;
@@ -897,6 +897,14 @@ QStringList FitsImagePlugin::provides() const {
 }
 
 
+QStringList FitsImagePlugin::signatures() const {
+  // "SIMPLE", or a file cfitsio would uncompress first: gzip, compress,
+  // pkzip or bzip2
+  return QStringList() << "magic:0:53494d504c45" << "magic:0:1f8b" << "magic:0:1f9d"
+                       << "magic:0:504b0304" << "magic:0:425a68";
+}
+
+
 Kst::DataSourceConfigWidget *FitsImagePlugin::configWidget(QSettings *cfg, const QString& filename) const {
 
   Q_UNUSED(cfg)
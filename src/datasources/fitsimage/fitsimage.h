@@ -65,7 +65,7 @@ class FitsImageSource : public Kst::DataSource {
 class FitsImagePlugin : public QObject, public Kst::DataSourcePluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataSourcePluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.3")
   public:
     virtual ~FitsImagePlugin() {}
 
@@ -110,6 +110,8 @@ class FitsImagePlugin : public QObject, public Kst::DataSourcePluginInterface {
 
     virtual QStringList provides() const;
 
+    virtual QStringList signatures() const;
+
     virtual Kst::DataSourceConfigWidget *configWidget(QSettings *cfg, const QString& filename) const;
 };
 
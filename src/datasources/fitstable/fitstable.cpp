@@ -27,7 +27,7 @@ class DataInterfaceFitsTableScalar : public DataSource::DataInterface<DataScalar
       DataInterfaceFitsTableScalar(FitsTableSource& s) : source(s) {}
 
       // read one element
-      int read(const QString&, DataScalar::ReadInfo&);
+      qint64 read(const QString&, DataScalar::ReadInfo&);
 
       // named elements
       QStringList list() const { return source._scalars.keys(); }
@@ -47,7 +47,7 @@ class DataInterfaceFitsTableScalar : public DataSource::DataInterface<DataScalar
 };
 
 
-int DataInterfaceFitsTableScalar::read(const QString& scalar, DataScalar::ReadInfo& p){
+qint64 DataInterfaceFitsTableScalar::read(const QString& scalar, DataScalar::ReadInfo& p){
 
    DBG qDebug() << "Entering DataInterfaceFitsTableScalar::read() with scalar: " << scalar << Qt::endl;
    return source.readScalar(p.value, scalar);
@@ -67,7 +67,7 @@ class DataInterfaceFitsTableString : public DataSource::DataInterface<DataString
       DataInterfaceFitsTableString(FitsTableSource& s) : source(s) {}
 
       // read one element
-      int read(const QString&, DataString::ReadInfo&);
+      qint64 read(const QString&, DataString::ReadInfo&);
 
       // named elements
       QStringList list() const { return source._strings.keys(); }
@@ -87,7 +87,7 @@ class DataInterfaceFitsTableString : public DataSource::DataInterface<DataString
 };
 
 
-int DataInterfaceFitsTableString::read(const QString& string, DataString::ReadInfo& p){
+qint64 DataInterfaceFitsTableString::read(const QString& string, DataString::ReadInfo& p){
 
    DBG qDebug() << "Entering DataInterfaceFitsTableString::read() with string: " << string << Qt::endl;
    if (isValid(string) && p.value) {
@@ -111,7 +111,7 @@ class DataInterfaceFitsTableVector : public DataSource::DataInterface<DataVector
       DataInterfaceFitsTableVector(FitsTableSource& s) : source(s) {}
 
       // read one element
-      int read(const QString&, DataVector::ReadInfo&);
+      qint64 read(const QString&, DataVector::ReadInfo&);
 
       // named elements
       QStringList list() const { return source._fieldList; }
@@ -140,7 +140,7 @@ const DataVector::DataInfo DataInterfaceFitsTableVector::dataInfo(const QString
    return DataVector::DataInfo(source.frameCount(field), source.samplesPerFrame(field));
 }
 
-int DataInterfaceFitsTableVector::read(const QString& field, DataVector::ReadInfo& p){
+qint64 DataInterfaceFitsTableVector::read(const QString& field, DataVector::ReadInfo& p){
 
    DBG qDebug() << "Entering DataInterfaceFitsTableVector::read() with field: " << field << Qt::endl;
    return source.readField(p.data, field, p.startingFrame, p.numberOfFrames);
@@ -176,7 +176,7 @@ class DataInterfaceFitsTableMatrix : public DataSource::DataInterface<DataMatrix
       DataInterfaceFitsTableMatrix(FitsTableSource& s) : source(s) {}
 
       // read one element
-      int read(const QString&, DataMatrix::ReadInfo&);
+      qint64 read(const QString&, DataMatrix::ReadInfo&);
 
       // named elements
       QStringList list() const { return source._matrixList; }
@@ -212,7 +212,7 @@ const DataMatrix::DataInfo DataInterfaceFitsTableMatrix::dataInfo(const QString&
 }
 
 
-int DataInterfaceFitsTableMatrix::read(const QString& field, DataMatrix::ReadInfo& p){
+qint64 DataInterfaceFitsTableMatrix::read(const QString& field, DataMatrix::ReadInfo& p){
 
    DBG qDebug() << "Entering DataInterfaceFitsTableMatrix::read() with field: " << field << Qt::endl;
    int count = source.readMatrix(p.data->z, field);
@@ -553,7 +553,7 @@ int FitsTableSource::readString(QString *stringValue, const QString& stringName)
    return 1;
 }
 
-int FitsTableSource::readField(double *v, const QString& field, double s, double n) {
+qint64 FitsTableSource::readField(double *v, const QString& field, double s, double n) {
    int status = 0; /* cfitsio status flag */
    int colnum;     /* column number in table */
    int anynul;     /* Number of null values read by fits_read_col() */
@@ -564,7 +564,7 @@ int FitsTableSource::readField(double *v, const QString& field, double s, double
    long offset;    /* offset for data when repeat > 1 */
    long idx;       /* used when reading from Pixel Readout and tracking which
                       section of data array is being read by fits_read_col */
-   long totalidx;  /* to keep track of our location in the v array */
+   qint64 totalidx; /* to keep track of our location in the v array */
    long i,j,k;     /* loop variables */
    long nrow;      /* number of rows read for each data chunk */
    long maxrow;    /* maximum number of rows to read at once.  Later re-used
@@ -578,8 +578,8 @@ int FitsTableSource::readField(double *v, const QString& field, double s, double
                       containing data for a field.  Necessary to keep track of
                       s, the offset from the beginning of data */
    QByteArray ba;  /* needed to convert a QString to char array */
-   long s_l = (long)s;  /* cast to long for CFITSIO */
-   long n_l = (long)n;
+   qint64 s_l = (qint64)s;  /* CFITSIO takes LONGLONG rows */
+   qint64 n_l = (qint64)n;
 
    DBG qDebug() << "Entering FitsTableSource::readField() with params: " << field << ", from " << s_l << " for " << n_l << " frames" << Qt::endl;
 
@@ -589,10 +589,10 @@ int FitsTableSource::readField(double *v, const QString& field, double s, double
          v[0] = double(s_l);
          return 1;
       }
-      for (long i2 = 0; i2 < n_l; ++i2) {
+      for (qint64 i2 = 0; i2 < n_l; ++i2) {
          v[i2] = double(s_l + i2);
       }
-      return (int)n_l;
+      return n_l;
    }
 
    idx       = _fieldList.indexOf(field); /* get index of field in list */
@@ -740,7 +740,7 @@ int FitsTableSource::readField(double *v, const QString& field, double s, double
    for (i=totalidx; i< n_l; i++) /* fill remainder with NaNs */
       v[i] = sqrt(-1);
    free(data);
-   return (int)n_l;
+   return n_l;
 }
 
 int FitsTableSource::readMatrix(double *v, const QString& field){
@@ -1018,6 +1018,14 @@ QStringList FitsTableSourcePlugin::provides() const {
 }
 
 
+QStringList FitsTableSourcePlugin::signatures() const {
+   // "SIMPLE", or a file cfitsio would uncompress first: gzip, compress,
+   // pkzip or bzip2
+   return QStringList() << "magic:0:53494d504c45" << "magic:0:1f8b" << "magic:0:1f9d"
+                        << "magic:0:504b0304" << "magic:0:425a68";
+}
+
+
 // Request for this plugins configuration widget.
 Kst::DataSourceConfigWidget *FitsTableSourcePlugin::configWidget(QSettings *cfg,
    const QString& filename) const {
@@ -16,8 +16,62 @@
 #include <QImageReader>
 #include <qcolor.h>
 
+#include <string.h>
+
 using namespace Kst;
 
+// HDF5's own default; the cache is only grown past this when a dataset's
+// chunks, or the span of a read, would not fit.
+static const size_t DefaultChunkCacheBytes = 1024*1024;
+static const size_t MaxChunkCacheBytes = 64*1024*1024;
+
+// the HDF5 manual suggests a prime number of hash slots, about 100 per
+// chunk the cache can hold
+static size_t nextPrime(size_t n) {
+  if (n <= 2) {
+    return 2;
+  }
+  for (n |= 1; ; n += 2) {
+    bool prime = true;
+    for (size_t d = 3; d*d <= n; d += 2) {
+      if (n % d == 0) {
+        prime = false;
+        break;
+      }
+    }
+    if (prime) {
+      return n;
+    }
+  }
+}
+
+
+static hid_t openDataSet(hid_t file, const QString& name, size_t cacheBytes, size_t chunkBytes) {
+  hid_t dapl = H5Pcreate(H5P_DATASET_ACCESS);
+  if (cacheBytes > DefaultChunkCacheBytes) {
+    const size_t chunks = qMax(size_t(1), cacheBytes/qMax(size_t(1), chunkBytes));
+    H5Pset_chunk_cache(dapl, nextPrime(100*chunks), cacheBytes, H5D_CHUNK_CACHE_W0_DEFAULT);
+  }
+  hid_t id = H5Dopen2(file, qPrintable(name), dapl);
+  H5Pclose(dapl);
+  return id;
+}
+
+
+// The n samples of type T were read into the top of the n double buffer;
+// widen them in place, from the bottom up.  Sample i sits at or above
+// double i, so no sample is overwritten before it is converted.  memcpy
+// keeps the compiler from assuming the two views don't alias.
+template<class T>
+static void widenInPlace(double *v, qint64 n) {
+  const char *in = reinterpret_cast<const char*>(v) + n*(sizeof(double) - sizeof(T));
+  for (qint64 i = 0; i < n; ++i) {
+    T x;
+    memcpy(&x, in + i*sizeof(T), sizeof(T));
+    v[i] = double(x);
+  }
+}
+
 /**********************
 HDF5Source::Config - This class defines the config widget that will be added to the 
 Dialog Config Button for configuring the plugin.  This is only needed for special handling required
@@ -55,7 +109,7 @@ public:
   DataInterfaceHDF5Vector(HDF5Source& s) : hdf(s) {}
 
   //read one element
-  int read(const QString&, DataVector::ReadInfo&);
+  qint64 read(const QString&, DataVector::ReadInfo&);
 
   //Named Elements
   QStringList list() const { return hdf._vectorList; }
@@ -81,7 +135,7 @@ const DataVector::DataInfo DataInterfaceHDF5Vector::dataInfo(const QString &fiel
   }
 }
 
-int DataInterfaceHDF5Vector::read(const QString& field, DataVector::ReadInfo& p){
+qint64 DataInterfaceHDF5Vector::read(const QString& field, DataVector::ReadInfo& p){
   return hdf.readField(p.data, field, p.startingFrame, p.numberOfFrames);
 }
 
@@ -95,7 +149,7 @@ public:
   DataInterfaceHDF5Matrix(HDF5Source& s) : hdf(s) {}
 
   //read one element 
-  int read(const QString&, DataMatrix::ReadInfo&);
+  qint64 read(const QString&, DataMatrix::ReadInfo&);
 
   //named elements
   QStringList list() const { return hdf._matrixList; }
@@ -113,7 +167,7 @@ public:
   HDF5Source& hdf;
 };
 
-int DataInterfaceHDF5Matrix::read(const QString& field, DataMatrix::ReadInfo& p){
+qint64 DataInterfaceHDF5Matrix::read(const QString& field, DataMatrix::ReadInfo& p){
   //TODO: figure this out
   return hdf.readMatrix(p, field);
 }
@@ -165,7 +219,7 @@ public:
   DataInterfaceHDF5Scalar(HDF5Source & s) : hdf(s) {}
 
   //read one element
-  int read(const QString&, DataScalar::ReadInfo&);
+  qint64 read(const QString&, DataScalar::ReadInfo&);
 
   //Named Elements 
   QStringList list() const { return hdf._scalarList; }
@@ -184,7 +238,7 @@ public:
   HDF5Source& hdf;
 };
 
-int DataInterfaceHDF5Scalar::read(const QString& field, DataScalar::ReadInfo& p){
+qint64 DataInterfaceHDF5Scalar::read(const QString& field, DataScalar::ReadInfo& p){
   return hdf.readScalar(*p.value, field);
 }
 
@@ -197,7 +251,7 @@ public:
   DataInterfaceHDF5String(HDF5Source& s) : hdf(s) {}
 
   // read one element
-  int read(const QString&, DataString::ReadInfo&);
+  qint64 read(const QString&, DataString::ReadInfo&);
 
   // named elements
   QStringList list() const { return hdf._stringList; }
@@ -216,7 +270,7 @@ public:
   HDF5Source& hdf;
 };
 
-int DataInterfaceHDF5String::read(const QString& field, DataString::ReadInfo& p)
+qint64 DataInterfaceHDF5String::read(const QString& field, DataString::ReadInfo& p)
 {
     return hdf.readString(*p.value, field);
 }
@@ -241,7 +295,7 @@ be able to process the data.
 
 ***********************/
 HDF5Source::HDF5Source(Kst::ObjectStore *store, QSettings *cfg, const QString& filename, const QString& type, const QDomElement& e)
-: Kst::DataSource(store, cfg, filename, type), _config(0L), 
+: Kst::DataSource(store, cfg, filename, type), _config(0L), _hdfFile(0), _swmr(false),
   iv(new DataInterfaceHDF5Vector(*this)),
   ix(new DataInterfaceHDF5Scalar(*this)),
   im(new DataInterfaceHDF5Matrix(*this)),
@@ -269,6 +323,11 @@ HDF5Source::HDF5Source(Kst::ObjectStore *store, QSettings *cfg, const QString& f
 
   if (init()) {
     _valid = true;
+    // a file opened for SWMR reading may still be growing; the watcher
+    // fires on the writer's flushes, so finished files cost nothing
+    if (_swmr) {
+      startUpdating(File);
+    }
   }
 
   registerChange();
@@ -277,6 +336,7 @@ HDF5Source::HDF5Source(Kst::ObjectStore *store, QSettings *cfg, const QString& f
 HDF5Source::~HDF5Source() {
   delete _config;
   _config = NULL;
+  clearCaches();
   if(_hdfFile != NULL){
     delete _hdfFile;
   }
@@ -285,17 +345,180 @@ HDF5Source::~HDF5Source() {
 
 
 void HDF5Source::reset() {
+  clearCaches();
   if(_hdfFile){
     delete _hdfFile;
-  }
-  if(_config){
-    delete _config;
+    _hdfFile = NULL;
   }
 
   init();
   Object::reset();
 }
 
+
+void HDF5Source::clearCaches() {
+  foreach (const CachedDataSet& ds, _dataSets) {
+    H5Dclose(ds.id);
+  }
+  _dataSets.clear();
+  _attributes.clear();
+}
+
+
+hid_t HDF5Source::memoryType(SampleType sampleType) {
+  switch (sampleType) {
+    case Float: return H5T_NATIVE_FLOAT;
+    case Int8: return H5T_NATIVE_INT8;
+    case UInt8: return H5T_NATIVE_UINT8;
+    case Int16: return H5T_NATIVE_INT16;
+    case UInt16: return H5T_NATIVE_UINT16;
+    case Int32: return H5T_NATIVE_INT32;
+    case UInt32: return H5T_NATIVE_UINT32;
+    case Int64: return H5T_NATIVE_INT64;
+    case UInt64: return H5T_NATIVE_UINT64;
+    default: return H5T_NATIVE_DOUBLE;
+  }
+}
+
+
+// Opens the dataset on first use and keeps the handle.  Chunked datasets
+// start with a cache that holds at least two chunks, so a read that ends
+// part way through a chunk finds it again on the next, incremental, read.
+HDF5Source::CachedDataSet *HDF5Source::cachedDataSet(const QString& name) {
+  QHash<QString, CachedDataSet>::iterator it = _dataSets.find(name);
+  if (it != _dataSets.end()) {
+    return &it.value();
+  }
+  if (!_hdfFile) {
+    return 0;
+  }
+
+  CachedDataSet ds;
+  ds.id = openDataSet(_hdfFile->getId(), name, 0, 0);
+  if (ds.id < 0) {
+    Debug::self()->log(QString("Failed to open dataset ") + name);
+    return 0;
+  }
+
+  hid_t space = H5Dget_space(ds.id);
+  const int rank = qMax(0, H5Sget_simple_extent_ndims(space));
+  ds.dims.resize(rank);
+  if (rank > 0) {
+    H5Sget_simple_extent_dims(space, ds.dims.data(), NULL);
+  }
+  H5Sclose(space);
+
+  hid_t fileType = H5Dget_type(ds.id);
+  const size_t sampleBytes = H5Tget_size(fileType);
+  hid_t nativeType = H5Tget_native_type(fileType, H5T_DIR_ASCEND);
+  const size_t nativeBytes = H5Tget_size(nativeType);
+  ds.sampleType = Other;
+  if (H5Tget_class(nativeType) == H5T_FLOAT) {
+    if (nativeBytes == sizeof(double)) {
+      ds.sampleType = Double;
+    } else if (nativeBytes == sizeof(float)) {
+      ds.sampleType = Float;
+    }
+  } else if (H5Tget_class(nativeType) == H5T_INTEGER) {
+    const bool isSigned = H5Tget_sign(nativeType) == H5T_SGN_2;
+    switch (nativeBytes) {
+      case 1: ds.sampleType = isSigned ? Int8 : UInt8; break;
+      case 2: ds.sampleType = isSigned ? Int16 : UInt16; break;
+      case 4: ds.sampleType = isSigned ? Int32 : UInt32; break;
+      case 8: ds.sampleType = isSigned ? Int64 : UInt64; break;
+      default: break;
+    }
+  }
+  H5Tclose(nativeType);
+  H5Tclose(fileType);
+
+  ds.chunkBytes = 0;
+  ds.cacheBytes = DefaultChunkCacheBytes;
+  hid_t dcpl = H5Dget_create_plist(ds.id);
+  if (rank > 0 && H5Pget_layout(dcpl) == H5D_CHUNKED) {
+    ds.chunk.resize(rank);
+    H5Pget_chunk(dcpl, rank, ds.chunk.data());
+    ds.chunkBytes = sampleBytes;
+    for (int d = 0; d < rank; ++d) {
+      ds.chunkBytes *= ds.chunk[d];
+    }
+  }
+  H5Pclose(dcpl);
+
+  it = _dataSets.insert(name, ds);
+  if (!ds.chunk.isEmpty()) {
+    QVector<hsize_t> one(rank, 1);
+    one[0] = ds.chunk[0] + 1;
+    tuneChunkCache(name, &it.value(), one.constData());
+  }
+  return &it.value();
+}
+
+
+// Sizes the chunk cache of a chunked dataset so that every chunk touched
+// by a read of count samples fits, bounded by MaxChunkCacheBytes.  Growing
+// the cache means reopening the handle; it never shrinks.
+void HDF5Source::tuneChunkCache(const QString& name, CachedDataSet *ds, const hsize_t *count) {
+  if (ds->chunk.isEmpty() || ds->chunkBytes == 0) {
+    return;
+  }
+
+  size_t chunks = 1;
+  for (int d = 0; d < ds->chunk.size(); ++d) {
+    const hsize_t c = qMax(hsize_t(1), ds->chunk[d]);
+    const hsize_t touched = (count[d] + c - 1)/c + 1; // unaligned reads straddle one more
+    const hsize_t all = qMax(hsize_t(1), (ds->dims[d] + c - 1)/c);
+    chunks *= size_t(qMin(touched, all));
+  }
+  size_t bytes = qMin(chunks*ds->chunkBytes, MaxChunkCacheBytes);
+  bytes = qMax(bytes, DefaultChunkCacheBytes);
+  if (bytes <= ds->cacheBytes) {
+    return;
+  }
+
+  hid_t id = openDataSet(_hdfFile->getId(), name, bytes, ds->chunkBytes);
+  if (id < 0) {
+    return;
+  }
+  H5Dclose(ds->id);
+  ds->id = id;
+  ds->cacheBytes = bytes;
+}
+
+
+// Attributes can only be read whole, so keep them, converted to double,
+// instead of reading one per request.
+const HDF5Source::CachedAttribute *HDF5Source::cachedAttribute(const QString& field) {
+  QHash<QString, CachedAttribute>::const_iterator it = _attributes.constFind(field);
+  if (it != _attributes.constEnd()) {
+    return &it.value();
+  }
+  if (!_hdfFile) {
+    return 0;
+  }
+
+  QStringList list = field.split("->");
+  QString fieldName = list[0];
+  QString attrName = list[list.size() -1];
+
+  CachedAttribute cached;
+  try{
+    H5::Attribute attr = _hdfFile->openDataSet(qPrintable(fieldName)).openAttribute(qPrintable(attrName));
+    H5::DataSpace space = attr.getSpace();
+    const int rank = space.getSimpleExtentNdims();
+    cached.dims.resize(rank);
+    if (rank > 0) {
+      space.getSimpleExtentDims(cached.dims.data(), NULL);
+    }
+    cached.values.resize(space.getSimpleExtentNpoints());
+    attr.read(H5::PredType::NATIVE_DOUBLE, cached.values.data());
+  }catch(const H5::Exception &e){
+    Debug::self()->log(QString("Problem reading attribute ") + field + QString(" ") + QString(e.getCDetailMsg()));
+    return 0;
+  }
+  return &_attributes.insert(field, cached).value();
+}
+
 herr_t HDF5Source::visitFunc(hid_t id, const char* name, const H5L_info_t* info, void* opData){
     Q_UNUSED(info)
 
@@ -350,6 +573,7 @@ herr_t HDF5Source::visitFunc(hid_t id, const char* name, const H5L_info_t* info,
 
                 if(!h5Source->lengths.contains(len) && len > 1){
                     h5Source->lengths.append(len);
+                    h5Source->_indexSources.append(name);
                 }
                 if(len == 1){//len 1 vector ie. scalar
                     h5Source->_vectorList.removeLast();
@@ -364,6 +588,7 @@ herr_t HDF5Source::visitFunc(hid_t id, const char* name, const H5L_info_t* info,
                 unsigned len = h5Source->frameCount(name);
                 if(!h5Source->lengths.contains(len)){
                     h5Source->lengths.append(len);
+                    h5Source->_indexSources.append(name);
                 }
             }else{
                 //array is or too many dimentions to make sense, I guess do nothing?
@@ -428,6 +653,7 @@ herr_t HDF5Source::attrIterFunc(hid_t id, const char* name, const H5A_info_t* in
 
         if(!h5Source->lengths.contains(len) && len > 1){
             h5Source->lengths.append(len);
+            h5Source->_indexSources.append(attrName);
         }
         if(len == 1){//len 1 vector ie. scalar
             h5Source->_vectorList.removeLast();
@@ -459,10 +685,25 @@ bool HDF5Source::init() {
   _stringList.clear();
   _mpfList.clear();
   _vectorList.clear();
+  lengths.clear();
+  _indexSources.clear();
 
   H5::Exception::dontPrint();
+  _swmr = false;
+#if H5_VERSION_GE(1,10,0)
+  // Files being written in SWMR mode can only be opened for SWMR reading;
+  // older format files refuse it, and are opened normally below.
   try{
-     _hdfFile = new H5::H5File(qPrintable(_directoryName), H5F_ACC_RDONLY);
+     _hdfFile = new H5::H5File(qPrintable(_directoryName), H5F_ACC_RDONLY | H5F_ACC_SWMR_READ);
+     _swmr = true;
+  }catch(const H5::Exception &){
+     _hdfFile = NULL;
+  }
+#endif
+  try{
+     if (!_hdfFile) {
+       _hdfFile = new H5::H5File(qPrintable(_directoryName), H5F_ACC_RDONLY);
+     }
   }catch(const H5::Exception &e){
     //dump to debug log somewhere
     Debug::self()->log(QString("Failed to open HDF5 file with name ") + _directoryName +QString(" ") + QString(e.getCDetailMsg()));
@@ -498,35 +739,18 @@ unsigned HDF5Source::frameCount(const QString& field){
     return lengths[_indexList.indexOf(field)];
   }else if(_vectorList.contains(field)){
     if(field.contains("->")){//attribute vector
-      QStringList list = field.split("->");
-
-      QString fieldName = list[0];
-      QString attrName = list[list.size() -1];
-      try{
-        H5::Attribute attr = _hdfFile->openDataSet(qPrintable(fieldName)).openAttribute(qPrintable(attrName));
-        H5::DataSpace space = attr.getSpace();
-        hsize_t size = 0;
-        space.getSimpleExtentDims(&size, NULL);
-        //Debug::self()->log(QString("Returning attr vec len ") + QString::number((int)size));
-
-        return size;
-      }catch(const H5::Exception &e){
-        Debug::self()->log(QString("Problem reading dataset ") + field + QString(" ") + QString(e.getCDetailMsg()));
+      const CachedAttribute *attr = cachedAttribute(field);
+      if (!attr || attr->dims.isEmpty()) {
         return 0;
       }
+      return attr->dims[0];
     }else{
-      try{
-        H5::DataSet dataset = _hdfFile->openDataSet(qPrintable(field));
-        H5::DataSpace space = dataset.getSpace();
-    
-        hsize_t size = 0;
-        space.getSimpleExtentDims(&size, NULL);
-        //Debug::self()->log(QString("Returning vec len ") + QString::number((int)size));
-        return size;
-      }catch(const H5::Exception &e){
+      const CachedDataSet *ds = cachedDataSet(field);
+      if (!ds || ds->dims.isEmpty()) {
         Debug::self()->log(QString("Failed to get frame count of ") + field);
-
+        return 0;
       }
+      return ds->dims[0];
     }
   }else if(_mpfList.contains(field)){
     H5::DataSet dataset = _hdfFile->openDataSet(qPrintable(field));
@@ -544,7 +768,7 @@ unsigned HDF5Source::frameCount(const QString& field){
   return 0;
 }
 
-int HDF5Source::readField(double* dataVec, const QString& name, double start, double numFrames){
+qint64 HDF5Source::readField(double* dataVec, const QString& name, double start, double numFrames){
   qint64 start64 = (qint64)start;
   qint64 numFrames64 = (qint64)numFrames;
 
@@ -555,66 +779,72 @@ int HDF5Source::readField(double* dataVec, const QString& name, double start, do
     for(qint64 i = start64; i<numFrames64 + start64; i++){
       dataVec[i-start64] = i;
     }
-    return (int)numFrames64;
+    return numFrames64;
   }else if(name.contains("->")){//attribute vector
-    QStringList list = name.split("->");
-
-    QString fieldName = list[0];
-    QString attrName = list[list.size() -1];
-    try{
-
-      H5::DataSet dataset = _hdfFile->openDataSet(qPrintable(fieldName));
-      H5::Attribute attr = dataset.openAttribute(qPrintable(attrName));
-
-      double* temp = new double[frameCount(name)];
-      attr.read(attr.getDataType(), temp);//can only read the whole attribute
-      memcpy(dataVec, &temp[start64], numFrames64*samplesPerFrame(name)*sizeof(double));
-
-      delete[] temp;
-      return (int)numFrames64;
-    }catch (const H5::Exception &e){
-      Debug::self()->log(QString("Problem reading dataset ") + name + QString(" ") + QString(e.getCDetailMsg()));
+    const CachedAttribute *attr = cachedAttribute(name);
+    if (!attr || start64 < 0 || start64 + numFrames64 > attr->values.size()) {
+      return 0;
     }
-
-    return 0;
+    memcpy(dataVec, attr->values.constData() + start64, numFrames64*samplesPerFrame(name)*sizeof(double));
+    return numFrames64;
   }else{
 
-    H5::DataSet dataset = _hdfFile->openDataSet(qPrintable(name)); 
-
-    H5::DataSpace dataspace = dataset.getSpace();
+    CachedDataSet *ds = cachedDataSet(name);
+    if (!ds || ds->dims.isEmpty() || start64 < 0) {
+      return 0;
+    }
+    if (start64 + numFrames64 > qint64(ds->dims[0])) {
+      numFrames64 = qMax(qint64(0), qint64(ds->dims[0]) - start64);
+    }
+    if (numFrames64 == 0) {
+      return 0;
+    }
 
     hsize_t dataSize = numFrames64*samplesPerFrame(name);
+    tuneChunkCache(name, ds, &dataSize);
 
     hsize_t offsetOut = 0;
     hsize_t memsize = (numFrames64 + 1)*samplesPerFrame(name);//this better not work
     //ugh this worked. No idea why, but memsize must be strictly larger than numframes
     //or else data offsets don't work. Really feels like an off-by-one in the hdf library
 
-    H5::DataSpace memspace(1, &memsize);
-
-    memspace.selectHyperslab( H5S_SELECT_SET, &dataSize, &offsetOut);
+    hid_t memspace = H5Screate_simple(1, &memsize, NULL);
+    H5Sselect_hyperslab(memspace, H5S_SELECT_SET, &offsetOut, NULL, &dataSize, NULL);
 
     hsize_t startSize = start64*samplesPerFrame(name);
-    hsize_t framesSize = numFrames64*samplesPerFrame(name);
+    hid_t dataspace = H5Dget_space(ds->id);
+    H5Sselect_hyperslab(dataspace, H5S_SELECT_SET, &startSize, NULL, &dataSize, NULL);
+
+    // Read narrower types as they are stored, into the top of the buffer,
+    // and widen them here rather than through HDF5's conversion buffers.
+    void *buffer = dataVec;
+    if (ds->sampleType != Double && ds->sampleType != Other) {
+      buffer = reinterpret_cast<char*>(dataVec) + dataSize*(sizeof(double) - H5Tget_size(memoryType(ds->sampleType)));
+    }
 
-    //Debug::self()->log(QString("Going to read, datasize = ") + QString::number(dataSize));
+    herr_t status = H5Dread(ds->id, memoryType(ds->sampleType), memspace, dataspace, H5P_DEFAULT, buffer);
+    H5Sclose(dataspace);
+    H5Sclose(memspace);
 
-    dataspace.selectHyperslab(H5S_SELECT_SET, &framesSize, &startSize);
-  
-    try{ 
-      dataset.read((void*)dataVec, H5::PredType::NATIVE_DOUBLE, memspace, dataspace);
-    }catch(const H5::Exception &e){
-      Debug::self()->log(QString("Problem reading dataset ") + name + QString(" ") + QString(e.getCDetailMsg()));
-      numFrames64 = 0;
-    }catch(const std::exception& e1){
-      Debug::self()->log(QString("Problem reading dataset ") + name + QString(" " ) + QString(e1.what()));
-      numFrames64 = 0;
-    }catch(...){
-      Debug::self()->log(QString("Unknown problem reading dataset ") + name);
-      numFrames64 = 0;
+    if (status < 0) {
+      Debug::self()->log(QString("Problem reading dataset ") + name);
+      return 0;
+    }
+
+    switch (ds->sampleType) {
+      case Float: widenInPlace<float>(dataVec, dataSize); break;
+      case Int8: widenInPlace<qint8>(dataVec, dataSize); break;
+      case UInt8: widenInPlace<quint8>(dataVec, dataSize); break;
+      case Int16: widenInPlace<qint16>(dataVec, dataSize); break;
+      case UInt16: widenInPlace<quint16>(dataVec, dataSize); break;
+      case Int32: widenInPlace<qint32>(dataVec, dataSize); break;
+      case UInt32: widenInPlace<quint32>(dataVec, dataSize); break;
+      case Int64: widenInPlace<qint64>(dataVec, dataSize); break;
+      case UInt64: widenInPlace<quint64>(dataVec, dataSize); break;
+      default: break;
     }
   }
-  return (int)numFrames64;
+  return numFrames64;
 }
 
 int HDF5Source::readScalar(double& scalar, const QString& field){
@@ -701,76 +931,42 @@ int HDF5Source::readMatrix(DataMatrix::ReadInfo& data, const QString& name){
   hsize_t dataSize = data.xNumSteps*data.yNumSteps;
 
   if(name.contains("->")){//attribute matrix
-    QStringList list = name.split("->");
-
-    QString fieldName = list[0];
-    QString attrName = list[list.size() -1];
-    try{
-      H5::DataSet dataset = _hdfFile->openDataSet(qPrintable(fieldName));
-      H5::Attribute attr = dataset.openAttribute(qPrintable(attrName));
-      H5::DataSpace space = attr.getSpace();
-      hsize_t* dims = new hsize_t[2];
-      space.getSimpleExtentDims(dims, NULL);
-
-      double* temp = new double[dims[0] * dims[1]];
-      attr.read(attr.getDataType(), temp);//can only read the whole attribute
+    const CachedAttribute *attr = cachedAttribute(name);
+    if (!attr || attr->dims.size() != 2) {
+      dataSize = 0;
+    } else {
+      const hsize_t *dims = attr->dims.constData();
+      const double *temp = attr->values.constData();
       for(int i=0; i<data.xNumSteps; i++){
         for(int j = 0; j<data.yNumSteps; j++){
           data.data->z[i + dims[0]*j] = temp[((int)data.xStart + i) + dims[0]*((int)data.yStart + j)];
         }
       }
-
-      delete[] dims;
-      delete[] temp;
-      }catch (const H5::Exception &e){
-        Debug::self()->log(QString("Problem reading dataset ") + name + QString(" ") + QString(e.getCDetailMsg()));
-        dataSize = 0;
-      }
+    }
   }else{
-    H5::DataSet dataset = _hdfFile->openDataSet(qPrintable(name));
-
-    H5::DataSpace dataspace = dataset.getSpace();
-
-    hsize_t* memsize = new hsize_t[2];
-    hsize_t* offset = new hsize_t[2];
-
-    memsize[0] = data.xNumSteps;
-    memsize[1] = data.yNumSteps;
-
-    H5::DataSpace memspace(2, memsize);
-
-    offset[0] = 0;
-    offset[1] = 0;
+    CachedDataSet *ds = cachedDataSet(name);
+    if (!ds || ds->dims.size() != 2) {
+      return 0;
+    }
 
-    memspace.selectHyperslab(H5S_SELECT_SET, memsize, offset);
+    hsize_t memsize[2] = { hsize_t(data.xNumSteps), hsize_t(data.yNumSteps) };
+    hsize_t offset[2] = { 0, 0 };
+    hsize_t startSize[2] = { hsize_t(data.xStart), hsize_t(data.yStart) };
 
-    hsize_t* startSize = new hsize_t[2];
-    hsize_t* frameSize = new hsize_t[2];
+    tuneChunkCache(name, ds, memsize);
 
-    startSize[0] = data.xStart;
-    startSize[1] = data.yStart;
+    hid_t memspace = H5Screate_simple(2, memsize, NULL);
+    H5Sselect_hyperslab(memspace, H5S_SELECT_SET, offset, NULL, memsize, NULL);
 
-    frameSize[0] = data.xNumSteps;
-    frameSize[1] = data.yNumSteps;
+    hid_t dataspace = H5Dget_space(ds->id);
+    H5Sselect_hyperslab(dataspace, H5S_SELECT_SET, startSize, NULL, memsize, NULL);
 
-    dataspace.selectHyperslab(H5S_SELECT_SET, frameSize, startSize);
-  
-    try{
-      dataset.read((void*)data.data->z, H5::PredType::NATIVE_DOUBLE, memspace, dataspace);
-    }catch(const H5::Exception &e){
-      Debug::self()->log(QString("Problem reading dataset ") + name + QString(" ") + QString(e.getCDetailMsg()));
-      dataSize = 0;
-    }catch(const std::exception& e1){
-      Debug::self()->log(QString("Problem reading dataset ") + name + QString(" " ) + QString(e1.what()));
-      dataSize = 0;
-    }catch(...){
-      Debug::self()->log(QString("Unknown problem reading dataset ") + name);
+    if (H5Dread(ds->id, H5T_NATIVE_DOUBLE, memspace, dataspace, H5P_DEFAULT, data.data->z) < 0) {
+      Debug::self()->log(QString("Problem reading dataset ") + name);
       dataSize = 0;
     }
-    delete[] memsize;
-    delete[] offset;
-    delete[] startSize;
-    delete[] frameSize;
+    H5Sclose(dataspace);
+    H5Sclose(memspace);
   }
   //set some matrix viewing parameters
   data.data->xMin = data.xStart;
@@ -784,7 +980,34 @@ int HDF5Source::readMatrix(DataMatrix::ReadInfo& data, const QString& name){
 // Check if the data in the from the source has updated.  Typically done by checking the frame count of the datasource for 
 // changes.
 Kst::Object::UpdateType HDF5Source::internalDataSourceUpdate() {
-  return Kst::Object::NoChange;
+  if (!_swmr) {
+    return Kst::Object::NoChange;
+  }
+
+  // Only datasets that have been opened can be plotted, so only they need
+  // to be followed.  The INDEX fields grow with the field they were made for.
+  bool changed = false;
+#if H5_VERSION_GE(1,10,0)
+  for (QHash<QString, CachedDataSet>::iterator it = _dataSets.begin(); it != _dataSets.end(); ++it) {
+    CachedDataSet &ds = it.value();
+    if (ds.dims.isEmpty() || H5Drefresh(ds.id) < 0) {
+      continue;
+    }
+    hid_t space = H5Dget_space(ds.id);
+    QVector<hsize_t> dims(ds.dims.size());
+    H5Sget_simple_extent_dims(space, dims.data(), NULL);
+    H5Sclose(space);
+    if (dims != ds.dims) {
+      ds.dims = dims;
+      changed = true;
+      const int index = _indexSources.indexOf(it.key());
+      if (index >= 0) {
+        lengths[index] = dims[0];
+      }
+    }
+  }
+#endif
+  return changed ? Kst::Object::Updated : Kst::Object::NoChange;
 }
 
 
@@ -979,6 +1202,11 @@ QStringList HDF5Plugin::provides() const {
 }
 
 
+QStringList HDF5Plugin::signatures() const {
+  return QStringList() << "*.h5" << "*.hdf5";
+}
+
+
 // Request for this plugins configuration widget.  
 Kst::DataSourceConfigWidget *HDF5Plugin::configWidget(QSettings *cfg, const QString& filename) const {
   Q_UNUSED(cfg)
@@ -18,6 +18,8 @@
 #include <dataplugin.h>
 
 #include <QFileInfo>
+#include <QHash>
+#include <QVector>
 #include <H5Cpp.h>
 #include <exception>
 
@@ -58,7 +60,7 @@ class HDF5Source : public Kst::DataSource {
 
     unsigned frameCount(const QString& field);
 
-    int readField(double *v, const QString& field, double start, double numFrames);
+    qint64 readField(double *v, const QString& field, double start, double numFrames);
 
     int readScalar(double& s, const QString& field);
 
@@ -67,8 +69,38 @@ class HDF5Source : public Kst::DataSource {
     int readString(QString &data, const QString& field);
 
   private:
+    // How samples are stored in memory by H5Dread before being widened to
+    // double.  Other means "let HDF5 convert to NATIVE_DOUBLE".
+    enum SampleType { Double, Float, Int8, UInt8, Int16, UInt16, Int32, UInt32, Int64, UInt64, Other };
+
+    // An open dataset, kept for the life of the file so that its chunk
+    // cache survives between reads.
+    struct CachedDataSet {
+      hid_t id;
+      QVector<hsize_t> dims;    // current extents, refreshed on update
+      QVector<hsize_t> chunk;   // empty unless the layout is chunked
+      size_t chunkBytes;
+      size_t cacheBytes;        // chunk cache the handle was opened with
+      SampleType sampleType;
+    };
+
+    struct CachedAttribute {
+      QVector<double> values;
+      QVector<hsize_t> dims;
+    };
+
+    static hid_t memoryType(SampleType sampleType);
+    CachedDataSet *cachedDataSet(const QString& name);
+    void tuneChunkCache(const QString& name, CachedDataSet *ds, const hsize_t *count);
+    const CachedAttribute *cachedAttribute(const QString& field);
+    void clearCaches();
+
     mutable Config *_config;
     H5::H5File* _hdfFile;
+    bool _swmr;
+
+    QHash<QString, CachedDataSet> _dataSets;
+    QHash<QString, CachedAttribute> _attributes;
    
     static herr_t visitFunc(hid_t id, const char* name, const H5L_info_t* info, void* opData);
     static herr_t attrIterFunc(hid_t id, const char* name, const H5A_info_t* info, void* opData);
@@ -91,6 +123,7 @@ class HDF5Source : public Kst::DataSource {
     bool _resetNeeded;
 
     QVector<int> lengths;
+    QStringList _indexSources; // the field each INDEX-n follows as it grows
 
 };
 
@@ -98,7 +131,7 @@ class HDF5Source : public Kst::DataSource {
 class HDF5Plugin : public QObject, public Kst::DataSourcePluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataSourcePluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.3")
   public:
     virtual ~HDF5Plugin() {}
 
@@ -143,6 +176,8 @@ class HDF5Plugin : public QObject, public Kst::DataSourcePluginInterface {
 
     virtual QStringList provides() const;
 
+    virtual QStringList signatures() const;
+
     virtual Kst::DataSourceConfigWidget *configWidget(QSettings *cfg, const QString& filename) const;
 };
 
@@ -59,7 +59,7 @@ public:
   DataInterfaceITSMatrix(ITSSource& its) : _its(its) {}
 
   // read one element
-  int read(const QString&, DataMatrix::ReadInfo&);
+  qint64 read(const QString&, DataMatrix::ReadInfo&);
 
   // named elements
   QStringList list() const { return _its._matrixNames.keys(); }
@@ -121,7 +121,7 @@ const DataMatrix::DataInfo DataInterfaceITSMatrix::dataInfo(const QString& matri
 }
 
 
-int DataInterfaceITSMatrix::read(const QString& field, DataMatrix::ReadInfo& p)
+qint64 DataInterfaceITSMatrix::read(const QString& field, DataMatrix::ReadInfo& p)
 {
 
   int y0 = p.yStart;
@@ -182,7 +182,7 @@ public:
   DataInterfaceITSVector(ITSSource& its) : _its(its) {}
 
   // read one element
-  int read(const QString&, DataVector::ReadInfo&);
+  qint64 read(const QString&, DataVector::ReadInfo&);
 
   // named elements
   QStringList list() const { return _its._vectorList; }
@@ -228,7 +228,7 @@ const DataVector::DataInfo DataInterfaceITSVector::dataInfo(const QString& vecto
 }
 
 
-int DataInterfaceITSVector::read(const QString& field, DataVector::ReadInfo& p)
+qint64 DataInterfaceITSVector::read(const QString& field, DataVector::ReadInfo& p)
 {
 
   qint64 f0 = (qint64)p.startingFrame;
@@ -0,0 +1,377 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "livestreamsource.h"
+
+#include <QFile>
+#include <QMutexLocker>
+#include <QThread>
+#include <QXmlStreamWriter>
+
+#include <utility>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+using namespace Kst;
+
+static const QString liveStreamTypeString = "Live Stream";
+
+// how long opening a stream waits for the producer to name its fields
+static const int HeaderTimeout = 1000;
+
+
+/**********************
+LiveStreamSource::Config - how many frames of each field are kept.
+
+***********************/
+class LiveStreamSource::Config {
+  public:
+    Config() : history(LiveHistory::DefaultCapacity) {
+    }
+
+    void read(QSettings *cfg, const QString& fileName = QString()) {
+      Q_UNUSED(fileName);
+      cfg->beginGroup(liveStreamTypeString);
+      history = qMax(cfg->value("History", LiveHistory::DefaultCapacity).toLongLong(), qint64(1));
+      cfg->endGroup();
+    }
+
+    void save(QXmlStreamWriter& s) {
+      Q_UNUSED(s);
+    }
+
+    void load(const QDomElement& e) {
+      Q_UNUSED(e);
+    }
+
+    qint64 history;
+};
+
+
+//
+// Vector interface
+//
+
+class DataInterfaceLiveStreamVector : public DataSource::DataInterface<DataVector>
+{
+public:
+
+  DataInterfaceLiveStreamVector(LiveStreamSource& live) : _live(live) {}
+
+  // read one element
+  qint64 read(const QString&, DataVector::ReadInfo&);
+
+  // named elements
+  QStringList list() const;
+  bool isListComplete() const { return true; }
+  bool isValid(const QString&) const;
+
+  // T specific
+  const DataVector::DataInfo dataInfo(const QString&, double frame=0) const;
+  void setDataInfo(const QString&, const DataVector::DataInfo&) {}
+
+  // meta data
+  QMap<QString, double> metaScalars(const QString&) { return QMap<QString, double>(); }
+  QMap<QString, QString> metaStrings(const QString&) { return QMap<QString, QString>(); }
+
+  LiveStreamSource& _live;
+};
+
+
+QStringList DataInterfaceLiveStreamVector::list() const {
+  QMutexLocker locker(&_live._mutex);
+  return QStringList("INDEX") + _live._fields;
+}
+
+
+const DataVector::DataInfo DataInterfaceLiveStreamVector::dataInfo(const QString& field, double) const
+{
+  QMutexLocker locker(&_live._mutex);
+  if (field != "INDEX" && !_live._fields.contains(field)) {
+    return DataVector::DataInfo();
+  }
+  return DataVector::DataInfo(_live._frames, 1);
+}
+
+
+// Straight from the field's ring into the vector: frames the history has
+// already let go of read as NaN.
+qint64 DataInterfaceLiveStreamVector::read(const QString& field, DataVector::ReadInfo& p)
+{
+  QMutexLocker locker(&_live._mutex);
+  const qint64 f0 = (qint64)p.startingFrame;
+  const qint64 nr = qMin(p.singleSample ? qint64(1) : (qint64)p.numberOfFrames, _live._frames - f0);
+  if (f0 < 0 || nr <= 0) {
+    return 0;
+  }
+
+  if (field == "INDEX") {
+    for (qint64 i = 0; i < nr; ++i) {
+      p.data[i] = i + f0;
+    }
+    return nr;
+  }
+
+  return qMax(_live._reader->history().read(_live._fields.indexOf(field), f0, nr, p.data), qint64(0));
+}
+
+
+bool DataInterfaceLiveStreamVector::isValid(const QString& field) const {
+  QMutexLocker locker(&_live._mutex);
+  return field == "INDEX" || _live._fields.contains(field);
+}
+
+
+/**********************
+LiveStreamSource - frames from a producer on a local socket, kept in memory.
+
+***********************/
+LiveStreamSource::LiveStreamSource(Kst::ObjectStore *store, QSettings *cfg, const QString& filename, const QString& type, const QDomElement& e)
+: Kst::DataSource(store, cfg, filename, type), _config(0L), _reader(0), _frames(0)
+{
+  setInterface(new DataInterfaceLiveStreamVector(*this));
+
+  // the reader asks for updates as frames arrive
+  startUpdating(None);
+
+  // the history can be read from any thread, while frames are added to it
+  _concurrentUpdate = true;
+
+  _valid = false;
+  if (!type.isEmpty() && type != liveStreamTypeString) {
+    return;
+  }
+
+  _config = new LiveStreamSource::Config;
+  _config->read(cfg, filename);
+  if (!e.isNull()) {
+    _config->load(e);
+  }
+
+  if (init()) {
+    _valid = true;
+  }
+
+  registerChange();
+}
+
+
+LiveStreamSource::~LiveStreamSource() {
+  delete _reader;
+  delete _config;
+}
+
+
+// The reader's socket belongs to the source's thread: a reset asked for
+// from another one is done there, later.
+void LiveStreamSource::reset() {
+  if (QThread::currentThread() != thread()) {
+    QMetaObject::invokeMethod(this, [this]() { reset(); }, Qt::QueuedConnection);
+    return;
+  }
+  init();
+  Object::reset();
+}
+
+
+// Connects anew.  A producer that isn't there yet is waited for: its
+// fields turn up with its first frames.
+bool LiveStreamSource::init() {
+  if (!_config) {
+    return false;
+  }
+  Q_ASSERT(QThread::currentThread() == thread());
+
+  LiveStreamReader *reader = new LiveStreamReader(_filename, _config->history, this);
+  connect(reader, SIGNAL(framesArrived()), this, SLOT(checkUpdate()));
+  connect(reader, SIGNAL(fieldsChanged()), this, SLOT(checkUpdate()));
+  reader->waitForHeader(HeaderTimeout);
+
+  {
+    QMutexLocker locker(&_mutex);
+    std::swap(reader, _reader);
+    _fields = _reader->history().fields();
+    _frames = 0;
+  }
+  delete reader; // the old one: no read uses it any more
+
+  registerChange();
+  return true;
+}
+
+
+// A producer that came back with other fields starts again from frame 0.
+Kst::Object::UpdateType LiveStreamSource::internalDataSourceUpdate() {
+  if (!_valid) {
+    return Kst::Object::NoChange;
+  }
+
+  QMutexLocker locker(&_mutex);
+  const QStringList fields = _reader->history().fields();
+  const qint64 frames = _reader->history().frames();
+  const bool changed = fields != _fields || frames != _frames;
+  _fields = fields;
+  _frames = frames;
+
+  return changed ? Updated : NoChange;
+}
+
+
+QString LiveStreamSource::fileType() const {
+  return liveStreamTypeString;
+}
+
+
+void LiveStreamSource::save(QXmlStreamWriter &streamWriter) {
+  Kst::DataSource::save(streamWriter);
+}
+
+
+QString LiveStreamPlugin::pluginName() const { return tr("Live Stream Reader"); }
+QString LiveStreamPlugin::pluginDescription() const { return tr("Frames sent over a local socket by a live producer"); }
+
+
+Kst::DataSource *LiveStreamPlugin::create(Kst::ObjectStore *store,
+                                            QSettings *cfg,
+                                            const QString &filename,
+                                            const QString &type,
+                                            const QDomElement &element) const {
+
+  return new LiveStreamSource(store, cfg, filename, type, element);
+}
+
+
+QStringList LiveStreamPlugin::matrixList(QSettings *cfg,
+                                             const QString& filename,
+                                             const QString& type,
+                                             QString *typeSuggestion,
+                                             bool *complete) const {
+  Q_UNUSED(cfg)
+  Q_UNUSED(filename)
+  Q_UNUSED(type)
+
+  if (typeSuggestion) {
+    *typeSuggestion = liveStreamTypeString;
+  }
+  if (complete) {
+    *complete = true;
+  }
+  return QStringList();
+}
+
+
+QStringList LiveStreamPlugin::scalarList(QSettings *cfg,
+                                            const QString& filename,
+                                            const QString& type,
+                                            QString *typeSuggestion,
+                                            bool *complete) const {
+  Q_UNUSED(cfg)
+  Q_UNUSED(filename)
+  Q_UNUSED(type)
+
+  if (typeSuggestion) {
+    *typeSuggestion = liveStreamTypeString;
+  }
+  if (complete) {
+    *complete = true;
+  }
+  return QStringList();
+}
+
+
+QStringList LiveStreamPlugin::stringList(QSettings *cfg,
+                                      const QString& filename,
+                                      const QString& type,
+                                      QString *typeSuggestion,
+                                      bool *complete) const {
+  Q_UNUSED(cfg)
+  Q_UNUSED(filename)
+  Q_UNUSED(type)
+
+  if (typeSuggestion) {
+    *typeSuggestion = liveStreamTypeString;
+  }
+  if (complete) {
+    *complete = true;
+  }
+  return QStringList();
+}
+
+
+// The producer names the fields when a reader connects: incomplete if it
+// isn't there to ask.
+QStringList LiveStreamPlugin::fieldList(QSettings *cfg,
+                                            const QString& filename,
+                                            const QString& type,
+                                            QString *typeSuggestion,
+                                            bool *complete) const {
+  if (typeSuggestion) {
+    *typeSuggestion = liveStreamTypeString;
+  }
+  if ((!type.isEmpty() && !provides().contains(type)) ||
+      0 == understands(cfg, filename)) {
+    if (complete) {
+      *complete = false;
+    }
+    return QStringList();
+  }
+
+  LiveStreamReader reader(filename, 1);
+  const bool named = reader.waitForHeader(HeaderTimeout);
+  if (complete) {
+    *complete = named;
+  }
+
+  QStringList fieldList;
+  fieldList.append("INDEX");
+  fieldList += reader.history().fields();
+  return fieldList;
+}
+
+
+// Nothing but a producer makes a socket kst is pointed at.
+int LiveStreamPlugin::understands(QSettings *cfg, const QString& filename) const {
+  Q_UNUSED(cfg)
+#ifdef Q_OS_UNIX
+  struct stat info;
+  if (stat(QFile::encodeName(filename).constData(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+    return 100;
+  }
+#else
+  Q_UNUSED(filename)
+#endif
+  return 0;
+}
+
+
+bool LiveStreamPlugin::supportsTime(QSettings *cfg, const QString& filename) const {
+  Q_UNUSED(cfg)
+  Q_UNUSED(filename)
+  return false;
+}
+
+
+QStringList LiveStreamPlugin::provides() const {
+  QStringList rc;
+  rc += liveStreamTypeString;
+  return rc;
+}
+
+
+Kst::DataSourceConfigWidget *LiveStreamPlugin::configWidget(QSettings *cfg, const QString& filename) const {
+  Q_UNUSED(cfg)
+  Q_UNUSED(filename)
+  return 0;
+}
+
+// vim: ts=2 sw=2 et
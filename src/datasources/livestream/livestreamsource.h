@@ -0,0 +1,118 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef LIVESTREAMSOURCE_H
+#define LIVESTREAMSOURCE_H
+
+#include <datasource.h>
+#include <dataplugin.h>
+#include <livestream.h>
+
+#include <QMutex>
+
+class DataInterfaceLiveStreamVector;
+
+/** Frames sent by a producer over a local socket (see Kst::LiveStream), as
+    they come: the file name is the socket's.  The last frames of each field
+    are kept in memory, as many as the "History" setting asks, and reads are
+    served from there; an update is asked for as soon as frames arrive,
+    instead of on a timer. */
+class LiveStreamSource : public Kst::DataSource {
+  Q_OBJECT
+
+  public:
+    LiveStreamSource(Kst::ObjectStore *store, QSettings *cfg, const QString& filename, const QString& type, const QDomElement& e);
+
+    ~LiveStreamSource();
+
+    friend class DataInterfaceLiveStreamVector;
+
+    bool init();
+    virtual void reset();
+
+    Kst::Object::UpdateType internalDataSourceUpdate();
+
+    QString fileType() const;
+
+    void save(QXmlStreamWriter &streamWriter);
+
+    class Config;
+
+  private:
+    mutable Config *_config;
+
+    // the reader is only made, and deleted, on the source's own thread:
+    // its socket lives there.  _mutex guards the pointer and the fields
+    // and frame count, which the update sets while others are read.
+    mutable QMutex _mutex;
+    Kst::LiveStreamReader *_reader;
+
+    // as of the last update: reads don't see frames past it
+    QStringList _fields;
+    qint64 _frames;
+};
+
+
+class LiveStreamPlugin : public QObject, public Kst::DataSourcePluginInterface {
+    Q_OBJECT
+    Q_INTERFACES(Kst::DataSourcePluginInterface)
+    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.3")
+  public:
+    virtual ~LiveStreamPlugin() {}
+
+    virtual QString pluginName() const;
+    virtual QString pluginDescription() const;
+
+    virtual bool hasConfigWidget() const { return false; }
+
+    virtual Kst::DataSource *create(Kst::ObjectStore *store,
+                                  QSettings *cfg,
+                                  const QString &filename,
+                                  const QString &type,
+                                  const QDomElement &element) const;
+
+    virtual QStringList matrixList(QSettings *cfg,
+                                  const QString& filename,
+                                  const QString& type,
+                                  QString *typeSuggestion,
+                                  bool *complete) const;
+
+    virtual QStringList fieldList(QSettings *cfg,
+                                  const QString& filename,
+                                  const QString& type,
+                                  QString *typeSuggestion,
+                                  bool *complete) const;
+
+    virtual QStringList scalarList(QSettings *cfg,
+                                  const QString& filename,
+                                  const QString& type,
+                                  QString *typeSuggestion,
+                                  bool *complete) const;
+
+    virtual QStringList stringList(QSettings *cfg,
+                                  const QString& filename,
+                                  const QString& type,
+                                  QString *typeSuggestion,
+                                  bool *complete) const;
+
+    virtual int understands(QSettings *cfg, const QString& filename) const;
+
+    virtual bool supportsTime(QSettings *cfg, const QString& filename) const;
+
+    virtual QStringList provides() const;
+
+    virtual Kst::DataSourceConfigWidget *configWidget(QSettings *cfg, const QString& filename) const;
+};
+
+
+#endif
+// vim: ts=2 sw=2 et
@@ -74,7 +74,7 @@ public:
   DataInterfaceMatlabScalar(MatlabSource& s) : matlab(s) {}
 
   // read one element
-  int read(const QString&, DataScalar::ReadInfo&);
+  qint64 read(const QString&, DataScalar::ReadInfo&);
 
   // named elements
   QStringList list() const { return matlab._scalarList; }
@@ -95,7 +95,7 @@ private:
 };
 
 
-int DataInterfaceMatlabScalar::read(const QString& scalar, DataScalar::ReadInfo& p)
+qint64 DataInterfaceMatlabScalar::read(const QString& scalar, DataScalar::ReadInfo& p)
 {
   return matlab.readScalar(p.value, scalar);
 }
@@ -117,7 +117,7 @@ public:
   DataInterfaceMatlabString(MatlabSource& s) : matlab(s) {}
 
   // read one element
-  int read(const QString&, DataString::ReadInfo&);
+  qint64 read(const QString&, DataString::ReadInfo&);
 
   // named elements
   QStringList list() const { return matlab._strings.keys(); }
@@ -138,7 +138,7 @@ private:
 };
 
 
-int DataInterfaceMatlabString::read(const QString& string, DataString::ReadInfo& p)
+qint64 DataInterfaceMatlabString::read(const QString& string, DataString::ReadInfo& p)
 {
   if (isValid(string) && p.value) {
     *p.value = matlab._strings[string];
@@ -166,7 +166,7 @@ public:
   DataInterfaceMatlabVector(MatlabSource& s) : matlab(s) {}
 
   // read one element
-  int read(const QString&, DataVector::ReadInfo&);
+  qint64 read(const QString&, DataVector::ReadInfo&);
 
   // named elements
   QStringList list() const { return matlab._fieldList; }
@@ -197,7 +197,7 @@ const DataVector::DataInfo DataInterfaceMatlabVector::dataInfo(const QString &fi
 
 
 
-int DataInterfaceMatlabVector::read(const QString& field, DataVector::ReadInfo& p)
+qint64 DataInterfaceMatlabVector::read(const QString& field, DataVector::ReadInfo& p)
 {
   return matlab.readField(p.data, field, p.startingFrame, p.numberOfFrames);
 }
@@ -234,7 +234,7 @@ public:
   DataInterfaceMatlabMatrix(MatlabSource& s) : matlab(s) {}
 
   // read one element
-  int read(const QString&, DataMatrix::ReadInfo&);
+  qint64 read(const QString&, DataMatrix::ReadInfo&);
 
   // named elements
   QStringList list() const { return matlab._matrixList; }
@@ -281,7 +281,7 @@ const DataMatrix::DataInfo DataInterfaceMatlabMatrix::dataInfo(const QString& ma
 }
 
 
-int DataInterfaceMatlabMatrix::read(const QString& field, DataMatrix::ReadInfo& p)
+qint64 DataInterfaceMatlabMatrix::read(const QString& field, DataMatrix::ReadInfo& p)
 {
   int count = matlab.readMatrix(p.data->z, field);
 
@@ -467,7 +467,7 @@ int MatlabSource::readString(QString *stringValue, const QString& stringName)
   return 0;
 }
 
-int MatlabSource::readField(double *v, const QString& field, double s, double n) {
+qint64 MatlabSource::readField(double *v, const QString& field, double s, double n) {
   qint64 s64 = (qint64)s;
   qint64 n64 = (qint64)n;
 
@@ -482,7 +482,7 @@ int MatlabSource::readField(double *v, const QString& field, double s, double n)
     for (qint64 i = 0; i < n64; ++i) {
       v[i] = double(s64 + i);
     }
-    return (int)n64;
+    return n64;
   }
 
   /* For a variable from the Matlab file */
@@ -597,7 +597,7 @@ int MatlabSource::readField(double *v, const QString& field, double s, double n)
 
   KST_DBG qDebug() << "Finished reading " << field << Qt::endl;
   Mat_VarFree(matvar);
-  return (int)n64;
+  return n64;
 }
 
 
@@ -900,6 +900,11 @@ QStringList MatlabSourcePlugin::provides() const {
 }
 
 
+QStringList MatlabSourcePlugin::signatures() const {
+  return QStringList() << "*.mat";
+}
+
+
 // Request for this plugins configuration widget.
 Kst::DataSourceConfigWidget *MatlabSourcePlugin::configWidget(QSettings *cfg, const QString& filename) const {
   Q_UNUSED(cfg)
@@ -41,7 +41,7 @@ class MatlabSource : public Kst::DataSource {
 
     int readString(QString *stringValue, const QString& stringName);
 
-    int readField(double *v, const QString& field, double s, double n);
+    qint64 readField(double *v, const QString& field, double s, double n);
 
     int readMatrix(double *v, const QString& field);
 
@@ -84,7 +84,7 @@ class MatlabSource : public Kst::DataSource {
 class MatlabSourcePlugin : public QObject, public Kst::DataSourcePluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataSourcePluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.3")
   public:
     virtual ~MatlabSourcePlugin() {}
 
@@ -129,6 +129,8 @@ class MatlabSourcePlugin : public QObject, public Kst::DataSourcePluginInterface
 
     virtual QStringList provides() const;
 
+    virtual QStringList signatures() const;
+
     virtual Kst::DataSourceConfigWidget *configWidget(QSettings *cfg, const QString& filename) const;
 };
 
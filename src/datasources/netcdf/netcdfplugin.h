@@ -27,7 +27,7 @@ class NetCdfPlugin : public QObject, public Kst::DataSourcePluginInterface
 {
     Q_OBJECT
     Q_INTERFACES(Kst::DataSourcePluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.3")
 
   public:
     virtual ~NetCdfPlugin() {}
@@ -53,7 +53,7 @@ public:
   DataInterfaceNetCdfScalar(NetcdfSource& s) : netcdf(s) {}
 
   // read one element
-  int read(const QString&, DataScalar::ReadInfo&);
+  qint64 read(const QString&, DataScalar::ReadInfo&);
 
   // named elements
   QStringList list() const { return netcdf._scalarList; }
@@ -74,7 +74,7 @@ private:
 };
 
 
-int DataInterfaceNetCdfScalar::read(const QString& scalar, DataScalar::ReadInfo& p)
+qint64 DataInterfaceNetCdfScalar::read(const QString& scalar, DataScalar::ReadInfo& p)
 {
   return netcdf.readScalar(p.value, scalar);
 }
@@ -96,7 +96,7 @@ public:
   DataInterfaceNetCdfString(NetcdfSource& s) : netcdf(s) {}
 
   // read one element
-  int read(const QString&, DataString::ReadInfo&);
+  qint64 read(const QString&, DataString::ReadInfo&);
 
   // named elements
   QStringList list() const { return netcdf._strings.keys(); }
@@ -118,7 +118,7 @@ private:
 
 
 //-------------------------------------------------------------------------------------------
-int DataInterfaceNetCdfString::read(const QString& string, DataString::ReadInfo& p)
+qint64 DataInterfaceNetCdfString::read(const QString& string, DataString::ReadInfo& p)
 {
   //return netcdf.readString(p.value, string);
   if (isValid(string) && p.value) {
@@ -148,7 +148,7 @@ public:
   DataInterfaceNetCdfVector(NetcdfSource& s) : netcdf(s) {}
 
   // read one element
-  int read(const QString&, DataVector::ReadInfo&);
+  qint64 read(const QString&, DataVector::ReadInfo&);
 
   // named elements
   QStringList list() const { return netcdf._fieldList; }
@@ -180,7 +180,7 @@ const DataVector::DataInfo DataInterfaceNetCdfVector::dataInfo(const QString &fi
 
 
 
-int DataInterfaceNetCdfVector::read(const QString& field, DataVector::ReadInfo& p)
+qint64 DataInterfaceNetCdfVector::read(const QString& field, DataVector::ReadInfo& p)
 {
   return netcdf.readField(p.data, field, p.startingFrame, p.numberOfFrames);
 }
@@ -277,7 +277,7 @@ public:
   DataInterfaceNetCdfMatrix(NetcdfSource& s) : netcdf(s) {}
 
   // read one element
-  int read(const QString&, DataMatrix::ReadInfo&);
+  qint64 read(const QString&, DataMatrix::ReadInfo&);
 
   // named elements
   QStringList list() const { return netcdf._matrixList; }
@@ -323,7 +323,7 @@ const DataMatrix::DataInfo DataInterfaceNetCdfMatrix::dataInfo(const QString& ma
 }
 
 
-int DataInterfaceNetCdfMatrix::read(const QString& field, DataMatrix::ReadInfo& p)
+qint64 DataInterfaceNetCdfMatrix::read(const QString& field, DataMatrix::ReadInfo& p)
 {
   int count = netcdf.readMatrix(p.data->z, field);
 
@@ -493,7 +493,7 @@ int NetcdfSource::readString(QString *stringValue, const QString& stringName)
   return 0;
 }
 
-int NetcdfSource::readField(double *v, const QString& field, double s, double n) {
+qint64 NetcdfSource::readField(double *v, const QString& field, double s, double n) {
   qint64 s64 = (qint64)s;
   qint64 n64 = (qint64)n;
 // <<<<<<< HEAD
@@ -515,7 +515,7 @@ int NetcdfSource::readField(double *v, const QString& field, double s, double n)
     for (qint64 i = 0; i < n64; ++i) {
       v[i] = double(s64 + i);
     }
-    return (int)n64;
+    return n64;
   }
 
   /* For a variable from the netCDF file */
@@ -605,7 +605,7 @@ int NetcdfSource::readField(double *v, const QString& field, double s, double n)
 
   NETCDF_DBG qDebug() << "Finished reading " << field << Qt::endl;
 
-  return oneSample ? 1 : (int)n64;
+  return oneSample ? 1 : n64;
 }
 
 
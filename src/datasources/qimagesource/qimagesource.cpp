@@ -54,7 +54,7 @@ public:
   DataInterfaceQImageVector(QImage* img) : _image(img), _frameCount(0) {}
 
   // read one element
-  int read(const QString&, DataVector::ReadInfo&);
+  qint64 read(const QString&, DataVector::ReadInfo&);
 
   // named elements
   QStringList list() const { return _vectorList; }
@@ -108,7 +108,7 @@ const DataVector::DataInfo DataInterfaceQImageVector::dataInfo(const QString &fi
 
 
 
-int DataInterfaceQImageVector::read(const QString& field, DataVector::ReadInfo& p)
+qint64 DataInterfaceQImageVector::read(const QString& field, DataVector::ReadInfo& p)
 {
   qint64 i = 0;
   qint64 s = (qint64)p.startingFrame;
@@ -172,7 +172,7 @@ public:
   DataInterfaceQImageMatrix(QImage* img) : _image(img) {}
 
   // read one element
-  int read(const QString&, DataMatrix::ReadInfo&);
+  qint64 read(const QString&, DataMatrix::ReadInfo&);
 
   // named elements
   QStringList list() const { return _matrixList; }
@@ -226,7 +226,7 @@ const DataMatrix::DataInfo DataInterfaceQImageMatrix::dataInfo(const QString& ma
 }
 
 
-int DataInterfaceQImageMatrix::read(const QString& field, DataMatrix::ReadInfo& p)
+qint64 DataInterfaceQImageMatrix::read(const QString& field, DataMatrix::ReadInfo& p)
 {
   if ( _image->isNull() ) {
     return 0;
@@ -12,19 +12,70 @@
 
 #include "sourcelist.h"
 #include "datasourcepluginmanager.h"
+#include "updatemanager.h"
 
 #include <QXmlStreamWriter>
 #include <QImageReader>
 #include <qcolor.h>
 #include <QFile>
 #include <QFileInfo>
+#include <QDateTime>
+#include <QMutex>
+#include <QtConcurrent>
 
+#include <algorithm>
+#include <string.h>
 
 
 using namespace Kst;
 
 static const QString sourceListTypeString = "List of Datasources";
 
+// open child sources, at most
+static const int MaxOpenSources = 64;
+
+
+//
+// Frame counts of files which are not the last in a list do not change, so
+// remember them for as long as the file looks the same.  Reopening a list
+// (or resetting it) then only needs to open the files which are read.
+//
+struct CachedFrameCount {
+  qint64 size;
+  QDateTime modified;
+  qint64 frames;
+};
+
+static QHash<QString, CachedFrameCount> frameCountCache;
+static QMutex frameCountCacheMutex;
+
+static bool cachedFrameCount(const QString& fileName, qint64 *frames) {
+  const QFileInfo info(fileName);
+  if (info.isDir()) {
+    return false; // eg, a dirfile: files inside grow without changing the directory
+  }
+  QMutexLocker lock(&frameCountCacheMutex);
+  QHash<QString, CachedFrameCount>::const_iterator it = frameCountCache.constFind(fileName);
+  if (it == frameCountCache.constEnd() || it->size != info.size() || it->modified != info.lastModified()) {
+    return false;
+  }
+  *frames = it->frames;
+  return true;
+}
+
+static void cacheFrameCount(const QString& fileName, qint64 frames) {
+  const QFileInfo info(fileName);
+  if (info.isDir()) {
+    return;
+  }
+  CachedFrameCount c;
+  c.size = info.size();
+  c.modified = info.lastModified();
+  c.frames = frames;
+  QMutexLocker lock(&frameCountCacheMutex);
+  frameCountCache.insert(fileName, c);
+}
+
 
 //
 // Vector interface
@@ -36,7 +87,7 @@ public:
   DataInterfaceSourceListVector(SourceListSource& d) : sourcelist(d) {}
 
   // read one element
-  int read(const QString& field, DataVector::ReadInfo& p) {return sourcelist.readField(field, p);}
+  qint64 read(const QString& field, DataVector::ReadInfo& p) {return sourcelist.readField(field, p);}
 
   // named elements
   QStringList list() const { return sourcelist._fieldList; }
@@ -76,22 +127,39 @@ details.
 ***********************/
 class SourceListSource::Config {
   public:
-    Config() {
+    Config() : _parallelReads(true) {
     }
 
     void read(QSettings *cfg, const QString& fileName = QString()) {
       Q_UNUSED(fileName);
       cfg->beginGroup("Source List");
+      _parallelReads = cfg->value("Parallel Reads", true).toBool();
       cfg->endGroup();
     }
 
     void save(QXmlStreamWriter& s) {
-      Q_UNUSED(s);
+      s.writeStartElement("properties");
+      s.writeAttribute("parallelReads", _parallelReads ? "true" : "false");
+      s.writeEndElement();
     }
 
     void load(const QDomElement& e) {
-      Q_UNUSED(e);
+      if (e.hasAttribute("parallelReads")) {
+        _parallelReads = e.attribute("parallelReads") != "false";
+      }
     }
+
+    void parseProperties(QXmlStreamAttributes& properties) {
+      if (properties.hasAttribute("parallelReads")) {
+        _parallelReads = properties.value("parallelReads").toString() != "false";
+      }
+    }
+
+    // Read the files of one request from several threads at once, each
+    // file through its own source.  On unless the "Parallel Reads" setting
+    // of the "Source List" group, or the session, turns it off: for child
+    // plugins which can't read two of their files from different threads.
+    bool _parallelReads;
 };
 
 
@@ -128,12 +196,18 @@ SourceListSource::SourceListSource(Kst::ObjectStore *store, QSettings *cfg, cons
     _valid = true;
   }
 
+  // sources are only closed once nothing is reading them
+  connect(UpdateManager::self(), SIGNAL(objectsUpdated(qint64)), this, SLOT(releaseUnusedSources()));
+
   registerChange();
 }
 
 
 
 SourceListSource::~SourceListSource() {
+  releaseSources();
+  closeReleasedSources();
+  delete _config;
 }
 
 
@@ -152,9 +226,11 @@ bool SourceListSource::init() {
 
   _frameCount = 0;
 
-  // create the child sources, and create the list
-  _sources.clear(); // also deletes the smart pointers...
+  // forget the child sources, and the list
+  releaseSources();
+  _fileNames.clear();
   _sizeList.clear();
+  _frameStart.clear();
 
   if (!QFile::exists(_filename)) {
     return 0;
@@ -167,26 +243,24 @@ bool SourceListSource::init() {
 
   QByteArray line;
 
-  _frameCount = 0;
-
   while (1) {
     line = f.readLine(5000).trimmed();
     if (line.isEmpty()) {
       break;
     }
-    // create the data source and add it to _sources
-    DataSourcePtr ds = DataSourcePluginManager::findOrLoadSource(_store, line);
-    if (ds) {
-      _sources.append(ds);
-    }
+    _fileNames.append(QString::fromUtf8(line));
+  }
+
+  // all but the last file are only opened if their frame count isn't known
+  for (int i = 0; i < _fileNames.size(); i++) {
+    _sizeList.append(frameCountOf(i, i < _fileNames.size() - 1));
   }
+  updateFrameTable();
 
-  if (_sources.size()>0) {
-    _fieldList.append(_sources.at(0)->vector().list());
-    foreach (DataSourcePtr ds, _sources) {
-      DataVector::DataInfo info = ds->vector().dataInfo(ds->vector().list().at(0));
-      _sizeList.append(info.frameCount);
-      _frameCount += info.frameCount;
+  if (_fileNames.size()>0) {
+    DataSourcePtr ds = source(0);
+    if (ds) {
+      _fieldList.append(ds->vector().list());
     }
   }
 
@@ -196,11 +270,118 @@ bool SourceListSource::init() {
   return true; // false if something went wrong
 }
 
+
+DataSourcePtr SourceListSource::source(int i) {
+  if (i < 0 || i >= _fileNames.size()) {
+    return 0;
+  }
+
+  DataSourcePtr ds = _open.value(i);
+  if (ds) {
+    _lru.removeOne(i);
+    _lru.append(i);
+    return ds;
+  }
+
+  ds = DataSourcePluginManager::findOrLoadSource(_store, _fileNames.at(i));
+  if (!ds) {
+    return 0;
+  }
+  _open.insert(i, ds);
+  _lru.append(i);
+  return ds;
+}
+
+
+// Called after each update pass: closing a source removes it from the
+// store, which is not done while objects are being updated.  So sources
+// released during the pass (by a reset, say) are only closed here.
+void SourceListSource::releaseUnusedSources() {
+  while (_lru.size() > MaxOpenSources) {
+    releaseSource(_lru.first());
+  }
+  closeReleasedSources();
+}
+
+
+void SourceListSource::releaseSource(int i) {
+  _lru.removeOne(i);
+  DataSourcePtr ds = _open.take(i);
+  if (ds) {
+    _released.append(ds);
+  }
+}
+
+
+void SourceListSource::closeReleasedSources() {
+  QList<DataSourcePtr> released;
+  released.swap(_released);
+  while (!released.isEmpty()) {
+    DataSourcePtr ds = released.takeFirst();
+    released.removeAll(ds); // a file listed twice is one source
+    // close it, unless something other than the store and us uses it
+    if (ds->getUsage() <= 2) {
+      _store->removeObject(ds);
+    }
+  }
+}
+
+
+void SourceListSource::releaseSources() {
+  while (!_lru.isEmpty()) {
+    releaseSource(_lru.first());
+  }
+  _open.clear();
+}
+
+
+qint64 SourceListSource::frameCountOf(int i, bool useCache) {
+  qint64 frames = 0;
+  if (useCache && cachedFrameCount(_fileNames.at(i), &frames)) {
+    return frames;
+  }
+
+  DataSourcePtr ds = source(i);
+  if (!ds || ds->vector().list().isEmpty()) {
+    return 0;
+  }
+  DataVector::DataInfo info = ds->vector().dataInfo(ds->vector().list().at(0));
+  frames = qint64(info.frameCount);
+  cacheFrameCount(_fileNames.at(i), frames);
+  return frames;
+}
+
+
+void SourceListSource::updateFrameTable() {
+  _frameStart.resize(_sizeList.size() + 1);
+  qint64 frames = 0;
+  for (int i = 0; i < _sizeList.size(); i++) {
+    _frameStart[i] = frames;
+    frames += _sizeList.at(i);
+  }
+  _frameStart[_sizeList.size()] = frames;
+  _frameCount = frames;
+}
+
+
+// the file holding frame, or the last file if frame is past the end.
+// Files without frames are skipped.
+int SourceListSource::fileOfFrame(qint64 frame) const {
+  if (_fileNames.isEmpty()) {
+    return -1;
+  }
+  QVector<qint64>::const_iterator it = std::upper_bound(_frameStart.constBegin(), _frameStart.constEnd() - 1, frame);
+  return qBound(0, int(it - _frameStart.constBegin()) - 1, _fileNames.size() - 1);
+}
+
+
 int SourceListSource::samplesPerFrame(const QString &field) {
-  if (_sources.size()>0) {
-    DataSourcePtr ds = _sources.at(0);
-    DataVector::DataInfo info = ds->vector().dataInfo(field);
-    return info.samplesPerFrame;
+  if (_fileNames.size()>0) {
+    DataSourcePtr ds = source(0);
+    if (ds) {
+      DataVector::DataInfo info = ds->vector().dataInfo(field);
+      return info.samplesPerFrame;
+    }
   }
   return 1;
 }
@@ -208,7 +389,7 @@ int SourceListSource::samplesPerFrame(const QString &field) {
 
 // Check if the data in the from the source has updated.
 // For source list, we only check
-//   -if a new file has been added
+//   -if files have been added
 //   -if the last file has grown.
 Kst::Object::UpdateType SourceListSource::internalDataSourceUpdate() {
   QFile f(_filename);
@@ -219,35 +400,39 @@ Kst::Object::UpdateType SourceListSource::internalDataSourceUpdate() {
   QByteArray line;
 
   // check if the list has changed
-  for (int i = 0; i<_sources.size(); i++) {
+  for (int i = 0; i<_fileNames.size(); i++) {
     line = f.readLine(5000).trimmed();
-    if (line!=_sources.at(i)->fileName()) { // error: better reset
+    if (QString::fromUtf8(line) != _fileNames.at(i)) { // error: better reset
       qDebug() << "source list internal ds update: file list changed";
       reset();
       return (Kst::Object::Updated);
     }
   }
-  line = f.readLine(5000).trimmed();
-  if (!line.isEmpty()) {
-    // create the data source and add it to _sources
-    DataSourcePtr ds = DataSourcePluginManager::findOrLoadSource(_store, line);
-    if (ds) {
-      _sources.append(ds);
+
+  // only the last file can have grown; when files are added, that is the
+  // old last file one final time, and then the new ones.
+  int firstChanged = _fileNames.size() - 1;
+  while (1) {
+    line = f.readLine(5000).trimmed();
+    if (line.isEmpty()) {
+      break;
     }
+    _fileNames.append(QString::fromUtf8(line));
+    _sizeList.append(0);
+  }
+  for (int i = qMax(firstChanged, 0); i < _fileNames.size(); i++) {
+    _sizeList[i] = frameCountOf(i, false);
   }
 
-  if (_sources.size()>0) {
+  if (_fileNames.size()>0) {
     if (_fieldList.size()<1) {
-      _fieldList.append(_sources.at(0)->vector().list());
-    }
-    _sizeList.clear();
-    int oldFrameCount = _frameCount;
-    _frameCount = 0;
-    foreach (DataSourcePtr ds, _sources) {
-      DataVector::DataInfo info = ds->vector().dataInfo(ds->vector().list().at(0));
-      _sizeList.append(info.frameCount);
-      _frameCount += info.frameCount;
+      DataSourcePtr ds = source(0);
+      if (ds) {
+        _fieldList.append(ds->vector().list());
+      }
     }
+    qint64 oldFrameCount = _frameCount;
+    updateFrameTable();
     if (_frameCount != oldFrameCount) {
       return Kst::Object::Updated;
     }
@@ -269,60 +454,152 @@ QString SourceListSource::fileType() const {
 
 void SourceListSource::save(QXmlStreamWriter &streamWriter) {
   Kst::DataSource::save(streamWriter);
+  if (_config) {
+    _config->save(streamWriter);
+  }
+}
+
+
+void SourceListSource::parseProperties(QXmlStreamAttributes &properties) {
+  if (_config) {
+    _config->parseProperties(properties);
+  }
 }
 
 // 0 1000 2000 3000
 // 0 1    2    3
 
-int SourceListSource::readField(const QString& field, DataVector::ReadInfo& p) {
+namespace {
+// the part of a read which comes from one file
+struct FileRead {
+  int file;
+  DataSourcePtr ds;
+  DataVector::ReadInfo ri;
+  qint64 offset;  // where the samples go, if every file gives all it was asked for
+  qint64 samples; // what it gave
+};
+}
+
+qint64 SourceListSource::readField(const QString& field, DataVector::ReadInfo& p) {
   qint64 f0 = (qint64)p.startingFrame;
   qint64 nf = (qint64)p.numberOfFrames;
-  int i_file = 0;
   DataVector::ReadInfo ri;
   ri.singleSample = p.singleSample;
-  int samp_read = 0;
-  qint64 f_offset = 0;
-  //if (f0<0 && nf >0) {
-  //  f0 = qMax(_frameCount - nf, 0);
-  //} else if (nf<0 && f0>=0) {
-  //  nf = qMax(_frameCount-f0, 0);
-  //}
-
-  if (f0 >= 0) {
-    while ((f0 >= _sizeList.at(i_file)) && (i_file < _sizeList.size()-1)) {
-      f0 -= _sizeList.at(i_file);
-      f_offset += _sizeList.at(i_file);
+  qint64 samp_read = 0;
+
+  if (f0 < 0 || _fileNames.isEmpty()) {
+    return 0;
+  }
+
+  int i_file = fileOfFrame(f0);
+  qint64 f_offset = _frameStart.at(i_file);
+  f0 -= f_offset;
+
+  if (nf>0) {
+    QVector<FileRead> reads;
+    qint64 frames = 0;
+    while ((nf>0) && (i_file < _sizeList.size())) {
+      qint64 nr = qMin(nf, _sizeList.at(i_file)-f0);
+      if (nr > 0) {
+        FileRead r;
+        r.file = i_file;
+        r.ri = p;
+        r.ri.startingFrame = f0;
+        r.ri.numberOfFrames = nr;
+        r.offset = frames;
+        r.samples = 0;
+        reads.append(r);
+        frames += nr;
+      }
+      nf -= nr;
+      f0 = 0;
       i_file++;
     }
-    if (nf>0) {
-      while ((nf>0) && (i_file < _sizeList.size())) {
-        qint64 nr = qMin(nf, (qint64)_sizeList.at(i_file)-f0);
-        ri = p;
-        ri.startingFrame = f0;
-        ri.numberOfFrames = nr;
-        ri.data = p.data+samp_read;
-        if (field == "INDEX") {
-          for (qint64 i=0; i<nr; i++) {
-            ri.data[i] = i+f_offset + f0;
+
+    if (field == "INDEX") {
+      foreach (const FileRead& r, reads) {
+        const qint64 first = _frameStart.at(r.file) + qint64(r.ri.startingFrame);
+        for (qint64 i=0; i<qint64(r.ri.numberOfFrames); i++) {
+          p.data[samp_read + i] = first + i;
+        }
+        samp_read += qint64(r.ri.numberOfFrames);
+      }
+      return samp_read;
+    }
+
+    if (_config && _config->_parallelReads && reads.size() > 1) {
+      // open a pool's worth of files, and read them all at once
+      const int spf = qMax(samplesPerFrame(field), 1);
+      for (int first = 0; first < reads.size(); first += MaxOpenSources) {
+        QVector<FileRead> batch = reads.mid(first, MaxOpenSources);
+        FileRead *parts = batch.data();
+        // a file listed more than once is one source: one thread reads
+        // all of its parts, under its lock
+        QHash<DataSource*, int> groupOf;
+        QVector<QVector<int> > groups;
+        for (int i = 0; i < batch.size(); i++) {
+          parts[i].ds = source(parts[i].file);
+          parts[i].ri.data = p.data + parts[i].offset * spf;
+          if (parts[i].ds) {
+            QHash<DataSource*, int>::const_iterator it = groupOf.constFind(parts[i].ds.data());
+            if (it == groupOf.constEnd()) {
+              it = groupOf.insert(parts[i].ds.data(), groups.size());
+              groups.append(QVector<int>());
+            }
+            groups[it.value()].append(i);
           }
-          samp_read += (int)nr;
-        } else {
-          samp_read += _sources[i_file]->vector().read(field, ri);
         }
-        nf -= nr;
-        f0 = 0;
-        f_offset += _sizeList.at(i_file);
-        i_file++;
+        QtConcurrent::blockingMap(groups, [&field, parts](QVector<int>& group) {
+          DataSource *ds = parts[group.first()].ds.data();
+          KstReadLocker lock(ds);
+          for (int k = 0; k < group.size(); k++) {
+            FileRead& r = parts[group.at(k)];
+            const FileRead *same = 0;
+            for (int j = 0; j < k && !same; j++) {
+              const FileRead& o = parts[group.at(j)];
+              if (o.ri.startingFrame == r.ri.startingFrame && o.ri.numberOfFrames == r.ri.numberOfFrames) {
+                same = &o;
+              }
+            }
+            if (same) { // the same frames again: read them once
+              memcpy(r.ri.data, same->ri.data, same->samples * sizeof(double));
+              r.samples = same->samples;
+            } else {
+              r.samples = ds->vector().read(field, r.ri);
+            }
+          }
+        });
+        // close the gaps left by files which gave less than asked
+        foreach (const FileRead& r, batch) {
+          if (r.ri.data != p.data + samp_read && r.samples > 0) {
+            memmove(p.data + samp_read, r.ri.data, r.samples * sizeof(double));
+          }
+          samp_read += r.samples;
+        }
       }
-    } else if (p.singleSample) { // read one sample
-      ri = p;
-      ri.startingFrame = f0;
-      ri.numberOfFrames = nf;
-      if (field == "INDEX") {
-        ri.data[0] = f0 + f_offset;
-        samp_read++;
-      } else {
-        samp_read += _sources[i_file]->vector().read(field, ri);
+    } else {
+      foreach (const FileRead& r, reads) {
+        DataSourcePtr ds = source(r.file);
+        if (ds) {
+          KstReadLocker lock(ds.data());
+          ri = r.ri;
+          ri.data = p.data+samp_read;
+          samp_read += ds->vector().read(field, ri);
+        }
+      }
+    }
+  } else if (p.singleSample) { // read one sample
+    ri = p;
+    ri.startingFrame = f0;
+    ri.numberOfFrames = nf;
+    if (field == "INDEX") {
+      ri.data[0] = f0 + f_offset;
+      samp_read++;
+    } else {
+      DataSourcePtr ds = source(i_file);
+      if (ds) {
+        KstReadLocker lock(ds.data());
+        samp_read += ds->vector().read(field, ri);
       }
     }
   }
@@ -17,6 +17,9 @@
 #include <datasource.h>
 #include <dataplugin.h>
 
+#include <QHash>
+#include <QVector>
+
 class DataInterfaceSourceListVector;
 class DataInterfaceSourceListScalar;
 class DataInterfaceSourceListString;
@@ -41,17 +44,18 @@ class SourceListSource : public Kst::DataSource {
     QString fileType() const;
 
     void save(QXmlStreamWriter &streamWriter);
+    void parseProperties(QXmlStreamAttributes &properties);
 
     class Config;
 
     int samplesPerFrame(const QString &field);
 
-    int readField(const QString& field, DataVector::ReadInfo& p);
+    qint64 readField(const QString& field, DataVector::ReadInfo& p);
 
   private:
     mutable Config *_config;
 
-    int _frameCount;
+    qint64 _frameCount;
 
     QStringList _scalarList;
     QStringList _stringList;
@@ -68,15 +72,36 @@ class SourceListSource : public Kst::DataSource {
     //friend class DataInterfaceSourceListString;
     //friend class DataInterfaceSourceListMatrix;
 
-    DataSourceList _sources;
-    QList<int> _sizeList;
+    // the listed files, and their frame counts
+    QStringList _fileNames;
+    QVector<qint64> _sizeList;
+    // _frameStart[i] is the first frame of file i; one extra entry for the end
+    QVector<qint64> _frameStart;
+
+    // child sources are opened when first read; after an update pass, the
+    // least recently used are closed until MaxOpenSources are left open
+    QHash<int, DataSourcePtr> _open;
+    QList<int> _lru;
+    // released sources, removed from the store after the update pass
+    QList<DataSourcePtr> _released;
+
+    DataSourcePtr source(int i);
+    void releaseSource(int i);
+    void releaseSources();
+    void closeReleasedSources();
+    qint64 frameCountOf(int i, bool useCache);
+    void updateFrameTable();
+    int fileOfFrame(qint64 frame) const;
+
+  private Q_SLOTS:
+    void releaseUnusedSources();
 };
 
 
 class SourceListPlugin : public QObject, public Kst::DataSourcePluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataSourcePluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.3")
   public:
     virtual ~SourceListPlugin() {}
 
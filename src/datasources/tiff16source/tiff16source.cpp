@@ -54,7 +54,7 @@ public:
   DataInterfaceTiff16Vector(unsigned short **z) : _z(z), _frameCount(0) {}
 
   // read one element
-  int read(const QString&, DataVector::ReadInfo&);
+  qint64 read(const QString&, DataVector::ReadInfo&);
 
   // named elements
   QStringList list() const { return _vectorList; }
@@ -106,7 +106,7 @@ const DataVector::DataInfo DataInterfaceTiff16Vector::dataInfo(const QString &fi
 
 
 
-int DataInterfaceTiff16Vector::read(const QString& field, DataVector::ReadInfo& p)
+qint64 DataInterfaceTiff16Vector::read(const QString& field, DataVector::ReadInfo& p)
 {
   qint64 i = 0;
   qint64 s = (qint64)p.startingFrame;
@@ -150,7 +150,7 @@ public:
   DataInterfaceTiff16Matrix(unsigned short **z, int *width, int *height) : _image(z),_width(width),_height(height) {}
 
   // read one element
-  int read(const QString&, DataMatrix::ReadInfo&);
+  qint64 read(const QString&, DataMatrix::ReadInfo&);
 
   // named elements
   QStringList list() const { return _matrixList; }
@@ -204,7 +204,7 @@ const DataMatrix::DataInfo DataInterfaceTiff16Matrix::dataInfo(const QString& ma
 }
 
 
-int DataInterfaceTiff16Matrix::read(const QString& field, DataMatrix::ReadInfo& p)
+qint64 DataInterfaceTiff16Matrix::read(const QString& field, DataMatrix::ReadInfo& p)
 {
   if ( !*_image ) {
     return 0;
@@ -545,6 +545,11 @@ QStringList Tiff16SourcePlugin::provides() const {
 }
 
 
+QStringList Tiff16SourcePlugin::signatures() const {
+  return QStringList() << "*.tif" << "*.tiff";
+}
+
+
 Kst::DataSourceConfigWidget *Tiff16SourcePlugin::configWidget(QSettings *cfg, const QString& filename) const {
 
   Q_UNUSED(cfg)
@@ -60,7 +60,7 @@ class Tiff16Source : public Kst::DataSource
 class Tiff16SourcePlugin : public QObject, public Kst::DataSourcePluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataSourcePluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataSourcePluginInterface/2.3")
   public:
     virtual ~Tiff16SourcePlugin() {}
 
@@ -105,6 +105,8 @@ class Tiff16SourcePlugin : public QObject, public Kst::DataSourcePluginInterface
 
     virtual QStringList provides() const;
 
+    virtual QStringList signatures() const;
+
     virtual Kst::DataSourceConfigWidget *configWidget(QSettings *cfg, const QString& filename) const;
 };
 
@@ -11,12 +11,14 @@
  ***************************************************************************/
 
 #include "application.h"
+#include "renderserver.h"
 #include "settings.h"
 
 #include <QLibraryInfo>
 #include <QTranslator>
 #include <QLocale>
 #include <QDebug>
+#include <QThread>
 #include <time.h>
 
 #ifdef Q_CC_MSVC
@@ -37,6 +39,23 @@ int main(int argc, char *argv[]) {
 #endif
   bool translator_loaded = false;
 
+  // the render server and its workers never show a window
+  int renderWorkers = -1;
+  bool renderWorker = false;
+  for (int i = 1; i < argc; ++i) {
+    const QByteArray arg(argv[i]);
+    if (arg == "--renderWorker") {
+      renderWorker = true;
+    } else if (arg == "--renderServer") {
+      renderWorkers = 0;
+    } else if (arg.startsWith("--renderServer=")) {
+      renderWorkers = qMax(arg.mid(15).toInt(), 0);
+    }
+  }
+  if (renderWorker || renderWorkers >= 0) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+
   srand(time(NULL));
   Kst::Application app(argc, argv);
 
@@ -65,7 +84,17 @@ int main(int argc, char *argv[]) {
   app.installTranslator(&kstDirectoryTranslator);
 
 
+  if (renderWorkers >= 0) {
+    Kst::RenderServer server(renderWorkers > 0 ? renderWorkers : QThread::idealThreadCount());
+    return server.exec();
+  }
+
+  app.setHeadless(renderWorker);
   app.initMainWindow();
+  if (renderWorker) {
+    Kst::RenderWorker worker(app.mainWindow());
+    return worker.exec();
+  }
   if (app.mainWindow()->initFromCommandLine()) {
     app.mainWindow()->show();
     return app.exec();
@@ -24,8 +24,10 @@
 
 #include "datacollection.h"
 #include "debug.h"
+#include "memorymanager.h"
 #include "objectstore.h"
 #include "matrixscriptinterface.h"
+#include "tracer.h"
 
 
 // xStart, yStart < 0             count from end
@@ -241,10 +243,7 @@ void DataMatrix::doUpdateSkip(int realXStart, int realYStart, int frame) {
   // resize the array if necessary
   int requiredSize = _nX * _nY;
   if (requiredSize != _zSize) {
-    bool resizeOK = resizeZ(requiredSize);
-    if (!resizeOK) {
-      // TODO: Is aborting all we can do?
-      fatalError("Not enough memory for matrix data");
+    if (!resizeForRead(requiredSize)) {
       return;
     }
   }
@@ -319,15 +318,38 @@ void DataMatrix::doUpdateSkip(int realXStart, int realYStart, int frame) {
 }
 
 
+bool DataMatrix::resizeForRead(int sz) {
+  MemoryManager *mm = MemoryManager::self();
+  bool ok;
+  if (!mm->reserve(qint64(sz - _zSize)*sizeof(double))) {
+    Debug::self()->log(tr("Matrix %1 needs %2 MB, which is over the memory limit.  It was not updated.")
+                       .arg(Name()).arg(qint64(sz)*sizeof(double)/(1024*1024)), Debug::Warning);
+    ok = false;
+  } else {
+    ok = resizeZ(sz);
+    if (!ok) {
+      // caches are given back after the update pass, for the next one to use
+      mm->requestRelease();
+      Debug::self()->log(tr("Not enough memory for matrix %1.  It was not updated.").arg(Name()), Debug::Error);
+    }
+  }
+
+  if (!ok) {
+    // keep the dimensions consistent with what is allocated
+    _nX = 1;
+    _nY = qMin(_zSize, 1);
+    _NS = 0;
+  }
+  return ok;
+}
+
+
 void DataMatrix::doUpdateNoSkip(int realXStart, int realYStart, int frame) {
 
   // resize _z if necessary
   int requiredSize = _nX*_nY;
   if (requiredSize != _zSize) {
-    bool resizeOK = resizeZ(requiredSize);
-    if (!resizeOK) {
-      // TODO: Is aborting all we can do?
-      fatalError("Not enough memory for matrix data");
+    if (!resizeForRead(requiredSize)) {
       return;
     }
   }
@@ -736,7 +758,12 @@ QString DataMatrix::propertyString() const {
 int DataMatrix::readMatrix(MatrixData* data, const QString& matrix, int xStart, int yStart, int xNumSteps, int yNumSteps, int skip, int frame)
 {
   ReadInfo p = { data, xStart, yStart, xNumSteps, yNumSteps, skip, frame};
-  return dataSource()->matrix().read(matrix, p);
+
+  TraceSpan span("read", this);
+  const int n_read = dataSource()->matrix().read(matrix, p);
+  span.setSamples(n_read);
+  span.setBytes(qint64(n_read) * qint64(sizeof(double)));
+  return n_read;
 }
 
 
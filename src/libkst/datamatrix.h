@@ -165,6 +165,8 @@ class KSTCORE_EXPORT DataMatrix : public Matrix, public DataPrimitive
     void applyScaling(const MatrixData M);
     void doUpdateSkip(int realXStart, int realYStart, int frame);
     void doUpdateNoSkip(int realXStart, int realYStart, int frame);
+    // resize _z, within the memory limit.  On failure the matrix is left empty.
+    bool resizeForRead(int sz);
 
     virtual void _resetFieldScalars();
     virtual void _resetFieldStrings();
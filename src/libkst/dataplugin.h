@@ -84,6 +84,14 @@ class DataSourcePluginInterface : public PluginInterface {
 
     bool provides(const QString& type) const { return provides().contains(type); }
 
+    /** Cheap tests a file must pass for understands() to take it: file name
+        patterns ("*.mat") and magic bytes ("magic:0:53494d504c45", in hex,
+        at an offset).  They are kept with the plugin cache, so a file that
+        passes none of them is never shown to the plugin, which needn't even
+        be loaded.  None (the default): understands() is asked about every
+        file. */
+    virtual QStringList signatures() const { return QStringList(); }
+
     virtual DataSourceConfigWidget *configWidget(QSettings *cfg, const QString& filename) const = 0;
 };
 
@@ -91,8 +99,10 @@ class DataSourcePluginInterface : public PluginInterface {
 }
 
 
+#define DataSourcePluginInterface_iid "com.kst.DataSourcePluginInterface/2.3"
+
 Q_DECLARE_INTERFACE(Kst::PluginInterface, "com.kst.PluginInterface/2.0")
-Q_DECLARE_INTERFACE(Kst::DataSourcePluginInterface, "com.kst.DataSourcePluginInterface/2.0")
+Q_DECLARE_INTERFACE(Kst::DataSourcePluginInterface, DataSourcePluginInterface_iid)
 
 
 #endif
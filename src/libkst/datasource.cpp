@@ -35,8 +35,10 @@
 
 
 #include "datacollection.h"
+#include "datavector.h"
 #include "debug.h"
 #include "objectstore.h"
+#include "readahead.h"
 #include "scalar.h"
 #include "string.h"
 #include "nextcolor.h"
@@ -55,7 +57,7 @@ template<class T>
 struct NotSupportedImp : public DataSource::DataInterface<T>
 {
   // read one element
-  int read(const QString&, typename T::ReadInfo&) { return -1; }
+  qint64 read(const QString&, typename T::ReadInfo&) { return -1; }
 
   // named elements
   QStringList list() const { return QStringList(); }
@@ -96,6 +98,59 @@ Object::UpdateType DataSource::objectUpdate(qint64 newSerial) {
 }
 
 
+void DataSource::startReadAhead(const QList<ReadAhead::Request> &requests) {
+  if (UpdateManager::self()->paused()) {
+    return;
+  }
+  if (!_readAhead) {
+    _readAhead = new ReadAhead(this);
+  }
+  _readAhead->start(requests, _concurrentUpdate);
+}
+
+
+Object::UpdateType DataSource::collectReadAhead(qint64 newSerial) {
+  if (_serial == newSerial) {
+    return NoChange;
+  }
+  if (UpdateManager::self()->paused() || !_readAhead) {
+    _serial = newSerial;
+    return NoChange;
+  }
+
+  UpdateType updated = NoChange;
+  const int timeout = UpdateManager::self()->readAheadTimeout();
+  if (!_readAhead->collect(timeout, &updated)) {
+    // leave _serial behind, so everything that reads this source waits too
+    if (!_readAheadLate) {
+      Debug::self()->log(tr("%1 did not answer within %2 ms.  It will be updated when it does.")
+                         .arg(_filename).arg(timeout), Debug::Warning);
+      _readAheadLate = true;
+    }
+    return Deferred;
+  }
+  _readAheadLate = false;
+
+  if (updated == Updated) {
+    _serialOfLastChange = newSerial;
+  }
+  _serial = newSerial;
+  return updated;
+}
+
+
+void DataSource::clearReadAhead() {
+  if (_readAhead) {
+    _readAhead->clear();
+  }
+}
+
+
+qint64 DataSource::takeReadAhead(const QString& field, qint64 start, qint64 frames, double *v) const {
+  return _readAhead ? _readAhead->take(field, start, frames, v) : -1;
+}
+
+
 void DataSource::_initializeShortName() {
   _shortName = QString("DS%1").arg(_datasourcenum);
   if (_datasourcenum>max_datasourcenum)
@@ -142,13 +197,16 @@ DataSource::DataSource(ObjectStore *store, QSettings *cfg, const QString& filena
   interf_vector(new NotSupportedImp<DataVector>),
   interf_matrix(new NotSupportedImp<DataMatrix>),
   _watcher(0),
-  _color(NextColor::self().current())
+  _color(NextColor::self().current()),
+  _readAhead(0),
+  _readAheadLate(false)
 {
   Q_UNUSED(type)
   Q_UNUSED(store)
 
   _valid = false;
   _reusable = true;
+  _concurrentUpdate = false;
   _writable = false;
   _watcher = 0L;
 
@@ -159,6 +217,7 @@ DataSource::DataSource(ObjectStore *store, QSettings *cfg, const QString& filena
 }
 
 DataSource::~DataSource() {
+  delete _readAhead;
   resetFileWatcher();
   delete interf_scalar;
   delete interf_string;
@@ -41,6 +41,7 @@ class QFileSystemWatcher;
 namespace Kst {
 
 class DataSourceConfigWidget;
+class ReadAhead;
 //class DataSourcePlugin;
 
 
@@ -72,10 +73,28 @@ class KSTCORE_EXPORT DataSource : public Object
 
       virtual ~DataInterface() {}
       // read data.  The buffer and range info are in ReadInfo
-      virtual int read(const QString& name, typename T::ReadInfo&) = 0;
+      virtual qint64 read(const QString& name, typename T::ReadInfo&) = 0;
       virtual void prepareRead(int number_of_read_calls) {Q_UNUSED(number_of_read_calls)}
       virtual void readingDone() {}
 
+      // one read of a batch; samples is what read() would have returned
+      struct BatchRead {
+        QString name;
+        typename T::ReadInfo info;
+        qint64 samples;
+      };
+
+      // read a batch, typically all the new data of an update.  By default
+      // announced with prepareRead() and read one after the other; sources
+      // that can read in parallel, or in one sweep, should do so.
+      virtual void readBatch(QList<BatchRead>& reads) {
+        prepareRead(reads.size());
+        for (int i = 0; i < reads.size(); ++i) {
+          reads[i].samples = read(reads[i].name, reads[i].info);
+        }
+        readingDone();
+      }
+
       // named elements
       virtual QStringList list() const = 0;
       virtual bool isListComplete() const = 0;
@@ -220,6 +239,25 @@ class KSTCORE_EXPORT DataSource : public Object
     /** Returns true if this file is empty */
     virtual bool isEmpty() const;
 
+    /** true if internalDataSourceUpdate() and vector reads may run in a
+        worker thread, at the same time as the updates of other sources.
+        Such sources are updated through a ReadAhead, under the read lock:
+        what they tell other readers (lists, data info) has to be kept
+        consistent while they run. */
+    bool supportsConcurrentUpdate() const { return _concurrentUpdate; }
+
+    /** the read ahead stage, used by the UpdateManager for every source:
+        those that don't support concurrent update run it in the calling
+        thread.  requests are those of the vectors reading this source.
+        collectReadAhead() stands in for objectUpdate(), and is called
+        without the lock: the job holds it. */
+    void startReadAhead(const QList<ReadAhead::Request> &requests);
+    UpdateType collectReadAhead(qint64 newSerial);
+    void clearReadAhead();
+
+    /** frames staged by the read ahead, or -1; see ReadAhead::take() */
+    qint64 takeReadAhead(const QString& field, qint64 start, qint64 frames, double *v) const;
+
     /** Reset to initial state of the source, just as though no data had been
      *  read and the file had just been opened.
      */
@@ -255,6 +293,9 @@ class KSTCORE_EXPORT DataSource : public Object
 
     bool _writable;
 
+    /** set by sources whose updates only touch their own state */
+    bool _concurrentUpdate;
+
     /** The filename.  Populated by the base class constructor.  */
     QString _filename;
 
@@ -292,6 +333,9 @@ class KSTCORE_EXPORT DataSource : public Object
 
     QColor _color;
 
+    ReadAhead *_readAhead;
+    bool _readAheadLate;
+
     // NOTE: You must bump the version key if you add new member variables
     //       or change or add virtual functions.
 };
@@ -38,6 +38,7 @@
 #include "updatemanager.h"
 #include "settings.h"
 #include "dataplugin.h"
+#include "pluginregistry.h"
 
 #define DATASOURCE_UPDATE_TIMER_LENGTH 1000
 
@@ -94,16 +95,50 @@ void DataSourcePluginManager::init() {
 
 
 
+// What the plugin lists need to know of a data source plugin, kept in the
+// plugin cache: the plugin itself is only loaded when it is first asked
+// about a file.
+static bool describePlugin(QObject *object, QVariantMap *info)
+{
+  DataSourcePluginInterface *ds = qobject_cast<DataSourcePluginInterface*>(object);
+  if (!ds) {
+    return false;
+  }
+  info->insert("name", ds->pluginName());
+  info->insert("provides", ds->provides());
+  info->insert("signatures", ds->signatures());
+  info->insert("configWidget", ds->hasConfigWidget());
+  return true;
+}
+
+
 struct FoundPlugin
 {
-  FoundPlugin(const SharedPtr<DataSourcePluginInterface>& plug, const QString& path) :
-    plugin(plug),
-    filePath(path)
+  FoundPlugin(const QString& path, const QVariantMap& info) :
+    filePath(path),
+    name(info.value("name").toString()),
+    types(info.value("provides").toStringList()),
+    signatures(info.value("signatures").toStringList()),
+    configWidget(info.value("configWidget").toBool()),
+    failed(false)
    {}
 
+  DataSourcePluginInterface *instance() {
+    if (!plugin && !failed) {
+      plugin = qobject_cast<DataSourcePluginInterface*>(PluginRegistry::load(filePath));
+      failed = !plugin;
+    }
+    return plugin.data();
+  }
+
   SharedPtr<DataSourcePluginInterface> plugin;
   // TODO add filepath to PluginInterface
   QString filePath;
+  QString name;
+  QStringList types;
+  QStringList signatures;
+  bool configWidget;
+  bool failed;
 };
 
 typedef QList<FoundPlugin> PluginList;
@@ -151,34 +186,16 @@ static void scanPlugins() {
 
   foreach (QObject *plugin, QPluginLoader::staticInstances()) {
     //try a cast
-    if (DataSourcePluginInterface *ds = qobject_cast<DataSourcePluginInterface*>(plugin)) {
-      tmpList.append(FoundPlugin(ds, ""));
+    QVariantMap info;
+    if (describePlugin(plugin, &info)) {
+      FoundPlugin found("", info);
+      found.plugin = qobject_cast<DataSourcePluginInterface*>(plugin);
+      tmpList.append(found);
     }
   }
 
-  QStringList pluginPaths = pluginSearchPaths();
-  foreach (const QString& pluginPath, pluginPaths) {
-    QDir d(pluginPath);
-    foreach (const QString &fileName, d.entryList(QDir::Files)) {
-        if (!fileName.startsWith(QLatin1String("libdatasource")))
-            continue;
-#ifdef Q_OS_WIN
-        if (!fileName.endsWith(QLatin1String(".dll")))
-            continue;
-#endif
-        QPluginLoader loader(d.absoluteFilePath(fileName));
-        QObject *plugin = loader.instance();
-        if (plugin) {
-          if (DataSourcePluginInterface *ds = qobject_cast<DataSourcePluginInterface*>(plugin)) {
-
-            tmpList.append(FoundPlugin(ds, d.absoluteFilePath(fileName)));
-            Debug::self()->log(DataSource::tr("Plugin loaded: %1").arg(fileName));
-          }
-        } else {
-            Debug::self()->log(DataSource::tr("instance failed for %1 (%2)").arg(fileName).arg(loader.errorString()));
-            qDebug() << "Plugin load failed for" << fileName << ":" << loader.errorString();
-        }
-    }
+  foreach (const PluginRegistry::Entry& entry, PluginRegistry::scan("datasource", DataSourcePluginInterface_iid, "libdatasource", describePlugin)) {
+    tmpList.append(FoundPlugin(entry.path, entry.info));
   }
 
   // This cleans up plugins that have been uninstalled and adds in new ones.
@@ -200,7 +217,7 @@ QStringList DataSourcePluginManager::pluginList() {
 
   QStringList plugins;
   for (PluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
-    plugins += (*it).plugin->pluginName();
+    plugins += (*it).name;
   }
 
   return plugins;
@@ -210,7 +227,7 @@ QStringList DataSourcePluginManager::pluginList() {
 QString DataSourcePluginManager::pluginFileName(const QString& pluginName)
 {
   for (PluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
-    if (it->plugin->pluginName() == pluginName) {
+    if (it->name == pluginName) {
       return it->filePath;
     }
   }
@@ -232,12 +249,10 @@ QList<DataSourcePluginManager::PluginSortContainer> DataSourcePluginManager::bes
   QList<PluginSortContainer> bestPlugins;
   DataSourcePluginManager::init();
 
-  PluginList info = _pluginList;
-
   if (!type.isEmpty()) {
-    for (PluginList::Iterator it = info.begin(); it != info.end(); ++it) {
-      if (DataSourcePluginInterface *p = (*it).plugin.data()) {
-        if (p->provides(type)) {
+    for (PluginList::Iterator it = _pluginList.begin(); it != _pluginList.end(); ++it) {
+      if ((*it).types.contains(type)) {
+        if (DataSourcePluginInterface *p = (*it).instance()) {
           PluginSortContainer psc;
           psc.match = 100;
           psc.plugin = p;
@@ -248,9 +263,14 @@ QList<DataSourcePluginManager::PluginSortContainer> DataSourcePluginManager::bes
     }
   }
 
-  for (PluginList::Iterator it = info.begin(); it != info.end(); ++it) {
+  // plugins whose signatures the file fails wouldn't take it
+  PluginRegistry::Probe probe(filename);
+  for (PluginList::Iterator it = _pluginList.begin(); it != _pluginList.end(); ++it) {
     PluginSortContainer psc;
-    if (DataSourcePluginInterface *p = (*it).plugin.data()) {
+    if (!PluginRegistry::matches((*it).signatures, &probe)) {
+      continue;
+    }
+    if (DataSourcePluginInterface *p = (*it).instance()) {
       if ((psc.match = p->understands(&settingsObject(), filename)) > 0) {
         psc.plugin = p;
         bestPlugins.append(psc);
@@ -368,10 +388,12 @@ bool DataSourcePluginManager::validSource(const QString& filename) {
 
   DataSourcePluginManager::init();
 
-  PluginList info = _pluginList;
-
-  for (PluginList::Iterator it = info.begin(); it != info.end(); ++it) {
-    if (DataSourcePluginInterface *p = (*it).plugin.data()) {
+  PluginRegistry::Probe probe(filename);
+  for (PluginList::Iterator it = _pluginList.begin(); it != _pluginList.end(); ++it) {
+    if (!PluginRegistry::matches((*it).signatures, &probe)) {
+      continue;
+    }
+    if (DataSourcePluginInterface *p = (*it).instance()) {
       if ((p->understands(&settingsObject(), filename)) > 0) {
         return true;
       }
@@ -386,11 +408,9 @@ bool DataSourcePluginManager::validSource(const QString& filename) {
 bool DataSourcePluginManager::pluginHasConfigWidget(const QString& plugin) {
   initPlugins();
 
-  PluginList info = _pluginList;
-
-  for (PluginList::ConstIterator it = info.constBegin(); it != info.constEnd(); ++it) {
-    if ((*it).plugin->pluginName() == plugin) {
-      return (*it).plugin->hasConfigWidget();
+  for (PluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
+    if ((*it).name == plugin) {
+      return (*it).configWidget;
     }
   }
 
@@ -401,11 +421,9 @@ bool DataSourcePluginManager::pluginHasConfigWidget(const QString& plugin) {
 DataSourceConfigWidget* DataSourcePluginManager::configWidgetForPlugin(const QString& plugin) {
   initPlugins();
 
-  PluginList info = _pluginList;
-
-  for (PluginList::Iterator it = info.begin(); it != info.end(); ++it) {
-    if (DataSourcePluginInterface *p = (*it).plugin.data()) {
-      if (p->pluginName() == plugin) {
+  for (PluginList::Iterator it = _pluginList.begin(); it != _pluginList.end(); ++it) {
+    if ((*it).name == plugin) {
+      if (DataSourcePluginInterface *p = (*it).instance()) {
         return p->configWidget(&settingsObject(), QString());
       }
     }
@@ -29,7 +29,10 @@
 #include "debug.h"
 #include "datasource.h"
 #include "math_kst.h"
+#include "memorymanager.h"
 #include "objectstore.h"
+#include "samplebuffer.h"
+#include "tracer.h"
 #include "updatemanager.h"
 #include "vectorscriptinterface.h"
 
@@ -46,6 +49,9 @@ const QString DataVector::staticTypeTag = "datavector";
 
 //const int INVALIDS_PER_RESET = 5;
 
+// largest number of samples staged at once when reading into compact storage
+const int MAX_STAGE_SAMPLES = 1<<20;
+
 DataVector::DataInfo::DataInfo() :
     frameCount(-1),
     samplesPerFrame(-1)
@@ -72,6 +78,10 @@ DataVector::DataVector(ObjectStore *store)
   N_AveReadBuf = 0;
   AveReadBuf = 0L;
 
+  _storageMode = DoubleStorage;
+  N_StageBuf = 0;
+  StageBuf = 0L;
+
   ReqF0 = 0;
   ReqNF = 0;
   _countFromEnd = false;
@@ -79,6 +89,8 @@ DataVector::DataVector(ObjectStore *store)
   Skip = 1;
   DoSkip = false;
   DoAve = false;
+  _readSkip = 0;
+  _budgetWarned = 0;
   _invalidCount = 0;
 }
 
@@ -241,6 +253,10 @@ DataVector::~DataVector() {
     free(AveReadBuf);
     AveReadBuf = 0L;
   }
+  if (StageBuf) {
+    free(StageBuf);
+    StageBuf = 0L;
+  }
 }
 
 
@@ -264,6 +280,23 @@ bool DataVector::reqReadToEnd() const {
 }
 
 
+DataVector::StorageMode DataVector::storageMode() const {
+  return _storageMode;
+}
+
+
+void DataVector::setStorageMode(StorageMode mode) {
+  Q_ASSERT(myLockStatus() == KstRWLock::WRITELOCKED);
+
+  if (mode == _storageMode) {
+    return;
+  }
+  _storageMode = mode;
+  setCompact(mode == CompactStorage);
+  registerChange();
+}
+
+
 /** Return Starting Frame of Vector */
 double DataVector::startFrame() const {
   return F0;
@@ -327,6 +360,10 @@ void DataVector::save(QXmlStreamWriter &s) {
     s.writeAttribute("startUnits", startUnits());
     s.writeAttribute("rangeUnits", rangeUnits());
 
+    if (_storageMode == CompactStorage) {
+      s.writeAttribute("storage", "compact");
+    }
+
     saveNameInfo(s, VECTORNUM|SCALARNUM);
     s.writeEndElement();
   }
@@ -443,8 +480,9 @@ bool DataVector::checkIntegrity() {
 //     frame 0, Skip, 2*Skip... N*skip, and never M*Skip+1.
 
 void DataVector::internalUpdate() {
-  int i, k, shift, n_read=0;
-  int ave_nread;
+  qint64 i, shift, n_read=0;
+  qint64 ave_nread;
+  int k;
   double new_f0, new_nf;
   bool start_past_eof = false;
 
@@ -466,6 +504,14 @@ void DataVector::internalUpdate() {
     DoSkip = false;
   }
 
+  // what is left as it was at the last change, for incremental consumers
+  const qint64 unchangedSince = _serialOfLastChange;
+  const QString storage = storageTypeName();
+  qint64 unchanged = _numSamples;
+
+  // a window at the end of a growing file moves forward every update
+  setSlidingWindow(_countFromEnd);
+
   // set new_nf and new_f0
   double fc = info.frameCount;
   if (_readToEnd) { // read to end of file
@@ -491,56 +537,80 @@ void DataVector::internalUpdate() {
     }
   }
 
-  if (DoSkip) {
+  // Over the memory limit, 1 sample is read every skip frames for as long
+  // as it has to be.  Skip and DoSkip, which are saved, are left as asked.
+  int skip = DoSkip ? Skip : 1;
+  if (!start_past_eof) {
+    skip = budgetSkip(new_nf, skip);
+  }
+  const bool doSkip = DoSkip || skip > 1;
+  if (skip != _readSkip) {
+    if (_readSkip != 0) {
+      reset();
+      unchanged = 0;
+    }
+    _readSkip = skip;
+  }
+
+  if (doSkip) {
     // in count from end mode, change new_f0 and new_nf so they both lie on skip boundaries
     if ((new_f0 != 0) && _countFromEnd) {
-      new_f0 = ((new_f0-1)/Skip+1)*Skip;
+      new_f0 = ((new_f0-1)/skip+1)*skip;
     }
-    new_nf = (new_nf/Skip)*Skip;
+    new_nf = (new_nf/skip)*skip;
   }
 
   // shift vector if necessary
   if ((NF>new_nf) || new_f0 < F0 || new_f0 >= F0 + NF) { // No useful data around.
     reset();
+    unchanged = 0;
   } else { // shift stuff rather than re-read
-    if (DoSkip) {
-      shift = (int)((new_f0 - F0)/Skip);
+    if (doSkip) {
+      shift = (qint64)((new_f0 - F0)/skip);
       NF -= (new_f0 - F0);
-      _numSamples = (int)(NF/Skip);
+      _numSamples = (qint64)(NF/skip);
     } else {
-      shift = (int)(SPF*(new_f0 - F0));
+      shift = (qint64)(SPF*(new_f0 - F0));
       NF -= (new_f0 - F0);
       //_numSamples = (NF-1)*SPF;
       if (shift > 0) {
         if (SPF == 1) {
-          _numSamples = (int)NF;
+          _numSamples = (qint64)NF;
         } else {
-          _numSamples = (int)((NF-1)*SPF);
+          _numSamples = (qint64)((NF-1)*SPF);
         }
       }
     }
 
-    memmove(_v_raw, _v_raw+shift, _numSamples*sizeof(double));
+    dropFront(shift, _numSamples);
+    if (shift != 0) {
+      unchanged = 0;
+    } else if (!doSkip && SPF > 1) {
+      // the last frame is read again
+      unchanged = qMin(unchanged, qint64(qMax(NF - 1.0, 0.0)*SPF));
+    }
+    unchanged = qMin(unchanged, _numSamples);
   }
 
-  if (DoSkip) {
+  if (doSkip) {
     // reallocate V if necessary
-    if ((int)(new_nf / Skip) != _size) {
-      if (! resize((int)(new_nf/Skip))) {
-        // TODO: Is aborting all we can do?
-        fatalError("Not enough memory for vector data");
+    if ((qint64)(new_nf / skip) != _size) {
+      if (!resizeForRead((qint64)(new_nf/skip))) {
+        if (dataSource()) {
+          dataSource()->unlock();
+        }
         return;
       }
     }
     n_read = 0;
     /** read each sample from the File */
-    double *t = _v_raw + _numSamples;
-    int new_nf_Skip = (int)(new_nf - Skip);
+    qint64 t = _numSamples;
+    qint64 new_nf_Skip = (qint64)(new_nf - skip);
     if (DoAve) {
-      for (i = (int)NF; new_nf_Skip >= i; i += Skip) {
+      for (i = (qint64)NF; new_nf_Skip >= i; i += skip) {
         /* enlarge AveReadBuf if necessary */
-        if (N_AveReadBuf < Skip*SPF) {
-          N_AveReadBuf = Skip*SPF;
+        if (N_AveReadBuf < skip*SPF) {
+          N_AveReadBuf = skip*SPF;
           if (!kstrealloc(AveReadBuf, N_AveReadBuf*sizeof(double))) {
             qCritical() << "Vector resize failed";
           }
@@ -548,51 +618,52 @@ void DataVector::internalUpdate() {
             // FIXME: handle failed resize
           }
         }
-        ave_nread = readField(AveReadBuf, _field, new_f0+i, Skip);
+        ave_nread = readField(AveReadBuf, _field, new_f0+i, skip);
         for (k = 1; k < ave_nread; ++k) {
           AveReadBuf[0] += AveReadBuf[k];
         }
         if (ave_nread > 0) {
-          *t = AveReadBuf[0]/double(ave_nread);
+          storeSample(t, AveReadBuf[0]/double(ave_nread));
           n_read++;
         }
         ++t;
       }
     } else {
-      for (i = (int)NF; new_nf_Skip >= i; i += Skip) {
-        n_read += readField(t++, _field, new_f0 + i, 1, -1, true);
+      for (i = (qint64)NF; new_nf_Skip >= i; i += skip) {
+        n_read += readFieldAt(t++, _field, new_f0 + i, 1, true);
       }
     }
   } else {
     // reallocate V if necessary
-    if ((int)((new_nf - 1)*SPF + 1) != _size) {
-      if (!resize((int)((new_nf - 1)*SPF + 1))) {
-        // TODO: Is aborting all we can do?
-        fatalError("Not enough memory for vector data");
+    if ((qint64)((new_nf - 1)*SPF + 1) != _size) {
+      if (!resizeForRead((qint64)((new_nf - 1)*SPF + 1))) {
+        if (dataSource()) {
+          dataSource()->unlock();
+        }
         return;
       }
     }
 
     // read the new data from file
     if (start_past_eof) {
-      _v_raw[0] = NOPOINT;
+      storeSample(0, NOPOINT);
       n_read = 1;
     } else if (info.samplesPerFrame > 1) {
       if (NF>0) {
         NF--;  /* last frame read was only partially read... */
       }
-      int safe_nf = (int)(new_nf>0 ? new_nf : 0);
+      qint64 safe_nf = (qint64)(new_nf>0 ? new_nf : 0);
 
       assert(new_f0 + NF >= 0);
       //assert(new_f0 + safe_nf - 1 >= 0);
       if ((new_f0 + safe_nf - 1 >= 0) && (safe_nf - NF > 1)) {
-        n_read = readField(_v_raw+(qint64)(NF*SPF), _field, new_f0 + NF, safe_nf - NF - 1);
-        n_read += readField(_v_raw+(qint64)((safe_nf-1)*SPF), _field, new_f0 + safe_nf - 1, 1, -1, true);
+        n_read = readFieldAt((qint64)(NF*SPF), _field, new_f0 + NF, safe_nf - NF - 1);
+        n_read += readFieldAt((qint64)((safe_nf-1)*SPF), _field, new_f0 + safe_nf - 1, 1, true);
       }
     } else {
       assert(new_f0 + NF >= 0);
       if (new_nf - NF > 0 || new_nf - NF == -1) {
-        n_read = readField(_v_raw+(qint64)(NF*SPF), _field, new_f0 + NF, new_nf - NF);
+        n_read = readFieldAt((qint64)(NF*SPF), _field, new_f0 + NF, new_nf - NF);
       }
     }
   }
@@ -611,11 +682,19 @@ void DataVector::internalUpdate() {
   _dirty = false;
   if (_numSamples != _size && !(_numSamples == 0 && _size == 1)) {
     _dirty = true;
-    for (i = _numSamples; i < _size; ++i) {
-      _v_raw[i] = _v_raw[0];
+    if (_compact) {
+      _compact->fill(_numSamples, _size - _numSamples, _compact->at(0));
+    } else {
+      for (i = _numSamples; i < _size; ++i) {
+        _v_raw[i] = _v_raw[0];
+      }
     }
   }
 
+  if (_compact) {
+    _compactExpanded.storeRelaxed(0);
+  }
+
   if (_numNew > _size) {
     _numNew = _size;
   }
@@ -623,6 +702,12 @@ void DataVector::internalUpdate() {
     _numShifted = _size;
   }
 
+  if (start_past_eof || storageTypeName() != storage) {
+    unchanged = 0;
+  }
+  _numUnchanged = qMin(unchanged, _size);
+  _numUnchangedSince = unchangedSince;
+
   if (dataSource()) {
     dataSource()->unlock();
   }
@@ -632,6 +717,51 @@ void DataVector::internalUpdate() {
   }
 }
 
+// The skip to read nf frames with: the one asked for, or a larger one if
+// the samples it gives would go over the memory limit.  Worked out again
+// every update, so that the vector is read in full again once there is
+// room for it.
+int DataVector::budgetSkip(double nf, int skip) {
+  MemoryManager *mm = MemoryManager::self();
+  if (mm->ceiling() <= 0 || nf <= 0) {
+    _budgetWarned = 0;
+    return skip;
+  }
+
+  const qint64 bytesPerSample = _compact ? SampleBuffer::typeSize(_compact->type()) : sizeof(double);
+  const double samples = (DoSkip || skip > 1) ? nf/skip : (nf - 1)*SPF + 1;
+  const qint64 held = memoryUsage();
+  const qint64 needed = qint64(samples)*bytesPerSample;
+  int budget = skip;
+  if (needed > held && !mm->reserve(needed - held)) {
+    const qint64 maxSamples = qMax((mm->available() + held)/bytesPerSample, qint64(2));
+    budget = qMax((int)ceil(nf/double(maxSamples)), skip + 1);
+  }
+
+  if (budget != skip && budget != _budgetWarned) {
+    Debug::self()->log(tr("Vector %1 needs %2 MB, which is over the memory limit.  Reading 1 sample every %3 frames until there is room.")
+                       .arg(Name()).arg(needed/(1024*1024)).arg(budget), Debug::Warning);
+  } else if (budget == skip && _budgetWarned != 0) {
+    Debug::self()->log(tr("Vector %1 fits under the memory limit again.").arg(Name()));
+  }
+  _budgetWarned = (budget != skip) ? budget : 0;
+  return budget;
+}
+
+
+bool DataVector::resizeForRead(qint64 sz) {
+  // the new samples are read right away: blanking them first would only
+  // promote compact storage to float32
+  if (resize(sz, !isCompact())) {
+    return true;
+  }
+  // caches are given back after the update pass, for the next one to use
+  MemoryManager::self()->requestRelease();
+  Debug::self()->log(tr("Not enough memory for vector %1 (%2 samples).  It was not updated.").arg(Name()).arg(sz), Debug::Error);
+  return false;
+}
+
+
 QByteArray DataVector::scriptInterface(QList<QByteArray> &c)
 {
   Q_ASSERT(c.size());
@@ -669,6 +799,8 @@ QByteArray DataVector::scriptInterface(QList<QByteArray> &c)
     return QByteArray(descriptionTip().toLatin1());
   } else if(c[0]=="isValid") {
     return isValid()?"true":"false";
+  } else if(c[0]=="storageType") {
+    return storageTypeName().toLatin1();
   }
 
   return "No such command...";
@@ -788,6 +920,7 @@ PrimitivePtr DataVector::makeDuplicate() const {
 
   vector->writeLock();
   vector->change(dataSource(), _field, ReqF0, _countFromEnd, ReqNF, _readToEnd, Skip, DoSkip, DoAve);
+  vector->setStorageMode(_storageMode);
   if (descriptiveNameIsManual()) {
     vector->setDescriptiveName(descriptiveName());
   }
@@ -844,7 +977,7 @@ QString DataVector::propertyString() const {
 }
 
 
-int DataVector::readField(double *v, const QString& field, double s, double n, double skip, bool singleSample)
+qint64 DataVector::readField(double *v, const QString& field, double s, double n, double skip, bool singleSample)
 {
   ReadInfo par;
   par.data = v;
@@ -854,9 +987,94 @@ int DataVector::readField(double *v, const QString& field, double s, double n, d
   par.numberOfFrames = singleSample ? -1 : n;
   par.skipFrame = skip;
   par.singleSample = singleSample;
-  return dataSource()->vector().read(field, par);
+
+  TraceSpan span("read", this);
+  qint64 n_read = -1;
+  if (!singleSample && skip < 0 && n > 0 && SPF == 1) {
+    n_read = dataSource()->takeReadAhead(field, qint64(s), qint64(n), v);
+  }
+  if (n_read < 0) {
+    n_read = dataSource()->vector().read(field, par);
+  }
+  span.setSamples(n_read);
+  span.setBytes(n_read * qint64(sizeof(double)));
+  return n_read;
 }
 
+// Read directly into _v_raw, or for compact vectors, through a bounded
+// staging buffer so a full double copy of the field never exists.
+qint64 DataVector::readFieldAt(qint64 pos, const QString& field, double s, double n, bool singleSample)
+{
+  if (!_compact) {
+    return readField(_v_raw + pos, field, s, n, -1, singleSample);
+  }
+
+  if (singleSample || n < 0) {
+    double v;
+    qint64 nr = readField(&v, field, s, n, -1, singleSample);
+    if (nr > 0) {
+      _compact->write(pos, &v, 1);
+    }
+    return nr;
+  }
+
+  const int spf = qMax(SPF, 1);
+  const double chunk_frames = qMax(MAX_STAGE_SAMPLES/spf, 1);
+  if (N_StageBuf < chunk_frames*spf) {
+    if (!kstrealloc(StageBuf, qint64(chunk_frames*spf)*sizeof(double))) {
+      qCritical() << "Vector staging buffer allocation failed";
+      return 0;
+    }
+    N_StageBuf = chunk_frames*spf;
+  }
+
+  qint64 total = 0;
+  double remaining = n;
+  while (remaining > 0) {
+    const double nf = qMin(remaining, chunk_frames);
+    qint64 nr = readField(StageBuf, field, s, nf);
+    if (nr <= 0) {
+      break;
+    }
+    nr = qMin(nr, _compact->length() - pos - total);
+    _compact->write(pos + total, StageBuf, nr);
+    total += nr;
+    if (nr < nf*spf) {
+      break;
+    }
+    s += nf;
+    remaining -= nf;
+  }
+  return total;
+}
+
+
+void DataVector::storeSample(qint64 pos, double value)
+{
+  if (_compact) {
+    _compact->write(pos, &value, 1);
+  } else {
+    _v_raw[pos] = value;
+  }
+}
+
+
+bool DataVector::readAheadRequest(ReadAhead::Request &r) const
+{
+  if (!(_readToEnd || _countFromEnd) || DoSkip || _readSkip > 1 || SPF != 1) {
+    return false;
+  }
+  r.field = _field;
+  r.f0 = F0;
+  r.nf = NF;
+  r.reqF0 = ReqF0;
+  r.reqNF = ReqNF;
+  r.readToEnd = _readToEnd;
+  r.countFromEnd = _countFromEnd;
+  return true;
+}
+
+
 const DataVector::DataInfo DataVector::dataInfo(const QString& field) const
 {
   dataSource()->readLock();
@@ -20,6 +20,7 @@
 
 #include "kstcore_export.h"
 #include "dataprimitive.h"
+#include "readahead.h"
 #include "vector.h"
 
 
@@ -62,6 +63,13 @@ class KSTCORE_EXPORT DataVector : public Vector, public DataPrimitive
       int samplesPerFrame;
     };
 
+    /** How the samples are held in memory.
+      DoubleStorage: one double per sample (the default)
+      CompactStorage: the narrowest of int16, int32, float32 or double which
+        holds every sample read exactly.  Consumers see the same values.
+     */
+    enum StorageMode { DoubleStorage = 0, CompactStorage };
+
 
 
     virtual QString typeString() const;
@@ -108,6 +116,9 @@ class KSTCORE_EXPORT DataVector : public Vector, public DataPrimitive
     /** Reload the contents of the vector */
     void reload();                                              //si
 
+    StorageMode storageMode() const;
+    void setStorageMode(StorageMode mode); // must be called with a lock
+
     /** Returns intrinsic samples per frame */
     int samplesPerFrame() const;                                //si
 
@@ -142,6 +153,10 @@ class KSTCORE_EXPORT DataVector : public Vector, public DataPrimitive
     /** does the vector represent ctime? */
     virtual bool isCTime() const;
 
+    /** what the source's read ahead needs to stage this vector's next
+        frames; false if it can't (skipping, or a fixed range) */
+    bool readAheadRequest(ReadAhead::Request &r) const;
+
     virtual ScriptInterface* createScriptInterface();
 
   protected:
@@ -177,6 +192,11 @@ class KSTCORE_EXPORT DataVector : public Vector, public DataPrimitive
     bool DoAve;
     int Skip;
 
+    /** the skip the samples held were read with: Skip, or more to keep under
+        the memory limit; 0 before the first read.  Not saved. */
+    int _readSkip;
+    int _budgetWarned;
+
     /** max number of frames */
     double ReqNF;
 
@@ -190,15 +210,29 @@ class KSTCORE_EXPORT DataVector : public Vector, public DataPrimitive
     bool _readToEnd;
 
     /** Number of Samples allocated to the vector */
-    int _numSamples;
+    qint64 _numSamples;
 
     int N_AveReadBuf;
     double *AveReadBuf;
 
+    StorageMode _storageMode;
+
+    /** staging buffer for reads into compact storage */
+    int N_StageBuf;
+    double *StageBuf;
+
     bool checkIntegrity(); // must be called with a lock
 
+    // the skip, at least skip, that keeps nf frames under the memory limit
+    int budgetSkip(double nf, int skip);
+    // resize, freeing caches and retrying on failure
+    bool resizeForRead(qint64 sz);
+
     // wrappers around DataSource interface functions
-    int readField(double *v, const QString& field, double s, double n, double skip = -1, bool singleSample = false);
+    qint64 readField(double *v, const QString& field, double s, double n, double skip = -1, bool singleSample = false);
+    // read into the vector starting at sample pos, for either storage mode
+    qint64 readFieldAt(qint64 pos, const QString& field, double s, double n, bool singleSample = false);
+    void storeSample(qint64 pos, double value);
     const DataInfo dataInfo(const QString& field) const;
 
     QHash<QString, ScalarPtr> _fieldScalars;
@@ -50,7 +50,7 @@ void EditableVector::setSaveData(bool save) {
   Q_UNUSED(save)
 }
 
-void EditableVector::setValue(const int &i, const double &val) { //sa Vector::change(...)
+void EditableVector::setValue(const qint64 &i, const double &val) { //sa Vector::change(...)
     writeLock();
     Q_ASSERT(i>=0);
     if(i>_size) {
@@ -78,7 +78,7 @@ void EditableVector::save(QXmlStreamWriter &s) {
     QByteArray qba(length()*sizeof(double), '\0');
     QDataStream qds(&qba, QIODevice::WriteOnly);
 
-    for (int i = 0; i < length(); i++) {
+    for (qint64 i = 0; i < length(); i++) {
       qds << _v_raw[i];
     }
 
@@ -40,7 +40,7 @@ class KSTCORE_EXPORT EditableVector : public Vector {
     /** If value exceeds length, vector is resized
       * @sa Vector::change()
       */
-    void setValue(const int& i,const double&val);
+    void setValue(const qint64& i,const double&val);
 
     virtual QString descriptionTip() const;
 
@@ -56,7 +56,7 @@ void GeneratedVector::save(QXmlStreamWriter &s) {
 }
 
 
-void GeneratedVector::changeRange(double x0, double x1, int n) {
+void GeneratedVector::changeRange(double x0, double x1, qint64 n) {
   if (n < 2) {
     n = 2;
   }
@@ -64,7 +64,7 @@ void GeneratedVector::changeRange(double x0, double x1, int n) {
     resize(n, false);
   }
 
-  for (int i = 0; i < n; i++) {
+  for (qint64 i = 0; i < n; i++) {
     _v_raw[i] = x0 + double(i) * (x1 - x0) / double(n - 1);
   }
 
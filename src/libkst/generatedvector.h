@@ -36,7 +36,7 @@ class KSTCORE_EXPORT GeneratedVector : public Vector {
 
     void save(QXmlStreamWriter &s);
 
-    void changeRange(double x0, double x1, int n);
+    void changeRange(double x0, double x1, qint64 n);
     void setSaveData(bool save);
 
     virtual QString descriptionTip() const;
@@ -0,0 +1,297 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "livestream.h"
+
+#include "debug.h"
+#include "math_kst.h"
+
+#include <QElapsedTimer>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+#include <string.h>
+
+namespace Kst {
+
+static const char Magic[] = "KSTLIVE1";
+static const int MagicBytes = 8;
+static const int FixedBytes = MagicBytes + 2*sizeof(quint32);
+
+
+QByteArray LiveStream::header(const QStringList &fields) {
+  const quint32 count = fields.count();
+  const quint32 reserved = 0;
+
+  QByteArray h(Magic, MagicBytes);
+  h.append(reinterpret_cast<const char*>(&count), sizeof(count));
+  h.append(reinterpret_cast<const char*>(&reserved), sizeof(reserved));
+  foreach (const QString &field, fields) {
+    QByteArray name = field.toUtf8().left(NameBytes - 1);
+    name.append(QByteArray(NameBytes - name.size(), '\0'));
+    h.append(name);
+  }
+  return h;
+}
+
+
+int LiveStream::parseHeader(const QByteArray &data, QStringList *fields) {
+  if (data.size() < MagicBytes) {
+    return QByteArray(Magic, MagicBytes).startsWith(data) ? 0 : -1;
+  }
+  if (!data.startsWith(QByteArray(Magic, MagicBytes))) {
+    return -1;
+  }
+  if (data.size() < FixedBytes) {
+    return 0;
+  }
+
+  quint32 count;
+  memcpy(&count, data.constData() + MagicBytes, sizeof(count));
+  if (count == 0 || count > quint32(MaxFields)) {
+    return -1;
+  }
+  const int size = FixedBytes + count*NameBytes;
+  if (data.size() < size) {
+    return 0;
+  }
+
+  fields->clear();
+  for (quint32 i = 0; i < count; ++i) {
+    const char *name = data.constData() + FixedBytes + i*NameBytes;
+    fields->append(QString::fromUtf8(name, qstrnlen(name, NameBytes)));
+  }
+  return size;
+}
+
+
+LiveHistory::LiveHistory(qint64 capacity)
+  : _capacity(qMax(capacity, qint64(1))), _frames(0) {
+}
+
+
+void LiveHistory::reset(const QStringList &fields) {
+  QMutexLocker locker(&_mutex);
+  _fields = fields;
+  _rings.clear();
+  _rings.resize(fields.count());
+  _frames = 0;
+}
+
+
+QStringList LiveHistory::fields() const {
+  QMutexLocker locker(&_mutex);
+  return _fields;
+}
+
+
+qint64 LiveHistory::frames() const {
+  QMutexLocker locker(&_mutex);
+  return _frames;
+}
+
+
+// Frames come in a field after another; each field goes to its own ring,
+// so that reads of it are contiguous.
+void LiveHistory::append(const double *frames, qint64 count) {
+  QMutexLocker locker(&_mutex);
+  const int n = _rings.count();
+  for (int f = 0; f < n; ++f) {
+    QVector<double> &ring = _rings[f];
+    qint64 slot = _frames % _capacity;
+    const double *in = frames + f;
+    for (qint64 i = 0; i < count; ++i, in += n) {
+      if (slot == ring.size()) {
+        ring.append(*in);
+      } else {
+        ring[slot] = *in;
+      }
+      if (++slot == _capacity) {
+        slot = 0;
+      }
+    }
+  }
+  _frames += count;
+}
+
+
+qint64 LiveHistory::read(int field, qint64 start, qint64 count, double *v) const {
+  QMutexLocker locker(&_mutex);
+  if (field < 0 || field >= _rings.count()) {
+    return -1;
+  }
+  start = qMax(start, qint64(0));
+  const qint64 end = qMin(start + count, _frames);
+  if (end <= start) {
+    return 0;
+  }
+
+  qint64 f = start;
+  const qint64 kept = qMax(_frames - _capacity, qint64(0));
+  for (; f < qMin(kept, end); ++f) {
+    *v++ = NOPOINT;
+  }
+
+  // at most two spans: up to the end of the ring, and on from its start
+  const double *ring = _rings[field].constData();
+  while (f < end) {
+    const qint64 slot = f % _capacity;
+    const qint64 n = qMin(end - f, _capacity - slot);
+    memcpy(v, ring + slot, n*sizeof(double));
+    v += n;
+    f += n;
+  }
+  return end - start;
+}
+
+
+LiveStreamReader::LiveStreamReader(const QString &server, qint64 capacity, QObject *parent)
+  : QObject(parent), _server(server), _socket(new QLocalSocket(this)), _haveHeader(false), _history(capacity) {
+  _retry.setSingleShot(true);
+  _retry.setInterval(RetryPeriod);
+  connect(&_retry, SIGNAL(timeout()), this, SLOT(reconnect()));
+  connect(_socket, SIGNAL(readyRead()), this, SLOT(readFrames()));
+  connect(_socket, SIGNAL(disconnected()), this, SLOT(lost()));
+  connect(_socket, SIGNAL(errorOccurred(QLocalSocket::LocalSocketError)), this, SLOT(lost()));
+  reconnect();
+}
+
+
+LiveStreamReader::~LiveStreamReader() {
+  _socket->disconnect(this);
+}
+
+
+bool LiveStreamReader::waitForHeader(int msecs) {
+  QElapsedTimer timer;
+  timer.start();
+  if (_socket->state() != QLocalSocket::ConnectedState && !_socket->waitForConnected(msecs)) {
+    return false;
+  }
+  while (!_haveHeader) {
+    const int left = msecs - timer.elapsed();
+    if (left <= 0 || !_socket->waitForReadyRead(left)) {
+      break;
+    }
+  }
+  return _haveHeader;
+}
+
+
+void LiveStreamReader::readFrames() {
+  if (!_haveHeader) {
+    const qint64 most = FixedBytes + LiveStream::MaxFields*LiveStream::NameBytes;
+    QStringList fields;
+    const int used = LiveStream::parseHeader(_socket->peek(qMin(_socket->bytesAvailable(), most)), &fields);
+    if (used < 0) {
+      Debug::self()->log(tr("%1 does not send a kst live stream.").arg(_server), Debug::Warning);
+      _socket->abort();
+      return;
+    }
+    if (used == 0) {
+      return;
+    }
+    _socket->skip(used);
+    _haveHeader = true;
+    if (fields != _history.fields()) {
+      _history.reset(fields);
+      emit fieldsChanged();
+    }
+  }
+
+  // whole frames only: the rest waits in the socket
+  const int n = _history.fields().count();
+  const qint64 frameBytes = n*sizeof(double);
+  const qint64 count = _socket->bytesAvailable() / frameBytes;
+  if (count == 0) {
+    return;
+  }
+  _buffer.resize(count*n);
+  _socket->read(reinterpret_cast<char*>(_buffer.data()), count*frameBytes);
+  _history.append(_buffer.constData(), count);
+  emit framesArrived();
+}
+
+
+void LiveStreamReader::lost() {
+  _haveHeader = false;
+  if (!_retry.isActive()) {
+    _retry.start();
+  }
+}
+
+
+void LiveStreamReader::reconnect() {
+  if (_socket->state() == QLocalSocket::UnconnectedState) {
+    _haveHeader = false;
+    _socket->connectToServer(_server);
+  }
+}
+
+
+LiveStreamProducer::LiveStreamProducer(const QStringList &fields, QObject *parent)
+  : QObject(parent), _header(LiveStream::header(fields)), _fields(fields.count()), _server(new QLocalServer(this)) {
+  connect(_server, SIGNAL(newConnection()), this, SLOT(addReaders()));
+}
+
+
+LiveStreamProducer::~LiveStreamProducer() {
+  foreach (QLocalSocket *reader, _readers) {
+    reader->disconnect(this);
+  }
+  _server->close();
+}
+
+
+bool LiveStreamProducer::listen(const QString &server) {
+  QLocalServer::removeServer(server);
+  return _server->listen(server);
+}
+
+
+QString LiveStreamProducer::fullServerName() const {
+  return _server->fullServerName();
+}
+
+
+void LiveStreamProducer::send(const double *frames, qint64 count) {
+  const qint64 bytes = count*_fields*sizeof(double);
+  foreach (QLocalSocket *reader, _readers) {
+    if (reader->bytesToWrite() > MaxBacklog) {
+      reader->abort();
+      continue;
+    }
+    reader->write(reinterpret_cast<const char*>(frames), bytes);
+    reader->flush();
+  }
+}
+
+
+void LiveStreamProducer::addReaders() {
+  while (_server->hasPendingConnections()) {
+    QLocalSocket *reader = _server->nextPendingConnection();
+    connect(reader, SIGNAL(disconnected()), this, SLOT(dropReader()));
+    reader->write(_header);
+    reader->flush();
+    _readers.append(reader);
+  }
+}
+
+
+void LiveStreamProducer::dropReader() {
+  QLocalSocket *reader = qobject_cast<QLocalSocket*>(sender());
+  _readers.removeAll(reader);
+  reader->deleteLater();
+}
+
+}
+
+// vim: ts=2 sw=2 et
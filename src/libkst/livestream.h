@@ -0,0 +1,169 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef LIVESTREAM_H
+#define LIVESTREAM_H
+
+#include "kstcore_export.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+class QLocalServer;
+class QLocalSocket;
+
+namespace Kst {
+
+/** A live stream: frames of doubles sent by a producer, as they are taken,
+    over a local socket (a Unix domain socket, or a named pipe on Windows)
+    rather than through a file kst would have to poll.  The producer
+    listens; what it sends each reader starts with a header
+
+      char     magic[8]           "KSTLIVE1"
+      quint32  fields
+      quint32  reserved           0
+      char     names[fields][32]  UTF-8, NUL padded
+
+    and goes on with frames of one double per field, in the order of the
+    names.  Producer and readers share the machine, so numbers are in its
+    byte order. */
+namespace LiveStream {
+  const int NameBytes = 32;
+  const int MaxFields = 4096;
+
+  KSTCORE_EXPORT QByteArray header(const QStringList &fields);
+
+  /** the size of the header data starts with, its names in fields; 0 if
+      more of it is needed, -1 if data doesn't start with a header */
+  KSTCORE_EXPORT int parseHeader(const QByteArray &data, QStringList *fields);
+}
+
+
+/** The last capacity frames of each field of a stream: frame f of a field
+    is in slot f % capacity of its ring, which grows as frames come in up to
+    capacity.  Appended to in one thread while updates read it in others. */
+class KSTCORE_EXPORT LiveHistory
+{
+  public:
+    static const qint64 DefaultCapacity = 1 << 20;
+
+    explicit LiveHistory(qint64 capacity = DefaultCapacity);
+
+    /** drops every frame and takes fields */
+    void reset(const QStringList &fields);
+
+    QStringList fields() const;
+    qint64 capacity() const { return _capacity; }
+
+    /** frames appended since the reset, including those let go */
+    qint64 frames() const;
+
+    /** count frames of fields().count() doubles each */
+    void append(const double *frames, qint64 count);
+
+    /** Copies frames [start, start+count) of field into v, those already let
+        go as NaN, straight from its ring.  Returns how many of them have come
+        in; -1 if there is no such field. */
+    qint64 read(int field, qint64 start, qint64 count, double *v) const;
+
+  private:
+    mutable QMutex _mutex;
+    QStringList _fields;
+    QVector<QVector<double> > _rings;
+    qint64 _capacity;
+    qint64 _frames;
+};
+
+
+/** Keeps what a producer sends in a LiveHistory.  framesArrived() is emitted
+    in the reader's thread as soon as new frames are in; when the producer
+    goes away, or isn't there yet, the reader tries again every second. */
+class KSTCORE_EXPORT LiveStreamReader : public QObject
+{
+  Q_OBJECT
+  public:
+    LiveStreamReader(const QString &server, qint64 capacity = LiveHistory::DefaultCapacity, QObject *parent = 0);
+    ~LiveStreamReader();
+
+    const LiveHistory &history() const { return _history; }
+    bool hasHeader() const { return _haveHeader; }
+
+    /** for those that only want the field names: waits up to msecs for the
+        connection and the header, true if they came */
+    bool waitForHeader(int msecs);
+
+    static const int RetryPeriod = 1000;
+
+  Q_SIGNALS:
+    void framesArrived();
+    /** the producer that came back sends other fields: the history is
+        emptied */
+    void fieldsChanged();
+
+  private Q_SLOTS:
+    void readFrames();
+    void lost();
+    void reconnect();
+
+  private:
+    QString _server;
+    QLocalSocket *_socket;
+    QTimer _retry;
+    bool _haveHeader;
+    QVector<double> _buffer;
+    LiveHistory _history;
+};
+
+
+/** The producer end, serving frames to every reader that connects.  It is
+    the stand-in for live telemetry in the tests and benchmarks, and shows
+    what a producer of one's own has to do.  A reader that falls more than
+    MaxBacklog bytes behind is dropped rather than buffered without end. */
+class KSTCORE_EXPORT LiveStreamProducer : public QObject
+{
+  Q_OBJECT
+  public:
+    explicit LiveStreamProducer(const QStringList &fields, QObject *parent = 0);
+    ~LiveStreamProducer();
+
+    /** takes over server from a producer that didn't clean up */
+    bool listen(const QString &server);
+    /** what readers connect to: for a socket, its path */
+    QString fullServerName() const;
+
+    int readers() const { return _readers.count(); }
+
+    /** count frames of one double per field */
+    void send(const double *frames, qint64 count);
+
+    static const qint64 MaxBacklog = 64 << 20;
+
+  private Q_SLOTS:
+    void addReaders();
+    void dropReader();
+
+  private:
+    QByteArray _header;
+    int _fields;
+    QLocalServer *_server;
+    QList<QLocalSocket*> _readers;
+};
+
+}
+
+#endif
+
+// vim: ts=2 sw=2 et
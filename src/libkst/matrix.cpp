@@ -24,11 +24,14 @@
 #include <QDebug>
 #include <QXmlStreamWriter>
 #include <QList>
+#include <QVector>
 
 #include "debug.h"
 #include "math_kst.h"
 #include "datacollection.h"
+#include "memorymanager.h"
 #include "objectstore.h"
+#include "quantiles.h"
 
 
 // used for resizing; set to 1 for loop zeroing, 2 to use memset
@@ -62,6 +65,7 @@ Matrix::~Matrix() {
     _vectors["z"]->setV(0L, 0);
     free(_z);
     _z = 0L;
+    MemoryManager::adjust(-qint64(_zSize)*sizeof(double));
   }
 }
 
@@ -202,7 +206,7 @@ void Matrix::calcNoSpikeRange(double per) {
   int n_checked;
   double x=0;
   int n_notnan;
-  QList<double> pixels;
+  QVector<double> pixels;
   double max = -1E300;
   double min = 1E300;
 
@@ -237,7 +241,7 @@ void Matrix::calcNoSpikeRange(double per) {
 
   n_checked = 0;
 
-  pixels.clear();
+  pixels.reserve(n_check);
 
   while (n_checked < n_check) {
     j = size_t(double(rand())*double(_NS-1)/(double(RAND_MAX)));
@@ -247,11 +251,14 @@ void Matrix::calcNoSpikeRange(double per) {
       n_checked++;
     }
   }
-  std::sort(pixels.begin(), pixels.end());
 
   // FIXME: this needs a z spike insensitive algorithm...
-  _minNoSpike = pixels[size_t(n_check*per)];
-  _maxNoSpike = pixels[size_t(n_check*(1.0-per)-1)];
+  // only the two ranks are needed: select them rather than sort
+  const qint64 ranks[2] = { qint64(n_check*per), qint64(n_check*(1.0-per)-1) };
+  double range[2];
+  selectRanks(pixels.data(), n_check, ranks, 2, range);
+  _minNoSpike = range[0];
+  _maxNoSpike = range[1];
 
 }
 
@@ -298,6 +305,11 @@ int Matrix::getUsage() const {
 }
 
 
+qint64 Matrix::memoryUsage() const {
+  return qint64(_zSize)*sizeof(double);
+}
+
+
 void Matrix::internalUpdate() {
   // calculate stats
   _NS = _nX * _nY;
@@ -468,6 +480,7 @@ bool Matrix::resizeZ(int sz, bool reinit) {
     fatalError("Not enough memory for matrix data");
     return false;
 #endif
+    MemoryManager::adjust(qint64(sz - _zSize)*sizeof(double));
     _zSize = sz;
     updateScalars();
   }
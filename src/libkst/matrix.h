@@ -107,6 +107,9 @@ class KSTCORE_EXPORT Matrix : public Primitive
     // get usage of this matrix by other objects
     virtual int getUsage() const;
 
+    // bytes of memory held by the matrix data
+    virtual qint64 memoryUsage() const;
+
     // save the matrix
     virtual void save(QXmlStreamWriter &s);
 
@@ -193,6 +193,8 @@ PrimitivePtr DataMatrixFactory::generatePrimitive(ObjectStore *store, QXmlStream
 
         if (!store->override.fileName.isEmpty()) {
           file = store->override.fileName;
+        } else {
+          file = store->override.files.value(file, file);
         }
 
         field = attrs.value("field").toString();
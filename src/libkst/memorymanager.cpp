@@ -0,0 +1,154 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "memorymanager.h"
+
+#include "matrix.h"
+#include "objectstore.h"
+#include "vector.h"
+
+#include <QAtomicInteger>
+#include <QCoreApplication>
+
+#include <algorithm>
+#include <limits>
+
+namespace Kst {
+
+static MemoryManager *_self = 0;
+void MemoryManager::cleanup() {
+  delete _self;
+  _self = 0;
+}
+
+
+MemoryManager *MemoryManager::self() {
+  if (!_self) {
+    _self = new MemoryManager;
+    qAddPostRoutine(cleanup);
+  }
+  return _self;
+}
+
+
+MemoryManager::MemoryManager() {
+  _ceiling = 0;
+  _store = 0;
+}
+
+
+MemoryManager::~MemoryManager() {
+}
+
+
+void MemoryManager::setCeiling(qint64 bytes) {
+  _ceiling = qMax(bytes, qint64(0));
+}
+
+
+// a counter of its own, rather than a member, so that primitives destroyed
+// after the manager still balance it
+static QAtomicInteger<qint64> _used(0);
+
+qint64 MemoryManager::used() const {
+  return _used.loadRelaxed();
+}
+
+
+void MemoryManager::adjust(qint64 bytes) {
+  _used.fetchAndAddRelaxed(bytes);
+}
+
+
+qint64 MemoryManager::available() const {
+  if (_ceiling <= 0) {
+    return std::numeric_limits<qint64>::max();
+  }
+  return qMax(_ceiling - used(), qint64(0));
+}
+
+
+bool MemoryManager::reserve(qint64 bytes) {
+  if (_ceiling <= 0 || bytes <= 0) {
+    return true;
+  }
+  if (used() + bytes <= _ceiling) {
+    return true;
+  }
+  requestRelease();
+  return false;
+}
+
+
+void MemoryManager::requestRelease() {
+  _releaseWanted.storeRelaxed(1);
+}
+
+
+qint64 MemoryManager::releaseCaches() {
+  if (!_store) {
+    return 0;
+  }
+  qint64 freed = 0;
+  const VectorList vectors = _store->getObjects<Vector>();
+  foreach (const VectorPtr &v, vectors) {
+    v->writeLock();
+    freed += v->releaseCaches();
+    v->unlock();
+  }
+  return freed;
+}
+
+
+qint64 MemoryManager::releaseCachesIfWanted() {
+  if (!_releaseWanted.fetchAndStoreRelaxed(0)) {
+    return 0;
+  }
+  return releaseCaches();
+}
+
+
+QList<MemoryManager::Usage> MemoryManager::usage() const {
+  QList<Usage> list;
+  if (!_store) {
+    return list;
+  }
+
+  const VectorList vectors = _store->getObjects<Vector>();
+  foreach (const VectorPtr &v, vectors) {
+    Usage u;
+    u.bytes = v->memoryUsage();
+    if (u.bytes > 0) {
+      u.name = v->Name();
+      u.type = v->typeString();
+      list.append(u);
+    }
+  }
+  const MatrixList matrices = _store->getObjects<Matrix>();
+  foreach (const MatrixPtr &m, matrices) {
+    Usage u;
+    u.bytes = m->memoryUsage();
+    if (u.bytes > 0) {
+      u.name = m->Name();
+      u.type = m->typeString();
+      list.append(u);
+    }
+  }
+
+  std::sort(list.begin(), list.end(), [](const Usage &a, const Usage &b) {
+    return a.bytes > b.bytes;
+  });
+  return list;
+}
+
+}
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,94 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef MEMORYMANAGER_H
+#define MEMORYMANAGER_H
+
+#include <QAtomicInt>
+#include <QList>
+#include <QString>
+
+#include "kstcore_export.h"
+
+namespace Kst {
+class ObjectStore;
+
+/** Keeps track of the memory held by vectors and matrices, and enforces an
+ *  optional ceiling on it.
+ *
+ *  Vectors and matrices report what they hold as it changes, so used() is a
+ *  counter rather than a walk of the store.  Before a data primitive grows,
+ *  it asks reserve() for the extra bytes; if they don't fit, the caller is
+ *  expected to read less (eg, DataVector decimates) rather than allocate
+ *  anyway.  Caches are not released from there, in the middle of another
+ *  object's update: the refusal is remembered, and the UpdateManager
+ *  releases them once the update pass is over.
+ */
+class KSTCORE_EXPORT MemoryManager
+{
+  public:
+    struct KSTCORE_EXPORT Usage {
+      QString name;
+      QString type;
+      qint64 bytes;
+    };
+
+    static MemoryManager *self();
+
+    void setStore(ObjectStore *store) { _store = store; }
+
+    /** the most bytes primitives may hold.  0 means no limit. */
+    qint64 ceiling() const { return _ceiling; }
+    void setCeiling(qint64 bytes);
+
+    /** bytes currently held by all vectors and matrices */
+    qint64 used() const;
+
+    /** vectors and matrices call this with how much more (or, negative,
+        less) they hold */
+    static void adjust(qint64 bytes);
+
+    /** bytes left below the ceiling */
+    qint64 available() const;
+
+    /** true if bytes more can be held without going over the ceiling.
+        If not, caches are released after the update pass. */
+    bool reserve(qint64 bytes);
+
+    /** ask for caches to be released after the update pass */
+    void requestRelease();
+
+    /** drop caches which can be recomputed, each under its vector's write
+        lock.  Returns the bytes freed.  Not to be called while objects are
+        being updated. */
+    qint64 releaseCaches();
+
+    /** releaseCaches() if a reservation failed since the last time */
+    qint64 releaseCachesIfWanted();
+
+    /** per object breakdown, largest first */
+    QList<Usage> usage() const;
+
+  private:
+    MemoryManager();
+    ~MemoryManager();
+    static void cleanup();
+
+    qint64 _ceiling;
+    ObjectStore *_store;
+    QAtomicInt _releaseWanted;
+};
+
+}
+
+#endif
+
+// vim: ts=2 sw=2 et
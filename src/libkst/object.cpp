@@ -20,6 +20,7 @@
 class ScriptInterface;
 
 #include "objectstore.h"
+#include "tracer.h"
 
 namespace Kst {
 
@@ -84,6 +85,11 @@ bool Object::uses(ObjectPtr p) const {
 }
 
 
+QList<ObjectPtr> Object::inputObjects() const {
+  return QList<ObjectPtr>();
+}
+
+
 ObjectStore* Object::store() const {
   return _store;
 }
@@ -102,6 +108,7 @@ Object::UpdateType Object::objectUpdate(qint64 newSerial) {
   } else if (minInputSerial() < newSerial) { // if an input was forced, this will be true
     return Deferred;
   } else if ((_serialOfLastChange < maxInputSerialOfLastChange()) || (_serial == Object::Forced)) {
+    TraceSpan span("update", this);
     internalUpdate();
     _serialOfLastChange = newSerial;
     _serial = newSerial;
@@ -78,6 +78,9 @@ class KSTCORE_EXPORT Object : public QObject, public Shared, public KstRWLock, p
 
     virtual bool uses(ObjectPtr p) const;
 
+    /** the objects this one is computed from, which must be updated first */
+    virtual QList<ObjectPtr> inputObjects() const;
+
     virtual ScriptInterface* createScriptInterface();
     ScriptInterface *scriptInterface();
 
@@ -26,6 +26,7 @@
 #include "datastring.h"
 #include "datavector.h"
 #include "object.h"
+#include "updatemanager.h"
 #include "vscalar.h"
 
 // NAMEDEBUG: 0 for no debug, 1 for some debug, 2 for more debug, 3 for all
@@ -42,6 +43,9 @@ ObjectStore::ObjectStore() {
   override.countFromEnd = false;
   override.readToEnd = false;
   sessionVersion = 9999999;
+  deferSourceScans = false;
+  _transactionDepth = 0;
+  _transactionPending = false;
 }
 
 ObjectStore::~ObjectStore() {}
@@ -171,6 +175,19 @@ void ObjectStore::cleanUpDataSourceList() {
   currentSourceList.clear();
 }
 
+void ObjectStore::beginTransaction() {
+  ++_transactionDepth;
+}
+
+void ObjectStore::endTransaction(bool update) {
+  if (_transactionDepth == 0 || --_transactionDepth > 0) {
+    return;
+  }
+  const bool pending = _transactionPending;
+  _transactionPending = false;
+  UpdateManager::self()->endTransaction(this, update && pending);
+}
+
 bool ObjectStore::isEmpty() const {
   KstReadLocker l(&_lock);
   return _list.isEmpty();
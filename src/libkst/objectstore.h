@@ -19,6 +19,7 @@
 #define OBJECTSTORE_H
 
 #include <QDebug>
+#include <QHash>
 
 #include "kstcore_export.h"
 #include "object.h"
@@ -74,6 +75,20 @@ class KSTCORE_EXPORT ObjectStore
     /** locking */
     KstRWLock& lock() const { return _lock; }
 
+    /** Bulk construction, for making many objects at once.  While a
+        transaction is open UpdateManager::doUpdates() does nothing, and
+        views hold back automatic layouts; when the outermost one ends, the
+        objects made in it, and the updates asked for, are seen to in a
+        single pass, in the order of their inputs.  Transactions nest.  See
+        ObjectTransaction. */
+    void beginTransaction();
+    /** update is false when the caller does the update itself */
+    void endTransaction(bool update = true);
+    bool inTransaction() const { return _transactionDepth > 0; }
+
+    /** an update asked for in a transaction, to be done when it ends */
+    void holdUpdate() { _transactionPending = true; }
+
     /** clear the 'used' flag on all objects in list */
     void clearUsedFlags();
 
@@ -98,15 +113,23 @@ class KSTCORE_EXPORT ObjectStore
       int skip;
       bool hasDoAve;    // true when doAve is overridden from CLI
       int doAve;
+      QHash<QString, QString> files; // data file -> the file to read instead
     } override;
 
     unsigned sessionVersion; // keep track of older .kst file sessions.
+
+    // set while a session is loaded: data sources leave their first scan
+    // of the file to the staged update, which reads them in parallel
+    bool deferSourceScans;
     QString sessionVersionString;
   private:
     Q_DISABLE_COPY(ObjectStore)
 
     mutable KstRWLock _lock;
 
+    int _transactionDepth;
+    bool _transactionPending;
+
     // objects are stored in these lists
     DataSourceList _dataSourceList;
     QList<ObjectPtr> _list;
@@ -157,10 +180,46 @@ bool ObjectStore::addObject(T *o) {
   } else {
     _list.append(o);
   }
+  if (_transactionDepth > 0) {
+    _transactionPending = true;
+  }
   return true;
 }
 
 
+/** Opens a transaction on store for as long as it lives, or until commit():
+
+      ObjectTransaction transaction(store);
+      for (...) {
+        CurvePtr curve = store->createObject<Curve>();
+        ...
+      }
+      transaction.commit();
+ */
+class KSTCORE_EXPORT ObjectTransaction
+{
+  public:
+    explicit ObjectTransaction(ObjectStore *store) : _store(store) {
+      if (_store) {
+        _store->beginTransaction();
+      }
+    }
+    ~ObjectTransaction() { commit(); }
+
+    void commit(bool update = true) {
+      if (_store) {
+        ObjectStore *store = _store;
+        _store = 0;
+        store->endTransaction(update);
+      }
+    }
+
+  private:
+    Q_DISABLE_COPY(ObjectTransaction)
+    ObjectStore *_store;
+};
+
+
 }
 #endif
 
@@ -0,0 +1,165 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "pluginregistry.h"
+
+#include "dataplugin.h"
+#include "debug.h"
+#include "settings.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QPluginLoader>
+#include <QRegularExpression>
+
+namespace Kst {
+
+static QSettings& cacheSettings() {
+  static QSettings& settings = createSettings("plugins");
+  return settings;
+}
+
+
+QList<PluginRegistry::Entry> PluginRegistry::scan(const QString &scope, const QString &iid, const QString &prefix, Describe describe) {
+  QSettings& cache = cacheSettings();
+  cache.beginGroup(scope);
+
+  // a new interface version makes the cache useless
+  QHash<QString, QVariantMap> known;
+  if (cache.value("interface").toString() == iid) {
+    foreach (const QVariant &v, cache.value("files").toList()) {
+      const QVariantMap file = v.toMap();
+      known.insert(file.value("path").toString(), file);
+    }
+  }
+
+  QList<Entry> entries;
+  QVariantList files;
+  int described = 0;
+  foreach (const QString &pluginPath, pluginSearchPaths()) {
+    QDir d(pluginPath);
+    foreach (const QString &fileName, d.entryList(QDir::Files)) {
+      if (!fileName.startsWith(prefix)) {
+        continue;
+      }
+#ifdef Q_OS_WIN
+      if (!fileName.endsWith(QLatin1String(".dll"))) {
+        continue;
+      }
+#endif
+      const QString path = d.absoluteFilePath(fileName);
+      const QFileInfo info(path);
+      const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+
+      QVariantMap file = known.value(path);
+      if (file.isEmpty() || file.value("modified").toLongLong() != modified || file.value("size").toLongLong() != info.size()) {
+        file.clear();
+        file.insert("path", path);
+        file.insert("modified", modified);
+        file.insert("size", info.size());
+
+        QPluginLoader loader(path);
+        if (loader.metaData().value("IID").toString() != iid) {
+          // not a plugin, or another kind
+          file.insert("plugin", false);
+        } else if (QObject *plugin = loader.instance()) {
+          QVariantMap pluginInfo;
+          const bool taken = describe(plugin, &pluginInfo);
+          file.insert("plugin", taken);
+          file.insert("info", pluginInfo);
+          if (taken) {
+            Debug::self()->log(QObject::tr("Plugin loaded: %1").arg(fileName));
+          }
+          ++described;
+        } else {
+          // not remembered: its libraries may yet turn up
+          Debug::self()->log(QObject::tr("instance failed for %1 (%2)").arg(fileName).arg(loader.errorString()));
+          continue;
+        }
+      }
+
+      files.append(file);
+      if (file.value("plugin").toBool()) {
+        Entry entry;
+        entry.path = path;
+        entry.info = file.value("info").toMap();
+        entries.append(entry);
+      }
+    }
+  }
+
+  cache.setValue("interface", iid);
+  cache.setValue("files", files);
+  cache.endGroup();
+
+  Debug::self()->log(QObject::tr("Found %1 %2 plugins, %3 of them new or changed.").arg(entries.count()).arg(scope).arg(described));
+  return entries;
+}
+
+
+QObject *PluginRegistry::load(const QString &path) {
+  QPluginLoader loader(path);
+  QObject *plugin = loader.instance();
+  if (plugin) {
+    Debug::self()->log(QObject::tr("Plugin loaded: %1").arg(QFileInfo(path).fileName()));
+  } else {
+    Debug::self()->log(QObject::tr("instance failed for %1 (%2)").arg(path).arg(loader.errorString()), Debug::Warning);
+  }
+  return plugin;
+}
+
+
+bool PluginRegistry::matches(const QStringList &signatures, Probe *probe) {
+  if (signatures.isEmpty()) {
+    return true;
+  }
+
+  const QString name = QFileInfo(probe->filename).fileName();
+  foreach (const QString &signature, signatures) {
+    if (!signature.startsWith(QLatin1String("magic:"))) {
+      if (QRegularExpression::fromWildcard(signature, Qt::CaseInsensitive).match(name).hasMatch()) {
+        return true;
+      }
+      continue;
+    }
+
+    const QStringList parts = signature.split(':');
+    bool ok = parts.size() == 3;
+    const int offset = ok ? parts[1].toInt(&ok) : 0;
+    const QByteArray magic = QByteArray::fromHex(ok ? parts[2].toLatin1() : QByteArray());
+    if (!ok || offset < 0 || magic.isEmpty() || offset + magic.size() > HeadBytes) {
+      return true;
+    }
+
+    if (!probe->read) {
+      probe->read = true;
+      QFile f(probe->filename);
+      if (!QFileInfo(probe->filename).isDir() && f.open(QIODevice::ReadOnly)) {
+        probe->head = f.read(HeadBytes);
+        probe->readable = true;
+      }
+    }
+    if (!probe->readable) {
+      return true;
+    }
+    if (probe->head.mid(offset, magic.size()) == magic) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,78 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef PLUGINREGISTRY_H
+#define PLUGINREGISTRY_H
+
+#include "kstcore_export.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+
+class QObject;
+
+namespace Kst {
+
+/** The plugin files under pluginSearchPaths(), and what they provide,
+    remembered from one run to the next.  A file is only loaded when it is
+    new, or has changed, since the last scan, or when one of its plugins is
+    first used; until then what the plugin lists need of it comes from the
+    cache.  Files of another kind of plugin are told apart by the metadata
+    Qt keeps outside the code, and never loaded. */
+class KSTCORE_EXPORT PluginRegistry
+{
+  public:
+    struct Entry {
+      QString path;
+      QVariantMap info;
+    };
+
+    /** records in info what the plugin lists need to know of plugin; false
+        if it is not of the kind scanned for */
+    typedef bool (*Describe)(QObject *plugin, QVariantMap *info);
+
+    /** The plugins with interface iid in the files under the search paths
+        whose names start with prefix.  The sizes and times of the files, and
+        what describe() made of them, are kept under scope. */
+    static QList<Entry> scan(const QString &scope, const QString &iid, const QString &prefix, Describe describe);
+
+    /** loads the plugin in path, or returns the one already loaded; 0 if
+        it fails to load */
+    static QObject *load(const QString &path);
+
+    /** The start of a file, read once for all the plugins asked about it. */
+    struct Probe {
+      explicit Probe(const QString &f) : filename(f), read(false), readable(false) {}
+      QString filename;
+      QByteArray head;
+      bool read;
+      bool readable;
+    };
+
+    /** how much of a file magic signatures can look at */
+    static const int HeadBytes = 4096;
+
+    /** Whether probe's file passes one of a plugin's signatures, the cheap
+        tests a file must pass for its understands() to take it: file name
+        patterns ("*.h5") and magic bytes ("magic:0:89484446", in hex, at an
+        offset).  A plugin without signatures, or a file that can't be read,
+        or magic beyond HeadBytes, passes: only understands() can tell. */
+    static bool matches(const QStringList &signatures, Probe *probe);
+};
+
+}
+
+#endif
+
+// vim: ts=2 sw=2 et
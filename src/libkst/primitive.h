@@ -55,6 +55,8 @@ class KSTCORE_EXPORT Primitive : public Object
     virtual bool used() const;
     virtual void setUsed(bool used_in);
 
+    virtual QList<ObjectPtr> inputObjects() const;
+
     virtual ObjectList<Primitive> outputPrimitives() const = 0;
 
     virtual PrimitiveMap metas() const = 0;
@@ -0,0 +1,217 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "quantiles.h"
+
+#include "math_kst.h"
+
+#include <QThread>
+#include <QVarLengthArray>
+#include <QVector>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+
+namespace Kst {
+
+// ranks[r0, r1) are sorted, and all fall in v[lo, hi).  The middle one is
+// put in place; those below it can then only be left of it, the others right.
+static void selectSortedRanks(double *v, qint64 lo, qint64 hi, const qint64 *ranks, int r0, int r1) {
+  while (r0 < r1) {
+    const int mid = (r0 + r1)/2;
+    const qint64 k = ranks[mid];
+    std::nth_element(v + lo, v + k, v + hi);
+
+    // equal ranks are already in place
+    int left = mid;
+    while (left > r0 && ranks[left - 1] == k) {
+      --left;
+    }
+    int right = mid + 1;
+    while (right < r1 && ranks[right] == k) {
+      ++right;
+    }
+
+    // recurse into the smaller side, loop on the other
+    if (left - r0 < r1 - right) {
+      selectSortedRanks(v, lo, k, ranks, r0, left);
+      lo = k + 1;
+      r0 = right;
+    } else {
+      selectSortedRanks(v, k + 1, hi, ranks, right, r1);
+      hi = k;
+      r1 = left;
+    }
+  }
+}
+
+
+void selectRanks(double *v, qint64 n, const qint64 *ranks, int n_ranks, double *out) {
+  if (n <= 0 || n_ranks <= 0) {
+    return;
+  }
+
+  QVarLengthArray<qint64, 16> sorted(n_ranks);
+  for (int i = 0; i < n_ranks; ++i) {
+    sorted[i] = qBound(qint64(0), ranks[i], n - 1);
+  }
+  std::sort(sorted.begin(), sorted.end());
+
+  selectSortedRanks(v, 0, n, sorted.constData(), 0, n_ranks);
+
+  for (int i = 0; i < n_ranks; ++i) {
+    out[i] = v[qBound(qint64(0), ranks[i], n - 1)];
+  }
+}
+
+
+// below this many samples a copy and selectRanks() is as quick
+static const qint64 ParallelSelectThreshold = 1 << 20;
+static const int SelectBuckets = 1 << 14;
+
+namespace {
+  struct SelectChunk {
+    const double *v;
+    qint64 n;
+    double min, max;
+    QVector<qint64> counts;
+    QVector<QVector<double> > picked; // per wanted bucket
+  };
+}
+
+
+// The bucket of a sample never decreases as the sample increases, so the
+// samples of rank r are in the bucket where the cumulative count passes r,
+// at the rank left over within it.
+void selectRanksParallel(const double *v, qint64 n, const qint64 *ranks, int n_ranks, double *out) {
+  if (n <= 0 || n_ranks <= 0) {
+    return;
+  }
+
+  const int n_chunks = int(qMin(qint64(QThread::idealThreadCount()), n/(ParallelSelectThreshold/4)));
+  if (n < ParallelSelectThreshold || n_chunks < 2) {
+    QVector<double> copy(v, v + n);
+    selectRanks(copy.data(), n, ranks, n_ranks, out);
+    return;
+  }
+
+  QVector<SelectChunk> chunks(n_chunks);
+  const qint64 chunk_size = (n + n_chunks - 1)/n_chunks;
+  for (int i = 0; i < n_chunks; ++i) {
+    chunks[i].v = v + i*chunk_size;
+    chunks[i].n = qMax(qint64(0), qMin(chunk_size, n - i*chunk_size));
+  }
+
+  QtConcurrent::blockingMap(chunks, [](SelectChunk &chunk) {
+    chunk.min = chunk.max = chunk.n > 0 ? chunk.v[0] : 0.0;
+    for (qint64 i = 1; i < chunk.n; ++i) {
+      chunk.min = qMin(chunk.min, chunk.v[i]);
+      chunk.max = qMax(chunk.max, chunk.v[i]);
+    }
+  });
+  double min = chunks[0].min;
+  double max = chunks[0].max;
+  for (int i = 1; i < n_chunks; ++i) {
+    if (chunks[i].n > 0) {
+      min = qMin(min, chunks[i].min);
+      max = qMax(max, chunks[i].max);
+    }
+  }
+  if (!(max > min)) {
+    for (int i = 0; i < n_ranks; ++i) {
+      out[i] = min;
+    }
+    return;
+  }
+  if (!isfinite(max - min)) {
+    QVector<double> copy(v, v + n);
+    selectRanks(copy.data(), n, ranks, n_ranks, out);
+    return;
+  }
+
+  const double scale = SelectBuckets/(max - min);
+  auto bucketOf = [min, scale](double x) {
+    return qMin(int((x - min)*scale), SelectBuckets - 1);
+  };
+
+  QtConcurrent::blockingMap(chunks, [&](SelectChunk &chunk) {
+    chunk.counts.fill(0, SelectBuckets);
+    qint64 *counts = chunk.counts.data();
+    for (qint64 i = 0; i < chunk.n; ++i) {
+      counts[bucketOf(chunk.v[i])]++;
+    }
+  });
+
+  QVector<qint64> first(SelectBuckets + 1, 0);
+  for (int b = 0; b < SelectBuckets; ++b) {
+    first[b + 1] = first[b];
+    for (int i = 0; i < n_chunks; ++i) {
+      first[b + 1] += chunks[i].counts[b];
+    }
+  }
+
+  // the buckets holding the ranks, each once
+  QVector<int> wanted;
+  QVarLengthArray<int, 16> rankBucket(n_ranks);
+  for (int i = 0; i < n_ranks; ++i) {
+    const qint64 r = qBound(qint64(0), ranks[i], n - 1);
+    const int b = int(std::upper_bound(first.constBegin(), first.constEnd(), r) - first.constBegin()) - 1;
+    int slot = wanted.indexOf(b);
+    if (slot < 0) {
+      slot = wanted.size();
+      wanted.append(b);
+    }
+    rankBucket[i] = slot;
+  }
+  QVector<int> slotOf(SelectBuckets, -1);
+  for (int slot = 0; slot < wanted.size(); ++slot) {
+    slotOf[wanted[slot]] = slot;
+  }
+
+  QtConcurrent::blockingMap(chunks, [&](SelectChunk &chunk) {
+    chunk.picked.resize(wanted.size());
+    for (int slot = 0; slot < wanted.size(); ++slot) {
+      chunk.picked[slot].reserve(chunk.counts[wanted[slot]]);
+    }
+    for (qint64 i = 0; i < chunk.n; ++i) {
+      const int slot = slotOf[bucketOf(chunk.v[i])];
+      if (slot >= 0) {
+        chunk.picked[slot].append(chunk.v[i]);
+      }
+    }
+  });
+
+  for (int slot = 0; slot < wanted.size(); ++slot) {
+    const int b = wanted[slot];
+    QVector<double> bucket;
+    bucket.reserve(first[b + 1] - first[b]);
+    for (int i = 0; i < n_chunks; ++i) {
+      bucket += chunks[i].picked[slot];
+    }
+    QVector<qint64> inBucket;
+    QVector<int> which;
+    for (int i = 0; i < n_ranks; ++i) {
+      if (rankBucket[i] == slot) {
+        inBucket.append(qBound(qint64(0), ranks[i], n - 1) - first[b]);
+        which.append(i);
+      }
+    }
+    QVector<double> values(inBucket.size());
+    selectRanks(bucket.data(), bucket.size(), inBucket.constData(), inBucket.size(), values.data());
+    for (int i = 0; i < which.size(); ++i) {
+      out[which[i]] = values[i];
+    }
+  }
+}
+
+}
+
+// vim: ts=2 sw=2 et
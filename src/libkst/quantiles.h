@@ -0,0 +1,39 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QUANTILES_H
+#define QUANTILES_H
+
+#include <QtGlobal>
+
+#include "kstcore_export.h"
+
+namespace Kst {
+
+/** Order statistics by selection rather than by sorting.  out[i] is set to
+    the value of rank ranks[i] (0 based, as in v sorted ascending); ranks
+    need not be sorted or distinct, and must be in [0, n).  All of them come
+    from one pass of nth_element partitions, each on the part of v left by
+    the ones before: O(n) for a few ranks, where a sort is O(n log n).
+    v is reordered, and must hold no NaNs. */
+KSTCORE_EXPORT void selectRanks(double *v, qint64 n, const qint64 *ranks, int n_ranks, double *out);
+
+/** As selectRanks(), but v is left as it is.  Large inputs are shared
+    between threads: each counts its part of v into buckets between the
+    min and the max, and then only the samples in the buckets holding the
+    ranks are copied out and selected from. */
+KSTCORE_EXPORT void selectRanksParallel(const double *v, qint64 n, const qint64 *ranks, int n_ranks, double *out);
+
+}
+
+#endif
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,250 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "readahead.h"
+
+#include "datasource.h"
+#include "datavector.h"
+#include "tracer.h"
+#include "updatemanager.h"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QThreadPool>
+
+#include <string.h>
+
+namespace Kst {
+
+// A hung source keeps its thread until it comes back, so don't share the
+// global pool, and leave room for the sources that still answer.
+static QThreadPool *readAheadPool() {
+  static QThreadPool *pool = 0;
+  if (!pool) {
+    pool = new QThreadPool(QCoreApplication::instance());
+    pool->setMaxThreadCount(qMax(QThread::idealThreadCount(), 8));
+  }
+  return pool;
+}
+
+
+ReadAhead::ReadAhead(DataSource *source)
+  : _source(source), _state(Idle), _late(false), _result(Object::NoChange) {
+}
+
+
+ReadAhead::~ReadAhead() {
+  QMutexLocker locker(&_mutex);
+  while (_state == Running) {
+    _done.wait(&_mutex);
+  }
+}
+
+
+void ReadAhead::start(const QList<Request> &requests, bool inWorker) {
+  {
+    QMutexLocker locker(&_mutex);
+    if (_state != Idle) {
+      return;
+    }
+    _state = Running;
+    _started.start();
+  }
+
+  if (!inWorker) {
+    run(requests, 0);
+    return;
+  }
+
+  // the reference is taken, and dropped, in the GUI thread, where sources
+  // are deleted: if the source is closed while the job runs, it goes then
+  DataSourcePtr *keep = new DataSourcePtr(_source);
+  readAheadPool()->start([this, requests, keep]() { run(requests, keep); });
+}
+
+
+bool ReadAhead::isRunning() const {
+  QMutexLocker locker(&_mutex);
+  return _state == Running;
+}
+
+
+bool ReadAhead::collect(int msecs, Object::UpdateType *result) {
+  QMutexLocker locker(&_mutex);
+  while (_state == Running) {
+    const qint64 remaining = msecs - _started.elapsed();
+    if (remaining <= 0) {
+      _late = true;
+      return false;
+    }
+    _done.wait(&_mutex, remaining);
+  }
+
+  if (_state == Finished) {
+    *result = _result;
+    _state = Collected;
+  } else {
+    *result = Object::NoChange;
+  }
+  return true;
+}
+
+
+qint64 ReadAhead::take(const QString &field, qint64 start, qint64 frames, double *v) const {
+  QMutexLocker locker(&_mutex);
+  if (_state != Collected) {
+    return -1;
+  }
+  QHash<QString, Staged>::const_iterator it = _staged.constFind(field);
+  if (it == _staged.constEnd()) {
+    return -1;
+  }
+  const Staged &staged = it.value();
+  if (start < staged.start || start + frames > staged.start + staged.data.size()) {
+    return -1;
+  }
+  memcpy(v, staged.data.constData() + (start - staged.start), frames*sizeof(double));
+  return frames;
+}
+
+
+void ReadAhead::clear() {
+  QMutexLocker locker(&_mutex);
+  if (_state == Collected) {
+    _staged.clear();
+    _state = Idle;
+  }
+}
+
+
+// The range is worked out as DataVector::internalUpdate() will: the frames
+// after those it holds, or all of them if it has to start over.  Several
+// vectors of one field share a single read covering all of them.
+//
+// In a worker, the I/O is done under the read lock: it keeps out the vectors
+// and the edits, which write lock the source, but not the GUI, which only
+// looks at what the source has found, even while a job runs over.  The
+// source publishes that under its own lock.
+void ReadAhead::run(QList<Request> requests, DataSourcePtr *keep) {
+  QHash<QString, Staged> staged;
+
+  if (keep) {
+    _source->readLock();
+  } else {
+    _source->writeLock();
+  }
+  const Object::UpdateType result = _source->internalDataSourceUpdate();
+  if (result == Object::Updated) {
+    QHash<QString, QPair<qint64, qint64> > ranges;
+    foreach (const Request &r, requests) {
+      const DataVector::DataInfo info = _source->vector().dataInfo(r.field);
+      if (info.samplesPerFrame != 1) {
+        continue;
+      }
+      const double fc = info.frameCount;
+      double new_f0, new_nf;
+      if (r.readToEnd) {
+        new_f0 = r.reqF0;
+        new_nf = fc - new_f0;
+      } else if (r.countFromEnd) {
+        new_nf = qMin(fc, r.reqNF);
+        new_f0 = fc - new_nf;
+      } else {
+        continue;
+      }
+      if (new_nf <= 0) {
+        continue;
+      }
+      qint64 first = qint64(new_f0);
+      if (r.nf <= new_nf && new_f0 >= r.f0 && new_f0 < r.f0 + r.nf) {
+        first = qint64(r.f0 + r.nf);
+      }
+      const qint64 end = qint64(new_f0 + new_nf);
+      if (end <= first) {
+        continue;
+      }
+      if (ranges.contains(r.field)) {
+        QPair<qint64, qint64> &range = ranges[r.field];
+        range.first = qMin(range.first, first);
+        range.second = qMax(range.second, end);
+      } else {
+        ranges.insert(r.field, qMakePair(first, end));
+      }
+    }
+
+    typedef DataSource::DataInterface<DataVector>::BatchRead BatchRead;
+    QList<BatchRead> reads;
+    QList<Staged> buffers;
+    qint64 samples = 0;
+    for (QHash<QString, QPair<qint64, qint64> >::const_iterator it = ranges.constBegin(); it != ranges.constEnd(); ++it) {
+      const qint64 frames = it.value().second - it.value().first;
+      if (frames > MaxFrames) {
+        continue;
+      }
+      Staged s;
+      s.start = it.value().first;
+      s.data.resize(frames);
+      buffers.append(s);
+
+      BatchRead read;
+      read.name = it.key();
+      read.info.data = buffers.last().data.data();
+      read.info.startingFrame = s.start;
+      read.info.numberOfFrames = frames;
+      read.info.skipFrame = -1;
+      read.info.singleSample = false;
+      read.samples = 0;
+      reads.append(read);
+    }
+
+    if (!reads.isEmpty()) {
+      TraceSpan span("read", QString("read ahead, %1 fields").arg(reads.size()));
+      _source->vector().readBatch(reads);
+      for (int i = 0; i < reads.size(); ++i) {
+        const qint64 n_read = reads[i].samples;
+        if (n_read > 0) {
+          buffers[i].data.resize(qMin(n_read, qint64(buffers[i].data.size())));
+          staged.insert(reads[i].name, buffers[i]);
+          samples += n_read;
+        }
+      }
+      span.setSamples(samples);
+      span.setBytes(samples * qint64(sizeof(double)));
+    }
+  }
+  _source->unlock();
+
+  QMutexLocker locker(&_mutex);
+  _staged = staged;
+  _result = result;
+  _state = Finished;
+  _done.wakeAll();
+  const bool late = _late;
+  _late = false;
+  locker.unlock();
+
+  if (!keep) {
+    return;
+  }
+
+  // an update gave up waiting for us: ask for another, as the source may
+  // not be on a timer
+  QMetaObject::invokeMethod(QCoreApplication::instance(), [keep, late]() {
+    delete keep;
+    if (late) {
+      UpdateManager::self()->doUpdates();
+    }
+  }, Qt::QueuedConnection);
+}
+
+}
+
+// vim: ts=2 sw=2 et
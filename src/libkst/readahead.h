@@ -0,0 +1,102 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef READAHEAD_H
+#define READAHEAD_H
+
+#include "object.h"
+#include "sharedptr.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+
+namespace Kst {
+
+class DataSource;
+
+/** The asynchronous I/O stage of a data source.  start() checks the source
+    for new data in a worker thread and, if it grew, reads the new frames
+    of every read-to-end or count-from-end vector into staging buffers.
+    The update then waits for it at most the source's timeout; the vectors
+    take their new frames from the buffers instead of from the file.  A job
+    that runs over (a hung mount, say) is picked up by a later update.
+
+    In a worker, the job holds the source's read lock, and a reference to
+    it, while it runs: a job that runs over keeps the vectors of the source
+    waiting, not the GUI.  Its reads go to the source as one batch (see
+    DataSource::DataInterface::readBatch()).  Sources that can't be used
+    from another thread run the job in the caller's thread, under the write
+    lock: no timeout, but their reads are still batched. */
+class KSTCORE_EXPORT ReadAhead
+{
+  public:
+    /** the state of a vector, from which the job works out what it will
+        read next */
+    struct Request {
+      QString field;
+      double f0;
+      double nf;
+      double reqF0;
+      double reqNF;
+      bool readToEnd;
+      bool countFromEnd;
+    };
+
+    explicit ReadAhead(DataSource *source);
+    /** waits for a running job */
+    ~ReadAhead();
+
+    /** does nothing if a job is already running, or finished but not yet
+        collected */
+    void start(const QList<Request> &requests, bool inWorker = true);
+    bool isRunning() const;
+
+    /** waits until the job has run for msecs in all; true if it finished.
+        The staged frames can then be taken until clear(). */
+    bool collect(int msecs, Object::UpdateType *result);
+
+    /** copies frames [start, start+frames) of field if they were staged,
+        and returns the number of samples; -1 if they were not. */
+    qint64 take(const QString &field, qint64 start, qint64 frames, double *v) const;
+
+    /** drops the staged frames once they have been collected */
+    void clear();
+
+    /** staged frames per field are capped: a first read of a whole file is
+        left to the vector */
+    static const qint64 MaxFrames = 1 << 20;
+
+  private:
+    struct Staged {
+      qint64 start;
+      QVector<double> data;
+    };
+
+    void run(QList<Request> requests, SharedPtr<DataSource> *keep);
+
+    DataSource *_source;
+    mutable QMutex _mutex;
+    QWaitCondition _done;
+    enum State { Idle, Running, Finished, Collected } _state;
+    bool _late;
+    QElapsedTimer _started;
+    Object::UpdateType _result;
+    QHash<QString, Staged> _staged;
+};
+
+}
+
+#endif
+
+// vim: ts=2 sw=2 et
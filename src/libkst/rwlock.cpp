@@ -18,15 +18,65 @@
 #include "rwlock.h"
 
 #include <qdebug.h>
+#include <qvarlengtharray.h>
 
 //#define LOCKTRACE
 
 #ifdef ONE_LOCK_TO_RULE_THEM_ALL
 QMutex KstRWLock::_mutex(true);
+#else
+namespace {
+
+// The read locks this thread holds, and how many times it holds each.  A
+// thread holds few at once, and takes the last one first, so a short list
+// searched from the end.
+struct HeldReads {
+  struct Held {
+    const KstRWLock *lock;
+    int count;
+  };
+
+  int *find(const KstRWLock *lock) {
+    for (int i = held.size() - 1; i >= 0; --i) {
+      if (held[i].lock == lock) {
+        return &held[i].count;
+      }
+    }
+    return 0;
+  }
+
+  void append(const KstRWLock *lock) {
+    const Held h = { lock, 1 };
+    held.append(h);
+  }
+
+  // false if the thread doesn't hold lock
+  bool release(const KstRWLock *lock) {
+    for (int i = held.size() - 1; i >= 0; --i) {
+      if (held[i].lock == lock) {
+        if (--held[i].count == 0) {
+          held.remove(i);
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  QVarLengthArray<Held, 16> held;
+};
+
+
+HeldReads &heldReads() {
+  thread_local HeldReads reads;
+  return reads;
+}
+
+}
 #endif
 
 KstRWLock::KstRWLock()
-: _readCount(0), _writeCount(0), _waitingReaders(0), _waitingWriters(0) {
+: _state(0), _waitingReaders(0), _waitingWriters(0), _writeCount(0), _writeLocker(0) {
 }
 
 
@@ -36,38 +86,47 @@ KstRWLock::~KstRWLock() {
 
 void KstRWLock::readLock() const {
 #ifndef ONE_LOCK_TO_RULE_THEM_ALL
-  QMutexLocker lock(&_mutex);
-  
 #ifdef LOCKTRACE
-  qDebug() << (void*)this << " KstRWLock::readLock() by tid=" << (int)QThread::currentThreadId() << Qt::endl;
-//  qDebug() << kstdBacktrace(6) << Qt::endl;
+  qDebug() << (void*)this << " KstRWLock::readLock() by tid=" << QThread::currentThreadId() << Qt::endl;
 #endif
 
-  Qt::HANDLE me = QThread::currentThreadId();
+  HeldReads &reads = heldReads();
+  if (int *held = reads.find(this)) {
+    // thread already has another read lock: it goes ahead of any writer
+    ++*held;
+    _state.fetchAndAddRelaxed(1);
+    return;
+  }
 
-  if (_writeCount > 0 && _writeLocker == me) {
-    // thread already has a write lock
-#ifdef LOCKTRACE
-    qDebug() << "Thread " << (int)QThread::currentThreadId() << " has a write lock on KstRWLock " << (void*)this << ", getting a read lock" << Qt::endl;
-#endif
-  } else {
-    QMap<Qt::HANDLE, int>::Iterator it = _readLockers.find(me);
-    if (it != _readLockers.end() && it.value() > 0) {
-      // thread already has another read lock
-    } else {
-      while (_writeCount > 0 || _waitingWriters) {  // writer priority otherwise
-        ++_waitingReaders;
-        _readerWait.wait(&_mutex);
-        --_waitingReaders;
+  for (;;) {
+    const int state = _state.loadRelaxed();
+    if (!(state & (Writing | WriterWaiting))) {
+      if (_state.testAndSetAcquire(state, state + 1)) {
+        break;
       }
+      continue;
+    }
+
+    if ((state & Writing) && _writeLocker.loadRelaxed() == QThread::currentThreadId()) {
+      // thread already has a write lock
+      _state.fetchAndAddRelaxed(1);
+      break;
     }
-  }
 
-  _readLockers[me] = _readLockers[me] + 1;
-  ++_readCount;
+    // writer priority otherwise.  Counted as waiting before looking at the
+    // state, which the writer leaving clears before looking at the count,
+    // so that one of the two sees the other.
+    QMutexLocker lock(&_mutex);
+    _waitingReaders.fetchAndAddOrdered(1);
+    while (_state.fetchAndAddOrdered(0) & (Writing | WriterWaiting)) {
+      _readerWait.wait(&_mutex);
+    }
+    _waitingReaders.fetchAndSubRelaxed(1);
+  }
+  reads.append(this);
 
 #ifdef LOCKTRACE
-  qDebug() << (void*)this << " KstRWLock::readLock() done by tid=" << (int)QThread::currentThread() << Qt::endl;
+  qDebug() << (void*)this << " KstRWLock::readLock() done by tid=" << QThread::currentThreadId() << Qt::endl;
 #endif
 #else
   _mutex.lock();
@@ -77,34 +136,47 @@ void KstRWLock::readLock() const {
 
 void KstRWLock::writeLock() const {
 #ifndef ONE_LOCK_TO_RULE_THEM_ALL
-  QMutexLocker lock(&_mutex);
-
 #ifdef LOCKTRACE
-  qDebug() << (void*)this << " KstRWLock::writeLock() by tid=" << (int)QThread::currentThreadId() << Qt::endl;
-//  qDebug() << kstdBacktrace(6) << Qt::endl;
+  qDebug() << (void*)this << " KstRWLock::writeLock() by tid=" << QThread::currentThreadId() << Qt::endl;
 #endif
 
   Qt::HANDLE me = QThread::currentThreadId();
 
-  if (_readCount > 0) {
-    QMap<Qt::HANDLE, int>::Iterator it = _readLockers.find(me);
-    if (it != _readLockers.end() && it.value() > 0) {
-      // cannot acquire a write lock if I already have a read lock -- ERROR
-      qDebug() << "Thread " << QThread::currentThread() << " tried to write lock KstRWLock " << (void*)this << " while holding a read lock" << Qt::endl;
-      return;
-    }
+  if (_writeLocker.loadRelaxed() == me) {
+    ++_writeCount;
+    return;
+  }
+
+  if (heldReads().find(this)) {
+    // cannot acquire a write lock if I already have a read lock -- ERROR
+    qDebug() << "Thread " << QThread::currentThread() << " tried to write lock KstRWLock " << (void*)this << " while holding a read lock" << Qt::endl;
+    return;
   }
 
-  while (_readCount > 0 || (_writeCount > 0 && _writeLocker != me)) {
+  if (!_state.testAndSetAcquire(0, Writing)) {
+    // Keeps new readers out while the ones inside finish.  The next writer
+    // in takes the bit over if others are still waiting.
+    QMutexLocker lock(&_mutex);
     ++_waitingWriters;
-    _writerWait.wait(&_mutex);
+    _state.fetchAndOrOrdered(WriterWaiting);
+    for (;;) {
+      const int state = _state.fetchAndAddOrdered(0);
+      if (!(state & (Writing | Readers))) {
+        const int next = Writing | (_waitingWriters > 1 ? WriterWaiting : 0);
+        if (_state.testAndSetAcquire(state, next)) {
+          break;
+        }
+        continue;
+      }
+      _writerWait.wait(&_mutex);
+    }
     --_waitingWriters;
   }
-  _writeLocker = me;
-  ++_writeCount;
+  _writeLocker.storeRelaxed(me);
+  _writeCount = 1;
 
 #ifdef LOCKTRACE
-  qDebug() << (void*)this << " KstRWLock::writeLock() done by tid=" << (int)QThread::currentThread() << Qt::endl;
+  qDebug() << (void*)this << " KstRWLock::writeLock() done by tid=" << QThread::currentThreadId() << Qt::endl;
 #endif
 #else
   _mutex.lock();
@@ -114,67 +186,62 @@ void KstRWLock::writeLock() const {
 
 void KstRWLock::unlock() const {
 #ifndef ONE_LOCK_TO_RULE_THEM_ALL
-  QMutexLocker lock(&_mutex);
-
 #ifdef LOCKTRACE
-  qDebug() << (void*)this << " KstRWLock::unlock() by tid=" << (int)QThread::currentThreadId() << Qt::endl;
+  qDebug() << (void*)this << " KstRWLock::unlock() by tid=" << QThread::currentThreadId() << Qt::endl;
 #endif
 
-  Qt::HANDLE me = QThread::currentThreadId();
-
-  if (_readCount > 0) {
-    QMap<Qt::HANDLE, int>::Iterator it = _readLockers.find(me);
-    if (it == _readLockers.end()) {
-      // read locked but not by me -- ERROR
-      qDebug() << "Thread " << QThread::currentThread() << " tried to unlock KstRWLock " << (void*)this << " (read locked) without holding the lock" << Qt::endl;
-      return;
-    } else {
-      --_readCount;
-      if (it.value() == 1) {
-        _readLockers.remove(it.key());
-      } else {
-        --(it.value());
-      }
-    }
-  } else if (_writeCount > 0) {
-    if (_writeLocker != me) {
-      // write locked but not by me -- ERROR
-      qDebug() << "Thread " << QThread::currentThread() << " tried to unlock KstRWLock " << (void*)this << " (write locked) without holding the lock" << Qt::endl;
-      return;
-    } else {
-      --_writeCount;
-    }
-  } else if (_readCount == 0 && _writeCount == 0) {
-    // not locked -- ERROR
-    qDebug() << "Thread " << QThread::currentThread() << " tried to unlock KstRWLock " << (void*)this << " (unlocked) without holding the lock" << Qt::endl;
-    return;
+  if (heldReads().release(this)) {
+    readUnlock();
+  } else if (_writeLocker.loadRelaxed() == QThread::currentThreadId()) {
+    writeUnlock();
+  } else {
+    // not locked by me -- ERROR
+    qDebug() << "Thread " << QThread::currentThread() << " tried to unlock KstRWLock " << (void*)this << " without holding the lock" << Qt::endl;
   }
+#else
+  _mutex.unlock();
+#endif
+}
 
-  if (_readCount == 0 && _writeCount == 0) {
-    // no locks remaining
-    if (_waitingWriters) {
-      _writerWait.wakeOne();
-    } else if (_waitingReaders) {
-      _readerWait.wakeAll();
-    }
-  }
 
-#ifdef LOCKTRACE
-  qDebug() << (void*)this << " KstRWLock::unlock() done by tid=" << (int)QThread::currentThread() << Qt::endl;
+void KstRWLock::readUnlock() const {
+#ifndef ONE_LOCK_TO_RULE_THEM_ALL
+  const int state = _state.fetchAndSubOrdered(1) - 1;
+  if ((state & WriterWaiting) && !(state & Readers)) {
+    // the last reader out lets the waiting writer in
+    QMutexLocker lock(&_mutex);
+    _writerWait.wakeOne();
+  }
 #endif
-#else
-  _mutex.unlock();
+}
+
+
+void KstRWLock::writeUnlock() const {
+#ifndef ONE_LOCK_TO_RULE_THEM_ALL
+  if (--_writeCount > 0) {
+    return;
+  }
+  _writeLocker.storeRelaxed(0);
+
+  const int state = _state.fetchAndAndOrdered(~Writing);
+  if (state & WriterWaiting) {
+    QMutexLocker lock(&_mutex);
+    _writerWait.wakeOne();
+  } else if (_waitingReaders.fetchAndAddOrdered(0) > 0) {
+    QMutexLocker lock(&_mutex);
+    _readerWait.wakeAll();
+  }
 #endif
 }
 
 
 KstRWLock::LockStatus KstRWLock::lockStatus() const {
 #ifndef ONE_LOCK_TO_RULE_THEM_ALL
-  QMutexLocker lock(&_mutex);
+  const int state = _state.loadAcquire();
 
-  if (_writeCount > 0) {
+  if (state & Writing) {
     return WRITELOCKED;
-  } else if (_readCount > 0) {
+  } else if (state & Readers) {
     return READLOCKED;
   } else {
     return UNLOCKED;
@@ -188,13 +255,9 @@ KstRWLock::LockStatus KstRWLock::lockStatus() const {
 
 KstRWLock::LockStatus KstRWLock::myLockStatus() const {
 #ifndef ONE_LOCK_TO_RULE_THEM_ALL
-  QMutexLocker lock(&_mutex);
-
-  Qt::HANDLE me = QThread::currentThreadId();
-
-  if (_writeCount > 0 && _writeLocker == me) {
+  if (_writeLocker.loadRelaxed() == QThread::currentThreadId()) {
     return WRITELOCKED;
-  } else if (_readCount > 0 && _readLockers.find(me) != _readLockers.end()) {
+  } else if (heldReads().find(this)) {
     return READLOCKED;
   } else {
     return UNLOCKED;
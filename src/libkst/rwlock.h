@@ -18,8 +18,8 @@
 #ifndef RWLOCK_H
 #define RWLOCK_H
 
+#include <qatomic.h>
 #include <qmutex.h>
-#include <qmap.h>
 #include <qthread.h>
 #include <qwaitcondition.h>
 
@@ -31,6 +31,12 @@
 //       variables or virtual functions, or when you remove or change
 //       non-virtual functions.
 
+// A read/write lock, recursive in each thread, that a thread holding the
+// write lock may also read lock.  Readers come and go without the mutex
+// while no writer holds the lock or waits for it: one atomic operation
+// each way.  A writer that has to wait blocks new readers, other than
+// those already holding the lock, so a steady stream of them can't starve
+// it.
 class KSTCORE_EXPORT KstRWLock {
   public:
     KstRWLock();
@@ -55,11 +61,19 @@ class KSTCORE_EXPORT KstRWLock {
     QMutex _mutex;
     mutable QWaitCondition _readerWait, _writerWait;
 
-    mutable int _readCount, _writeCount;
-    mutable int _waitingReaders, _waitingWriters;
+    // the read locks held, and the Writing and WriterWaiting bits
+    enum { Writing = 1 << 30, WriterWaiting = 1 << 29, Readers = WriterWaiting - 1 };
+    mutable QAtomicInt _state;
+    mutable QAtomicInt _waitingReaders;
+    mutable int _waitingWriters; // under the mutex
 
-    mutable Qt::HANDLE _writeLocker;
-    mutable QMap<Qt::HANDLE, int> _readLockers;
+    // only the writer touches these while it holds the lock
+    mutable int _writeCount;
+    mutable QAtomicPointer<void> _writeLocker;
+
+  private:
+    void readUnlock() const;
+    void writeUnlock() const;
 };
 
 
@@ -0,0 +1,302 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "samplebuffer.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <QDebug>
+
+namespace Kst {
+
+SampleBuffer::SampleBuffer()
+  : _type(Int16), _size(0), _capacity(0), _sliding(false), _base(0L), _data(0L) {
+}
+
+
+SampleBuffer::~SampleBuffer() {
+  free(_base);
+}
+
+
+int SampleBuffer::typeSize(Type type) {
+  switch (type) {
+    case Int16:
+      return sizeof(qint16);
+    case Int32:
+      return sizeof(qint32);
+    case Float32:
+      return sizeof(float);
+    default:
+      return sizeof(double);
+  }
+}
+
+
+QString SampleBuffer::typeName(Type type) {
+  switch (type) {
+    case Int16:
+      return QStringLiteral("int16");
+    case Int32:
+      return QStringLiteral("int32");
+    case Float32:
+      return QStringLiteral("float32");
+    default:
+      return QStringLiteral("float64");
+  }
+}
+
+
+SampleBuffer::Type SampleBuffer::classify(double v) {
+  if (v != v) {
+    return Float32; // NaN: no integer representation
+  }
+  if (v >= -32768.0 && v <= 32767.0 && v == double(qint16(v)) && !(v == 0.0 && signbit(v))) {
+    return Int16;
+  }
+  if (v >= -2147483648.0 && v <= 2147483647.0 && v == double(qint32(v)) && !(v == 0.0 && signbit(v))) {
+    return Int32;
+  }
+  if (double(float(v)) == v) {
+    return Float32;
+  }
+  return Float64;
+}
+
+
+// the narrowest type which holds everything a and b each hold exactly.
+static SampleBuffer::Type joinTypes(SampleBuffer::Type a, SampleBuffer::Type b) {
+  if (a == b) {
+    return a;
+  }
+  if (a == SampleBuffer::Int16) {
+    return b;
+  }
+  if (b == SampleBuffer::Int16) {
+    return a;
+  }
+  // int32 and float32 can't hold each other's values
+  return SampleBuffer::Float64;
+}
+
+
+qint64 SampleBuffer::bytes() const {
+  return qint64(_capacity) * typeSize(_type);
+}
+
+
+qint64 SampleBuffer::offset() const {
+  return qint64((static_cast<const char*>(_data) - static_cast<const char*>(_base)) / typeSize(_type));
+}
+
+
+void SampleBuffer::clear() {
+  free(_base);
+  _base = _data = 0L;
+  _size = _capacity = 0;
+  _type = Int16;
+}
+
+
+void SampleBuffer::setSliding(bool sliding) {
+  _sliding = sliding;
+}
+
+
+bool SampleBuffer::resize(qint64 size) {
+  if (size < 0) {
+    size = 0;
+  }
+  if (size == _size) {
+    return true;
+  }
+  const int ts = typeSize(_type);
+  const qint64 off = offset();
+
+  if (!_sliding || off + size > _capacity) {
+    // move the data back to the start of the allocation
+    if (off > 0) {
+      memmove(_base, _data, size_t(qMin(_size, size)) * ts);
+      _data = _base;
+    }
+    if (!_sliding || size > _capacity) {
+      const qint64 capacity = _sliding ? size + size/2 : size;
+      void *newptr = realloc(_base, qMax(capacity, qint64(1)) * size_t(ts));
+      if (!newptr) {
+        qCritical() << "SampleBuffer resize failed";
+        return false;
+      }
+      _base = _data = newptr;
+      _capacity = capacity;
+    }
+  }
+
+  if (size > _size) {
+    memset(static_cast<char*>(_data) + size_t(_size) * ts, 0, size_t(size - _size) * ts);
+  }
+  _size = size;
+  return true;
+}
+
+
+bool SampleBuffer::promote(Type type) {
+  if (type == _type) {
+    return true;
+  }
+  const qint64 capacity = _sliding ? _size + _size/2 : _size;
+  void *newptr = malloc(qMax(capacity, qint64(1)) * size_t(typeSize(type)));
+  if (!newptr) {
+    qCritical() << "SampleBuffer promotion to" << typeName(type) << "failed";
+    return false;
+  }
+
+  // decode in blocks so we don't need a full double copy
+  const int block = 4096;
+  double tmp[block];
+  for (qint64 i = 0; i < _size; i += block) {
+    int n = int(qMin(qint64(block), _size - i));
+    read(i, n, tmp);
+    for (int k = 0; k < n; ++k) {
+      switch (type) {
+        case Int32:
+          static_cast<qint32*>(newptr)[i + k] = qint32(tmp[k]);
+          break;
+        case Float32:
+          static_cast<float*>(newptr)[i + k] = float(tmp[k]);
+          break;
+        case Float64:
+          static_cast<double*>(newptr)[i + k] = tmp[k];
+          break;
+        default:
+          Q_ASSERT(false); // we never demote
+          break;
+      }
+    }
+  }
+  free(_base);
+  _base = _data = newptr;
+  _capacity = capacity;
+  _type = type;
+  return true;
+}
+
+
+bool SampleBuffer::write(qint64 pos, const double *src, qint64 n) {
+  if (n <= 0) {
+    return true;
+  }
+  Q_ASSERT(pos >= 0 && pos + n <= _size);
+
+  // find the narrowest type which holds the old and new samples
+  Type needed = _type;
+  if (needed != Float64) {
+    for (qint64 i = 0; i < n; ++i) {
+      Type t = classify(src[i]);
+      if (t != needed && joinTypes(needed, t) != needed) {
+        needed = joinTypes(needed, t);
+        if (needed == Float64) {
+          break;
+        }
+      }
+    }
+  }
+  if (!promote(needed)) {
+    return false;
+  }
+
+  switch (_type) {
+    case Int16:
+      for (qint64 i = 0; i < n; ++i) {
+        static_cast<qint16*>(_data)[pos + i] = qint16(src[i]);
+      }
+      break;
+    case Int32:
+      for (qint64 i = 0; i < n; ++i) {
+        static_cast<qint32*>(_data)[pos + i] = qint32(src[i]);
+      }
+      break;
+    case Float32:
+      for (qint64 i = 0; i < n; ++i) {
+        static_cast<float*>(_data)[pos + i] = float(src[i]);
+      }
+      break;
+    default:
+      memcpy(static_cast<double*>(_data) + pos, src, n * sizeof(double));
+      break;
+  }
+  return true;
+}
+
+
+bool SampleBuffer::fill(qint64 pos, qint64 n, double value) {
+  if (n <= 0) {
+    return true;
+  }
+  if (!write(pos, &value, 1)) {
+    return false;
+  }
+  const int ts = typeSize(_type);
+  char *p = static_cast<char*>(_data) + size_t(pos) * ts;
+  for (qint64 i = 1; i < n; ++i) {
+    memcpy(p + size_t(i) * ts, p, ts);
+  }
+  return true;
+}
+
+
+void SampleBuffer::read(qint64 pos, qint64 n, double *dst) const {
+  Q_ASSERT(pos >= 0 && pos + n <= _size);
+  switch (_type) {
+    case Int16:
+      for (qint64 i = 0; i < n; ++i) {
+        dst[i] = static_cast<const qint16*>(_data)[pos + i];
+      }
+      break;
+    case Int32:
+      for (qint64 i = 0; i < n; ++i) {
+        dst[i] = static_cast<const qint32*>(_data)[pos + i];
+      }
+      break;
+    case Float32:
+      for (qint64 i = 0; i < n; ++i) {
+        dst[i] = static_cast<const float*>(_data)[pos + i];
+      }
+      break;
+    default:
+      memcpy(dst, static_cast<const double*>(_data) + pos, n * sizeof(double));
+      break;
+  }
+}
+
+
+void SampleBuffer::shift(qint64 n) {
+  if (n <= 0) {
+    return;
+  }
+  if (n >= _size) {
+    _size = 0;
+    _data = _base;
+    return;
+  }
+  const int ts = typeSize(_type);
+  if (_sliding) {
+    _data = static_cast<char*>(_data) + size_t(n) * ts;
+  } else {
+    memmove(_data, static_cast<char*>(_data) + size_t(n) * ts, size_t(_size - n) * ts);
+  }
+  _size -= n;
+}
+
+}
+
+// vim: ts=2 sw=2 et
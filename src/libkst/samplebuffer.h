@@ -0,0 +1,107 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SAMPLEBUFFER_H
+#define SAMPLEBUFFER_H
+
+#include <QString>
+
+#include "kstcore_export.h"
+
+namespace Kst {
+
+/** Compact backing store for vector samples.
+ *
+ *  Samples are written and read as doubles, but are held in the narrowest
+ *  type which represents every sample written so far exactly.  Most data
+ *  files store int16 or float32 fields, so this typically saves 50 to 75%
+ *  of the memory of a plain double array.  When a sample arrives which the
+ *  current type can not hold exactly, the whole buffer is promoted, so
+ *  reading back always returns exactly what was written.
+ */
+class KSTCORE_EXPORT SampleBuffer
+{
+  public:
+    enum Type { Int16 = 0, Int32, Float32, Float64 };
+
+    SampleBuffer();
+    ~SampleBuffer();
+
+    Type type() const { return _type; }
+    qint64 length() const { return _size; }
+
+    /** change the number of samples held.  New samples are 0. */
+    bool resize(qint64 size);
+
+    /** release all memory and go back to the narrowest type */
+    void clear();
+
+    /** store n samples starting at sample pos.  Promotes as needed. */
+    bool write(qint64 pos, const double *src, qint64 n);
+
+    /** set n samples starting at pos to value */
+    bool fill(qint64 pos, qint64 n, double value);
+
+    /** decode n samples starting at sample pos into dst */
+    void read(qint64 pos, qint64 n, double *dst) const;
+
+    /** decode a single sample.  No range checking. */
+    inline double at(qint64 i) const {
+      switch (_type) {
+        case Int16:
+          return static_cast<const qint16*>(_data)[i];
+        case Int32:
+          return static_cast<const qint32*>(_data)[i];
+        case Float32:
+          return static_cast<const float*>(_data)[i];
+        default:
+          return static_cast<const double*>(_data)[i];
+      }
+    }
+
+    /** drop the first n samples, keeping the rest in order */
+    void shift(qint64 n);
+
+    /** In sliding mode the allocation keeps headroom past the end, and
+        shift() just moves the start of the data into it. */
+    void setSliding(bool sliding);
+
+    /** the samples, in the representation given by type() */
+    const void *data() const { return _data; }
+
+    /** bytes of sample storage currently allocated, including headroom */
+    qint64 bytes() const;
+
+    static int typeSize(Type type);
+    static QString typeName(Type type);
+
+    /** the narrowest type which holds v exactly */
+    static Type classify(double v);
+
+  private:
+    Q_DISABLE_COPY(SampleBuffer)
+
+    bool promote(Type type);
+    qint64 offset() const;
+
+    Type _type;
+    qint64 _size;
+    qint64 _capacity;
+    bool _sliding;
+    void *_base; // the allocation
+    void *_data; // the first sample: _base, or later in sliding mode
+};
+
+}
+
+#endif
+
+// vim: ts=2 sw=2 et
@@ -111,6 +111,8 @@ PrimitivePtr DataScalarFactory::generatePrimitive(ObjectStore *store, QXmlStream
 
         if (!store->override.fileName.isEmpty()) {
           file = store->override.fileName;
+        } else {
+          file = store->override.files.value(file, file);
         }
 
         if (attrs.value("descriptiveNameIsManual").toString() == "true") {
@@ -183,6 +185,8 @@ PrimitivePtr VScalarFactory::generatePrimitive(ObjectStore *store, QXmlStreamRea
 
         if (!store->override.fileName.isEmpty()) {
           file = store->override.fileName;
+        } else {
+          file = store->override.files.value(file, file);
         }
 
         field = attrs.value("field").toString();
@@ -14,7 +14,7 @@
 #ifndef SharedPTR_H
 #define SharedPTR_H
 
-#include <QSemaphore>
+#include <QAtomicInt>
 #include <QDebug>
 
 // Supress GCC 13's (apparently) over-agressive warnings about use of this class.
@@ -46,21 +46,19 @@
 
 namespace Kst {
 
-#define SEMAPHORE_COUNT 999999
-
 class Shared {
 public:
    /**
     * Standard constructor.  This will initialize the reference count
     * on this object to 0.
     */
-   Shared() : sem(SEMAPHORE_COUNT) { }
+   Shared() : count(0) { }
 
    /**
     * Copy constructor.  This will @em not actually copy the objects
     * but it will initialize the reference count on this object to 0.
     */
-   Shared( const Shared & ) : sem(SEMAPHORE_COUNT) { }
+   Shared( const Shared & ) : count(0) { }
 
    /**
     * Overloaded assignment operator.
@@ -71,7 +69,7 @@ public:
     * Increases the reference count by one.
     */
    void _KShared_ref() const {
-     sem.acquire(1);
+     count.ref();
      KST_DBG qDebug() << "KShared_ref: " << (void*)this << " -> " << _KShared_count() << Qt::endl;
    }
 
@@ -80,9 +78,9 @@ public:
     * the count goes to 0, this object will delete itself.
     */
    void _KShared_unref() const {
-     sem.release(1);
+     const bool referenced = count.deref();
      KST_DBG qDebug() << "KShared_unref: " << (void*)this << " -> " << _KShared_count() << Qt::endl;
-     if (SEMAPHORE_COUNT == sem.available()) delete this;
+     if (!referenced) delete this;
    }
 
    /**
@@ -90,13 +88,13 @@ public:
     *
     * @return Number of references
     */
-   int _KShared_count() const { return SEMAPHORE_COUNT - sem.available(); }
+   int _KShared_count() const { return count.loadRelaxed(); }
 
 protected:
    virtual ~Shared() { }
 
 private:
-   mutable QSemaphore sem;
+   mutable QAtomicInt count;
 };
 
 
@@ -209,5 +207,78 @@ inline SharedPtr<T> kst_cast(QObject *object) {
   return qobject_cast<T*>(object);
 }
 
+
+/**
+ * The object of a SharedPtr, used without a reference of its own.  Copying
+ * a SharedPtr takes a reference and drops it again, an atomic operation on
+ * a count that every thread using the object touches; copying a Borrowed
+ * costs nothing.  For loops over objects that are held elsewhere, eg. the
+ * objects of the store during an update, and for pointers to a base class
+ * of them, which would otherwise be SharedPtrs of their own.  It must not
+ * outlive what holds the object: keep() a SharedPtr for that.
+ */
+template <class T>
+class Borrowed
+{
+public:
+  Borrowed() : ptr(0) { }
+  Borrowed( T* t ) : ptr(t) { }
+  template <class Y> Borrowed( const SharedPtr<Y>& p ) : ptr(static_cast<Y*>(p)) { }
+  template <class Y> Borrowed( const Borrowed<Y>& b ) : ptr(b.data()) { }
+
+  bool operator!() const { return ptr == 0; }
+  operator T*() const { return ptr; }
+  T* data() const { return ptr; }
+  T& operator*() const { Q_ASSERT(ptr); return *ptr; }
+  T* operator->() const { Q_ASSERT(ptr); return ptr; }
+
+  /**
+   * A reference of its own to the object, to hold on to it.
+   */
+  SharedPtr<T> keep() const { return SharedPtr<T>(ptr); }
+
+private:
+  T* ptr;
+};
+
+
+/**
+ * The SharedPtrs of a list, or the values of a map, as Borrowed<T>s:
+ *
+ *   for (Borrowed<Object> object : borrow<Object>(store->objectList())) ...
+ *
+ * The container is held, as one more implicitly shared copy, for as long
+ * as the loop runs; its objects aren't.
+ */
+template <class T, class Container>
+class BorrowedRange
+{
+public:
+  class const_iterator
+  {
+  public:
+    const_iterator( typename Container::const_iterator i ) : it(i) { }
+    Borrowed<T> operator*() const { return Borrowed<T>(*it); }
+    const_iterator& operator++() { ++it; return *this; }
+    bool operator==( const const_iterator& o ) const { return it == o.it; }
+    bool operator!=( const const_iterator& o ) const { return it != o.it; }
+  private:
+    typename Container::const_iterator it;
+  };
+
+  explicit BorrowedRange( const Container& c ) : container(c) { }
+  const_iterator begin() const { return const_iterator(container.constBegin()); }
+  const_iterator end() const { return const_iterator(container.constEnd()); }
+
+private:
+  const Container container;
+};
+
+
+template <class T, class Container>
+inline BorrowedRange<T, Container> borrow(const Container& c) {
+  return BorrowedRange<T, Container>(c);
+}
+
 }
 #endif
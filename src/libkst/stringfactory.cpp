@@ -110,6 +110,8 @@ PrimitivePtr DataStringFactory::generatePrimitive(ObjectStore *store, QXmlStream
 
         if (!store->override.fileName.isEmpty()) {
           file = store->override.fileName;
+        } else {
+          file = store->override.files.value(file, file);
         }
 
         if (attrs.value("descriptiveNameIsManual").toString() == "true") {
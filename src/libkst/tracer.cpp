@@ -0,0 +1,276 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "tracer.h"
+
+#include "namedobject.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace Kst {
+
+static const quint64 TraceCapacity = 16384;
+static const int TraceNameLength = 64;
+
+// seq is 2*ticket+1 while the span of that ticket is being written, and
+// 2*ticket+2 once it is complete.
+struct Tracer::Slot {
+  std::atomic<quint64> seq;
+  const char *category;
+  char name[TraceNameLength];
+  int nameLength;
+  qint64 start;
+  qint64 duration;
+  quint64 thread;
+  qint64 samples;
+  qint64 bytes;
+};
+
+
+struct Tracer::Private {
+  std::atomic<bool> enabled;
+  std::atomic<quint64> next;
+  std::atomic<quint64> first;   // spans before this were cleared
+  Slot *slots;
+  QElapsedTimer clock;
+};
+
+
+// spans are recorded from worker threads too, so the first call must be
+// safe to race
+Tracer *Tracer::self() {
+  static Tracer tracer;
+  return &tracer;
+}
+
+
+Tracer::Tracer() {
+  d = new Private;
+  d->enabled = qEnvironmentVariable("KST_TRACE") != QLatin1String("0");
+  d->next = 0;
+  d->first = 0;
+  d->slots = new Slot[TraceCapacity];
+  for (quint64 i = 0; i < TraceCapacity; ++i) {
+    d->slots[i].seq = 0;
+  }
+  d->clock.start();
+}
+
+
+Tracer::~Tracer() {
+  delete[] d->slots;
+  delete d;
+}
+
+
+bool Tracer::isEnabled() const {
+  return d->enabled.load(std::memory_order_relaxed);
+}
+
+
+void Tracer::setEnabled(bool enabled) {
+  d->enabled = enabled;
+}
+
+
+qint64 Tracer::now() const {
+  return d->clock.nsecsElapsed();
+}
+
+
+void Tracer::record(const char *category, const QString &name, qint64 start, qint64 samples, qint64 bytes) {
+  if (!isEnabled()) {
+    return;
+  }
+  const qint64 end = now();
+
+  // cut on a character boundary
+  const QByteArray utf8 = name.toUtf8();
+  int length = qMin(utf8.size(), TraceNameLength);
+  if (length < utf8.size()) {
+    while (length > 0 && (uchar(utf8[length]) & 0xC0) == 0x80) {
+      --length;
+    }
+  }
+
+  const quint64 ticket = d->next.fetch_add(1, std::memory_order_relaxed);
+  Slot &slot = d->slots[ticket % TraceCapacity];
+  slot.seq.store(2*ticket + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.category = category;
+  memcpy(slot.name, utf8.constData(), length);
+  slot.nameLength = length;
+  slot.start = start;
+  slot.duration = end - start;
+  slot.thread = quint64(quintptr(QThread::currentThreadId()));
+  slot.samples = samples;
+  slot.bytes = bytes;
+
+  slot.seq.store(2*ticket + 2, std::memory_order_release);
+}
+
+
+QList<Tracer::Span> Tracer::spans() const {
+  QList<Span> list;
+
+  const quint64 next = d->next.load(std::memory_order_acquire);
+  quint64 ticket = d->first.load(std::memory_order_relaxed);
+  if (next > TraceCapacity) {
+    ticket = qMax(ticket, next - TraceCapacity);
+  }
+
+  for (; ticket < next; ++ticket) {
+    const Slot &slot = d->slots[ticket % TraceCapacity];
+    const quint64 seq = slot.seq.load(std::memory_order_acquire);
+    if (seq != 2*ticket + 2) {
+      continue;   // still being written, or already overwritten
+    }
+
+    char name[TraceNameLength];
+    const int length = qBound(0, slot.nameLength, TraceNameLength);
+    memcpy(name, slot.name, length);
+    Span span;
+    span.category = QByteArray(slot.category);
+    span.start = slot.start;
+    span.duration = slot.duration;
+    span.thread = slot.thread;
+    span.samples = slot.samples;
+    span.bytes = slot.bytes;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != seq) {
+      continue;
+    }
+    span.name = QString::fromUtf8(name, length);
+    list.append(span);
+  }
+
+  return list;
+}
+
+
+void Tracer::clear() {
+  d->first = d->next.load();
+}
+
+
+QList<Tracer::Summary> Tracer::summary() const {
+  QHash<QPair<QByteArray, QString>, int> index;
+  QList<Summary> list;
+
+  const QList<Span> all = spans();
+  foreach (const Span &span, all) {
+    const QPair<QByteArray, QString> key(span.category, span.name);
+    int i = index.value(key, -1);
+    if (i < 0) {
+      Summary s;
+      s.category = span.category;
+      s.name = span.name;
+      s.count = 0;
+      s.total = s.max = s.samples = s.bytes = 0;
+      i = list.size();
+      index.insert(key, i);
+      list.append(s);
+    }
+    Summary &s = list[i];
+    s.count++;
+    s.total += span.duration;
+    s.max = qMax(s.max, span.duration);
+    s.samples += span.samples;
+    s.bytes += span.bytes;
+  }
+
+  std::sort(list.begin(), list.end(), [](const Summary &a, const Summary &b) {
+    return a.total > b.total;
+  });
+  return list;
+}
+
+
+QByteArray Tracer::chromeTrace() const {
+  const qint64 pid = QCoreApplication::applicationPid();
+  QHash<quint64, int> threads;   // small ids read better than addresses
+  QJsonArray events;
+
+  const QList<Span> all = spans();
+  foreach (const Span &span, all) {
+    int tid = threads.value(span.thread, -1);
+    if (tid < 0) {
+      tid = threads.size() + 1;
+      threads.insert(span.thread, tid);
+    }
+
+    QJsonObject args;
+    if (span.samples) {
+      args.insert("samples", double(span.samples));
+    }
+    if (span.bytes) {
+      args.insert("bytes", double(span.bytes));
+    }
+
+    QJsonObject event;
+    event.insert("name", span.name);
+    event.insert("cat", QString::fromLatin1(span.category));
+    event.insert("ph", QStringLiteral("X"));
+    event.insert("ts", span.start / 1000.0);
+    event.insert("dur", span.duration / 1000.0);
+    event.insert("pid", double(pid));
+    event.insert("tid", tid);
+    event.insert("args", args);
+    events.append(event);
+  }
+
+  QJsonObject trace;
+  trace.insert("traceEvents", events);
+  trace.insert("displayTimeUnit", QStringLiteral("ms"));
+  return QJsonDocument(trace).toJson(QJsonDocument::Compact);
+}
+
+
+TraceSpan::TraceSpan(const char *category, const NamedObject *object)
+  : _category(category), _object(object), _start(-1), _samples(0), _bytes(0) {
+  Tracer *tracer = Tracer::self();
+  if (tracer->isEnabled()) {
+    _start = tracer->now();
+  }
+}
+
+
+TraceSpan::TraceSpan(const char *category, const QString &name)
+  : _category(category), _object(0), _name(name), _start(-1), _samples(0), _bytes(0) {
+  Tracer *tracer = Tracer::self();
+  if (tracer->isEnabled()) {
+    _start = tracer->now();
+  }
+}
+
+
+TraceSpan::~TraceSpan() {
+  if (_start < 0) {
+    return;
+  }
+  Tracer::self()->record(_category, _object ? _object->Name() : _name, _start, _samples, _bytes);
+}
+
+}
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,115 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include "kstcore_export.h"
+
+namespace Kst {
+class NamedObject;
+
+/** Records timed spans (an update tick, a data source read, a relation
+ *  paint, ...) into a fixed size ring buffer, for looking at where the time
+ *  goes without rebuilding kst.
+ *
+ *  Recording takes no locks: each span claims a slot with an atomic counter
+ *  and marks it complete with a sequence number, so readers skip slots which
+ *  are being written.  When the buffer is full, the oldest spans are
+ *  overwritten.
+ */
+class KSTCORE_EXPORT Tracer
+{
+  public:
+    struct KSTCORE_EXPORT Span {
+      QByteArray category;
+      QString name;
+      qint64 start;     // ns since the tracer was created
+      qint64 duration;  // ns
+      quint64 thread;
+      qint64 samples;
+      qint64 bytes;
+    };
+
+    struct KSTCORE_EXPORT Summary {
+      QByteArray category;
+      QString name;
+      int count;
+      qint64 total;     // ns
+      qint64 max;       // ns
+      qint64 samples;
+      qint64 bytes;
+    };
+
+    static Tracer *self();
+
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+
+    /** ns since the tracer was created */
+    qint64 now() const;
+
+    /** category must be a string literal: only the pointer is kept */
+    void record(const char *category, const QString &name, qint64 start, qint64 samples = 0, qint64 bytes = 0);
+
+    /** the spans in the buffer, oldest first */
+    QList<Span> spans() const;
+    void clear();
+
+    /** spans grouped by category and name, most total time first */
+    QList<Summary> summary() const;
+
+    /** the spans in the Chrome trace event format, for chrome://tracing
+        or Perfetto */
+    QByteArray chromeTrace() const;
+
+  private:
+    Tracer();
+    ~Tracer();
+
+    struct Slot;
+    struct Private;
+    Private *d;
+};
+
+
+/** Times the enclosing scope and records it with the tracer.  The object's
+ *  name is only looked up if tracing is enabled. */
+class KSTCORE_EXPORT TraceSpan
+{
+  public:
+    TraceSpan(const char *category, const NamedObject *object);
+    TraceSpan(const char *category, const QString &name);
+    ~TraceSpan();
+
+    void setSamples(qint64 samples) { _samples = samples; }
+    void setBytes(qint64 bytes) { _bytes = bytes; }
+
+  private:
+    Q_DISABLE_COPY(TraceSpan)
+
+    const char *_category;
+    const NamedObject *_object;
+    QString _name;
+    qint64 _start;
+    qint64 _samples;
+    qint64 _bytes;
+};
+
+}
+
+#endif
+
+// vim: ts=2 sw=2 et
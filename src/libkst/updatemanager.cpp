@@ -14,13 +14,21 @@
 
 //#include "primitive.h"
 #include "datasource.h"
+#include "datavector.h"
+#include "memorymanager.h"
+#include "readahead.h"
 #include "objectstore.h"
+#include "tracer.h"
 //#include "measuretime.h"
 #include <QCoreApplication>
+#include <QHash>
+#include <QSet>
 #include <QTimer>
 #include <QDebug>
 
 #define DEFAULT_MIN_UPDATE_PERIOD 2000
+// long enough for a healthy local or network disk to answer every update
+#define DEFAULT_READ_AHEAD_TIMEOUT 500
 
 namespace Kst {
 
@@ -42,7 +50,9 @@ UpdateManager *UpdateManager::self() {
 
 UpdateManager::UpdateManager() {
   _serial = 0;
+  _concurrentSourceUpdates = 0;
   _minUpdatePeriod = DEFAULT_MIN_UPDATE_PERIOD;
+  _readAheadTimeout = DEFAULT_READ_AHEAD_TIMEOUT;
   _paused = false;
   _store = 0;
   _delayedUpdateScheduled = false;
@@ -68,6 +78,11 @@ void UpdateManager::doUpdates(bool forceImmediate) {
     return;
   }
 
+  if (_store->inTransaction()) {
+    _store->holdUpdate();
+    return;
+  }
+
   //FIXME: should we just skip updating data sources in this case?
   if (_paused && !forceImmediate) {
     return;
@@ -90,15 +105,9 @@ void UpdateManager::doUpdates(bool forceImmediate) {
 
   _serial++;
 
-  int n_updated=0, n_deferred=0, n_unchanged = 0;
-  qint64 retval = 0;
+  TraceSpan span("tick", QString("update %1").arg(_serial));
 
-  // update the datasources
-  foreach (DataSourcePtr ds, _store->dataSourceList()) {
-    ds->writeLock();
-    ds->objectUpdate(_serial);
-    ds->unlock();
-  }
+  updateDataSources();
 
   // We are going to check all data objects regardless of whether
   // files have been changed, because the necessity of an update
@@ -106,12 +115,166 @@ void UpdateManager::doUpdates(bool forceImmediate) {
 
   //MeasureTime t(" UpdateManager::doUpdates loop");
 
+  updateObjects(_store->objectList());
+
+  finishDataSources(forceImmediate);
+
+  emit objectsUpdated(_serial);
+}
+
+
+void UpdateManager::beginStagedUpdate() {
+  if (!_store) {
+    return;
+  }
+  _updateInProgress = true;
+  _time.restart();
+  _serial++;
+
+  TraceSpan span("tick", QString("update %1, data sources").arg(_serial));
+  updateDataSources();
+}
+
+
+void UpdateManager::endStagedUpdate() {
+  if (!_store) {
+    return;
+  }
+
+  TraceSpan span("tick", QString("update %1, objects").arg(_serial));
+  updateObjects(_store->objectList());
+
+  finishDataSources(true);
+
+  emit objectsUpdated(_serial);
+}
+
+
+void UpdateManager::endTransaction(ObjectStore *store, bool update) {
+  if (store != _store) {
+    return;
+  }
+  emit transactionEnded();
+  if (!update) {
+    return;
+  }
+
+  _updateInProgress = true;
+  _time.restart();
+  _serial++;
+
+  TraceSpan span("tick", QString("update %1, transaction").arg(_serial));
+  updateDataSources();
+  updateObjects(sortedByInputs(_store->objectList()));
+  finishDataSources(true);
+
+  emit objectsUpdated(_serial);
+}
+
+
+bool UpdateManager::inTransaction() const {
+  return _store && _store->inTransaction();
+}
+
+
+static void appendSorted(Object *object, const QHash<Object*, ObjectPtr> &listed,
+                         QSet<Object*> *visited, QList<ObjectPtr> *sorted) {
+  if (visited->contains(object)) {
+    return; // done, or an input of itself
+  }
+  visited->insert(object);
+  foreach (ObjectPtr input, object->inputObjects()) {
+    if (input) {
+      appendSorted(input, listed, visited, sorted);
+    }
+  }
+  if (listed.contains(object)) {
+    sorted->append(listed.value(object));
+  }
+}
+
+
+// A depth first walk of the inputs: the objects in the list come out after
+// their inputs, and otherwise in the order they were in.
+QList<ObjectPtr> UpdateManager::sortedByInputs(const QList<ObjectPtr> &objects) {
+  QHash<Object*, ObjectPtr> listed;
+  foreach (ObjectPtr object, objects) {
+    listed.insert(object.data(), object);
+  }
+
+  QSet<Object*> visited;
+  QList<ObjectPtr> sorted;
+  foreach (ObjectPtr object, objects) {
+    appendSorted(object.data(), listed, &visited, &sorted);
+  }
+  return sorted;
+}
+
+
+// Sources that can be updated in a worker thread check for new data, and
+// read it ahead, while the others do the same here.  They are collected
+// without the lock: their job holds it.
+void UpdateManager::updateDataSources() {
+  DataSourceList inOrder;
+  DataSourceList readAhead;
+  foreach (DataSourcePtr ds, _store->dataSourceList()) {
+    if (ds->supportsConcurrentUpdate()) {
+      readAhead.append(ds);
+    } else {
+      inOrder.append(ds);
+    }
+  }
+  _concurrentSourceUpdates = readAhead.size();
+
+  // one pass over the vectors for all the sources
+  QHash<DataSource*, QList<ReadAhead::Request> > requests;
+  foreach (DataVectorPtr v, _store->getObjects<DataVector>()) {
+    ReadAhead::Request r;
+    if (v->dataSource() && v->readAheadRequest(r)) {
+      requests[v->dataSource().data()].append(r);
+    }
+  }
+
+  foreach (DataSourcePtr ds, readAhead + inOrder) {
+    ds->startReadAhead(requests.value(ds.data()));
+  }
+
+  foreach (DataSourcePtr ds, readAhead + inOrder) {
+    ds->collectReadAhead(_serial);
+  }
+}
+
+
+void UpdateManager::finishDataSources(bool readingDone) {
+  foreach(DataSourcePtr ds, _store->dataSourceList()) {
+    if (readingDone) {
+      ds->vector().readingDone();
+    }
+    ds->clearReadAhead();
+  }
+
+  // no object is being updated: a safe point to give back caches
+  MemoryManager::self()->releaseCachesIfWanted();
+}
+
+
+void UpdateManager::updateObjects(const QList<ObjectPtr> &objects) {
+  int n_updated=0, n_deferred=0, n_unchanged = 0;
+  qint64 retval = 0;
+
   int i_loop = 0;
-  int maxloop = _store->objectList().size();
+  int maxloop = objects.size();
+  int last_deferred;
   do {
+    last_deferred = n_deferred;
     n_updated = n_unchanged = n_deferred = 0;
     // update data objects
-    foreach (ObjectPtr p, _store->objectList()) {
+    for (Borrowed<Object> p : borrow<Object>(objects)) {
+      // brought up to date by an earlier pass: no need of the lock to see it
+      if (p->serial() == _serial) {
+        n_unchanged++;
+        continue;
+      }
       p->writeLock();
       retval = p->objectUpdate(_serial);
       p->unlock();
@@ -126,15 +289,9 @@ void UpdateManager::doUpdates(bool forceImmediate) {
     }
     maxloop = qMin(maxloop,n_deferred);
     i_loop++;
-  } while ((n_deferred + n_updated > 0) && (i_loop<=maxloop));
-
-  if (forceImmediate) {
-    foreach(DataSourcePtr ds, _store->dataSourceList()) {
-        ds->vector().readingDone();
-    }
-  }
-
-  emit objectsUpdated(_serial);
+    // objects waiting on a source that is still being read wait for the
+    // next update: once a pass frees none of them, another won't either.
+  } while ((n_deferred + n_updated > 0) && (i_loop<=maxloop) && (i_loop == 1 || n_deferred < last_deferred));
 }
 }
 
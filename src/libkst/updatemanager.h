@@ -31,11 +31,40 @@ class KSTCORE_EXPORT UpdateManager : public QObject
     void setMinimumUpdatePeriod(const int period) { _minUpdatePeriod = period; }
     int minimumUpdatePeriod() { return _minUpdatePeriod; }
 
+    /** how long (ms) an update waits for the read ahead of a source before
+        leaving it, and everything that reads it, for a later update */
+    void setReadAheadTimeout(const int msecs) { _readAheadTimeout = msecs; }
+    int readAheadTimeout() const { return _readAheadTimeout; }
+
     void setPaused(bool paused) { _paused = paused;}
     bool paused() { return _paused; }
 
     void setStore(ObjectStore *store) {_store = store;}
 
+    qint64 serial() const { return _serial; }
+
+    /** A staged update, for loading sessions: beginStagedUpdate() updates the
+        data sources, updateObjects() can then be called for the objects
+        needed first, and endStagedUpdate() updates everything else and
+        announces the new serial.  All stages share one serial. */
+    void beginStagedUpdate();
+    void updateObjects(const QList<ObjectPtr> &objects);
+    void endStagedUpdate();
+
+    /** Called by the store as its outermost transaction ends: views lay out
+        what they held back, then, if update, data sources and objects are
+        updated in one pass, the objects sorted by their inputs. */
+    void endTransaction(ObjectStore *store, bool update);
+
+    /** whether the store is in a transaction, and updates are held back */
+    bool inTransaction() const;
+
+    /** objects, each after those of its inputs that are in the list */
+    static QList<ObjectPtr> sortedByInputs(const QList<ObjectPtr> &objects);
+
+    /** number of data sources updated, and read ahead, in worker threads
+        by the last update */
+    int concurrentSourceUpdates() const { return _concurrentSourceUpdates; }
 
   public Q_SLOTS:
     void doUpdates(bool forceImmediate = false);
@@ -44,20 +73,25 @@ class KSTCORE_EXPORT UpdateManager : public QObject
 
   Q_SIGNALS:
     void objectsUpdated(qint64 serial);
+    void transactionEnded();
 
   private:
     UpdateManager();
     ~UpdateManager();
     static void cleanup();
+    void updateDataSources();
+    void finishDataSources(bool readingDone);
     QElapsedTimer _time;
 
   private:
     bool _delayedUpdate;
     int _minUpdatePeriod;
+    int _readAheadTimeout;
     bool _paused;
     bool _delayedUpdateScheduled;
     bool _updateInProgress;
     qint64 _serial;
+    int _concurrentSourceUpdates;
     ObjectStore *_store;
 };
 
@@ -31,7 +31,10 @@
 #include "datacollection.h"
 #include "math_kst.h"
 #include "debug.h"
+#include "memorymanager.h"
 #include "objectstore.h"
+#include "quantiles.h"
+#include "samplebuffer.h"
 #include "updatemanager.h"
 #include "vectorscriptinterface.h"
 
@@ -41,6 +44,9 @@ namespace Kst {
 
 #define INITSIZE 1
 
+// samples decoded at a time when computing statistics of compact vectors
+#define STAT_BLOCK 4096
+
 const QString Vector::staticTypeString = "Vector";
 const QString Vector::staticTypeTag = "vector";
 
@@ -53,6 +59,10 @@ Vector::Vector(ObjectStore *store)
   _editable = false;
   _numShifted = 0;
   _numNew = 0;
+  _numUnchanged = 0;
+  _numUnchangedSince = 0;
+  _n_ns_stats = 0;
+  _ns_levels_valid = false;
   _saveData = false;
   _isScalarList = false;
 
@@ -73,12 +83,19 @@ Vector::Vector(ObjectStore *store)
   } else {
     _size = size;
   }
+  _v_alloc = _v_raw;
+  _v_capacity = _size;
+  _slidingWindow = false;
   _v_out = _v_raw;
   _is_rising = false;
   _has_nan = false;
   _v_no_nans_dirty = true;
   _v_no_nans_size = 0;
 
+  _compact = 0L;
+  _compactExpanded.storeRelaxed(0);
+  _accountedBytes = 0;
+
   _scalars.clear();
   _strings.clear();
 
@@ -86,7 +103,7 @@ Vector::Vector(ObjectStore *store)
   setFlag(true);
 
   blank();
-
+  accountMemory();
 }
 
 void Vector::_initializeShortName() {
@@ -97,10 +114,13 @@ void Vector::_initializeShortName() {
 }
 
 Vector::~Vector() {
-  if (_v_raw) {
-    free(_v_raw);
-    _v_raw = 0;
+  if (_v_alloc) {
+    free(_v_alloc);
+    _v_alloc = _v_raw = 0;
   }
+  delete _compact;
+  _compact = 0L;
+  MemoryManager::adjust(-_accountedBytes);
 }
 
 
@@ -144,33 +164,51 @@ QString Vector::typeString() const {
                                             \
   double fj = in_i * double(_size - 1) / double(ns_i-1); /* scaled index */ \
                                             \
-  int j = int(fj); /* index of sample one lower */ \
+  qint64 j = qint64(fj); /* index of sample one lower */ \
   /*assert(j==int(floor(fj)));*/ \
   assert(j+1 < _size && j >= 0);            \
   if (_v_out[j + 1] != _v_out[j + 1] || _v_out[j] != _v_out[j]) { \
     return NOPOINT;                    \
   }                                         \
                                             \
-  double fdj = fj - float(j); /* fdj is fraction between _v_out[j] and _v_out[j+1] */ \
+  double fdj = fj - double(j); /* fdj is fraction between _v_out[j] and _v_out[j+1] */ \
                                             \
   return _v_out[j + 1] * fdj + _v_out[j] * (1.0 - fdj);
 
 
+/** the same interpolation, directly on the compact sample types */
+template<class T>
+static double interpolateSamples(const T *_v_out, qint64 _size, qint64 in_i, qint64 ns_i) {
+  GENERATE_INTERPOLATION
+}
+
 /** Return v[i], i is sample number, interpolated to have ns_i total
     samples in vector */
-double Vector::interpolate(int in_i, int ns_i) const {
+double Vector::interpolate(qint64 in_i, qint64 ns_i) const {
+  if (_compact) {
+    switch (_compact->type()) {
+      case SampleBuffer::Int16:
+        return interpolateSamples(static_cast<const qint16*>(_compact->data()), _size, in_i, ns_i);
+      case SampleBuffer::Int32:
+        return interpolateSamples(static_cast<const qint32*>(_compact->data()), _size, in_i, ns_i);
+      case SampleBuffer::Float32:
+        return interpolateSamples(static_cast<const float*>(_compact->data()), _size, in_i, ns_i);
+      default:
+        return interpolateSamples(static_cast<const double*>(_compact->data()), _size, in_i, ns_i);
+    }
+  }
   GENERATE_INTERPOLATION
 }
 
 /** same as above, but as a function for use in plugins, etc */
-double kstInterpolate(double *_v_out, int _size, int in_i, int ns_i) {
+double kstInterpolate(double *_v_out, qint64 _size, qint64 in_i, qint64 ns_i) {
   GENERATE_INTERPOLATION
 }
 
 #undef GENERATE_INTERPOLATION
 
 #define RETURN_FIRST_NON_HOLE               \
-    for (int i = 0; i < _size; ++i) {       \
+    for (qint64 i = 0; i < _size; ++i) {    \
       if (_v_out[i] == _v_out[i]) {                 \
         return _v_out[i];                       \
       }                                     \
@@ -178,7 +216,7 @@ double kstInterpolate(double *_v_out, int _size, int in_i, int ns_i) {
     return 0.;
 
 #define RETURN_LAST_NON_HOLE                \
-    for (int i = _size - 1; i >= 0; --i) {  \
+    for (qint64 i = _size - 1; i >= 0; --i) {\
       if (_v_out[i] == _v_out[i]) {                 \
         return _v_out[i];                       \
       }                                     \
@@ -216,7 +254,7 @@ double kstInterpolate(double *_v_out, int _size, int in_i, int ns_i) {
       return _v_out[in_i];                      \
     }                                       \
     double left = 0., right = 0.;           \
-    int leftIndex = in_i, rightIndex = in_i;\
+    qint64 leftIndex = in_i, rightIndex = in_i;\
     FIND_LEFT(left, leftIndex)              \
     FIND_RIGHT(right, rightIndex)           \
     if (leftIndex == -1) {                  \
@@ -231,26 +269,44 @@ double kstInterpolate(double *_v_out, int _size, int in_i, int ns_i) {
   double indexScaleFactor = double(_size - 1) / double(ns_i - 1); \
   double fj = in_i * indexScaleFactor; /* scaled index */ \
                                             \
-  int j = int(floor(fj)); /* index of sample one lower */ \
+  qint64 j = qint64(floor(fj)); /* index of sample one lower */ \
   assert(j+1 < _size && j >= 0);            \
   if (_v_out[j + 1] != _v_out[j + 1] || _v_out[j] != _v_out[j]) { \
     return NOPOINT;                    \
   }                                         \
                                             \
-  double fdj = fj - float(j); /* fdj is fraction between _v_out[j] and _v_out[j+1] */ \
+  double fdj = fj - double(j); /* fdj is fraction between _v_out[j] and _v_out[j+1] */ \
                                             \
   return _v_out[j + 1] * fdj + _v_out[j] * (1.0 - fdj);
 
 
+/** the same, directly on the compact sample types */
+template<class T>
+static double interpolateNoHolesSamples(const T *_v_out, qint64 _size, qint64 in_i, qint64 ns_i) {
+  GENERATE_INTERPOLATION
+}
+
 // FIXME: optimize me - possible that floor() (especially) and isnan() are
 //        expensive here.
-double Vector::interpolateNoHoles(int in_i, int ns_i) const {
+double Vector::interpolateNoHoles(qint64 in_i, qint64 ns_i) const {
+  if (_compact) {
+    switch (_compact->type()) {
+      case SampleBuffer::Int16:
+        return interpolateNoHolesSamples(static_cast<const qint16*>(_compact->data()), _size, in_i, ns_i);
+      case SampleBuffer::Int32:
+        return interpolateNoHolesSamples(static_cast<const qint32*>(_compact->data()), _size, in_i, ns_i);
+      case SampleBuffer::Float32:
+        return interpolateNoHolesSamples(static_cast<const float*>(_compact->data()), _size, in_i, ns_i);
+      default:
+        return interpolateNoHolesSamples(static_cast<const double*>(_compact->data()), _size, in_i, ns_i);
+    }
+  }
   GENERATE_INTERPOLATION
 }
 
 
 #if 0
-double kstInterpolateNoHoles(double *_v, int _size, int in_i, int ns_i) {
+double kstInterpolateNoHoles(double *_v, qint64 _size, qint64 in_i, qint64 ns_i) {
   GENERATE_INTERPOLATION
 }
 #endif
@@ -262,14 +318,14 @@ double kstInterpolateNoHoles(double *_v, int _size, int in_i, int ns_i) {
 #undef RETURN_FIRST_NON_HOLE
 #undef GENERATE_INTERPOLATION
 
-double Vector::value(int i) const {
+double Vector::value(qint64 i) const {
   if (i < 0 || i >= _size) { // can't look before beginning or past end
     return 0.0;
   }
-  return _v_out[i];
+  return sample(i);
 }
 
-double Vector::noNanValue(int i) {
+double Vector::noNanValue(qint64 i) {
   if (i < 0 || i >= _size) { // can't look before beginning or past end
     return 0.0;
   }
@@ -279,7 +335,7 @@ double Vector::noNanValue(int i) {
     }
     return _v_no_nans[i];
   }
-  return _v_out[i];
+  return sample(i);
 }
 
 void Vector::CreateScalars(ObjectStore *store) {
@@ -367,16 +423,18 @@ void Vector::updateScalars() {
 }
 
 
-void Vector::setV(double *memptr, int newSize) {
+void Vector::setV(double *memptr, qint64 newSize) {
   if (_v_raw_managed) {
-    free(_v_raw);
+    free(_v_alloc);
     _v_raw_managed = false;
   }
-  _v_raw = memptr;
+  _v_alloc = _v_raw = memptr;
+  _v_capacity = newSize;
   _v_out = _v_raw;
 
   _numNew = newSize;
   _size = newSize;
+  accountMemory();
 }
 
 #define FIND_LEFT(val, idx)                 \
@@ -395,20 +453,25 @@ void Vector::setV(double *memptr, int newSize) {
 
 void Vector::updateVNoNans()  {
 
+  if (_compact) {
+    expandCompact();
+  }
+
   if (_size != _v_no_nans_size) {
     if (_v_no_nans_size < 1) {
       _v_no_nans = NULL;
     }
     kstrealloc(_v_no_nans, _size*sizeof(double));
     _v_no_nans_size = _size;
+    accountMemory();
   }
 
-  for (int in_i = 0; in_i < _size; in_i++) {
+  for (qint64 in_i = 0; in_i < _size; in_i++) {
     if (_v_out[in_i] == _v_out[in_i]) {
       _v_no_nans[in_i] = _v_out[in_i];
     } else {
       double left = 0., right = 0.;
-      int leftIndex = in_i, rightIndex = in_i;
+      qint64 leftIndex = in_i, rightIndex = in_i;
       FIND_LEFT(left, leftIndex);
       FIND_RIGHT(right, rightIndex);
       if (leftIndex == -1) {
@@ -428,37 +491,66 @@ void Vector::updateVNoNans()  {
 
 void Vector::zero() {
   _n_ns_stats = 0;
-  _ns_stats_sorted = false;
+  _ns_levels_valid = false;
 
-  memset(_v_raw, 0, sizeof(double)*_size);
+  if (_compact) {
+    _compact->fill(0, _size, 0.0);
+    _compactExpanded.storeRelaxed(0);
+  } else {
+    memset(_v_raw, 0, sizeof(double)*_size);
+  }
   updateScalars();
 }
 
 
 void Vector::blank() {
   _n_ns_stats = 0;
-  _ns_stats_sorted = false;
+  _ns_levels_valid = false;
 
-  for (int i = 0; i < _size; ++i) {
-    _v_raw[i] = NOPOINT;
+  if (_compact) {
+    _compact->fill(0, _size, NOPOINT);
+    _compactExpanded.storeRelaxed(0);
+  } else {
+    for (qint64 i = 0; i < _size; ++i) {
+      _v_raw[i] = NOPOINT;
+    }
   }
   updateScalars();
 }
 
 
-bool Vector::resize(int sz, bool init) {
+bool Vector::resize(qint64 sz, bool init) {
+  if (_compact) {
+    // blanking promotes integer storage to float32: those about to read
+    // into the new samples pass init = false
+    if (sz > 0) {
+      if (!_compact->resize(sz)) {
+        qCritical() << "Vector resize failed";
+        return false;
+      }
+      if (init && _size < sz) {
+        _compact->fill(_size, sz - _size, NOPOINT);
+      }
+      _size = sz;
+      _compactExpanded.storeRelaxed(0);
+      accountMemory();
+      updateScalars();
+    }
+    return true;
+  }
   if (sz > 0) {
-    if (!kstrealloc(_v_raw, sz*sizeof(double))){
+    if (!reserveRaw(sz)){
        qCritical() << "Vector resize failed";
        return false;
     }
     if (init && _size < sz) {
-      for (int i = _size; i < sz; ++i) {
+      for (qint64 i = _size; i < sz; ++i) {
         _v_raw[i] = NOPOINT;
       }
     }
     _size = sz;
     _v_out = _v_raw;
+    accountMemory();
     updateScalars();
   }
   return true;
@@ -474,6 +566,9 @@ bool Vector::saveToTmpFile(QFile &fp) {
 
   n_write = length()*sizeof(double);
 
+  if (_compact) {
+    expandCompact();
+  }
   n_written = fp.write((char *)_v_raw, n_write);
 
   fp.flush();
@@ -482,65 +577,49 @@ bool Vector::saveToTmpFile(QFile &fp) {
 }
 
 
-double Vector::ns_max(int ns_zoom_level) {
-  if (!_ns_stats_sorted) {
-    if (_n_ns_stats>4) {
-      std::sort(_v_ns_stats, _v_ns_stats+_n_ns_stats);
-      _ns_stats_sorted = true;
-    }
+// The levels drop the top and bottom 0, 0.3, 1, 3 and 10% of the
+// samples (less one at the bottom).  All ten ranks come from one selection.
+void Vector::selectNsLevels() {
+  static const int fraction[N_DESPIKE_LEVELS] = { 0, 333, 100, 33, 10 };
+  qint64 ranks[2*N_DESPIKE_LEVELS];
+  for (int level = 0; level < N_DESPIKE_LEVELS; ++level) {
+    const int drop = fraction[level] ? _n_ns_stats/fraction[level] : 0;
+    ranks[level] = drop + 1;
+    ranks[N_DESPIKE_LEVELS + level] = _n_ns_stats - drop - 1;
   }
+
+  double levels[2*N_DESPIKE_LEVELS];
+  selectRanks(_v_ns_stats, _n_ns_stats, ranks, 2*N_DESPIKE_LEVELS, levels);
+  for (int level = 0; level < N_DESPIKE_LEVELS; ++level) {
+    _ns_min_level[level] = levels[level];
+    _ns_max_level[level] = levels[N_DESPIKE_LEVELS + level];
+  }
+  _ns_levels_valid = true;
+}
+
+
+double Vector::ns_max(int ns_zoom_level) {
   if (_n_ns_stats <= 4 ) {
     return max();
   }
-
-  switch (ns_zoom_level) {
-  case 0:
-    return (_v_ns_stats[_n_ns_stats - 1]);
-    break;
-  case 1:
-    return (_v_ns_stats[_n_ns_stats - _n_ns_stats/333 - 1]);
-    break;
-  case 2:
-    return (_v_ns_stats[_n_ns_stats - _n_ns_stats/100 - 1]);
-    break;
-  case 3:
-    return (_v_ns_stats[_n_ns_stats - _n_ns_stats/33 - 1]);
-    break;
-  default:
-    return (_v_ns_stats[_n_ns_stats - _n_ns_stats/10 - 1]);
-    break;
+  if (!_ns_levels_valid) {
+    selectNsLevels();
   }
+  return _ns_max_level[qBound(0, ns_zoom_level, N_DESPIKE_LEVELS - 1)];
 }
 
 double Vector::ns_min(int ns_zoom_level) {
-  if (_n_ns_stats>2) {
-    std::sort(_v_ns_stats, _v_ns_stats+_n_ns_stats);
-    _ns_stats_sorted = true;
-  }
   if (_n_ns_stats <= 4 ) {
     return min();
   }
-  switch (ns_zoom_level) {
-  case 0:
-    return (_v_ns_stats[1]);
-    break;
-  case 1:
-    return (_v_ns_stats[_n_ns_stats/333 + 1]);
-    break;
-  case 2:
-    return (_v_ns_stats[_n_ns_stats/100 + 1]);
-    break;
-  case 3:
-    return (_v_ns_stats[_n_ns_stats/33 + 1]);
-    break;
-  default:
-    return (_v_ns_stats[_n_ns_stats/10 + 1]);
-    break;
+  if (!_ns_levels_valid) {
+    selectNsLevels();
   }
+  return _ns_min_level[qBound(0, ns_zoom_level, N_DESPIKE_LEVELS - 1)];
 }
 
 void Vector::internalUpdate() {
-  int i, i0;
+  qint64 i, i0;
   double sum, sum2, last, first, v;
   double last_v;
   const double epsilon=DBL_MIN; // FIXME: this is not the smallest positive subnormal
@@ -556,10 +635,12 @@ void Vector::internalUpdate() {
     _is_rising = true;
 
     // FIXME: update V_out here
-    _v_out = _v_raw;
+    if (!_compact) {
+      _v_out = _v_raw;
+    }
 
     // Look for a valid (finite) point...
-    for (i = 0; i < _size && !isfinite(_v_out[i]); ++i) {
+    for (i = 0; i < _size && !isfinite(sample(i)); ++i) {
       // do nothing
     }
 
@@ -582,7 +663,7 @@ void Vector::internalUpdate() {
         }
       }
       _n_ns_stats = 0;
-      _ns_stats_sorted = false;
+      _ns_levels_valid = false;
 
       updateScalars();
       return;
@@ -594,63 +675,71 @@ void Vector::internalUpdate() {
       _is_rising = false;
     }
 
-    _max = _min = _v_out[i0];
+    _max = _min = sample(i0);
     _imax = _imin = i0;
     sum = sum2 = 0.0;
 
-    if (_v_out[i0] > epsilon) {
-      _minPos = _v_out[i0];
+    if (sample(i0) > epsilon) {
+      _minPos = sample(i0);
     }
 
-    last_v = _v_out[i0];
+    last_v = sample(i0);
 
-    for (i = i0; i < _size; ++i) {
-      v = _v_out[i]; // get rid of redirections
+    double scratch[STAT_BLOCK];
+    for (qint64 b0 = i0; b0 < _size; b0 += STAT_BLOCK) {
+      const int bn = int(qMin(qint64(STAT_BLOCK), _size - b0));
+      const double *block = sampleBlock(b0, bn, scratch);
 
-      if (isfinite(v)) {
-        if (v <= last_v) {
-          if (i != i0) {
-            _is_rising = false;
+      for (int k = 0; k < bn; ++k) {
+        i = b0 + k;
+        v = block[k]; // get rid of redirections
+
+        if (isfinite(v)) {
+          if (v <= last_v) {
+            if (i != i0) {
+              _is_rising = false;
+            }
           }
-        }
 
-        last_v = v;
+          last_v = v;
 
-        _nsum++;
-        sum += v;
-        sum2 += v*v;
+          _nsum++;
+          sum += v;
+          sum2 += v*v;
 
-        if (v > _max) {
-          _max = v;
-          _imax = i;
-        } else if (v < _min) {
-          _min = v;
-          _imin = i;
-        }
-        if ((isnan(_minPos) || v < _minPos) && v > epsilon) {
-          _minPos = v;
+          if (v > _max) {
+            _max = v;
+            _imax = i;
+          } else if (v < _min) {
+            _min = v;
+            _imin = i;
+          }
+          if ((isnan(_minPos) || v < _minPos) && v > epsilon) {
+            _minPos = v;
+          }
+        } else {
+          _is_rising = false;
+          _has_nan = true;
         }
-      } else {
-        _is_rising = false;
-        _has_nan = true;
       }
     }
 
     //no_spike_max_dv = 7.0*sqrt(dv2/double(_nsum));
 
-    last_v = _v_out[i0];
+    last_v = sample(i0);
 
-    last = _v_out[_size-1];
-    first = _v_out[0];
+    last = sample(_size-1);
+    first = sample(0);
 
     /* make vector for spike insensitive autoscale */
     _n_ns_stats = 0;
-    _ns_stats_sorted = false;
+    _ns_levels_valid = false;
     double step = qMax(double(_size)/double(MAX_N_DESPIKE_STAT), 1.0);
     for (int k = 0; (k < _size) && (k < MAX_N_DESPIKE_STAT); k++) {
-      int m = int(double(k) * step); // FIXME: add random([0, step]) to m
-      if (isfinite(_v_out[m])) {
-        _v_ns_stats[_n_ns_stats] = _v_out[m];
+      qint64 m = qint64(double(k) * step); // FIXME: add random([0, step]) to m
+      const double vm = sample(m);
+      if (isfinite(vm)) {
+        _v_ns_stats[_n_ns_stats] = vm;
         _n_ns_stats++;
       }
     }
@@ -686,7 +775,7 @@ void Vector::save(QXmlStreamWriter &s) {
     QByteArray qba(length()*sizeof(double), '\0');
     QDataStream qds(&qba, QIODevice::WriteOnly);
 
-    for (int i = 0; i < length(); ++i) {
+    for (qint64 i = 0; i < length(); ++i) {
       qds << _v_raw[i];
     }
 
@@ -696,12 +785,15 @@ void Vector::save(QXmlStreamWriter &s) {
   s.writeEndElement();
 }
 
-void Vector::setNewAndShift(int inNew, int inShift) {
+void Vector::setNewAndShift(qint64 inNew, qint64 inShift) {
   _numNew = inNew;
   _numShifted = inShift;
 }
 
 double const *Vector::noNanValue() {
+  if (_compact) {
+    expandCompact();
+  }
   if (_has_nan) {
     if (_v_no_nans_dirty) {
       updateVNoNans();
@@ -716,6 +808,211 @@ void Vector::newSync() {
   _numNew = _numShifted = 0;
 }
 
+qint64 Vector::memoryUsage() const {
+  qint64 bytes = 0;
+  if (_compact) {
+    bytes += _compact->bytes();
+    if (_v_capacity > INITSIZE) {
+      bytes += qint64(_v_capacity)*sizeof(double);
+    }
+  } else if (_v_raw_managed) {
+    bytes += qint64(_v_capacity)*sizeof(double);
+  }
+  if (_v_no_nans_size > 0) {
+    bytes += qint64(_v_no_nans_size)*sizeof(double);
+  }
+  return bytes;
+}
+
+
+qint64 Vector::releaseCaches() {
+  qint64 freed = 0;
+  if (_v_no_nans_size > 0) {
+    free(_v_no_nans);
+    _v_no_nans = 0L;
+    freed += qint64(_v_no_nans_size)*sizeof(double);
+    _v_no_nans_size = 0;
+    _v_no_nans_dirty = true;
+  }
+  // the double expansion of compact data
+  if (_compact && _v_capacity > INITSIZE) {
+    if (kstrealloc(_v_alloc, INITSIZE*sizeof(double))) {
+      freed += qint64(_v_capacity - INITSIZE)*sizeof(double);
+      _v_capacity = INITSIZE;
+    }
+    _v_out = _v_raw = _v_alloc;
+    _compactExpanded.storeRelaxed(0);
+  }
+  accountMemory();
+  return freed;
+}
+
+
+void Vector::accountMemory() const {
+  const qint64 bytes = memoryUsage();
+  MemoryManager::adjust(bytes - _accountedBytes);
+  _accountedBytes = bytes;
+}
+
+
+QString Vector::storageTypeName() const {
+  if (_compact) {
+    return SampleBuffer::typeName(_compact->type());
+  }
+  return SampleBuffer::typeName(SampleBuffer::Float64);
+}
+
+
+void Vector::setCompact(bool compact) {
+  if (compact == (_compact != 0L)) {
+    return;
+  }
+
+  if (compact) {
+    _compact = new SampleBuffer;
+    if (!_compact->resize(_size) || !_compact->write(0, _v_out, _size)) {
+      delete _compact;
+      _compact = 0L;
+      return;
+    }
+    _compact->setSliding(_slidingWindow);
+    // _v_raw is now only a cache: release it
+    if (kstrealloc(_v_alloc, INITSIZE*sizeof(double))) {
+      _v_capacity = INITSIZE;
+    }
+    _v_out = _v_raw = _v_alloc;
+    _compactExpanded.storeRelaxed(0);
+  } else {
+    if (!kstrealloc(_v_alloc, qMax(_size, qint64(INITSIZE))*sizeof(double))) {
+      qCritical() << "Vector resize failed";
+      return;
+    }
+    _v_capacity = qMax(_size, qint64(INITSIZE));
+    _v_out = _v_raw = _v_alloc;
+    _compact->read(0, _size, _v_raw);
+    delete _compact;
+    _compact = 0L;
+    _compactExpanded.storeRelaxed(0);
+  }
+  _v_no_nans_dirty = true;
+  accountMemory();
+}
+
+
+void Vector::expandCompact() const {
+  if (!_compact || _compactExpanded.loadAcquire()) {
+    return;
+  }
+
+  // the expansion is a cache, so this is logically const.  Writers hold
+  // the write lock, but any number of readers can get here at once.
+  QMutexLocker locker(&_expandMutex);
+  if (_compactExpanded.loadRelaxed()) {
+    return;
+  }
+  Vector *self = const_cast<Vector*>(this);
+  if (_v_capacity < _size) {
+    if (!kstrealloc(self->_v_alloc, qMax(_size, qint64(INITSIZE))*sizeof(double))) {
+      qCritical() << "Vector expansion failed";
+      return;
+    }
+    self->_v_capacity = qMax(_size, qint64(INITSIZE));
+    accountMemory();
+  }
+  self->_v_raw = self->_v_alloc;
+  _compact->read(0, _size, self->_v_raw);
+  self->_v_out = self->_v_raw;
+  _compactExpanded.storeRelease(1);
+}
+
+
+// make room for sz samples starting at _v_raw
+bool Vector::reserveRaw(qint64 sz) {
+  const qint64 offset = _v_raw - _v_alloc;
+
+  if (_slidingWindow && offset + sz <= _v_capacity) {
+    return true;
+  }
+
+  // move the data back to the start of the allocation
+  if (offset > 0) {
+    memmove(_v_alloc, _v_raw, qMin(_size, sz)*sizeof(double));
+    _v_raw = _v_alloc;
+  }
+
+  if (_slidingWindow) {
+    if (sz <= _v_capacity) {
+      return true;
+    }
+    const qint64 capacity = sz + sz/2;
+    if (!kstrealloc(_v_alloc, capacity*sizeof(double))) {
+      return false;
+    }
+    _v_capacity = capacity;
+  } else {
+    if (!kstrealloc(_v_alloc, sz*sizeof(double))) {
+      return false;
+    }
+    _v_capacity = sz;
+  }
+  _v_raw = _v_alloc;
+  return true;
+}
+
+
+void Vector::setSlidingWindow(bool sliding) {
+  if (sliding == _slidingWindow) {
+    return;
+  }
+  _slidingWindow = sliding;
+  if (_compact) {
+    _compact->setSliding(sliding);
+  } else if (!sliding && _v_raw != _v_alloc) {
+    memmove(_v_alloc, _v_raw, _size*sizeof(double));
+    _v_out = _v_raw = _v_alloc;
+  }
+}
+
+
+void Vector::dropFront(qint64 n, qint64 keep) {
+  if (n <= 0) {
+    return;
+  }
+  n = qMin(n, _size);
+  keep = qMax(qMin(keep, _size - n), qint64(0));
+
+  if (_compact) {
+    _compact->shift(n);
+    _compact->resize(_size);
+    _compactExpanded.storeRelaxed(0);
+    return;
+  }
+
+  const qint64 offset = _v_raw - _v_alloc;
+  if (_slidingWindow && offset + n + _size <= _v_capacity) {
+    _v_raw += n;
+  } else {
+    memmove(_v_alloc, _v_raw + n, keep*sizeof(double));
+    _v_raw = _v_alloc;
+  }
+  _v_out = _v_raw;
+}
+
+
+double Vector::compactSample(qint64 i) const {
+  return _compact->at(i);
+}
+
+
+const double *Vector::sampleBlock(qint64 i0, qint64 n, double *scratch) const {
+  if (_compact) {
+    _compact->read(i0, n, scratch);
+    return scratch;
+  }
+  return _v_out + i0;
+}
+
+
 int Vector::getUsage() const {
   int adj = 0;
   for (QHash<QString, ScalarPtr>::ConstIterator it = _scalars.begin(); it != _scalars.end(); ++it) {
@@ -756,11 +1053,11 @@ void Vector::oldChange(QByteArray &data) {
 
     QDataStream qds(data);
 
-    int sz = qMax(qint64((size_t)(INITSIZE)), qint64(data.size()/sizeof(double)));
+    qint64 sz = qMax(qint64((size_t)(INITSIZE)), qint64(data.size()/sizeof(double)));
     resize(sz, true);
 
     double sum=0.0;
-    for (int i = 0; i<sz; ++i) {
+    for (qint64 i = 0; i<sz; ++i) {
       qds >> _v_raw[i];
       if(!i) {
           _min=_max=_minPos=sum=_v_raw[i];
@@ -788,11 +1085,11 @@ void Vector::change(QByteArray &data) {
     QDataStream qds(data);
     qds>>count;
 
-    int sz = qMax(qint64((size_t)(INITSIZE)), count);
+    qint64 sz = qMax(qint64((size_t)(INITSIZE)), count);
     resize(sz, true);
 
     double sum=0.0;
-    for (int i = 0; i<count; ++i) {
+    for (qint64 i = 0; i<count; ++i) {
       qds >> _v_raw[i];
       if(!i) {
           _min=_max=_minPos=sum=_v_raw[i];
@@ -944,8 +1241,8 @@ QByteArray Vector::getBinaryArray() const {
     QByteArray ret;
     QDataStream ds(&ret,QIODevice::WriteOnly);
     ds<<(qint64)_size;
-    for(int i=0; i<_size; ++i) {
-        ds<<(double)_v_raw[i];
+    for(qint64 i=0; i<_size; ++i) {
+        ds<<sample(i);
     }
     unlock();
     return ret;
@@ -20,6 +20,8 @@
 
 #include <math.h>
 
+#include <QAtomicInt>
+#include <QMutex>
 #include <QPointer>
 #include <QFile>
 
@@ -38,15 +40,17 @@ namespace Equation {
 namespace Kst {
 
 class KstDataObject;
+class SampleBuffer;
 
 // KST::interpolate is still too polluting
-KSTCORE_EXPORT double kstInterpolate(double *v, int _size, int in_i, int ns_i);
-//KSTCORE_EXPORT double kstInterpolateNoHoles(double *v, int _size, int in_i, int ns_i);
+KSTCORE_EXPORT double kstInterpolate(double *v, qint64 _size, qint64 in_i, qint64 ns_i);
+//KSTCORE_EXPORT double kstInterpolateNoHoles(double *v, qint64 _size, qint64 in_i, qint64 ns_i);
 
 class Vector;
 typedef SharedPtr<Vector> VectorPtr;
 
 #define MAX_N_DESPIKE_STAT 10000
+#define N_DESPIKE_LEVELS 5
 
 /**A class for handling data vectors for kst.
  *@author cbn
@@ -74,30 +78,41 @@ class KSTCORE_EXPORT Vector : public Primitive
     void change(QByteArray& data);
     void oldChange(QByteArray& data);
 
-    inline int length() const { return _size; }
+    inline qint64 length() const { return _size; }
 
     /** Return V[i], interpolated/decimated to have ns_i total samples */
-    double interpolate(int i, int ns_i) const;
+    double interpolate(qint64 i, qint64 ns_i) const;
 
     /** Return V[i], interpolated/decimated to have ns_i total samples, without any NaNs */
-    double interpolateNoHoles(int i, int ns_i) const;
+    double interpolateNoHoles(qint64 i, qint64 ns_i) const;
 
     /** Return V[i] uninterpolated */
-    double value(int i) const;
-    double noNanValue(int i);
+    double value(qint64 i) const;
+    double noNanValue(qint64 i);
 
     /** Return a pointer to data to be read */
     /** these might be modified for output */
     /** eg - by masking */
-    double const *value() const { return _v_out;}
-    double *value() { return _v_out;}
+    /** For compact vectors this expands the samples into a double array */
+    double const *value() const { if (_compact) expandCompact(); return _v_out;}
+    double *value() { if (_compact) expandCompact(); return _v_out;}
     double const *noNanValue();
 
+    /** samples [i0, i0+n) as doubles, without expanding a compact vector:
+        either a pointer into the vector or scratch, which holds n. */
+    const double *sampleBlock(qint64 i0, qint64 n, double *scratch) const;
+
     /** raw pointer for writing */
     /** reading it will not provide */
     /** mask filtering and is probably */
     /** not what you want. */
-    double *raw_V_ptr() { return _v_raw;}
+    double *raw_V_ptr() { if (_compact) expandCompact(); return _v_raw;}
+
+    /** true if the samples are held in a SampleBuffer rather than as doubles */
+    bool isCompact() const { return _compact != 0; }
+
+    /** the sample type used for storage: "float64" for plain vectors */
+    QString storageTypeName() const;
 
     /** Return Minimum value in Vector */
     inline double min() const { return _min; }
@@ -118,22 +133,35 @@ class KSTCORE_EXPORT Vector : public Primitive
     inline double minPos() const { return _minPos; }
 
     /** Number of new samples in the vector since last newSync */
-    inline int numNew() const { return _numNew; }
+    inline qint64 numNew() const { return _numNew; }
 
     /** Number of samples  shifted since last newSync */
-    inline int numShift() const { return _numShifted; }
+    inline qint64 numShift() const { return _numShifted; }
+
+    /** Number of samples at the front which are as they were at the change
+        numUnchangedSince() (a serialOfLastChange()).  Someone who has seen
+        that change only needs to look at the samples after them. */
+    inline qint64 numUnchanged() const { return _numUnchanged; }
+    inline qint64 numUnchangedSince() const { return _numUnchangedSince; }
+
+    /** For the provider of the vector: the first n samples are as they were
+        at the change since. */
+    void setUnchanged(qint64 n, qint64 since) { _numUnchanged = n; _numUnchangedSince = since; }
 
     inline bool isRising() const { return _is_rising; }
 
+    /** whether noNanValue() has had to fill in any samples */
+    inline bool hasNaN() const { return _has_nan; }
+
     /** reset New Samples and Shifted samples */
     void newSync();
 
-    virtual bool resize(int sz, bool init = true);
+    virtual bool resize(qint64 sz, bool init = true);
 
     /** dump the vector values to a raw binary file */
     bool saveToTmpFile(QFile &fp);
 
-    virtual void setNewAndShift(int inNew, int inShift);
+    virtual void setNewAndShift(qint64 inNew, qint64 inShift);
 
     /** Clear out the vector by setting everything to 0.0 */
     void zero();
@@ -152,6 +180,12 @@ class KSTCORE_EXPORT Vector : public Primitive
 
     virtual int getUsage() const;
 
+    /** bytes of sample memory held by the vector, including caches */
+    virtual qint64 memoryUsage() const;
+
+    /** free memory which can be recomputed on demand.  Returns the bytes freed. */
+    virtual qint64 releaseCaches();
+
     /** Save vector information */
     virtual void save(QXmlStreamWriter &s);
 
@@ -199,21 +233,43 @@ class KSTCORE_EXPORT Vector : public Primitive
 
   protected:
     /** current number of samples */
-    int _size;
+    qint64 _size;
 
     /** number of valid points */
-    int _nsum;
+    qint64 _nsum;
 
     /** variables for SpikeInsensitiveAutoscale **/
     double _v_ns_stats[MAX_N_DESPIKE_STAT];
     int _n_ns_stats;
-    bool _ns_stats_sorted;
+    /** the min and max of each zoom level, selected from _v_ns_stats
+        on the first call after an update **/
+    double _ns_min_level[N_DESPIKE_LEVELS];
+    double _ns_max_level[N_DESPIKE_LEVELS];
+    bool _ns_levels_valid;
+    void selectNsLevels();
 
 
     /** Where raw input data is held */
     double *_v_raw;
     bool _v_raw_managed; // if the vector manages the memory for _v_raw;
 
+    /** the allocation holding _v_raw, and its size in samples.  In sliding
+        window mode _v_raw may start part way into it. */
+    double *_v_alloc;
+    qint64 _v_capacity;
+    bool _slidingWindow;
+
+    /** In sliding window mode the allocation has headroom past the end of
+        the data, so dropping samples from the front only moves _v_raw.
+        The data is moved back to the start of the allocation when the
+        headroom is used up, so a shift costs O(samples dropped) amortized
+        rather than O(length).  Consumers still see a contiguous array. */
+    void setSlidingWindow(bool sliding);
+
+    /** discard the first n samples, keeping the next 'keep' at the front.
+        The length is unchanged: the caller fills in the tail. */
+    void dropFront(qint64 n, qint64 keep);
+
     /** _v_raw with flagged data replaced with NaNs */
     double *_v_flagged;
 
@@ -223,13 +279,38 @@ class KSTCORE_EXPORT Vector : public Primitive
     /** _v_out with nans removed **/
     double *_v_no_nans;
     bool _v_no_nans_dirty : 1;
-    int _v_no_nans_size;
+    qint64 _v_no_nans_size;
+
+    /** if set, the samples live here and _v_raw is only an expansion cache */
+    SampleBuffer *_compact;
+    mutable QAtomicInt _compactExpanded;
+    /** readers holding the read lock may expand at once: one does it */
+    mutable QMutex _expandMutex;
+
+    /** memoryUsage() as last reported to the MemoryManager */
+    mutable qint64 _accountedBytes;
+
+    /** report the change in memoryUsage() to the MemoryManager */
+    void accountMemory() const;
+
+    /** switch between compact and double storage, keeping the samples */
+    void setCompact(bool compact);
+
+    /** materialize the compact samples into _v_raw */
+    void expandCompact() const;
+
+    /** sample i, regardless of storage */
+    inline double sample(qint64 i) const { return _compact ? compactSample(i) : _v_out[i]; }
 
     /** number of samples shifted since last newSync */
-    int _numShifted;
+    qint64 _numShifted;
 
     /** number of new samples since last newSync */
-    int _numNew;
+    qint64 _numNew;
+
+    /** leading samples unchanged since the change _numUnchangedSince */
+    qint64 _numUnchanged;
+    qint64 _numUnchangedSince;
 
     /** is the vector monotonically rising */
     bool _is_rising : 1;
@@ -252,7 +333,7 @@ class KSTCORE_EXPORT Vector : public Primitive
     bool _saveData : 1;
 
     double _min, _max, _mean, _minPos;
-    int _imax, _imin;
+    qint64 _imax, _imin;
 
     /** Scalar Maintenance methods */
     void CreateScalars(ObjectStore *store);
@@ -264,14 +345,16 @@ class KSTCORE_EXPORT Vector : public Primitive
 
     friend class DataObject;
     friend class Matrix;
-    //virtual double* realloced(double *memptr, int newSize);
-    virtual void setV(double *memptr, int newSize);
+    //virtual double* realloced(double *memptr, qint64 newSize);
+    virtual void setV(double *memptr, qint64 newSize);
 
     ObjectMap<Scalar> _scalars;
     ObjectMap<String> _strings;
 
 private:
     void updateVNoNans();
+    bool reserveRaw(qint64 size);
+    double compactSample(qint64 i) const;
 };
 
 
@@ -237,6 +237,7 @@ PrimitivePtr DataVectorFactory::generatePrimitive(ObjectStore *store, QXmlStream
   bool doAve=false;
   QString start_units;
   QString range_units;
+  DataVector::StorageMode storage = DataVector::DoubleStorage;
 
   while (!xml.atEnd()) {
       const QString n = xml.name().toString();
@@ -267,10 +268,15 @@ PrimitivePtr DataVectorFactory::generatePrimitive(ObjectStore *store, QXmlStream
         doAve = attrs.value("doAve").toString() == "true" ? true : false;
         start_units = attrs.value("startUnits").toString();
         range_units = attrs.value("rangeUnits").toString();
+        if (attrs.value("storage").toString() == "compact") {
+          storage = DataVector::CompactStorage;
+        }
 
         // set overrides if set from command line
         if (!store->override.fileName.isEmpty()) {
           file = store->override.fileName;
+        } else {
+          file = store->override.files.value(file, file);
         }
         if (store->override.hasF0) {
           start = store->override.f0;
@@ -332,6 +338,7 @@ PrimitivePtr DataVectorFactory::generatePrimitive(ObjectStore *store, QXmlStream
       (skip != -1),
       doAve);
 
+  vector->setStorageMode(storage);
   vector->setDescriptiveName(descriptiveName);
   vector->setStartUnits(start_units);
   vector->setRangeUnits(range_units);
@@ -139,6 +139,8 @@ DataVectorSI::DataVectorSI(DataVectorPtr it) {
   _fnMap.insert("NFrames",&DataVectorSI::NFrames);
   _fnMap.insert("skip",&DataVectorSI::skip);
   _fnMap.insert("boxcarFirst",&DataVectorSI::boxcarFirst);
+  _fnMap.insert("setCompactStorage",&DataVectorSI::setCompactStorage);
+  _fnMap.insert("storageType",&DataVectorSI::storageType);
 
   _fnMap.insert("value",&DataVectorSI::value);
   _fnMap.insert("length",&DataVectorSI::length);
@@ -260,6 +262,19 @@ QString DataVectorSI::boxcarFirst(QString& command) {
   return _datavector->doAve()?"True":"False";
 }
 
+QString DataVectorSI::setCompactStorage(QString& command) {
+  QString arg = getArg(command);
+  _datavector->writeLock();
+  _datavector->setStorageMode(arg == "True" ? DataVector::CompactStorage : DataVector::DoubleStorage);
+  _datavector->unlock();
+  return "Done";
+}
+
+QString DataVectorSI::storageType(QString& command) {
+  QString arg = getArg(command);
+  return _datavector->storageTypeName();
+}
+
 /******************************************************/
 /* Generated  Vectors                                 */
 /******************************************************/
@@ -421,7 +436,7 @@ QString EditableVectorSI::load(QString & command) {
 QString EditableVectorSI::setValue(QString & command) {
   QStringList vars = getArgs(command);
 
-  _editablevector->setValue(vars.at(0).toInt(),
+  _editablevector->setValue(vars.at(0).toLongLong(),
                             vars.at(1).toDouble());
 
   return "Done";
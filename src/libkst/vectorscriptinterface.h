@@ -85,6 +85,8 @@ public:
     QString NFrames(QString &command);
     QString skip(QString &command);
     QString boxcarFirst(QString &command);
+    QString setCompactStorage(QString &command);
+    QString storageType(QString &command);
 
 private:
     DataVectorPtr _datavector;
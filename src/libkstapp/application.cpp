@@ -35,7 +35,7 @@
 namespace Kst {
 
 Application::Application(int &argc, char **argv)
-    : QApplication(argc, argv) {
+    : QApplication(argc, argv), _headless(false) {
 
   QCoreApplication::setApplicationName("Kst");
   setWindowIcon(KstGetIcon("kst"));
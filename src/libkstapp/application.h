@@ -35,9 +35,14 @@ class Application : public QApplication
 
     void initMainWindow();
     QString userName() {return _userName;}
+
+    // no one to answer a dialog: the render server's workers
+    bool headless() const {return _headless;}
+    void setHeadless(bool headless) {_headless = headless;}
 private:
     QPointer<MainWindow> _mainWindow;
     QString _userName;
+    bool _headless;
 };
 
 }
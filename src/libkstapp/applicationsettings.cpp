@@ -12,6 +12,7 @@
 
 #include "applicationsettings.h"
 
+#include "memorymanager.h"
 #include "updatemanager.h"
 #include "defaultlabelpropertiestab.h"
 #include "settings.h"
@@ -64,6 +65,8 @@ void ApplicationSettings::_readFromQSettings() {
   _useRaster = _settings.value("general/raster", false).toBool();
 
   _maxUpdate = _settings.value("general/minimumupdateperiod", QVariant(200)).toInt();
+  _readAheadTimeout = _settings.value("general/readaheadtimeout", QVariant(500)).toInt();
+  _memoryLimit = _settings.value("general/memorylimit", QVariant(0)).toInt();
 
   _showGrid = _settings.value("grid/showgrid", QVariant(false)).toBool();
   _snapToGrid = _settings.value("grid/snaptogrid", QVariant(false)).toBool();
@@ -186,6 +189,32 @@ void ApplicationSettings::setMinimumUpdatePeriod(const int period) {
 }
 
 
+int ApplicationSettings::readAheadTimeout() const {
+  return _readAheadTimeout;
+}
+
+
+void ApplicationSettings::setReadAheadTimeout(const int msecs) {
+  _readAheadTimeout = msecs;
+  _settings.setValue("general/readaheadtimeout", msecs);
+
+  UpdateManager::self()->setReadAheadTimeout(msecs);
+}
+
+
+int ApplicationSettings::memoryLimit() const {
+  return _memoryLimit;
+}
+
+
+void ApplicationSettings::setMemoryLimit(const int megabytes) {
+  _memoryLimit = megabytes;
+  _settings.setValue("general/memorylimit", megabytes);
+
+  MemoryManager::self()->setCeiling(qint64(megabytes)*1024*1024);
+}
+
+
 bool ApplicationSettings::showGrid() const {
   return _showGrid;
 }
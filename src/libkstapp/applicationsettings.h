@@ -52,6 +52,13 @@ class ApplicationSettings : public QObject
     int minimumUpdatePeriod() const;
     void setMinimumUpdatePeriod(const int period);
 
+    int readAheadTimeout() const;
+    void setReadAheadTimeout(const int msecs);
+
+    // in MB.  0 means no limit.
+    int memoryLimit() const;
+    void setMemoryLimit(const int megabytes);
+
     bool showGrid() const;
     void setShowGrid(bool showGrid);
 
@@ -92,6 +99,8 @@ class ApplicationSettings : public QObject
     qreal _refViewHeight;
     qreal _minFontSize;
     int _maxUpdate;
+    int _readAheadTimeout;
+    int _memoryLimit;
     bool _showGrid;
     bool _snapToGrid;
     qreal _gridHorSpacing;
@@ -76,6 +76,8 @@ void ApplicationSettingsDialog::setupGeneral() {
   _generalTab->setUseRaster(ApplicationSettings::self()->useRaster());
   _generalTab->setTransparentDrag(ApplicationSettings::self()->transparentDrag());
   _generalTab->setMinimumUpdatePeriod(ApplicationSettings::self()->minimumUpdatePeriod());
+  _generalTab->setReadAheadTimeout(ApplicationSettings::self()->readAheadTimeout());
+  _generalTab->setMemoryLimit(ApplicationSettings::self()->memoryLimit());
   _generalTab->setAntialiasPlot(ApplicationSettings::self()->antialiasPlots());
 }
 
@@ -109,6 +111,8 @@ void ApplicationSettingsDialog::generalChanged() {
   ApplicationSettings::self()->setTransparentDrag(_generalTab->transparentDrag());
   ApplicationSettings::self()->setUseRaster(_generalTab->useRaster());
   ApplicationSettings::self()->setMinimumUpdatePeriod(_generalTab->minimumUpdatePeriod());
+  ApplicationSettings::self()->setReadAheadTimeout(_generalTab->readAheadTimeout());
+  ApplicationSettings::self()->setMemoryLimit(_generalTab->memoryLimit());
   ApplicationSettings::self()->setAntialiasPlots(_generalTab->antialiasPlot());
   ApplicationSettings::self()->blockSignals(false);
 
@@ -65,6 +65,11 @@ namespace Kst {
 "      --png <filename>         Render to a png image, and exit.\n"
 "      --pngHeight <height>     Height of png image (pixels).\n"
 "      --pngWidth <width>       Width of png image (pixels).\n"
+"      --renderServer[=<n>]     Render the jobs read from stdin in n processes\n"
+"                               (default: one per core), and exit at the end of input.\n"
+"                               One job per line: {\"session\": \"report.kst\",\n"
+"                               \"files\": {\"old.dat\": \"new.dat\"}, \"output\": \"out.png\",\n"
+"                               \"width\": 1280, \"height\": 1024}\n"
 "File Options:\n"
 "      -f <startframe>          default: 'end' counts from end\n"
 "      -n <numframes>           default: 'end' reads to end of file\n"
@@ -804,6 +809,8 @@ bool CommandLineParser::processCommandLine(bool *ok) {
     } else if (arg == "--letter") {
       _paperSize = QPageSize::Letter;
 #endif
+    } else if (arg == "--renderServer" || arg.startsWith("--renderServer=") || arg == "--renderWorker") {
+      /* main() has already handled this.  Skip it. */
     } else if (arg.startsWith("--serverName=")) {
       /* scriptServer has already handled this.  Skip it. */
     } else { // arg is not an option... must be a file
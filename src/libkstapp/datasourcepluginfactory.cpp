@@ -79,6 +79,8 @@ DataSourcePtr DataSourcePluginFactory::generateDataSource(ObjectStore *store, QX
 
   if (!store->override.fileName.isEmpty()) {
     fileName = store->override.fileName;
+  } else {
+    fileName = store->override.files.value(fileName, fileName);
   }
 
   DataSourcePtr dataSource = 0L;
@@ -96,6 +98,9 @@ DataSourcePtr DataSourcePluginFactory::generateDataSource(ObjectStore *store, QX
       dataSource->setUpdateType(updateCheckType);
       dataSource->enableUpdates();
       return dataSource;
+    } else if (kstApp->headless()) {
+      Debug::self()->log(QObject::tr("Error creating data source from Kst file: could not open %1.").arg(fileName), Debug::Warning);
+      break;
     } else {
       alternate_filename = fileName;
       BadDatasourceDialog dialog(&fileName, store);
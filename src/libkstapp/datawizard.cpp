@@ -31,7 +31,6 @@
 #include "plotitem.h"
 #include "plotiteminterface.h"
 #include "applicationsettings.h"
-#include "updatemanager.h"
 #include "datasourcepluginmanager.h"
 #include "sharedaxisboxitem.h"
 #include "boxitem.h"
@@ -1033,6 +1032,10 @@ void DataWizard::finished() {
     return;
   }
 
+  // Hundreds of objects may be made here: they are updated, and the plots
+  // laid out, once, as the transaction ends.
+  ObjectTransaction transaction(_document->objectStore());
+
 //  n_steps += _pageVectors->plotVectors()->count();
 //  if (_pageDataPresentation->plotPSD()) {
 //    n_steps += _pageVectors->plotVectors()->count();
@@ -1426,7 +1429,7 @@ void DataWizard::finished() {
     }
   }
 
-  UpdateManager::self()->doUpdates(true);
+  transaction.commit();
 
   kstApp->mainWindow()->document()->setChanged(true);
   QApplication::restoreOverrideCursor();
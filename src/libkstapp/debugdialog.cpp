@@ -17,9 +17,13 @@
 #include "logevents.h"
 #include "datasource.h"
 #include "datasourcepluginmanager.h"
+#include "tracer.h"
 
 
 #include <QDebug>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QSaveFile>
 
 namespace Kst {
 
@@ -40,6 +44,12 @@ DebugDialog::DebugDialog(QWidget *parent)
 
   connect(_clearDSSettings, SIGNAL(clicked()), this, SLOT(clearDSSettings()));
 
+  _traceEnabled->setChecked(Tracer::self()->isEnabled());
+  connect(_traceEnabled, SIGNAL(toggled(bool)), this, SLOT(setTraceEnabled(bool)));
+  connect(_refreshTiming, SIGNAL(clicked()), this, SLOT(refreshTiming()));
+  connect(_clearTiming, SIGNAL(clicked()), this, SLOT(clearTiming()));
+  connect(_saveTrace, SIGNAL(clicked()), this, SLOT(saveTrace()));
+
   if (!Debug::self()->kstRevision().isEmpty())
     _buildInfo->setText(tr("<h1>Kst</h1> Version %1%2").arg(KSTVERSION).arg(Debug::self()->kstRevision()));
   else
@@ -92,6 +102,7 @@ void DebugDialog::show() {
   }
 
   _dataSources->header()->resizeSections(QHeaderView::ResizeToContents);
+  refreshTiming();
   QDialog::show();
 }
 
@@ -100,6 +111,50 @@ void DebugDialog::clearDSSettings() {
 }
 
 
+void DebugDialog::refreshTiming() {
+  _timing->setSortingEnabled(false);
+  _timing->clear();
+  const QList<Tracer::Summary> summary = Tracer::self()->summary();
+  foreach (const Tracer::Summary &s, summary) {
+    QTreeWidgetItem *item = new QTreeWidgetItem;
+    item->setText(0, QString::fromLatin1(s.category));
+    item->setText(1, s.name);
+    item->setData(2, Qt::DisplayRole, s.count);
+    item->setData(3, Qt::DisplayRole, s.total / 1.0e6);
+    item->setData(4, Qt::DisplayRole, s.max / 1.0e6);
+    item->setData(5, Qt::DisplayRole, s.samples);
+    item->setData(6, Qt::DisplayRole, s.bytes);
+    _timing->addTopLevelItem(item);
+  }
+  _timing->setSortingEnabled(true);
+  _timing->sortByColumn(3, Qt::DescendingOrder);
+  _timing->header()->resizeSections(QHeaderView::ResizeToContents);
+}
+
+
+void DebugDialog::clearTiming() {
+  Tracer::self()->clear();
+  refreshTiming();
+}
+
+
+void DebugDialog::saveTrace() {
+  const QString fileName = QFileDialog::getSaveFileName(this, tr("Save Trace"), QString(), tr("Chrome trace (*.json)"));
+  if (fileName.isEmpty()) {
+    return;
+  }
+  QSaveFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly) || file.write(Tracer::self()->chromeTrace()) < 0 || !file.commit()) {
+    QMessageBox::warning(this, tr("Kst"), tr("Could not write the trace to %1.").arg(fileName));
+  }
+}
+
+
+void DebugDialog::setTraceEnabled(bool enabled) {
+  Tracer::self()->setEnabled(enabled);
+}
+
+
 }
 
 // vim: ts=2 sw=2 et
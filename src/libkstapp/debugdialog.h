@@ -41,6 +41,10 @@ class DebugDialog : public QDialog, Ui::DebugDialog
     void clear();
     void show();
     void clearDSSettings();
+    void refreshTiming();
+    void clearTiming();
+    void saveTrace();
+    void setTraceEnabled(bool enabled);
 
   protected:
     bool event(QEvent *e);
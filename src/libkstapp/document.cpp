@@ -12,8 +12,11 @@
 
 #include "document.h"
 #include "mainwindow.h"
+#include "plotitem.h"
+#include "plotrenderitem.h"
 #include "sessionmodel.h"
 #include "tabwidget.h"
+#include "view.h"
 #include <datasourcefactory.h>
 #include <graphicsfactory.h>
 #include <datacollection.h>
@@ -22,13 +25,20 @@
 #include <relationfactory.h>
 #include <viewitem.h>
 #include <commandlineparser.h>
+#include "debug.h"
+#include "memorymanager.h"
 #include "objectstore.h"
+#include "relation.h"
 #include "updatemanager.h"
 #include "updateserver.h"
 
+#include <QCoreApplication>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QFileInfo>
 #include <QDir>
+#include <QSet>
 #include <QXmlStreamReader>
 
 
@@ -41,10 +51,12 @@ Document::Document(MainWindow *window)
   _fileName.clear();
 
   UpdateManager::self()->setStore(objectStore());
+  MemoryManager::self()->setStore(objectStore());
 }
 
 
 Document::~Document() {
+  MemoryManager::self()->setStore(0);
   delete _session;
   _session = 0;
 }
@@ -243,18 +255,118 @@ bool Document::initFromCommandLine(CommandLineParser *P) {
   return false;
 
 
+static QList<PlotItem*> plotsOf(View *view) {
+  QList<PlotItem*> plots;
+  foreach (QGraphicsItem *item, view->scene()->items()) {
+    if (PlotItem *plot = dynamic_cast<PlotItem*>(item)) {
+      plots.append(plot);
+    }
+  }
+  return plots;
+}
+
+
+// The relations plotted in view, and everything they are computed from.
+static QList<ObjectPtr> inputsOf(View *view) {
+  QList<ObjectPtr> objects;
+  QSet<Object*> seen;
+  QList<ObjectPtr> pending;
+
+  foreach (PlotItem *plot, plotsOf(view)) {
+    foreach (PlotRenderItem *renderer, plot->renderItems()) {
+      foreach (RelationPtr relation, renderer->relationList()) {
+        pending.append(relation);
+      }
+    }
+  }
+
+  while (!pending.isEmpty()) {
+    ObjectPtr object = pending.takeLast();
+    if (!object || seen.contains(object.data())) {
+      continue;
+    }
+    seen.insert(object.data());
+    objects.append(object);
+
+    PrimitiveList inputs;
+    if (RelationPtr relation = kst_cast<Relation>(object)) {
+      inputs = relation->inputPrimitives();
+    } else if (DataObjectPtr dataObject = kst_cast<DataObject>(object)) {
+      inputs = dataObject->inputPrimitives();
+    } else if (PrimitivePtr primitive = kst_cast<Primitive>(object)) {
+      pending.append(primitive->provider());
+    }
+    foreach (PrimitivePtr input, inputs) {
+      pending.append(input);
+    }
+  }
+
+  return objects;
+}
+
+
+static void setAwaitingData(View *view, bool awaiting) {
+  foreach (PlotItem *plot, plotsOf(view)) {
+    foreach (PlotRenderItem *renderer, plot->renderItems()) {
+      renderer->setAwaitingData(awaiting);
+    }
+  }
+}
+
+
+void Document::updateViewData(View *view) {
+  UpdateManager::self()->updateObjects(inputsOf(view));
+
+  const qint64 serial = UpdateManager::self()->serial();
+  foreach (PlotItem *plot, plotsOf(view)) {
+    plot->handleChangedInputs(serial);
+  }
+  setAwaitingData(view, false);
+  view->update();
+}
+
+
+// Sources opened while it lives leave their first scan of the file to the
+// staged update.
+class DeferredSourceScans {
+  public:
+    explicit DeferredSourceScans(ObjectStore *store) : _store(store) {
+      _store->deferSourceScans = true;
+    }
+    ~DeferredSourceScans() {
+      _store->deferSourceScans = false;
+    }
+
+  private:
+    ObjectStore *_store;
+};
+
+
 bool Document::open(const QString& file) {
-  _isOpen = false;
   QFile f(file);
   if (!f.open(QIODevice::ReadOnly)) {
+    _isOpen = false;
     _lastError = QObject::tr("File could not be opened for reading.");
     return false;
   }
+  return open(&f, file);
+}
+
+
+bool Document::open(QIODevice *device, const QString& file) {
+  QElapsedTimer timer;
+  timer.start();
+
+  _isOpen = false;
   // Temporarily set the application dir to the current dir to be able to load data using the "fileRelative" attribute
   QString restorePath = QDir::currentPath();
   QDir::setCurrent(file.left(file.lastIndexOf('/')) + '/');
   _fileName = file;
 
+  // The plots would otherwise update everything as each of them is read.
+  ObjectTransaction transaction(objectStore());
+  DeferredSourceScans deferred(objectStore());
+
   // If we move this into the <graphics> block then we could, if desired, open
   // .kst files that contained only data and basically "merge" that data into
   // the current session
@@ -264,7 +376,7 @@ bool Document::open(const QString& file) {
   QRectF currentSceneRect;
 
   QXmlStreamReader xml;
-  xml.setDevice(&f);
+  xml.setDevice(device);
 
   enum State { Unknown=0, Data, Variables, Objects, Relations, Graphics, View };
   State state = Unknown;
@@ -434,6 +546,7 @@ bool Document::open(const QString& file) {
 
   if (xml.hasError()) {
     _lastError = QObject::tr("File is malformed and encountered an error while reading.");
+    QDir::setCurrent(restorePath);
     return false;
   }
 
@@ -454,7 +567,46 @@ bool Document::open(const QString& file) {
     _win->tabWidget()->setCurrentIndex(currentTab);
   }
 
-  UpdateManager::self()->doUpdates(true);
+  // Nothing has been read yet: show the views right away, saying so, then
+  // read the data sources and fill in the current tab before the others.
+  foreach (View *view, _win->tabWidget()->views()) {
+    setAwaitingData(view, true);
+  }
+  transaction.commit(false);
+  const qint64 parseTime = timer.restart();
+  _win->updateProgress(1, QObject::tr("Reading data for %1").arg(file));
+  QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+  const qint64 viewTime = timer.restart();
+
+  UpdateManager::self()->beginStagedUpdate();
+  const qint64 sourceTime = timer.restart();
+
+  View *current = _win->tabWidget()->currentView();
+  if (current) {
+    updateViewData(current);
+    QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+  }
+  const qint64 currentTime = timer.restart();
+
+  foreach (View *view, _win->tabWidget()->views()) {
+    if (view != current) {
+      updateViewData(view);
+    }
+  }
+  UpdateManager::self()->endStagedUpdate();
+  _win->updateProgress(100, QString());
+  const qint64 otherTime = timer.restart();
+
+  Debug::self()->log(QObject::tr("Loaded %1: parse %2 ms, views %3 ms, %4 data sources (%5 in parallel) %6 ms, current tab %7 ms, other tabs %8 ms, total %9 ms")
+                     .arg(file).arg(parseTime).arg(viewTime)
+                     .arg(objectStore()->dataSourceList().count()).arg(UpdateManager::self()->concurrentSourceUpdates())
+                     .arg(sourceTime).arg(currentTime).arg(otherTime)
+                     .arg(parseTime + viewTime + sourceTime + currentTime + otherTime));
+  _win->setStatusMessage(QObject::tr("Loaded %1 in %2 ms (data sources %3 ms, current tab %4 ms, other tabs %5 ms)")
+                         .arg(QFileInfo(file).fileName())
+                         .arg(parseTime + viewTime + sourceTime + currentTime + otherTime)
+                         .arg(sourceTime).arg(currentTime).arg(otherTime), 10000);
+
   setChanged(false);
   // Restore current app path
   QDir::setCurrent(restorePath);
@@ -490,6 +642,11 @@ bool Document::isOpen() const {
 
 void Document::setChanged(bool dirty) {
   _dirty = dirty;
+  if (dirty && _win && _win->tabWidget()) {
+    foreach (View *view, _win->tabWidget()->views()) {
+      view->touchRevision();
+    }
+  }
 }
 
 View* Document::currentView() const {
@@ -16,6 +16,8 @@
 #include <QPointer>
 #include <QString>
 
+class QIODevice;
+
 #include "coredocument.h"
 #include "dataobject.h"
 namespace Kst {
@@ -38,6 +40,9 @@ class Document : public CoreDocument {
     bool initFromCommandLine(CommandLineParser *P);
 
     bool open(const QString& file);
+    /** reads the session from device, as if it were file: data files are
+        found relative to the directory of file */
+    bool open(QIODevice *device, const QString& file);
     bool save(const QString& to = QString());
 
     ObjectList<DataObject> sortedDataObjectList();
@@ -57,6 +62,9 @@ class Document : public CoreDocument {
 
 
   private:
+    /** update only what the plots of view need, then redraw them */
+    void updateViewData(View *view);
+
     QPointer<MainWindow> _win;
     SessionModel *_session;
     bool _dirty;
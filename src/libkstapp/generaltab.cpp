@@ -21,6 +21,8 @@ GeneralTab::GeneralTab(QWidget *parent)
 
   connect(_useRaster, SIGNAL(stateChanged(int)), this, SIGNAL(modified()));
   connect(_maxUpdate, SIGNAL(valueChanged(int)), this, SIGNAL(modified()));
+  connect(_readAheadTimeout, SIGNAL(valueChanged(int)), this, SIGNAL(modified()));
+  connect(_memoryLimit, SIGNAL(valueChanged(int)), this, SIGNAL(modified()));
   connect(_transparentDrag, SIGNAL(stateChanged(int)), this, SIGNAL(modified()));
   connect(_antialiasPlots, SIGNAL(stateChanged(int)), this, SIGNAL(modified()));
 }
@@ -64,6 +66,26 @@ void GeneralTab::setMinimumUpdatePeriod(const int period) {
   _maxUpdate->setValue(period);
 }
 
+
+int GeneralTab::readAheadTimeout() const {
+  return _readAheadTimeout->value();
+}
+
+
+void GeneralTab::setReadAheadTimeout(const int msecs) {
+  _readAheadTimeout->setValue(msecs);
+}
+
+
+int GeneralTab::memoryLimit() const {
+  return _memoryLimit->value();
+}
+
+
+void GeneralTab::setMemoryLimit(const int megabytes) {
+  _memoryLimit->setValue(megabytes);
+}
+
 }
 
 // vim: ts=2 sw=2 et
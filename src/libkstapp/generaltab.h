@@ -38,6 +38,12 @@ class GeneralTab : public DialogTab, Ui::GeneralTab {
     int minimumUpdatePeriod() const;
     void setMinimumUpdatePeriod(const int Period);
 
+    int readAheadTimeout() const;
+    void setReadAheadTimeout(const int msecs);
+
+    int memoryLimit() const;
+    void setMemoryLimit(const int megabytes);
+
 };
 
 }
@@ -42,6 +42,7 @@
 #include "viewprimitivedialog.h"
 #include "view.h"
 #include "applicationsettings.h"
+#include "memorymanager.h"
 #include "updatemanager.h"
 #include "datasourcepluginmanager.h"
 #include "pluginmenuitemaction.h"
@@ -62,6 +63,7 @@
 #include "dialogdefaults.h"
 #include "colorsequence.h"
 #include "settings.h"
+#include "tracer.h"
 
 #include "dialoglauncher.h"
 #include "scriptserver.h"
@@ -81,6 +83,10 @@
 #include <QProgressBar>
 #include <QMessageBox>
 #include <QImageWriter>
+#include <QBuffer>
+#include <QSaveFile>
+#include <QTemporaryFile>
+#include <QtConcurrentRun>
 #include <QToolBar>
 #include <QDebug>
 #include <QDesktopServices>
@@ -163,6 +169,7 @@ MainWindow::MainWindow() :
 
 
 MainWindow::~MainWindow() {
+  waitForExports();
   delete _dataManager;
   _dataManager = 0;
   delete _doc;
@@ -177,6 +184,8 @@ MainWindow::~MainWindow() {
 void MainWindow::performHeavyStartupActions() {
   // Set the timer for the UpdateManager.
   UpdateManager::self()->setMinimumUpdatePeriod(ApplicationSettings::self()->minimumUpdatePeriod());
+  UpdateManager::self()->setReadAheadTimeout(ApplicationSettings::self()->readAheadTimeout());
+  MemoryManager::self()->setCeiling(qint64(ApplicationSettings::self()->memoryLimit())*1024*1024);
   DataObject::init();
   DataSourcePluginManager::init();
 }
@@ -536,7 +545,7 @@ void MainWindow::checkRecentFilesOnExistence()
 }
 
 void MainWindow::autoExportImage() {
-  exportGraphicsFile(_ae_filename, _ae_format, _ae_width, _ae_height, _ae_display, _ae_export_all, _ae_autosave_period);
+  exportGraphicsFile(_ae_filename, _ae_format, _ae_width, _ae_height, _ae_display, _ae_export_all, _ae_autosave_period, true);
 }
 
 
@@ -597,7 +606,41 @@ void MainWindow::openFile(const QString &file) {
 }
 
 
-void MainWindow::exportGraphicsFile(const QString &filename, const QString &format, int width, int height, int display, bool export_all, int autosave_period) {
+// Writes by way of a temporary file renamed over the old one, so that
+// whatever watches the exports never reads half a file.
+static bool writeExportFile(const QString &file, const QByteArray &data) {
+  QSaveFile saveFile(file);
+  if (!saveFile.open(QIODevice::WriteOnly) || saveFile.write(data) != data.size() || !saveFile.commit()) {
+    Debug::self()->log(MainWindow::tr("Could not export %1: %2").arg(file, saveFile.errorString()), Debug::Warning);
+    return false;
+  }
+  return true;
+}
+
+
+static bool writeExportImage(const QString &file, const QImage &image, const QByteArray &format) {
+  QSaveFile saveFile(file);
+  bool ok = saveFile.open(QIODevice::WriteOnly);
+  if (ok) {
+    QImageWriter imageWriter(&saveFile, format);
+    ok = imageWriter.write(image) && saveFile.commit();
+  }
+  if (!ok) {
+    Debug::self()->log(MainWindow::tr("Could not export %1: %2").arg(file, saveFile.errorString()), Debug::Warning);
+  }
+  return ok;
+}
+
+
+// Views are laid out at the export size and drawn here, as they must be;
+// the encoding and writing of their files is left to worker threads.  A periodic export
+// (only_changed) skips the views whose revision and export size are as
+// they were when their file was last written, and those whose last file is
+// still being written.  Any other export waits for its files, and returns
+// false if one of them could not be written.
+bool MainWindow::exportGraphicsFile(const QString &filename, const QString &format, int width, int height, int display, bool export_all, int autosave_period, bool only_changed) {
+  bool ok = true;
+  QStringList files;
   int viewCount = 0;
   int n_views = _tabWidget->views().size();
   int i_startview, i_endview;
@@ -623,7 +666,16 @@ void MainWindow::exportGraphicsFile(const QString &filename, const QString &form
     i_startview = i_endview = _tabWidget->currentIndex();
   }
 
-  for (int i_view = i_startview; i_view<=i_endview; i_view++) {
+  for (QHash<QString, ExportWrite>::iterator it = _ae_writes.begin(); it != _ae_writes.end(); ) {
+    if (it.value().write.isFinished()) {
+      finishExport(it.key(), it.value());
+      it = _ae_writes.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  for (int i_view = i_startview; i_view<=i_endview; i_view++, viewCount++) {
     View *view = _tabWidget->views().at(i_view);
     QSize size;
     if (display == 0) { // Width set by user, maintain aspect ratio
@@ -650,76 +702,108 @@ void MainWindow::exportGraphicsFile(const QString &filename, const QString &form
           _tabWidget->tabBar()->tabText(viewCount).replace(QString("&"),QString()) + '.' +
              QFI.suffix();
     }
+
+    ExportWrite exportWrite;
+    exportWrite.stamp.revision = view->revision();
+    exportWrite.stamp.size = size;
+    exportWrite.stamp.format = format;
+    if (_ae_writes.contains(file)) {
+      if (only_changed) {
+        continue;
+      }
+      finishExport(file, _ae_writes.take(file));
+    }
+    if (only_changed && _ae_exported.contains(file)) {
+      const AutoExport &last = _ae_exported[file];
+      if (last.revision == exportWrite.stamp.revision && last.size == size && last.format == format) {
+        continue;
+      }
+    }
+
+    TraceSpan span("render", QString("export %1").arg(file));
+
     if (format == QString("svg")) {
 #ifndef KST_NO_SVG
       QPainter painter;
       QSvgGenerator generator;
+      QBuffer *buffer = new QBuffer;
+      buffer->open(QIODevice::WriteOnly);
 
-      QSize currentSize(view->size());
-      view->resize(size);
-      view->processResize(size);
-      view->setPrinting(true);
-
-      generator.setFileName(file);
+      generator.setOutputDevice(buffer);
       generator.setResolution(300);
-      generator.setSize(view->size());
-      generator.setViewBox(view->rect());
+      generator.setSize(size);
+      generator.setViewBox(QRect(QPoint(), size));
 
       painter.begin(&generator);
-      view->render(&painter);
+      view->renderAtSize(&painter, size);
       painter.end();
 
-      view->setPrinting(false);
-      view->resize(currentSize);
-      view->processResize(currentSize);
+      const QByteArray data = buffer->data();
+      delete buffer;
+      exportWrite.write = QtConcurrent::run([file, data]() { return writeExportFile(file, data); });
+      _ae_writes.insert(file, exportWrite);
+#else
+      ok = false;
 #endif
-    } else if (format == QString("eps")) {
+    } else if (format == QString("eps") || format == QString("pdf")) {
 #ifndef KST_NO_PRINTER
-      QPrinter printer(QPrinter::ScreenResolution);
-      printer.setOutputFormat(QPrinter::PdfFormat);
-      printer.setOutputFileName(file);
-      printer.setPageOrientation(QPageLayout::Portrait);
-
-      printer.setPrintRange(QPrinter::PageRange);
-      printer.setFromTo(i_view+1, i_view+1);
-
-      printer.setPageSize(QPageSize(size, QPageSize::Point));
-      printToPrinter(&printer);
+      // the printer writes its own file: print to a temporary one, and
+      // copy that over
+      QTemporaryFile temporary(QDir::tempPath() + "/kst_export_XXXXXX." + format);
+      if (!temporary.open()) {
+        Debug::self()->log(tr("Could not export %1: %2").arg(file, temporary.errorString()), Debug::Warning);
+        ok = false;
+        continue;
+      }
+      temporary.close();
 
-    } else if (format == QString("pdf")) {
       QPrinter printer(QPrinter::ScreenResolution);
       printer.setOutputFormat(QPrinter::PdfFormat);
-      printer.setOutputFileName(file);
+      printer.setOutputFileName(temporary.fileName());
       //setPrinterDefaults(&printer);
       printer.setPageOrientation(QPageLayout::Portrait);
+      printer.setPageSize(QPageSize(size, QPageSize::Point));
 
-      printer.setPrintRange(QPrinter::PageRange);
-      printer.setFromTo(i_view+1, i_view+1);
+      QPainter painter;
+      if (!painter.begin(&printer)) {
+        Debug::self()->log(tr("Could not export %1: could not print to %2").arg(file, temporary.fileName()), Debug::Warning);
+        ok = false;
+        continue;
+      }
+      view->renderAtSize(&painter, printer.pageRect(QPrinter::DevicePixel).size().toSize());
+      painter.end();
 
-      printer.setPageSize(QPageSize(size, QPageSize::Point));
-      printToPrinter(&printer);
+      if (!temporary.open()) {
+        Debug::self()->log(tr("Could not export %1: %2").arg(file, temporary.errorString()), Debug::Warning);
+        ok = false;
+        continue;
+      }
+      const QByteArray data = temporary.readAll();
+      exportWrite.write = QtConcurrent::run([file, data]() { return writeExportFile(file, data); });
+      _ae_writes.insert(file, exportWrite);
 #endif
     } else {
       QPainter painter;
       QImage image(size, QImage::Format_ARGB32);
 
       painter.begin(&image);
-
-      QSize currentSize(view->size());
-      view->resize(size);
-      view->processResize(size);
-      view->setPrinting(true);
-      view->render(&painter);
-      view->setPrinting(false);
-      view->resize(currentSize);
-      view->processResize(currentSize);
-
+      view->renderAtSize(&painter, size);
       painter.end();
 
-      QImageWriter imageWriter(file, format.toLatin1());
-      imageWriter.write(image);
+      const QByteArray imageFormat = format.toLatin1();
+      exportWrite.write = QtConcurrent::run([file, image, imageFormat]() { return writeExportImage(file, image, imageFormat); });
+      _ae_writes.insert(file, exportWrite);
+    }
+    files.append(file);
+  }
+
+  if (!only_changed) {
+    foreach (const QString &file, files) {
+      if (_ae_writes.contains(file)) {
+        ok = finishExport(file, _ae_writes.take(file)) && ok;
+      }
     }
-    viewCount++;
+    waitForExports();
   }
 
   if (_ae_autosave_period > 0) {
@@ -730,6 +814,27 @@ void MainWindow::exportGraphicsFile(const QString &filename, const QString &form
     }
     _ae_Timer->start(_ae_autosave_period); // one shot timer...
   }
+  return ok;
+}
+
+
+// Waits for the write of file, and returns whether it was written.  A file
+// counts as exported, for the change detection, only once it has been.
+bool MainWindow::finishExport(const QString &file, const ExportWrite &write) {
+  if (write.write.result()) {
+    _ae_exported.insert(file, write.stamp);
+    return true;
+  }
+  _ae_exported.remove(file);
+  return false;
+}
+
+
+void MainWindow::waitForExports() {
+  for (QHash<QString, ExportWrite>::const_iterator it = _ae_writes.constBegin(); it != _ae_writes.constEnd(); ++it) {
+    finishExport(it.key(), it.value());
+  }
+  _ae_writes.clear();
 }
 
 void MainWindow::exportLog(const QString &imagename, QString &msgfilename, const QString &format, int x_size, int y_size,
@@ -808,14 +913,7 @@ void MainWindow::printToPrinter(QPrinter *printer) {
   for (int i = 0; i < 1; ++i) {  // Qt6: numCopies removed, default to 1
     for (int i_page = 0; i_page<pages.count(); i_page++) {
       View *view = pages.at(i_page);
-      QSize currentSize(view->size());
-      view->resize(printerPageSize);
-      view->processResize(printerPageSize);
-      view->setPrinting(true);
-      view->render(&painter);
-      view->setPrinting(false);
-      view->resize(currentSize);
-      view->processResize(currentSize);
+      view->renderAtSize(&painter, printerPageSize);
       if (i_page<pages.count()-1)
         printer->newPage();
 
@@ -2346,13 +2444,18 @@ void Kst::MainWindow::updateViewItems(qint64 serial)
 
   bool changed = false;
   foreach (PlotItem *plot, plots) {
-    changed |= plot->handleChangedInputs(serial);
+    if (plot->handleChangedInputs(serial)) {
+      plot->view()->touchRevision();
+      changed = true;
+    }
   }
 
   QList<LabelItem*> labels = ViewItem::getItems<LabelItem>();
   foreach (LabelItem * label, labels) {
     if (label->_labelRc) {
-      label->inputsChanged(serial);
+      if (label->inputsChanged(serial)) {
+        label->view()->touchRevision();
+      }
     }
   }
 
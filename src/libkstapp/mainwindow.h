@@ -13,6 +13,8 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include <QFuture>
+#include <QHash>
 #include <QMainWindow>
 #include <QPointer>
 #include <QLabel>
@@ -131,7 +133,7 @@ public Q_SLOTS:
     void printToPrinter(QPrinter *printer);
     void printFromCommandLine(const QString &printFileName);
 #endif
-    void exportGraphicsFile(const QString &filename, const QString &format, int w, int h, int display, bool export_all, int autosave_period);
+    bool exportGraphicsFile(const QString &filename, const QString &format, int w, int h, int display, bool export_all, int autosave_period, bool only_changed = false);
     void exportLog(const QString &imagename, QString &msgfilename, const QString &_format, int x_size, int y_size,
                    int size_option_index, const QString &message);
 
@@ -381,6 +383,22 @@ public Q_SLOTS:
     bool _ae_export_all;
     int _ae_autosave_period;
     QTimer *_ae_Timer;
+
+    // what each file was last exported from, and the files being written
+    struct AutoExport {
+      quint64 revision;
+      QSize size;
+      QString format;
+    };
+    struct ExportWrite {
+      QFuture<bool> write;
+      AutoExport stamp;
+    };
+    QHash<QString, AutoExport> _ae_exported;
+    QHash<QString, ExportWrite> _ae_writes;
+    bool finishExport(const QString &file, const ExportWrite &write);
+    void waitForExports();
+
     QString _sessionFileName;
 
     friend class ScriptServer;
@@ -14,6 +14,8 @@
 
 #include "memorywidget.h"
 
+#include "memorymanager.h"
+
 #include <psversion.h>
 #include <sysinfo.h>
 
@@ -32,10 +34,30 @@ MemoryWidget::~MemoryWidget() {
 
 
 void MemoryWidget::updateFreeMemory() {
+  const int MB = 1024 * 1024;
+  MemoryManager *mm = MemoryManager::self();
+
+  QString vectorText;
+  if (mm->ceiling() > 0) {
+    vectorText = tr("%1 of %2 MB in data").arg(mm->used() / MB).arg(mm->ceiling() / MB);
+  } else {
+    vectorText = tr("%1 MB in data").arg(mm->used() / MB);
+  }
+
+  // the biggest users go in the tool tip
+  const QList<MemoryManager::Usage> usage = mm->usage();
+  QString tip;
+  for (int i = 0; i < usage.count() && i < 10; ++i) {
+    tip += tr("%1 (%2): %3 MB\n").arg(usage[i].name).arg(usage[i].type).arg(usage[i].bytes / double(MB), 0, 'f', 1);
+  }
+  setToolTip(tip.trimmed());
+
 #ifdef __linux__
   meminfo();
   unsigned long mi = S(kb_main_free + kb_main_cached);
-  setText(tr("%1 MB available").arg(mi / (1024 * 1024)));
+  setText(tr("%1, %2 MB available").arg(vectorText).arg(mi / (1024 * 1024)));
+#else
+  setText(vectorText);
 #endif
 }
 
@@ -41,6 +41,7 @@
 #include "updatemanager.h"
 #include "plotscriptinterface.h"
 #include "math_kst.h"
+#include "tracer.h"
 
 #include "dialogdefaults.h"
 
@@ -1044,6 +1045,9 @@ void PlotItem::updatePlotPixmap() {
   QPixmap pixmap(device_pixel_ratio*(rect().width()+1), device_pixel_ratio*(rect().height()+1));
   pixmap.setDevicePixelRatio(device_pixel_ratio);
 
+  TraceSpan span("render", this);
+  span.setBytes(qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8);
+
   pixmap.fill(Qt::transparent);
   QPainter pixmapPainter(&pixmap);
 
@@ -36,7 +36,7 @@ QList<double> PlotMarkers::markers() {
   QList<double> calculatedMarkers = _manualMarkers;
   if (_vector != 0) {
     _vector->readLock();
-    for (int i = 0; i < _vector->length(); ++i) {
+    for (qint64 i = 0; i < _vector->length(); ++i) {
       calculatedMarkers << _vector->value(i);
     }
     _vector->unlock();
@@ -44,7 +44,7 @@ QList<double> PlotMarkers::markers() {
   if (_curve != 0) {
     _curve->readLock();
 
-    int count = _curve->sampleCount();
+    qint64 count = _curve->sampleCount();
 
     if (count > 0) {
       double prevX, prevY;
@@ -52,7 +52,7 @@ QList<double> PlotMarkers::markers() {
 
       // scan through the whole curve
       _curve->point(0, prevX, prevY);
-      for (int i = 1; i < count; i++) {
+      for (qint64 i = 1; i < count; i++) {
         _curve->point(i, curX, curY);
         if (_xAxis) {
           if ((_curveMode == RisingEdge || _curveMode == BothEdges) && prevY == 0.0 && curY > 0.0) {
@@ -38,7 +38,7 @@
 namespace Kst {
 
 PlotRenderItem::PlotRenderItem(PlotItem *parentItem)
-  : ViewItem(parentItem->view()), _referencePointMode(false), _highlightPointActive(false), _invertHighlight(false) {
+  : ViewItem(parentItem->view()), _referencePointMode(false), _highlightPointActive(false), _invertHighlight(false), _awaitingData(false) {
 
   setTypeName(tr("Plot Render"));
   setParentViewItem(parentItem);
@@ -95,6 +95,14 @@ void PlotRenderItem::setReferencePoint(const QPointF& point) {
 }
 
 
+void PlotRenderItem::setAwaitingData(bool awaiting) {
+  if (awaiting != _awaitingData) {
+    _awaitingData = awaiting;
+    update();
+  }
+}
+
+
 PlotRenderItem::RenderType PlotRenderItem::renderType() const {
   return _type;
 }
@@ -280,6 +288,13 @@ void PlotRenderItem::paint(QPainter *painter) {
 
   painter->restore();
 
+  if (_awaitingData && !view()->isPrinting()) {
+    painter->save();
+    painter->setPen(QColor("gray"));
+    painter->drawText(rect(), Qt::AlignCenter, tr("Reading data..."));
+    painter->restore();
+  }
+
   if (!view()->isPrinting()) {
     processHoverMoveEvent(_hoverPos, true);
   }
@@ -881,7 +896,7 @@ void PlotRenderItem::highlightNearestDataPoint(const QPointF& position, bool del
 
     foreach(RelationPtr relation, relationList()) {
       if (Curve* curve = kst_cast<Curve>(relation)) {
-        int index = curve->getIndexNearXY(position.x(), dxPerPix, position.y());
+        qint64 index = curve->getIndexNearXY(position.x(), dxPerPix, position.y());
         curve->point(index, x, y);
         distance = fabs(position.y() - y);
         if (bFirst || distance < minDistance) {
@@ -50,6 +50,10 @@ class PlotRenderItem : public ViewItem
     void clearRelations();
     void setRelationsList(const RelationList &relations);
 
+    /** while set, the plot says its data is still being read */
+    bool awaitingData() const { return _awaitingData; }
+    void setAwaitingData(bool awaiting);
+
     virtual void save(QXmlStreamWriter &xml);
     virtual void saveInPlot(QXmlStreamWriter &xml);
     virtual void paint(QPainter *painter);
@@ -142,6 +146,7 @@ class PlotRenderItem : public ViewItem
     bool _highlightPointActive;
     bool _invertHighlight;
     QPointF _highlightPoint;
+    bool _awaitingData;
 
     RelationList _relationList;
     SelectionRect _selectionRect;
@@ -0,0 +1,402 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "renderserver.h"
+
+#include "datasource.h"
+#include "debug.h"
+#include "document.h"
+#include "mainwindow.h"
+#include "objectstore.h"
+
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+#include <stdio.h>
+
+namespace Kst {
+
+static QByteArray toLine(const QJsonObject &object) {
+  return QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+}
+
+
+static void writeOut(const QByteArray &line) {
+  fwrite(line.constData(), 1, line.size(), stdout);
+  fflush(stdout);
+}
+
+
+bool RenderJob::parse(const QByteArray &line, QString *error) {
+  QJsonParseError parseError;
+  const QJsonDocument document = QJsonDocument::fromJson(line, &parseError);
+  if (!document.isObject()) {
+    *error = parseError.error != QJsonParseError::NoError ? parseError.errorString() : QObject::tr("a job is a JSON object");
+    return false;
+  }
+  const QJsonObject job = document.object();
+
+  id = job.value("id").toVariant().toString();
+  session = job.value("session").toString();
+  output = job.value("output").toString();
+  if (session.isEmpty() || output.isEmpty()) {
+    *error = QObject::tr("a job needs a session and an output");
+    return false;
+  }
+
+  const QJsonObject substitutions = job.value("files").toObject();
+  files.clear();
+  for (QJsonObject::const_iterator it = substitutions.constBegin(); it != substitutions.constEnd(); ++it) {
+    files.insert(it.key(), it.value().toString());
+  }
+
+  format = job.value("format").toString();
+  if (format.isEmpty()) {
+    format = QFileInfo(output).suffix().toLower();
+    if (format.isEmpty()) {
+      format = "png";
+    }
+  }
+  width = job.value("width").toInt(width);
+  height = job.value("height").toInt(height);
+  if (width < 1 || height < 1) {
+    *error = QObject::tr("bad image size %1x%2").arg(width).arg(height);
+    return false;
+  }
+  allTabs = job.value("allTabs").toBool(allTabs);
+  return true;
+}
+
+
+RenderWorker::RenderWorker(MainWindow *win)
+  : _win(win) {
+}
+
+
+int RenderWorker::exec() {
+  QFile in;
+  if (!in.open(stdin, QIODevice::ReadOnly)) {
+    return 1;
+  }
+
+  for (;;) {
+    const QByteArray read = in.readLine();
+    if (read.isEmpty()) {
+      break;
+    }
+    const QByteArray line = read.trimmed();
+    if (line.isEmpty()) {
+      continue;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    RenderJob job;
+    QString error;
+    const bool ok = job.parse(line, &error) && render(job, &error);
+
+    QJsonObject result;
+    result.insert("id", job.id);
+    result.insert("ok", ok);
+    if (ok) {
+      result.insert("output", job.output);
+      result.insert("msecs", qint64(timer.elapsed()));
+    } else {
+      result.insert("error", error);
+    }
+    writeOut(toLine(result));
+
+    // there is no event loop to delete the last session's views
+    QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+    Debug::self()->clear();
+  }
+  return 0;
+}
+
+
+bool RenderWorker::render(const RenderJob &job, QString *error) {
+  const QString path = QFileInfo(job.session).absoluteFilePath();
+  QByteArray contents;
+  if (!session(path, &contents, error)) {
+    return false;
+  }
+
+  // keyed as the factories see the data files: absolute and clean
+  const QDir dir = QFileInfo(path).absoluteDir();
+  QHash<QString, QString> files;
+  for (QHash<QString, QString>::const_iterator it = job.files.constBegin(); it != job.files.constEnd(); ++it) {
+    files.insert(DataSource::cleanPath(dir.absoluteFilePath(it.key())),
+                 DataSource::cleanPath(dir.absoluteFilePath(it.value())));
+  }
+
+  _win->newDoc(true);
+  Document *document = _win->document();
+  document->objectStore()->override.files = files;
+
+  QBuffer buffer(&contents);
+  buffer.open(QIODevice::ReadOnly);
+  const bool opened = document->open(&buffer, path);
+  document->objectStore()->override.files.clear();
+  if (!opened) {
+    *error = document->lastError();
+    return false;
+  }
+  // the document has been read and updated by now
+  const QString output = QFileInfo(job.output).absoluteFilePath();
+  if (!_win->exportGraphicsFile(output, job.format, job.width, job.height, 2, job.allTabs, 0)) {
+    *error = QObject::tr("could not write %1").arg(output);
+    return false;
+  }
+  return true;
+}
+
+
+bool RenderWorker::session(const QString &file, QByteArray *contents, QString *error) {
+  const QDateTime modified = QFileInfo(file).lastModified();
+  QHash<QString, Template>::const_iterator it = _templates.constFind(file);
+  if (it != _templates.constEnd() && it.value().modified == modified) {
+    *contents = it.value().contents;
+    return true;
+  }
+
+  QFile f(file);
+  if (!f.open(QIODevice::ReadOnly)) {
+    *error = QObject::tr("could not read %1: %2").arg(file, f.errorString());
+    return false;
+  }
+  Template t;
+  t.modified = modified;
+  t.contents = f.readAll();
+  _templates.insert(file, t);
+  *contents = t.contents;
+  return true;
+}
+
+
+RenderServer::RenderServer(int workers, QObject *parent)
+  : QObject(parent), _inputFinished(false), _done(0), _failed(0) {
+  for (int i = 0; i < qMax(workers, 1); ++i) {
+    Worker *worker = new Worker;
+    worker->process = 0;
+    worker->busy = false;
+    _workers.append(worker);
+    startWorker(worker);
+  }
+}
+
+
+RenderServer::~RenderServer() {
+  foreach (Worker *worker, _workers) {
+    if (worker->process) {
+      worker->process->disconnect(this);
+      worker->process->closeWriteChannel();
+      if (!worker->process->waitForFinished(10000)) {
+        worker->process->kill();
+        worker->process->waitForFinished();
+      }
+      delete worker->process;
+    }
+    delete worker;
+  }
+}
+
+
+int RenderServer::exec() {
+  // a blocking read of stdin, so in a thread of its own
+  QThread *reader = QThread::create([this]() {
+    QFile in;
+    if (in.open(stdin, QIODevice::ReadOnly)) {
+      for (;;) {
+        const QByteArray line = in.readLine();
+        if (line.isEmpty()) {
+          break;
+        }
+        QMetaObject::invokeMethod(this, [this, line]() { readJob(line); }, Qt::QueuedConnection);
+      }
+    }
+    QMetaObject::invokeMethod(this, [this]() { inputFinished(); }, Qt::QueuedConnection);
+  });
+  reader->start();
+
+  const int result = QCoreApplication::exec();
+  reader->wait();
+  delete reader;
+  return result;
+}
+
+
+void RenderServer::startWorker(Worker *worker) {
+  QProcess *process = new QProcess(this);
+  process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+  connect(process, SIGNAL(readyReadStandardOutput()), this, SLOT(readResults()));
+  connect(process, SIGNAL(finished(int,QProcess::ExitStatus)), this, SLOT(workerFinished()));
+  worker->job.clear();
+  worker->busy = false;
+  process->start(QCoreApplication::applicationFilePath(), QStringList() << "--renderWorker");
+  if (!process->waitForStarted()) {
+    fprintf(stderr, "%s\n", qPrintable(tr("Could not start a render worker: %1").arg(process->errorString())));
+    delete process;
+    worker->process = 0;
+    return;
+  }
+  worker->process = process;
+}
+
+
+void RenderServer::readJob(const QByteArray &line) {
+  const QByteArray trimmed = line.trimmed();
+  if (trimmed.isEmpty()) {
+    return;
+  }
+  if (!_timer.isValid()) {
+    _timer.start();
+  }
+
+  RenderJob job;
+  QString error;
+  if (!job.parse(trimmed, &error)) {
+    fail(job.id, error);
+    return;
+  }
+  _jobs.enqueue(qMakePair(job.id, trimmed));
+  dispatch();
+}
+
+
+void RenderServer::inputFinished() {
+  _inputFinished = true;
+  finishIfDone();
+}
+
+
+void RenderServer::dispatch() {
+  bool running = false;
+  foreach (Worker *worker, _workers) {
+    if (worker->process) {
+      running = true;
+    }
+  }
+  while (!running && !_jobs.isEmpty()) {
+    fail(_jobs.dequeue().first, tr("no render worker is running"));
+  }
+
+  foreach (Worker *worker, _workers) {
+    if (_jobs.isEmpty()) {
+      return;
+    }
+    if (worker->process && !worker->busy) {
+      const QPair<QString, QByteArray> job = _jobs.dequeue();
+      worker->job = job.first;
+      worker->busy = true;
+      worker->process->write(job.second + '\n');
+    }
+  }
+}
+
+
+void RenderServer::readResults() {
+  QProcess *process = qobject_cast<QProcess*>(sender());
+  foreach (Worker *worker, _workers) {
+    if (worker->process != process) {
+      continue;
+    }
+    while (process->canReadLine()) {
+      // anything else a plugin prints goes with the log
+      const QByteArray line = process->readLine();
+      const QJsonObject result = QJsonDocument::fromJson(line).object();
+      if (!result.contains("ok")) {
+        fwrite(line.constData(), 1, line.size(), stderr);
+        continue;
+      }
+      report(line, result.value("ok").toBool());
+      worker->job.clear();
+      worker->busy = false;
+    }
+  }
+  dispatch();
+  finishIfDone();
+}
+
+
+// A worker that dies fails the job it was on, which isn't tried again;
+// another worker takes its place.
+void RenderServer::workerFinished() {
+  QProcess *process = qobject_cast<QProcess*>(sender());
+  foreach (Worker *worker, _workers) {
+    if (worker->process != process) {
+      continue;
+    }
+    if (worker->busy) {
+      fail(worker->job, tr("the render worker exited (%1)").arg(process->exitCode()));
+    }
+    process->deleteLater();
+    worker->process = 0;
+    if (!_inputFinished || !_jobs.isEmpty()) {
+      startWorker(worker);
+    } else {
+      worker->busy = false;
+    }
+  }
+  dispatch();
+  finishIfDone();
+}
+
+
+void RenderServer::fail(const QString &id, const QString &error) {
+  QJsonObject result;
+  result.insert("id", id);
+  result.insert("ok", false);
+  result.insert("error", error);
+  report(toLine(result), false);
+}
+
+
+void RenderServer::report(const QByteArray &result, bool ok) {
+  writeOut(result.endsWith('\n') ? result : result + '\n');
+  ++_done;
+  if (!ok) {
+    ++_failed;
+  }
+}
+
+
+void RenderServer::finishIfDone() {
+  if (!_inputFinished || !_jobs.isEmpty()) {
+    return;
+  }
+  foreach (Worker *worker, _workers) {
+    if (worker->busy) {
+      return;
+    }
+  }
+
+  const double seconds = _timer.isValid() ? _timer.nsecsElapsed() * 1.0e-9 : 0.0;
+  const int images = _done - _failed;
+  QJsonObject summary;
+  summary.insert("images", images);
+  summary.insert("failed", _failed);
+  summary.insert("seconds", seconds);
+  summary.insert("imagesPerSecond", seconds > 0.0 ? images / seconds : 0.0);
+  writeOut(toLine(summary));
+
+  QCoreApplication::exit(_failed > 0 ? 1 : 0);
+}
+
+}
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,137 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef RENDERSERVER_H
+#define RENDERSERVER_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPair>
+#include <QProcess>
+#include <QQueue>
+#include <QString>
+
+namespace Kst {
+
+class MainWindow;
+
+/** One image to render, read from a line of JSON:
+
+      {"id": "r1", "session": "/reports/daily.kst",
+       "files": {"/data/template.dat": "/data/2026-10-18.dat"},
+       "output": "/out/r1.png", "width": 1280, "height": 1024}
+
+    "files" names data files of the session and the files to read in their
+    place; relative paths are taken from the directory of the session.
+    "format" defaults to the suffix of output, "width" and "height" to
+    1280x1024; "allTabs" renders every tab, each to its own file, as
+    --png would. */
+struct RenderJob {
+  RenderJob() : width(1280), height(1024), allTabs(false) {}
+
+  bool parse(const QByteArray &line, QString *error);
+
+  QString id;
+  QString session;
+  QHash<QString, QString> files;
+  QString output;
+  QString format;
+  int width;
+  int height;
+  bool allTabs;
+};
+
+
+/** What a worker process (kst --renderWorker) runs in place of the event
+    loop: renders each job read from stdin in its main window, which is
+    never shown, and writes one line of JSON per job to stdout.  Data source
+    plugins stay loaded from one job to the next, and each session template
+    is read once, while it isn't modified. */
+class RenderWorker
+{
+  public:
+    explicit RenderWorker(MainWindow *win);
+
+    /** until the end of stdin */
+    int exec();
+
+  private:
+    bool render(const RenderJob &job, QString *error);
+    bool session(const QString &file, QByteArray *contents, QString *error);
+
+    struct Template {
+      QDateTime modified;
+      QByteArray contents;
+    };
+
+    MainWindow *_win;
+    QHash<QString, Template> _templates;
+};
+
+
+/** kst --renderServer[=<workers>]: reads jobs from stdin and hands them out
+    to worker processes on the offscreen platform, one per core by default,
+    each job to the first idle one.  Kst keeps one document per process, so
+    the jobs run side by side in processes rather than threads.
+
+    The results are written to stdout as the jobs finish, one line each:
+
+      {"id": "r1", "ok": true, "output": "/out/r1.png", "msecs": 412}
+
+    and at the end of input, once every job is done, a summary:
+
+      {"images": 3000, "failed": 0, "seconds": 71.2, "imagesPerSecond": 42.1} */
+class RenderServer : public QObject
+{
+  Q_OBJECT
+  public:
+    explicit RenderServer(int workers, QObject *parent = 0);
+    ~RenderServer();
+
+    /** runs the event loop; the exit code is 1 if any job failed */
+    int exec();
+
+  private Q_SLOTS:
+    void readJob(const QByteArray &line);
+    void inputFinished();
+    void readResults();
+    void workerFinished();
+
+  private:
+    struct Worker {
+      QProcess *process;
+      QString job; // the id of the job it is on, if any
+      bool busy;
+    };
+
+    void startWorker(Worker *worker);
+    void dispatch();
+    void fail(const QString &id, const QString &error);
+    void report(const QByteArray &result, bool ok);
+    void finishIfDone();
+
+    QList<Worker*> _workers;
+    QQueue<QPair<QString, QByteArray> > _jobs;
+    bool _inputFinished;
+    int _done;
+    int _failed;
+    QElapsedTimer _timer;
+};
+
+}
+
+#endif
+
+// vim: ts=2 sw=2 et
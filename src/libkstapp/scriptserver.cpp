@@ -60,7 +60,10 @@
 #include "editablematrix.h"
 
 #include "datasourcepluginmanager.h"
+#include "applicationsettings.h"
 
+#include <memorymanager.h>
+#include <tracer.h>
 #include <updatemanager.h>
 
 #include <QLocalSocket>
@@ -225,8 +228,18 @@ ScriptServer::ScriptServer(ObjectStore *obj) : _server(new QLocalServer(this)),
     _fnMap.insert("setDatasourceIntConfig()", &ScriptServer::setDatasourceIntConfig);
     _fnMap.insert("setDatasourceStringConfig()", &ScriptServer::setDatasourceStringConfig);
 
+    _fnMap.insert("getMemoryUsage()", &ScriptServer::getMemoryUsage);
+    _fnMap.insert("setMemoryLimit()", &ScriptServer::setMemoryLimit);
+
+    _fnMap.insert("getTimingSummary()", &ScriptServer::getTimingSummary);
+    _fnMap.insert("saveTrace()", &ScriptServer::saveTrace);
+    _fnMap.insert("clearTrace()", &ScriptServer::clearTrace);
+
     _fnMap.insert("cleanupLayout()", &ScriptServer::cleanupLayout);
 
+    _fnMap.insert("beginBulk()", &ScriptServer::beginBulk);
+    _fnMap.insert("endBulk()", &ScriptServer::endBulk);
+
     _fnMap.insert("testCommand()", &ScriptServer::testCommand);
 
 #if 0
@@ -333,6 +346,15 @@ void ScriptServer::procConnection() {
     while(_server->hasPendingConnections()) {
         QLocalSocket* s=_server->nextPendingConnection();
         connect(s,SIGNAL(readyRead()),this,SLOT(readSomething()));
+        connect(s,SIGNAL(disconnected()),this,SLOT(endBulkOf()));
+    }
+}
+
+/** Ends the transactions a client which went away left open. */
+void ScriptServer::endBulkOf() {
+    QLocalSocket* s=qobject_cast<QLocalSocket*>(sender());
+    for(int n=_bulk.take(s);n>0;n--) {
+        _store->endTransaction();
     }
 }
 
@@ -1093,6 +1115,26 @@ QByteArray ScriptServer::cleanupLayout(QByteArray&command, QLocalSocket* s,Objec
     return handleResponse("Done",s);
 }
 
+/** Objects made between beginBulk() and endBulk() are updated, and their
+    plots laid out, once, at endBulk(). */
+QByteArray ScriptServer::beginBulk(QByteArray&, QLocalSocket* s,ObjectStore*) {
+    _store->beginTransaction();
+    _bulk[s]++;
+    return handleResponse("Done",s);
+}
+
+QByteArray ScriptServer::endBulk(QByteArray&, QLocalSocket* s,ObjectStore*) {
+    if(_bulk.value(s)==0) {
+        return handleResponse("No bulk creation open.",s);
+    }
+    if(--_bulk[s]==0) {
+        _bulk.remove(s);
+    }
+    _store->endTransaction();
+    UpdateServer::self()->requestUpdateSignal();
+    return handleResponse("Done",s);
+}
+
 /*** Interface for changing datasource configuration settings ***/
 QByteArray ScriptServer::setDatasourceBoolConfig(QByteArray& command, QLocalSocket* s, ObjectStore*) {
   QStringList args = ScriptInterface::getArgs(command);
@@ -1163,4 +1205,51 @@ QByteArray ScriptServer::setDatasourceStringConfig(QByteArray& command, QLocalSo
 
 }
 
+/** one line per object: name|type|bytes, largest first.  The first line is
+    total|limit|bytes used, with a limit of 0 meaning none. */
+QByteArray ScriptServer::getMemoryUsage(QByteArray&, QLocalSocket* s, ObjectStore*) {
+  MemoryManager *mm = MemoryManager::self();
+  QByteArray a = "total|" + QByteArray::number(mm->ceiling()) + '|' + QByteArray::number(mm->used());
+
+  const QList<MemoryManager::Usage> usage = mm->usage();
+  foreach (const MemoryManager::Usage &u, usage) {
+    a += '\n' + u.name.toUtf8() + '|' + u.type.toUtf8() + '|' + QByteArray::number(u.bytes);
+  }
+  return handleResponse(a,s);
+}
+
+QByteArray ScriptServer::setMemoryLimit(QByteArray& command, QLocalSocket* s, ObjectStore*) {
+  ApplicationSettings::self()->setMemoryLimit(ScriptInterface::getArg(command).toInt());
+  return handleResponse("Done",s);
+}
+
+/** one line per kind and object: kind|name|count|total ns|max ns|samples|bytes,
+    most total time first. */
+QByteArray ScriptServer::getTimingSummary(QByteArray&, QLocalSocket* s, ObjectStore*) {
+  QByteArray a;
+  const QList<Tracer::Summary> summary = Tracer::self()->summary();
+  foreach (const Tracer::Summary &t, summary) {
+    if (!a.isEmpty()) {
+      a += '\n';
+    }
+    a += t.category + '|' + t.name.toUtf8() + '|' + QByteArray::number(t.count) + '|' +
+         QByteArray::number(t.total) + '|' + QByteArray::number(t.max) + '|' +
+         QByteArray::number(t.samples) + '|' + QByteArray::number(t.bytes);
+  }
+  return handleResponse(a,s);
+}
+
+QByteArray ScriptServer::saveTrace(QByteArray& command, QLocalSocket* s, ObjectStore*) {
+  QFile file(ScriptInterface::getArg(command));
+  if (!file.open(QIODevice::WriteOnly) || file.write(Tracer::self()->chromeTrace()) < 0) {
+    return handleResponse("Error: could not write " + file.fileName().toUtf8(),s);
+  }
+  return handleResponse("Done",s);
+}
+
+QByteArray ScriptServer::clearTrace(QByteArray&, QLocalSocket* s, ObjectStore*) {
+  Tracer::self()->clear();
+  return handleResponse("Done",s);
+}
+
 }
@@ -19,6 +19,7 @@
 
 #include "objectstore.h"
 #include "scriptinterface.h"
+#include <QHash>
 #include <QLocalServer>
 #include <QMap>
 
@@ -39,10 +40,11 @@ class ScriptServer : public QObject
     bool _curMacComEcho;
     QList<ViewItem*> vi;    // cache
     QMap<QByteArray,ScriptMemberFn> _fnMap;
+    QHash<QLocalSocket*,int> _bulk; // transactions each client has open
 public:
     explicit ScriptServer(ObjectStore*obj);
     ~ScriptServer();
-    void setStore(ObjectStore *obj) { _store = obj; vi.clear();}
+    void setStore(ObjectStore *obj) { _store = obj; vi.clear(); _bulk.clear();}
     QString serverName;
     bool serverNameSet;
     void setScriptServerName(QString server_name);
@@ -50,6 +52,7 @@ public:
 public slots:
     void procConnection();
     void readSomething();
+    void endBulkOf();
     QByteArray exec(QByteArray command,QLocalSocket* s);
 
 protected:
@@ -183,10 +186,20 @@ protected:
 
     QByteArray cleanupLayout(QByteArray& command, QLocalSocket* s,ObjectStore*_store);
 
+    QByteArray beginBulk(QByteArray& command, QLocalSocket* s,ObjectStore*_store);
+    QByteArray endBulk(QByteArray& command, QLocalSocket* s,ObjectStore*_store);
+
     QByteArray setDatasourceBoolConfig(QByteArray& command, QLocalSocket* s,ObjectStore*_store);
     QByteArray setDatasourceIntConfig(QByteArray& command, QLocalSocket* s,ObjectStore*_store);
     QByteArray setDatasourceStringConfig(QByteArray& command, QLocalSocket* s,ObjectStore*_store);
 
+    QByteArray getMemoryUsage(QByteArray& command, QLocalSocket* s,ObjectStore*_store);
+    QByteArray setMemoryLimit(QByteArray& command, QLocalSocket* s,ObjectStore*_store);
+
+    QByteArray getTimingSummary(QByteArray& command, QLocalSocket* s,ObjectStore*_store);
+    QByteArray saveTrace(QByteArray& command, QLocalSocket* s,ObjectStore*_store);
+    QByteArray clearTrace(QByteArray& command, QLocalSocket* s,ObjectStore*_store);
+
     QByteArray testCommand(QByteArray& command, QLocalSocket* s,ObjectStore*_store);
 
 };
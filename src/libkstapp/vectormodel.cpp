@@ -14,6 +14,7 @@
 #include "dialogdefaults.h"
 
 #include <assert.h>
+#include <limits>
 
 #include <QFont>
 #include <QMenu>
@@ -61,11 +62,12 @@ int VectorModel::columnCount(const QModelIndex&) const {
 
 
 int VectorModel::rowCount(const QModelIndex&) const {
-  int length = 0;
+  qint64 length = 0;
   for(int i=0;i<_vectorList.length();i++) {
       length = qMax(length, _vectorList.at(i)->length());
   }
-  return length;
+  // the view can't show more rows than an int holds
+  return int(qMin(length, qint64(std::numeric_limits<int>::max())));
 }
 
 
@@ -26,6 +26,7 @@
 #include "plotaxis.h"
 #include "dialogdefaults.h"
 #include "datacollection.h"
+#include "updatemanager.h"
 
 #include <math.h>
 
@@ -71,6 +72,8 @@ void View::init()
   _childMaximized = false;
   _undoStack = new QUndoStack(this);
   _referenceFontSizeToView = true;
+  touchRevision();
+  connect(_undoStack, SIGNAL(indexChanged(int)), this, SLOT(touchRevision()));
   setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
   setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
   setScene(new Scene(this));
@@ -105,6 +108,7 @@ void View::init()
   connect(_customLayoutAction, SIGNAL(triggered()), this, SLOT(createCustomLayout()));
 
   connect(this, SIGNAL(viewModeChanged(View::ViewMode)), PlotItemManager::self(), SLOT(clearFocusedPlots()));
+  connect(UpdateManager::self(), SIGNAL(transactionEnded()), this, SLOT(appendHeldItems()));
 
   applyDialogDefaultsFill();
 }
@@ -371,14 +375,43 @@ void View::createLayout(bool preserve, int columns) {
 
 
 void View::appendToLayout(CurvePlacement::Layout layout, ViewItem* item, int columns) {
+  appendToLayout(layout, QList<ViewItem*>() << item, columns);
+}
+
+
+// In a transaction, items appended to the automatic layout are put where a
+// protected layout would put them, and laid out together when it ends: each
+// would otherwise lay out the whole view again.
+void View::appendToLayout(CurvePlacement::Layout layout, const QList<ViewItem*> &items, int columns) {
+  const bool hold = layout == CurvePlacement::Auto && UpdateManager::self()->inTransaction();
+
   AppendLayoutCommand *appendlayout = new AppendLayoutCommand(new LayoutBoxItem(this));
-  appendlayout->appendLayout(layout, item, columns);
+  appendlayout->appendLayout(hold ? CurvePlacement::Protect : layout, items, columns);
   if (_layoutBoxItem) {
     LayoutBoxItem *layoutBox = _layoutBoxItem;
     _layoutBoxItem->setEnabled(false);
     delete layoutBox;
   }
 
+  if (hold) {
+    foreach (ViewItem *item, items) {
+      _heldAppends.append(item);
+    }
+  }
+}
+
+
+void View::appendHeldItems() {
+  QList<ViewItem*> items;
+  foreach (const QPointer<ViewItem> &item, _heldAppends) {
+    if (item && item->view() == this) {
+      items.append(item);
+    }
+  }
+  _heldAppends.clear();
+  if (!items.isEmpty()) {
+    appendToLayout(CurvePlacement::Auto, items);
+  }
 }
 
 void View::processResize(QSize size) {
@@ -405,6 +438,22 @@ void View::processResize(QSize size) {
   }
 }
 
+void View::renderAtSize(QPainter *painter, const QSize &size) {
+  const QSize currentSize(this->size());
+  const bool updates = updatesEnabled();
+  setUpdatesEnabled(false);
+
+  resize(size);
+  processResize(size);
+  setPrinting(true);
+  render(painter);
+  setPrinting(false);
+  resize(currentSize);
+  processResize(currentSize);
+
+  setUpdatesEnabled(updates);
+}
+
 void View::resizeEvent(QResizeEvent *event) {
   if (event) {
     QGraphicsView::resizeEvent(event);
@@ -493,7 +542,15 @@ void View::drawBackground(QPainter *painter, const QRectF &rect) {
 }
 
 
+void View::touchRevision() {
+  static quint64 lastRevision = 0;
+  _revision = ++lastRevision;
+}
+
+
 void View::updateSettings() {
+  touchRevision();
+
   setShowGrid(ApplicationSettings::self()->showGrid());
 
   setSnapToGrid(ApplicationSettings::self()->snapToGrid());
@@ -14,6 +14,7 @@
 #define VIEW_H
 
 #include <QGraphicsView>
+#include <QPointer>
 
 #include "kstcore_export.h"
 
@@ -124,6 +125,11 @@ class View : public QGraphicsView
 
     QList<ViewItem*> layoutableViewItems();
 
+    /** Changes whenever what the view shows may have: the data of its plots
+        or labels, an undoable edit, or the settings.  Revisions are not
+        reused across views. */
+    quint64 revision() const { return _revision; }
+
     virtual int nRows() {return 1.0;}
     virtual int nCols() {return 1.0;}
 
@@ -137,11 +143,17 @@ class View : public QGraphicsView
     void createLayout(bool preserve = true, int columns = 0);
     void createUnprotectedLayout(bool preserve = true, int columns = 0) {createLayout(false);}
     void appendToLayout(CurvePlacement::Layout layout, ViewItem* item, int columns = 0);
+    void appendToLayout(CurvePlacement::Layout layout, const QList<ViewItem*> &items, int columns = 0);
     void createCustomLayout();
     void viewChanged();
     void forceChildResize(QRectF oldRect, QRectF newRect);
     void processResize(QSize size);
+
+    /** Lays the view out at size, draws it as printed, and lays it out as
+        it was again.  The widget isn't repainted in between, shown or not. */
+    void renderAtSize(QPainter *painter, const QSize &size);
     void setZoomOnly(ZoomOnlyMode);
+    void touchRevision();
 
 
 
@@ -161,6 +173,7 @@ class View : public QGraphicsView
     void updateSettings();
     void loadSettings();
     virtual void edit();
+    void appendHeldItems();
 
   private:
     void updateChildGeometry(const QRectF &oldSceneRect);
@@ -170,6 +183,7 @@ class View : public QGraphicsView
     ViewMode _viewMode;
     MouseMode _mouseMode;
     LayoutBoxItem *_layoutBoxItem;
+    QList<QPointer<ViewItem> > _heldAppends; // automatic appends in a transaction
     QPolygonF _creationPolygonPress;
     QPolygonF _creationPolygonMove;
     QPolygonF _creationPolygonRelease;
@@ -183,6 +197,7 @@ class View : public QGraphicsView
     qreal _fontRescale;
     bool _childMaximized;
     bool _referenceFontSizeToView;
+    quint64 _revision;
 };
 
 }
@@ -2634,9 +2634,17 @@ void AppendLayoutCommand::redo() {
 
 
 void AppendLayoutCommand::appendLayout(CurvePlacement::Layout layout, ViewItem* item, int columns) {
+  Q_ASSERT(item);
+  appendLayout(layout, QList<ViewItem*>() << item, columns);
+}
+
+
+// The items are placed one after the other, each as it would be appended
+// on its own, but the layout is applied once.  They may already be in the
+// scene, held back for this (see View::appendToLayout()).
+void AppendLayoutCommand::appendLayout(CurvePlacement::Layout layout, const QList<ViewItem*> &items, int columns) {
   Q_ASSERT(_item);
   Q_ASSERT(_item->view());
-  Q_ASSERT(item);
 
   if (layout == CurvePlacement::Auto) {
     columns = 0;
@@ -2649,16 +2657,24 @@ void AppendLayoutCommand::appendLayout(CurvePlacement::Layout layout, ViewItem*
     QPointF center = _item->view()->sceneRect().center();
     center -= QPointF(100.0, 100.0);
 
-    item->setPos(center);
-    item->setViewRect(0.0, 0.0, 200.0, 200.0);
-    _item->view()->scene()->addItem(item);
+    foreach (ViewItem *item, items) {
+      item->setPos(center);
+      item->setViewRect(0.0, 0.0, 200.0, 200.0);
+      if (item->scene() != _item->view()->scene()) {
+        _item->view()->scene()->addItem(item);
+      }
+    }
     //_item->view()->undoStack()->push(this);
     return;
   }
 
 
   QList<ViewItem*> viewItems;
-  viewItems = _item->view()->layoutableViewItems();
+  foreach (ViewItem *v, _item->view()->layoutableViewItems()) {
+    if (!items.contains(v)) {
+      viewItems.append(v);
+    }
+  }
 
   _layout = new ViewGridLayout(_item);
 
@@ -2670,43 +2686,56 @@ void AppendLayoutCommand::appendLayout(CurvePlacement::Layout layout, ViewItem*
     }
   }
 
+  int n_views = viewItems.size();
   if (columns == 0) {
-    int row = -1;
-    int col = -1;
-    for (int i_col = 0; i_col<grid.n_cols; i_col++) {
-      for (int i_row = 0; i_row<grid.n_rows; i_row++) {
-        if (grid.a[i_row][i_col]==0) {
-          row = i_row;
-          col = i_col;
-          break;
-        }
-        if (row>=0) {
-          break;
-        }
-      }
-    }
-    if (row<0) { // no empty slots
-      if (grid.n_rows>grid.n_cols) { // add a column
-        row = 0;
-        col = grid.n_cols;
-      } else { // add a row
-        row = grid.n_rows;
-        col = 0;
-      }
-    }
-
-    int n_views = viewItems.size();
     for (int i_view = 0; i_view<n_views; i_view++) {
       ViewItem *v = viewItems.at(i_view);
       struct AutoFormatRC rc = grid.rcList.at(i_view);
       _layout->addViewItem(v, rc.row, rc.col, rc.row_span, rc.col_span);
     }
-    _item->view()->scene()->addItem(item);
-    _layout->addViewItem(item, row, col, 1,1);
+
+    foreach (ViewItem *item, items) {
+      int row = -1;
+      int col = -1;
+      for (int i_col = 0; i_col<grid.n_cols; i_col++) {
+        for (int i_row = 0; i_row<grid.n_rows; i_row++) {
+          if (grid.a[i_row][i_col]==0) {
+            row = i_row;
+            col = i_col;
+            break;
+          }
+          if (row>=0) {
+            break;
+          }
+        }
+      }
+      if (row<0) { // no empty slots
+        if (grid.n_rows>grid.n_cols) { // add a column
+          row = 0;
+          col = grid.n_cols;
+          grid.n_cols++;
+          for (int i_row = 0; i_row<grid.n_rows; i_row++) {
+            grid.a[i_row].resize(grid.n_cols);
+          }
+        } else { // add a row
+          row = grid.n_rows;
+          col = 0;
+          grid.n_rows++;
+          grid.n_cols = qMax(grid.n_cols, 1);
+          grid.a.resize(grid.n_rows);
+          grid.a[row].fill(0, grid.n_cols);
+        }
+      }
+      grid.a[row][col]++; // the next item goes elsewhere
+
+      if (item->scene() != _item->view()->scene()) {
+        _item->view()->scene()->addItem(item);
+      }
+      _layout->addViewItem(item, row, col, 1,1);
+    }
   } else {
     int row = 0;
     int col = 0;
-    int n_views = viewItems.size();
 
     for (int i_view = 0; i_view<n_views; i_view++) {
       ViewItem *v = viewItems.at(i_view);
@@ -2717,8 +2746,17 @@ void AppendLayoutCommand::appendLayout(CurvePlacement::Layout layout, ViewItem*
         row++;
       }
     }
-    _item->view()->scene()->addItem(item);
-    _layout->addViewItem(item, row, col, 1,1);
+    foreach (ViewItem *item, items) {
+      if (item->scene() != _item->view()->scene()) {
+        _item->view()->scene()->addItem(item);
+      }
+      _layout->addViewItem(item, row, col, 1,1);
+      col++;
+      if (col>=columns) {
+        col = 0;
+        row++;
+      }
+    }
     _layout->setColumnCount(columns);
   }
 
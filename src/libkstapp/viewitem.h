@@ -487,6 +487,7 @@ class AppendLayoutCommand : public ViewItemCommand
     virtual void undo();
     virtual void redo();
     void appendLayout(CurvePlacement::Layout layout, ViewItem* item, int columns = 0);
+    void appendLayout(CurvePlacement::Layout layout, const QList<ViewItem*> &items, int columns = 0);
 
   private:
     QPointer<ViewGridLayout> _layout;
@@ -145,7 +145,7 @@ void Curve::internalUpdate() {
 }
 
 
-void Curve::point(int i, double &x, double &y) const {
+void Curve::point(qint64 i, double &x, double &y) const {
   VectorPtr xv = xVector();
   if (xv) {
     x = xv->interpolate(i, NS);
@@ -157,7 +157,7 @@ void Curve::point(int i, double &x, double &y) const {
 }
 
 
-void Curve::getEXPoint(int i, double &x, double &y, double &ex) {
+void Curve::getEXPoint(qint64 i, double &x, double &y, double &ex) {
   VectorPtr xv = xVector();
   if (xv) {
     x = xv->interpolate(i, NS);
@@ -173,7 +173,7 @@ void Curve::getEXPoint(int i, double &x, double &y, double &ex) {
 }
 
 
-void Curve::getEXMinusPoint(int i, double &x, double &y, double &ex) {
+void Curve::getEXMinusPoint(qint64 i, double &x, double &y, double &ex) {
   VectorPtr xv = xVector();
   if (xv) {
     x = xv->interpolate(i, NS);
@@ -189,7 +189,7 @@ void Curve::getEXMinusPoint(int i, double &x, double &y, double &ex) {
 }
 
 
-void Curve::getEXPoints(int i, double &x, double &y, double &exminus, double &explus) {
+void Curve::getEXPoints(qint64 i, double &x, double &y, double &exminus, double &explus) {
   VectorPtr xv = xVector();
   if (xv) {
     x = xv->interpolate(i, NS);
@@ -209,7 +209,7 @@ void Curve::getEXPoints(int i, double &x, double &y, double &exminus, double &ex
 }
 
 
-void Curve::getEYPoint(int i, double &x, double &y, double &ey) {
+void Curve::getEYPoint(qint64 i, double &x, double &y, double &ey) {
   VectorPtr xv = xVector();
   if (xv) {
     x = xv->interpolate(i, NS);
@@ -225,7 +225,7 @@ void Curve::getEYPoint(int i, double &x, double &y, double &ey) {
 }
 
 
-void Curve::getEYMinusPoint(int i, double &x, double &y, double &ey) {
+void Curve::getEYMinusPoint(qint64 i, double &x, double &y, double &ey) {
   VectorPtr xv = xVector();
   if (xv) {
     x = xv->interpolate(i, NS);
@@ -241,7 +241,7 @@ void Curve::getEYMinusPoint(int i, double &x, double &y, double &ey) {
 }
 
 
-void Curve::getEYPoints(int i, double &x, double &y, double &eyminus, double &eyplus) {
+void Curve::getEYPoints(qint64 i, double &x, double &y, double &eyminus, double &eyplus) {
   VectorPtr xv = xVector();
   if (xv) {
     x = xv->interpolate(i, NS);
@@ -458,17 +458,17 @@ bool Curve::xIsRising() const {
 }
 
 
-inline int indexNearX(double x, VectorPtr& xv, int NS) {
+inline qint64 indexNearX(double x, VectorPtr& xv, qint64 NS) {
   // monotonically rising: we can do a binary search
   // should be reasonably fast
   if (xv->isRising()) {
-    int i_top = NS - 1;
-    int i_bot = 0;
+    qint64 i_top = NS - 1;
+    qint64 i_bot = 0;
 
     // don't pre-check for x outside of the curve since this is not
     // the common case.  It will be correct - just slightly slower...
     while (i_bot + 1 < i_top) {
-      int i0 = (i_top + i_bot)/2;
+      qint64 i0 = (i_top + i_bot)/2;
       double rX = xv->interpolate(i0, NS);
       if (x < rX) {
         i_top = i0;
@@ -488,9 +488,9 @@ inline int indexNearX(double x, VectorPtr& xv, int NS) {
     // May be unbearably slow for large vectors
     double rX = xv->interpolate(0, NS);
     double dx0 = fabs(x - rX);
-    int i0 = 0;
+    qint64 i0 = 0;
 
-    for (int i = 1; i < NS; ++i) {
+    for (qint64 i = 1; i < NS; ++i) {
       rX = xv->interpolate(i, NS);
       double dx = fabs(x - rX);
       if (dx < dx0) {
@@ -505,7 +505,7 @@ inline int indexNearX(double x, VectorPtr& xv, int NS) {
 
 /** getIndexNearXY: return index of point within (or closest too)
     x +- dx which is closest to y **/
-int Curve::getIndexNearXY(double x, double dx_per_pix, double y) const {
+qint64 Curve::getIndexNearXY(double x, double dx_per_pix, double y) const {
   VectorPtr xv = *_inputVectors.find(XVECTOR);
   VectorPtr yv = *_inputVectors.find(YVECTOR);
   if (!xv || !yv) {
@@ -514,8 +514,8 @@ int Curve::getIndexNearXY(double x, double dx_per_pix, double y) const {
 
   double xi, yi, dx, dxi, dy, dyi;
   bool first = true;
-  int i,i0, iN, index;
-  int sc = sampleCount();
+  qint64 i,i0, iN, index;
+  qint64 sc = sampleCount();
 
   if (xv->isRising()) {
     iN = i0 = indexNearX(x, xv, NS);
@@ -793,7 +793,7 @@ void Curve::updatePaintObjects(const CurveRenderContext& context) {
   double X2 = 0.0, Y2 = 0.0;
   double last_x1, last_y1;
   bool overlap = false;
-  int i_pt;
+  qint64 i_pt;
 
 #ifdef BENCHMARK
   QTime bench_time, benchtmp;
@@ -812,7 +812,7 @@ void Curve::updatePaintObjects(const CurveRenderContext& context) {
 
   double errorFlagDim = pointDim(context.painter->window());
   if (sampleCount() > 0) {
-    int i0, iN;
+    qint64 i0, iN;
 
     if (xv->isRising()) {
       i0 = indexNearX(XMin, xv, NS);
@@ -838,7 +838,7 @@ void Curve::updatePaintObjects(const CurveRenderContext& context) {
       double lastPlottedX = 0;
       double lastPlottedY = 0;
       int index = 0;
-      int i0Start = i0;
+      qint64 i0Start = i0;
 
 // optimize - isnan seems expensive, at least in gcc debug mode
 //            cachegrind backs this up.
@@ -1528,7 +1528,7 @@ void Curve::yRange(double xFrom, double xTo, double* yMin, double* yMax) {
   }
 
   // get range of the curve to search for min/max
-  int i0, iN;
+  qint64 i0, iN;
   if (xv->isRising()) {
     i0 = indexNearX(xFrom, xv, NS);
     iN = indexNearX(xTo, xv, NS);
@@ -1539,7 +1539,7 @@ void Curve::yRange(double xFrom, double xTo, double* yMin, double* yMax) {
   // search for min/max
   bool first = true;
   double newYMax = 0, newYMin = 0;
-  for (int i_pt = i0; i_pt <= iN; ++i_pt) {
+  for (qint64 i_pt = i0; i_pt <= iN; ++i_pt) {
     double rX = xv->interpolate(i_pt, NS);
     double rY = yv->interpolate(i_pt, NS);
     // make sure this point is visible
@@ -1568,7 +1568,7 @@ double Curve::distanceToPoint(double xpos, double dx, double ypos) const {
 
   double distance = 1.0E300;
 
-  int i_near_x = getIndexNearXY(xpos, dx, ypos);
+  qint64 i_near_x = getIndexNearXY(xpos, dx, ypos);
   double near_x, near_y;
   point(i_near_x, near_x, near_y);
 
@@ -1581,11 +1581,11 @@ double Curve::distanceToPoint(double xpos, double dx, double ypos) const {
     //  the point. if isRising because it is (probably) to slow to use this technique if the data is 
     //  unordered. borrowed from indexNearX. use binary search to find the indices immediately above 
     //  and below our xpos.
-    int i_top = NS - 1;
-    int i_bot = 0;
+    qint64 i_top = NS - 1;
+    qint64 i_bot = 0;
 
     while (i_bot + 1 < i_top) {
-      int i0 = (i_top + i_bot)/2;
+      qint64 i0 = (i_top + i_bot)/2;
 
       double rX = xv->interpolate(i0, NS);
       if (xpos < rX) {
@@ -46,7 +46,7 @@ class KSTMATH_EXPORT Curve: public Relation
     virtual void internalUpdate();
     virtual QString propertyString() const;
 
-    virtual int getIndexNearXY(double x, double dx, double y) const;
+    virtual qint64 getIndexNearXY(double x, double dx, double y) const;
 
     virtual bool hasXError() const;
     virtual bool hasYError() const;
@@ -54,13 +54,13 @@ class KSTMATH_EXPORT Curve: public Relation
     virtual bool hasYMinusError() const;
 
     // Note: these are -expensive-.  Don't use them on inner loops!
-    virtual void point(int i, double &x1, double &y1) const;
-    virtual void getEXPoint(int i, double &x1, double &y1, double &ex1);
-    virtual void getEYPoint(int i, double &x1, double &y1, double &ey1);
-    virtual void getEXMinusPoint(int i, double &x1, double &y1, double &ex1);
-    virtual void getEYMinusPoint(int i, double &x1, double &y1, double &ey1);
-    virtual void getEXPoints(int i, double &x, double &y, double &ex, double &exminus);
-    virtual void getEYPoints(int i, double &x, double &y, double &ey, double &eyminus);
+    virtual void point(qint64 i, double &x1, double &y1) const;
+    virtual void getEXPoint(qint64 i, double &x1, double &y1, double &ex1);
+    virtual void getEYPoint(qint64 i, double &x1, double &y1, double &ey1);
+    virtual void getEXMinusPoint(qint64 i, double &x1, double &y1, double &ex1);
+    virtual void getEYMinusPoint(qint64 i, double &x1, double &y1, double &ey1);
+    virtual void getEXPoints(qint64 i, double &x, double &y, double &ex, double &exminus);
+    virtual void getEYPoints(qint64 i, double &x, double &y, double &ey, double &eyminus);
 
     void setXVector(VectorPtr new_vx);
     void setYVector(VectorPtr new_vy);
@@ -24,6 +24,7 @@
 #include "objectstore.h"
 #include "relation.h"
 #include "sharedptr.h"
+#include "pluginregistry.h"
 #include "primitive.h"
 #include "settings.h"
 
@@ -72,7 +73,50 @@ DataObject::~DataObject() {
 }
 
 
-static DataObjectPluginList _pluginList;
+// What the plugin menus need to know of a data object plugin, kept in the
+// plugin cache: the plugin itself is only loaded to make an object or a
+// dialog.
+static bool describePlugin(QObject *object, QVariantMap *info) {
+  DataObjectPluginInterface *plugin = qobject_cast<DataObjectPluginInterface*>(object);
+  if (!plugin) {
+    return false;
+  }
+  info->insert("name", plugin->pluginName());
+  info->insert("description", plugin->pluginDescription());
+  info->insert("type", int(plugin->pluginType()));
+  info->insert("configWidget", plugin->hasConfigWidget());
+  return true;
+}
+
+
+struct FoundDataObjectPlugin {
+  FoundDataObjectPlugin(const QString& path, const QVariantMap& info) :
+    filePath(path),
+    name(info.value("name").toString()),
+    description(info.value("description").toString()),
+    type(info.value("type").toInt()),
+    configWidget(info.value("configWidget").toBool()),
+    failed(false) {}
+
+  DataObjectPluginInterface *instance() {
+    if (!plugin && !failed) {
+      plugin = qobject_cast<DataObjectPluginInterface*>(PluginRegistry::load(filePath));
+      failed = !plugin;
+    }
+    return plugin.data();
+  }
+
+  SharedPtr<DataObjectPluginInterface> plugin;
+  QString filePath;
+  QString name;
+  QString description;
+  int type;
+  bool configWidget;
+  bool failed;
+};
+
+typedef QList<FoundDataObjectPlugin> FoundDataObjectPluginList;
+static FoundDataObjectPluginList _pluginList;
 void DataObject::cleanupForExit() {
   _pluginList.clear(); //FIXME?
 }
@@ -265,34 +309,24 @@ void DataObject::scanPlugins() {
 
   _pluginList.clear(); //FIXME?
 
-  DataObjectPluginList tmpList;
+  FoundDataObjectPluginList tmpList;
 
   Debug::self()->log(tr("Scanning for data-object plugins."));
 
   foreach (QObject *plugin, QPluginLoader::staticInstances()) {
     //try a cast
-    if (DataObjectPluginInterface *basicPlugin = qobject_cast<DataObjectPluginInterface*>(plugin)) {
-      tmpList.append(basicPlugin);
-    }
-  }
-
-  QStringList pluginPaths = pluginSearchPaths();
-  foreach (const QString &pluginPath, pluginPaths) {
-    QDir d(pluginPath);
-    foreach (const QString &fileName, d.entryList(QDir::Files)) {
-        QPluginLoader loader(d.absoluteFilePath(fileName));
-        QObject *plugin = loader.instance();
-        if (plugin) {
-          if (DataObjectPluginInterface *dataObjectPlugin = qobject_cast<DataObjectPluginInterface*>(plugin)) {
-            tmpList.append(dataObjectPlugin);
-            Debug::self()->log(QString("Plugin loaded: %1").arg(fileName));
-          }
-        } else {
-          Debug::self()->log(QString("Plugin failed to load: %1").arg(fileName));
-        }
+    QVariantMap info;
+    if (describePlugin(plugin, &info)) {
+      FoundDataObjectPlugin found(QString(), info);
+      found.plugin = qobject_cast<DataObjectPluginInterface*>(plugin);
+      tmpList.append(found);
     }
   }
 
+  foreach (const PluginRegistry::Entry& entry, PluginRegistry::scan("dataobject", DataObjectPluginInterface_iid, QString(), describePlugin)) {
+    tmpList.append(FoundDataObjectPlugin(entry.path, entry.info));
+  }
+
   // This cleans up plugins that have been uninstalled and adds in new ones.
   // Since it is a shared pointer it can't dangle anywhere.
   _pluginList.clear();
@@ -313,8 +347,8 @@ QStringList DataObject::pluginList() {
 
   QStringList plugins;
 
-  for (DataObjectPluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
-    plugins += (*it)->pluginName();
+  for (FoundDataObjectPluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
+    plugins += (*it).name;
   }
 
   return plugins;
@@ -327,9 +361,9 @@ QStringList DataObject::dataObjectPluginList() {
 
   QStringList plugins;
 
-  for (DataObjectPluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
-    if ((*it)->pluginType() == DataObjectPluginInterface::Generic) {
-      plugins += (*it)->pluginName();
+  for (FoundDataObjectPluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
+    if ((*it).type == DataObjectPluginInterface::Generic) {
+      plugins += (*it).name;
     }
   }
 
@@ -344,9 +378,9 @@ QStringList DataObject::filterPluginList() {
 
   QStringList plugins;
 
-  for (DataObjectPluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
-    if ((*it)->pluginType() == DataObjectPluginInterface::Filter) {
-      plugins += (*it)->pluginName();
+  for (FoundDataObjectPluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
+    if ((*it).type == DataObjectPluginInterface::Filter) {
+      plugins += (*it).name;
     }
   }
 
@@ -361,9 +395,9 @@ QStringList DataObject::fitsPluginList() {
 
   QStringList plugins;
 
-  for (DataObjectPluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
-    if ((*it)->pluginType() == DataObjectPluginInterface::Fit) {
-      plugins += (*it)->pluginName();
+  for (FoundDataObjectPluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
+    if ((*it).type == DataObjectPluginInterface::Fit) {
+      plugins += (*it).name;
     }
   }
 
@@ -376,11 +410,12 @@ DataObjectConfigWidget* DataObject::pluginWidget(const QString& name) {
   // Ensure state.  When using kstapp MainWindow calls init.
   init();
 
-  for (DataObjectPluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
-    if ((*it)->pluginName() == name) {
-      if ((*it)->hasConfigWidget()) {
-
-        return (*it)->configWidget(&settingsObject());
+  for (FoundDataObjectPluginList::Iterator it = _pluginList.begin(); it != _pluginList.end(); ++it) {
+    if ((*it).name == name) {
+      if ((*it).configWidget) {
+        if (DataObjectPluginInterface *plugin = (*it).instance()) {
+          return plugin->configWidget(&settingsObject());
+        }
       }
       break;
     }
@@ -393,9 +428,9 @@ QString DataObject::pluginDescription(const QString& name) {
   // Ensure state.  When using kstapp MainWindow calls init.
   init();
 
-  for (DataObjectPluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
-    if ((*it)->pluginName() == name) {
-      return (*it)->pluginDescription();
+  for (FoundDataObjectPluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
+    if ((*it).name == name) {
+      return (*it).description;
     }
   }
   return QString();
@@ -406,9 +441,9 @@ int DataObject::pluginType(const QString& name) {
   // Ensure state.  When using kstapp MainWindow calls init.
   init();
 
-  for (DataObjectPluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
-    if ((*it)->pluginName() == name) {
-      return (*it)->pluginType();
+  for (FoundDataObjectPluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
+    if ((*it).name == name) {
+      return (*it).type;
     }
   }
   return -1;
@@ -419,9 +454,13 @@ DataObjectPtr DataObject::createPlugin(const QString& name, ObjectStore *store,
   // Ensure state.  When using kstapp MainWindow calls init.
   init();
 
-  for (DataObjectPluginList::ConstIterator it = _pluginList.constBegin(); it != _pluginList.constEnd(); ++it) {
-    if ((*it)->pluginName() == name) {
-      if (DataObjectPtr object = (*it)->create(store, configWidget, setupInputsOutputs)) {
+  for (FoundDataObjectPluginList::Iterator it = _pluginList.begin(); it != _pluginList.end(); ++it) {
+    if ((*it).name == name) {
+      DataObjectPluginInterface *plugin = (*it).instance();
+      if (!plugin) {
+        continue;
+      }
+      if (DataObjectPtr object = plugin->create(store, configWidget, setupInputsOutputs)) {
         return object;
       }
     }
@@ -772,6 +811,15 @@ void DataObject::deleteDependents() {
 }
 
 
+QList<ObjectPtr> DataObject::inputObjects() const {
+  QList<ObjectPtr> inputs;
+  foreach (PrimitivePtr P, inputPrimitives()) {
+    inputs.append(P);
+  }
+  return inputs;
+}
+
+
 bool DataObject::uses(ObjectPtr p) const {
   PrimitiveList this_input_primitives;
   PrimitiveList p_output_primitives;
@@ -72,7 +72,7 @@ class KSTMATH_EXPORT DataObject : public Object
     virtual QString propertyString() const = 0;
     virtual const QString& type() const { return _type; }
 
-    virtual int sampleCount() const { return 0; }
+    virtual qint64 sampleCount() const { return 0; }
 
     // If you use these, you must lock() and unlock() the object as long as you
     // hold the reference
@@ -127,6 +127,7 @@ class KSTMATH_EXPORT DataObject : public Object
     virtual void replaceInput(PrimitivePtr p, PrimitivePtr new_p);
 
     virtual bool uses(ObjectPtr p) const;
+    virtual QList<ObjectPtr> inputObjects() const;
 
     //These are generally only valid for plugins...
     const QString& name() const { return _name; }
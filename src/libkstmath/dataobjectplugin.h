@@ -60,8 +60,8 @@ typedef ObjectList<DataObjectPluginInterface> DataObjectPluginList;
 
 }
 
-#define DataObjectPluginInterface_iid "com.kst.DataObjectPluginInterface/2.0"
-#define BasicPluginInterface_iid "com.kst.BasicPluginInterface/2.0"
+#define DataObjectPluginInterface_iid "com.kst.DataObjectPluginInterface/2.1"
+#define BasicPluginInterface_iid "com.kst.BasicPluginInterface/2.1"
 
 Q_DECLARE_INTERFACE(Kst::DataObjectPluginInterface, DataObjectPluginInterface_iid)
 Q_DECLARE_INTERFACE(Kst::BasicPluginInterface, BasicPluginInterface_iid)
@@ -130,6 +130,12 @@ Kst::Object::UpdateType Node::update(Context *ctx) {
 }
 
 
+// only those that know they are
+bool Node::isPointwise() {
+  return false;
+}
+
+
 /////////////////////////////////////////////////////////////////
 BinaryNode::BinaryNode(Node *left, Node *right)
 : Node(), _left(left), _right(right) {
@@ -182,6 +188,11 @@ Kst::Object::UpdateType BinaryNode::update(Context *ctx) {
 }
 
 
+bool BinaryNode::isPointwise() {
+  return _left->isPointwise() && _right->isPointwise();
+}
+
+
 /////////////////////////////////////////////////////////////////
 Addition::Addition(Node *left, Node *right)
 : BinaryNode(left, right) {
@@ -531,6 +542,12 @@ Kst::Object::UpdateType Function::update(Context *ctx) {
 }
 
 
+// the functions of FTable and F2Table each take the one sample
+bool Function::isPointwise() {
+  return _args->isPointwise();
+}
+
+
 double Function::value(Context *ctx) {
   if (!_f) {
     return ctx->noPoint;
@@ -641,6 +658,16 @@ Kst::Object::UpdateType ArgumentList::update(Context *ctx) {
 }
 
 
+bool ArgumentList::isPointwise() {
+  foreach (Node *i, _args) {
+    if (!i->isPointwise()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
 QString ArgumentList::text() const {
   QString rc;
   bool first = true;
@@ -706,6 +733,11 @@ bool Identifier::isConst() {
 }
 
 
+bool Identifier::isPointwise() {
+  return true;
+}
+
+
 QString Identifier::text() const {
   return _name;
 }
@@ -818,6 +850,16 @@ bool DataNode::isConst() {
 }
 
 
+// An index into a vector can reach any sample of it; an embedded equation
+// isn't known until it has been evaluated once.
+bool DataNode::isPointwise() {
+  if (_isEquation) {
+    return _equation && _equation->isPointwise();
+  }
+  return !_vector || _vectorIndex.isEmpty();
+}
+
+
 bool DataNode::collectObjects(Kst::VectorMap& v, Kst::ScalarMap& s, Kst::StringMap& t) {
   if (_isEquation) {
     if (_equation) {
@@ -908,6 +950,11 @@ bool Number::isConst() {
 }
 
 
+bool Number::isPointwise() {
+  return true;
+}
+
+
 QString Number::text() const {
   if (_parentheses) {
     return QString('(') + QString::number(_n, 'g', 15) + ')';
@@ -947,6 +994,11 @@ bool Negation::isConst() {
 }
 
 
+bool Negation::isPointwise() {
+  return _n->isPointwise();
+}
+
+
 QString Negation::text() const {
   if (_parentheses) {
     return QString("(-") + _n->text() + ')';
@@ -980,6 +1032,11 @@ bool LogicalNot::isConst() {
 }
 
 
+bool LogicalNot::isPointwise() {
+  return _n->isPointwise();
+}
+
+
 QString LogicalNot::text() const {
   if (_parentheses) {
     return QString("(!") + _n->text() + ')';
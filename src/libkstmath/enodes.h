@@ -42,11 +42,11 @@ namespace Equations {
       Context() : i(0), x(0.0), xVector(0L), noPoint(0.0), sampleCount(0) {}
       ~Context() {}
 
-      long i;
+      qint64 i;
       double x;
       Kst::VectorPtr xVector;
       double noPoint;
-      long sampleCount;
+      qint64 sampleCount;
   };
 
   class NodeVisitor;
@@ -64,6 +64,11 @@ namespace Equations {
       virtual Kst::Object::UpdateType update(Context *ctx);
       virtual QString text() const = 0;
 
+      /* Whether sample i of the value depends only on sample i of the
+         vectors, and on x, scalars and constants: then appending samples
+         to the inputs leaves the values before them as they were. */
+      virtual bool isPointwise();
+
       void parenthesize() { _parentheses = true; }
 
     protected:
@@ -79,6 +84,7 @@ namespace Equations {
       virtual bool takeVectors(const Kst::VectorMap& c);
       virtual void visit(NodeVisitor*);
       virtual Kst::Object::UpdateType update(Context *ctx);
+      virtual bool isPointwise();
 
       Node *& left();
       Node *& right();
@@ -104,6 +110,7 @@ namespace Equations {
       bool isConst();
       bool collectObjects(Kst::VectorMap& v, Kst::ScalarMap& s, Kst::StringMap& t);
       bool takeVectors(const Kst::VectorMap& c);
+      bool isPointwise();
       double at(int, Context*);
       Node *node(int idx);
       Kst::Object::UpdateType update(Context *ctx);
@@ -124,6 +131,7 @@ namespace Equations {
       bool collectObjects(Kst::VectorMap& v, Kst::ScalarMap& s, Kst::StringMap& t);
       bool takeVectors(const Kst::VectorMap& c);
       Kst::Object::UpdateType update(Context *ctx);
+      bool isPointwise();
       QString text() const;
 
     protected:
@@ -151,6 +159,7 @@ namespace Equations {
 
       bool isConst();
       double value(Context*);
+      bool isPointwise();
       QString text() const;
 
     protected:
@@ -166,6 +175,7 @@ namespace Equations {
 
       bool isConst();
       double value(Context*);
+      bool isPointwise();
       const char *name() const;
       QString text() const;
 
@@ -186,6 +196,7 @@ namespace Equations {
       bool collectObjects(Kst::VectorMap& v, Kst::ScalarMap& s, Kst::StringMap& t);
       bool takeVectors(const Kst::VectorMap& c);
       Kst::Object::UpdateType update(Context *ctx);
+      bool isPointwise();
       QString text() const;
 
     protected:
@@ -227,6 +238,7 @@ namespace Equations {
       ~Negation();
       bool isConst();
       double value(Context*);
+      bool isPointwise();
       QString text() const;
       bool collectObjects(Kst::VectorMap& v, Kst::ScalarMap& s, Kst::StringMap& t);
 
@@ -240,6 +252,7 @@ namespace Equations {
       ~LogicalNot();
       bool isConst();
       double value(Context*);
+      bool isPointwise();
       QString text() const;
 
     protected:
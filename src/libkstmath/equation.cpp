@@ -58,6 +58,7 @@ Equation::Equation(ObjectStore *store)
 : DataObject(store), _doInterp(false), _xInVector(0) {
 
   _ns = 2;
+  _evaluated = 0;
   _pe = 0L;
   _typeString = "Equation";
   _type = "Equation";
@@ -235,6 +236,7 @@ void Equation::setEquation(const QString& in_fn) {
   ScalarsUsed.clear();
 
   _ns = 2; // reset the updating
+  _evaluated = 0;
   delete _pe;
   _pe = 0L;
   if (!_equation.isEmpty()) {
@@ -321,6 +323,7 @@ void Equation::setExistingXVector(VectorPtr in_xv, bool do_interp) {
   _inputVectors.insert(XINVECTOR, in_xv);
 
   _ns = 2; // reset the updating
+  _evaluated = 0;
 }
 
 //FIXME: equations should not use ScalarsUsed and VectorsUsed:
@@ -389,9 +392,9 @@ bool Equation::FillY(bool force) {
     return false;
   }
 
-  int v_shift=0, v_new;
-  int i0=0;
-  int ns;
+  qint64 v_shift=0, v_new;
+  qint64 i0=0;
+  qint64 ns;
 
   writeLockInputsAndOutputs();
 
@@ -407,7 +410,18 @@ bool Equation::FillY(bool force) {
     ns = _xInVector->length();
   }
 
-  if (_ns != _xInVector->length() || ns != _xInVector->length() ||
+  const qint64 appended = appendedFrom(ns);
+  _evaluated = 0; // until the outputs are whole again
+  if (appended > 0) {
+    // samples appended to the inputs: the outputs before them stand
+    _ns = ns;
+    if (!_xOutVector->resize(_ns) || !_yOutVector->resize(_ns)) {
+      // FIXME: handle error?
+      unlockInputsAndOutputs();
+      return false;
+    }
+    i0 = appended;
+  } else if (_ns != _xInVector->length() || ns != _xInVector->length() ||
       _xInVector->numShift() != _xInVector->numNew()) {
     _ns = ns;
 
@@ -450,7 +464,7 @@ bool Equation::FillY(bool force) {
     } else {
       VectorPtr xv = _xOutVector;
       VectorPtr yv = _yOutVector;
-      for (int i = v_shift; i < _ns; i++) {
+      for (qint64 i = v_shift; i < _ns; i++) {
         yv->raw_V_ptr()[i - v_shift] = yv->value()[i];
         xv->raw_V_ptr()[i - v_shift] = xv->value()[i];
       }
@@ -517,11 +531,65 @@ bool Equation::FillY(bool force) {
     return false;
   }
 
+  // so that whatever reads the outputs can skip the samples it has seen
+  _xOutVector->setUnchanged(appended, _xOutVector->serialOfLastChange());
+  _yOutVector->setUnchanged(appended, _yOutVector->serialOfLastChange());
+  keepEvaluated();
+
   unlockInputsAndOutputs();
   return true;
 }
 
 
+// Where the outputs need evaluating from, if the inputs have only had
+// samples appended since they were last evaluated: the outputs before are
+// as they were.  0 if the expression uses more than the one sample of each
+// vector (an index into a vector, say), if a scalar it uses has changed, or
+// if the vectors are interpolated to a length not their own.
+qint64 Equation::appendedFrom(qint64 ns) const {
+  if (!_pe || _evaluated <= 0 || ns <= _evaluated || !_pe->isPointwise()) {
+    return 0;
+  }
+  if (!appendedTo(_xInVector, ns)) {
+    return 0;
+  }
+  foreach (const VectorPtr &v, VectorsUsed) {
+    if (!appendedTo(v, ns)) {
+      return 0;
+    }
+  }
+  foreach (const ScalarPtr &s, ScalarsUsed) {
+    if (s->serialOfLastChange() != _evaluatedChanges.value(s.data(), qint64(Forced))) {
+      return 0;
+    }
+  }
+  return _evaluated;
+}
+
+
+bool Equation::appendedTo(const VectorPtr &v, qint64 ns) const {
+  const qint64 serial = _evaluatedChanges.value(v.data(), qint64(Forced));
+  if (v->length() != ns || serial == Forced) {
+    return false;
+  }
+  return v->serialOfLastChange() == serial ||
+         (v->numUnchangedSince() == serial && v->numUnchanged() >= _evaluated);
+}
+
+
+void Equation::keepEvaluated() {
+  _evaluated = _ns;
+  _evaluatedChanges.clear();
+  _evaluatedChanges.insert(_xInVector.data(), _xInVector->serialOfLastChange());
+  foreach (const VectorPtr &v, VectorsUsed) {
+    _evaluatedChanges.insert(v.data(), v->serialOfLastChange());
+  }
+  foreach (const ScalarPtr &s, ScalarsUsed) {
+    _evaluatedChanges.insert(s.data(), s->serialOfLastChange());
+  }
+}
+
+
 QString Equation::propertyString() const {
   return equation();
 }
@@ -21,6 +21,8 @@
 #ifndef EQUATION_H
 #define EQUATION_H
 
+#include <QHash>
+
 #include "dataobject.h"
 #include "objectfactory.h"
 #include "kstmath_export.h"
@@ -105,13 +107,24 @@ class KSTMATH_EXPORT Equation : public DataObject {
     ScalarMap ScalarsUsed;
 
     bool FillY(bool force = false);
+    qint64 appendedFrom(qint64 ns) const;
+    bool appendedTo(const VectorPtr &v, qint64 ns) const;
+    void keepEvaluated();
+
     bool _isValid : 1;
     bool _doInterp : 1;
 
-    int _numNew, _numShifted, _interp, _ns;
+    qint64 _numNew, _numShifted;
+    int _interp;
+    qint64 _ns;
 
     VectorPtr _xInVector, _xOutVector, _yOutVector;
     Equations::Node *_pe;
+
+    // how many outputs were evaluated, and the changes of the inputs they
+    // were evaluated from
+    qint64 _evaluated;
+    QHash<const Primitive*, qint64> _evaluatedChanges;
 };
 
 typedef SharedPtr<Equation> EquationPtr;
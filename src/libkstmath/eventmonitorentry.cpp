@@ -151,7 +151,7 @@ void EventMonitorEntry::internalUpdate() {
 
   VectorPtr xv = *_xVector;
   VectorPtr yv = *_yVector;
-  int ns = 1;
+  qint64 ns = 1;
 
   for (VectorMap::ConstIterator i = _vectorsUsed.constBegin(); i != _vectorsUsed.constEnd(); ++i) {
     ns = qMax(ns, i.value()->length());
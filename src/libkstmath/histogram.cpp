@@ -23,7 +23,9 @@
 #include <stdlib.h>
 
 #include <QTextDocument>
+#include <QThread>
 #include <QXmlStreamWriter>
+#include <QtConcurrentMap>
 
 
 #include "dialoglauncher.h"
@@ -40,8 +42,71 @@ static const QLatin1String& RAWVECTOR  = QLatin1String("I");
 static const QLatin1String& BINS = QLatin1String("B");
 static const QLatin1String& HIST = QLatin1String("H");
 
+// below this many samples a thread costs more than it saves
+static const qint64 ParallelBinningThreshold = 1 << 18;
+static const int BinningBlock = 4096;
+
+// Adds samples [i0, i0+ns) of v to bins.  The top boundary of the top bin
+// is included in the top bin; for all other bins the top boundary is
+// included in the next bin.  NaNs are not counted.
+static void binSamples(const Vector *v, qint64 i0, qint64 ns, double xMin, double xMax, double w,
+                       int n_bins, unsigned long *bins) {
+  double scratch[BinningBlock];
+  for (qint64 b0 = i0; b0 < i0 + ns; b0 += BinningBlock) {
+    const int bn = int(qMin(qint64(BinningBlock), i0 + ns - b0));
+    const double *block = v->sampleBlock(b0, bn, scratch);
+    for (int k = 0; k < bn; ++k) {
+      const double y = block[k];
+      const double x = (y - xMin)/w;
+      if (x >= 0.0 && x < n_bins) {
+        bins[int(x)]++;
+      } else if (y == xMax) {
+        bins[n_bins-1]++;
+      }
+    }
+  }
+}
+
+
+// The counts are integers, so summing per-thread bins gives exactly what a
+// single pass would.
+static void binSamplesParallel(const Vector *v, qint64 i0, qint64 ns, double xMin, double xMax, double w,
+                               int n_bins, unsigned long *bins) {
+  const int n_chunks = int(qMin(qint64(QThread::idealThreadCount()), ns/ParallelBinningThreshold));
+  if (n_chunks < 2) {
+    binSamples(v, i0, ns, xMin, xMax, w, n_bins, bins);
+    return;
+  }
+
+  struct Chunk {
+    qint64 i0;
+    qint64 ns;
+    QVector<unsigned long> bins;
+  };
+  QVector<Chunk> chunks(n_chunks);
+  const qint64 chunk_size = (ns + n_chunks - 1)/n_chunks;
+  for (int i = 0; i < n_chunks; ++i) {
+    chunks[i].i0 = i0 + i*chunk_size;
+    chunks[i].ns = qMax(qint64(0), qMin(chunk_size, ns - i*chunk_size));
+    chunks[i].bins.fill(0, n_bins);
+  }
+
+  QtConcurrent::blockingMap(chunks, [=](Chunk &chunk) {
+    binSamples(v, chunk.i0, chunk.ns, xMin, xMax, w, n_bins, chunk.bins.data());
+  });
+
+  for (int i = 0; i < n_chunks; ++i) {
+    const unsigned long *chunk_bins = chunks[i].bins.constData();
+    for (int i_bin = 0; i_bin < n_bins; ++i_bin) {
+      bins[i_bin] += chunk_bins[i_bin];
+    }
+  }
+}
+
+
 Histogram::Histogram(ObjectStore *store)
-  : DataObject(store) {
+  : DataObject(store), _binnedSerial(Object::Forced), _binnedSamples(0),
+    _binnedMinX(0.0), _binnedMaxX(0.0), _binnedBins(0) {
   setRealTimeAutoBin(false);
   _typeString = staticTypeString;
   _type = "Histogram";
@@ -85,6 +150,7 @@ void Histogram::change(VectorPtr in_V,
   _NumberOfBins = 0;
 
   _inputVectors[RAWVECTOR] = in_V;
+  _binnedSerial = Object::Forced;
 
   if (xmax_in>xmin_in) {
     _MaxX = xmax_in;
@@ -129,7 +195,8 @@ void Histogram::internalUpdate() {
 
   writeLockInputsAndOutputs();
 
-  int i_bin, i_pt, ns;
+  int i_bin;
+  qint64 ns;
   double y = 0.0;
   double MaxY = 0.0;
   // do auto-binning if necessary
@@ -144,23 +211,28 @@ void Histogram::internalUpdate() {
   _NS = 3 * _NumberOfBins + 1;
   _W = (_MaxX - _MinX)/double(_NumberOfBins);
 
-  memset(_Bins, 0, _NumberOfBins*sizeof(*_Bins));
-
-  ns = _inputVectors[RAWVECTOR]->length();
-  for (i_pt = 0; i_pt < ns ; ++i_pt) {
-    y = _inputVectors[RAWVECTOR]->interpolate(i_pt, ns);
-    i_bin = (int)floor((y-_MinX)/_W);
-    if (i_bin >= 0 && i_bin < _NumberOfBins) {
-      _Bins[i_bin]++;
-    } else {
-      // the top boundary of the top bin is included in the top bin.
-      // for all other bins, the top boundary is included in the next bin
-      if (y == _MaxX) {
-        _Bins[_NumberOfBins-1]++;
-      }
-    }
+  VectorPtr v = _inputVectors[RAWVECTOR];
+  ns = v->length();
+
+  // samples appended to a vector we have already binned, into the same bins
+  qint64 i0 = 0;
+  if (_binnedSerial != Object::Forced && v->numUnchangedSince() == _binnedSerial &&
+      v->serialOfLastChange() != _binnedSerial && v->numUnchanged() >= _binnedSamples &&
+      ns >= _binnedSamples && _binnedBins == _NumberOfBins &&
+      _binnedMinX == _MinX && _binnedMaxX == _MaxX) {
+    i0 = _binnedSamples;
+  } else {
+    memset(_Bins, 0, _NumberOfBins*sizeof(*_Bins));
   }
 
+  binSamplesParallel(v, i0, ns - i0, _MinX, _MaxX, _W, _NumberOfBins, _Bins);
+
+  _binnedSerial = v->serialOfLastChange();
+  _binnedSamples = ns;
+  _binnedMinX = _MinX;
+  _binnedMaxX = _MaxX;
+  _binnedBins = _NumberOfBins;
+
   for (i_bin=0; i_bin<_NumberOfBins; ++i_bin) {
     y = _Bins[i_bin];
     if (y > MaxY) {
@@ -279,6 +351,7 @@ void Histogram::setNumberOfBins(int in_n_bins) {
 void Histogram::setVector(VectorPtr new_v) {
   if (new_v) {
     _inputVectors[RAWVECTOR] = new_v;
+    _binnedSerial = Object::Forced;
   }
 }
 
@@ -322,7 +395,7 @@ void Histogram::AutoBin(VectorPtr V, int *n, double *max, double *min) {
 
   *max = V->max();
   *min = V->min();
-  *n = V->length();
+  qint64 ns = V->length();
 
   if (*max < *min) {
     m = *max;
@@ -337,13 +410,7 @@ void Histogram::AutoBin(VectorPtr V, int *n, double *max, double *min) {
 
   // we can do a better job auto-ranging using the tick rules from plot...
   // this has not been done yet, you will notice...
-  *n /= 50;
-  if (*n < 6) {
-    *n = 6;
-  }
-  if (*n > 60) {
-    *n = 60;
-  }
+  *n = int(qBound(qint64(6), ns/50, qint64(60)));
 
   m = (*max - *min)/(100.0*double(*n));
   *max += m;
@@ -376,7 +443,7 @@ double Histogram::vMin() const {
 }
 
 
-int Histogram::vNumSamples() const {
+qint64 Histogram::vNumSamples() const {
   return _inputVectors[RAWVECTOR]->length();
 }
 
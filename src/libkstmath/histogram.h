@@ -82,7 +82,7 @@ public:
 
     double vMax() const;
     double vMin() const;
-    int vNumSamples() const;
+    qint64 vNumSamples() const;
 
     virtual DataObjectPtr makeDuplicate() const;
 
@@ -117,6 +117,14 @@ public:
     double _W;
     bool _realTimeAutoBin;
 
+    // what _Bins holds, so that when samples are only appended to the
+    // vector, and the bins stay put, just the new samples are binned
+    qint64 _binnedSerial;
+    qint64 _binnedSamples;
+    double _binnedMinX;
+    double _binnedMaxX;
+    int _binnedBins;
+
     void internalSetNumberOfBins(int in_n_bins);
     void internalSetXRange(double xmin_in, double xmax_in);
 };
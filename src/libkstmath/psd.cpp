@@ -139,12 +139,12 @@ void PSD::internalUpdate() {
 
   VectorPtr iv = _inputVectors[INVECTOR];
 
-  const int v_len = iv->length();
+  const qint64 v_len = iv->length();
 
   _last_n_new += iv->numNew();
   assert(_last_n_new >= 0);
 
-  int n_subsets = (v_len)/_PSDLength;
+  qint64 n_subsets = (v_len)/_PSDLength;
 
   // determine if the PSD needs to be updated.
   // if not using averaging, then we need at least _PSDLength/16 new data points.
@@ -119,9 +119,9 @@ class KSTMATH_EXPORT PSD : public DataObject {
     bool _Average;
     PSDType _Output;
     PSDType _prevOutput;
-    int _last_n_subsets;
-    int _last_n_new;
-    int _last_n;
+    qint64 _last_n_subsets;
+    qint64 _last_n_new;
+    qint64 _last_n;
     double _Frequency;
 
     int _PSDLength;
@@ -161,13 +161,13 @@ void PSDCalculator::updateWindowFxn(ApodizeFunction apodizeFxn, double gaussianS
 
 
 int PSDCalculator::calculatePowerSpectrum(
-  double const *input, int input_len,
+  double const *input, qint64 input_len,
   double *output, int output_len,
   bool removeMean,
   bool average, int average_len,
   bool apodize, ApodizeFunction apodize_function, double gaussian_sigma,
   PSDType output_type, double sampling_freq,
-  double const *input2, int input2_len, double *output2) {
+  double const *input2, qint64 input2_len, double *output2) {
 
   bool cross_spectra = false;
 
@@ -204,9 +204,9 @@ int PSDCalculator::calculatePowerSpectrum(
   }
 
   int currentCopyLen;
-  int nsamples = 0;
+  qint64 nsamples = 0;
   int i_samp;
-  int ioffset;
+  qint64 ioffset;
 
   memset(output, 0, sizeof(double)*output_len); // initialize output.
   if (cross_spectra) {
@@ -217,7 +217,7 @@ int PSDCalculator::calculatePowerSpectrum(
   //MeasureTime time_in_rfdt("rdft()");
 
   bool done = false;
-  for (int i_subset = 0; !done; i_subset++) {
+  for (qint64 i_subset = 0; !done; i_subset++) {
     ioffset = i_subset*output_len; //overlapping average => i_subset*outputLen
 
     // only zero pad if we really have to.  It is better to adjust the last chunk's
@@ -229,7 +229,7 @@ int PSDCalculator::calculatePowerSpectrum(
       currentCopyLen = _fft_len; //will copy a complete window.
       done = true;
     } else {
-      currentCopyLen = input_len - ioffset; //will copy a partial window.
+      currentCopyLen = int(input_len - ioffset); //will copy a partial window.
       memset(&_a[currentCopyLen], 0, sizeof(double)*(_fft_len - currentCopyLen)); //zero the leftovers.
       if (cross_spectra) {
         memset(&_b[currentCopyLen], 0, sizeof(double)*(_fft_len - currentCopyLen)); //zero the leftovers.
@@ -383,7 +383,7 @@ int PSDCalculator::calculatePowerSpectrum(
 }
 
 
-int PSDCalculator::calculateOutputVectorLength(int inputLen, bool average, int averageLen) {
+int PSDCalculator::calculateOutputVectorLength(qint64 inputLen, bool average, int averageLen) {
   int psdloglen;
 
   if (average && pow(2.0, averageLen) < inputLen) {
@@ -53,13 +53,13 @@ class KSTMATH_EXPORT PSDCalculator {
     PSDCalculator();
     ~PSDCalculator();
 
-    int calculatePowerSpectrum(double const *input, int input_len, double *output, int output_len,
+    int calculatePowerSpectrum(double const *input, qint64 input_len, double *output, int output_len,
                                bool remove_mean, bool average, int average_len,
                                bool apodize, ApodizeFunction apodize_function, double gaussian_sigma,
                                PSDType output_type, double sampling_freq,
-                               double const *input2 = 0L, int input2_len = 0, double *output2 = 0L);
+                               double const *input2 = 0L, qint64 input2_len = 0, double *output2 = 0L);
 
-    static int calculateOutputVectorLength(int input_len, bool average, int average_len);
+    static int calculateOutputVectorLength(qint64 input_len, bool average, int average_len);
 
   private:
     void updateWindowFxn(ApodizeFunction apodizeFxn, double gaussianSigma);
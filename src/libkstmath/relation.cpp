@@ -22,6 +22,7 @@
 
 
 #include "objectstore.h"
+#include "tracer.h"
 
 #include <QXmlStreamWriter>
 
@@ -77,6 +78,9 @@ void Relation::deleteDependents() {
 
 
 void Relation::paint(const CurveRenderContext& context) {
+  TraceSpan span("paint", this);
+  span.setSamples(sampleCount());
+
   if (redrawRequired(context) || _redrawRequired) {
     updatePaintObjects(context);
     _redrawRequired = false;
@@ -341,6 +345,15 @@ void Relation::unlockInputsAndOutputs() const {
 }
 
 
+QList<ObjectPtr> Relation::inputObjects() const {
+  QList<ObjectPtr> inputs;
+  foreach (PrimitivePtr P, inputPrimitives()) {
+    inputs.append(P);
+  }
+  return inputs;
+}
+
+
 bool Relation::uses(ObjectPtr p) const {
   VectorPtr v = kst_cast<Vector>(p);
   if (v) {
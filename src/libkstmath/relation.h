@@ -89,7 +89,7 @@ class KSTMATH_EXPORT Relation : public Object {
 
     virtual QString propertyString() const = 0;
 
-    virtual int sampleCount() const { return NS; }
+    virtual qint64 sampleCount() const { return NS; }
 
     virtual void setIgnoreAutoScale(bool ignoreAutoScale);
     virtual bool ignoreAutoScale() const { return _ignoreAutoScale; }
@@ -113,6 +113,7 @@ class KSTMATH_EXPORT Relation : public Object {
     virtual void yRange(double xFrom, double xTo, double* yMin, double* yMax) = 0;
 
     virtual bool uses(ObjectPtr p) const;
+    virtual QList<ObjectPtr> inputObjects() const;
 
     // return closest distance to the given point
     // images always return a rating >= 5
@@ -199,7 +200,7 @@ protected:
     double MinY;
     double MinPosY;
 
-    int NS;
+    qint64 NS;
 
     bool _ignoreAutoScale;
 
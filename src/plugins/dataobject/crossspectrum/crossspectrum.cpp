@@ -182,7 +182,7 @@ bool CrossSpectrumSource::algorithm() {
   
   double df;
   int i;
-  int v_len;
+  qint64 v_len;
 
   /* parse fft length */
   if ( fft_len_exponent > KSTPSDMAXLEN ) {
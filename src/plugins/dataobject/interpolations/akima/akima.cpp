@@ -125,10 +125,12 @@ class ConfigWidgetAkimaPlugin : public Kst::DataObjectConfigWidget, public Ui_Ak
 
 AkimaSource::AkimaSource(Kst::ObjectStore *store)
 : Kst::BasicPlugin(store) {
+  _plan = new InterpolationPlan;
 }
 
 
 AkimaSource::~AkimaSource() {
+  delete _plan;
 }
 
 
@@ -142,6 +144,7 @@ void AkimaSource::change(Kst::DataObjectConfigWidget *configWidget) {
     setInputVector(VECTOR_IN_X, config->selectedVectorX());
     setInputVector(VECTOR_IN_Y, config->selectedVectorY());
     setInputVector(VECTOR_IN_X1, config->selectedVectorX1());
+    _plan->reset();
   }
 }
 
@@ -157,7 +160,7 @@ bool AkimaSource::algorithm() {
   Kst::VectorPtr inputVectorX1 = _inputVectors[VECTOR_IN_X1];
   Kst::VectorPtr outputVector = _outputVectors[VECTOR_OUT];
 
-  return interpolate( inputVectorX, inputVectorY, inputVectorX1, outputVector, gsl_interp_akima);
+  return interpolate( inputVectorX, inputVectorY, inputVectorX1, outputVector, gsl_interp_akima, _plan);
 }
 
 
@@ -20,6 +20,8 @@
 #include <basicplugin.h>
 #include <dataobjectplugin.h>
 
+class InterpolationPlan;
+
 class CubicSplineSource : public Kst::BasicPlugin {
   Q_OBJECT
 
@@ -48,6 +50,8 @@ class CubicSplineSource : public Kst::BasicPlugin {
     CubicSplineSource(Kst::ObjectStore *store);
     ~CubicSplineSource();
 
+    InterpolationPlan *_plan;
+
   friend class Kst::ObjectStore;
 
 
@@ -57,7 +61,7 @@ class CubicSplineSource : public Kst::BasicPlugin {
 class CubicSplinePlugin : public QObject, public Kst::DataObjectPluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataObjectPluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.1")
   public:
     virtual ~CubicSplinePlugin() {}
 
@@ -125,10 +125,12 @@ class ConfigWidgetCubicSplinePeriodicPlugin : public Kst::DataObjectConfigWidget
 
 CubicSplinePeriodicSource::CubicSplinePeriodicSource(Kst::ObjectStore *store)
 : Kst::BasicPlugin(store) {
+  _plan = new InterpolationPlan;
 }
 
 
 CubicSplinePeriodicSource::~CubicSplinePeriodicSource() {
+  delete _plan;
 }
 
 
@@ -142,6 +144,7 @@ void CubicSplinePeriodicSource::change(Kst::DataObjectConfigWidget *configWidget
     setInputVector(VECTOR_IN_X, config->selectedVectorX());
     setInputVector(VECTOR_IN_Y, config->selectedVectorY());
     setInputVector(VECTOR_IN_X1, config->selectedVectorX1());
+    _plan->reset();
   }
 }
 
@@ -157,7 +160,7 @@ bool CubicSplinePeriodicSource::algorithm() {
   Kst::VectorPtr inputVectorX1 = _inputVectors[VECTOR_IN_X1];
   Kst::VectorPtr outputVector = _outputVectors[VECTOR_OUT];
 
-  return interpolate( inputVectorX, inputVectorY, inputVectorX1, outputVector, gsl_interp_cspline_periodic);
+  return interpolate( inputVectorX, inputVectorY, inputVectorX1, outputVector, gsl_interp_cspline_periodic, _plan);
 }
 
 
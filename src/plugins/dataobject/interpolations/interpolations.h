@@ -17,19 +17,117 @@
 
 #include <vector.h>
 
+#include <QVector>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+#include <math.h>
+
+// What an interpolation keeps between updates: the spline, as initialised
+// from the data it was last given, and how many outputs were evaluated for
+// which X' vector.
+class InterpolationPlan {
+  public:
+    InterpolationPlan() : spline(0), type(0), length(0) { reset(); }
+    ~InterpolationPlan() { reset(); }
+
+    // forget everything, as when the inputs are changed
+    void reset() {
+      if (spline) {
+        gsl_spline_free( spline );
+      }
+      spline = 0;
+      type = 0;
+      length = 0;
+      xSerial = ySerial = x1Serial = Kst::Object::Forced;
+      outputs = 0;
+    }
+
+    gsl_spline *spline;
+    const gsl_interp_type *type;
+    int length;
+    qint64 xSerial;
+    qint64 ySerial;
+    qint64 x1Serial;
+    qint64 outputs;
+};
+
+
+// outputs in a block evaluated by one thread
+#define INTERPOLATION_BLOCK (1 << 16)
+
+
+// Whether the first n samples of vector are as they were at its change
+// serial.
+bool interpolation_keeps(Kst::VectorPtr vector, qint64 serial, qint64 n) {
+  if (serial == Kst::Object::Forced) {
+    return false;
+  }
+  return vector->serialOfLastChange() == serial ||
+         (vector->numUnchangedSince() == serial && vector->numUnchanged() >= n);
+}
+
+
+// Appending data changes only the last intervals of a linear or an akima
+// interpolation: an output left of the data point this many from the old
+// end is as it was.  The other types depend on all of the data.
+int interpolation_reach(const gsl_interp_type* pType) {
+  if (pType == gsl_interp_linear) {
+    return 1;
+  } else if (pType == gsl_interp_akima) {
+    return 3;
+  }
+  return 0;
+}
+
+
+// Evaluates outputs [i0, i1), but for the first iKept whose x' is left of
+// dKeepBelow.  A rising x' is merged with the data: the interval of each
+// point is found from the one before, and handed to gsl as its cached guess.
+void interpolation_evaluate(const gsl_spline* pSpline, const double* pdX1, double* pdOut,
+                            qint64 i0, qint64 i1, bool bRising, qint64 iKept, double dKeepBelow) {
+  const double* pdX = pSpline->x;
+  const size_t iSize = pSpline->size;
+  gsl_interp_accel accel;
+  gsl_interp_accel_reset( &accel );
+
+  size_t j = 0;
+  if (bRising && i0 < i1) {
+    j = gsl_interp_bsearch( pdX, pdX1[i0], 0, iSize - 1 );
+  }
+
+  for (qint64 i = i0; i < i1; ++i) {
+    const double dX1 = pdX1[i];
+    if (i < iKept && dX1 < dKeepBelow) {
+      continue;
+    }
+    if (bRising) {
+      int iSteps = 0;
+      while (j + 2 < iSize && pdX[j + 1] <= dX1) {
+        if (++iSteps > 8) {
+          j = gsl_interp_bsearch( pdX, dX1, j, iSize - 1 );
+          break;
+        }
+        ++j;
+      }
+      accel.cache = j;
+    }
+    pdOut[i] = gsl_spline_eval( pSpline, dX1, &accel );
+  }
+}
+
+
 bool interpolate(Kst::VectorPtr xVector,
                  Kst::VectorPtr yVector,
                  Kst::VectorPtr x1Vector,
                  Kst::VectorPtr yOutVector,
-                 const gsl_interp_type* pType) {
+                 const gsl_interp_type* pType,
+                 InterpolationPlan* pPlan) {
 
-  gsl_interp_accel *pAccel = NULL;
-  gsl_interp *pInterp = NULL;
-  gsl_spline *pSpline = NULL;
   int iLengthData;
-  int iLengthInterp;
-  bool bReturn = false;
-  double* pResult[1];
+  qint64 iLengthInterp;
+  qint64 iKept = 0;
+  double dKeepBelow = -INFINITY;
 
   iLengthData = xVector->length();
   if (yVector->length() < iLengthData) {
@@ -37,50 +135,95 @@ bool interpolate(Kst::VectorPtr xVector,
   }
 
   iLengthInterp = x1Vector->length();
-  if (iLengthInterp > 0) {
-    if (yOutVector->length() != iLengthInterp) {
-      yOutVector->resize(iLengthInterp, true);
-      pResult[0] = (double*)realloc( yOutVector->raw_V_ptr(), iLengthInterp * sizeof( double ) );
-    } else {
-      pResult[0] = yOutVector->raw_V_ptr();
-    }
+  if (iLengthInterp <= 0) {
+    return false;
+  }
 
-    if (pResult[0] != NULL) {
+  //
+  // check that we have enough data points...
+  //
+  if ((unsigned int)iLengthData <= pType->min_size) {
+    pPlan->reset();
+    return false;
+  }
 
-      for (int i = 0; i < iLengthInterp; ++i) {
-        yOutVector->raw_V_ptr()[i] = pResult[0][i];
-      }
+  //
+  // the outputs of the last update are kept if x' only grew since, and
+  // either the data is as it was or, for the local types, they lie left of
+  // the data appended to it...
+  //
+  if (!x1Vector->hasNaN() && interpolation_keeps( x1Vector, pPlan->x1Serial, pPlan->outputs )) {
+    iKept = qMin(pPlan->outputs, iLengthInterp);
+  }
 
-      pInterp = gsl_interp_alloc( pType, iLengthData );
-      if (pInterp != NULL) {
-        //
-        // check that we have enough data points...
-        //
-        if ((unsigned int)iLengthData > gsl_interp_min_size( pInterp )) {
-          pAccel  = gsl_interp_accel_alloc( );
-          if (pAccel != NULL) {
-            pSpline = gsl_spline_alloc( pType, iLengthData );
-            if (pSpline != NULL) {
-              if (!gsl_spline_init( pSpline, xVector->noNanValue(), yVector->noNanValue(), iLengthData )) {
-                double const *xV1 = x1Vector->noNanValue();
-                double *yVout = yOutVector->raw_V_ptr();
-                for( int i=0; i<iLengthInterp; i++) {
-                  yVout[i] = gsl_spline_eval( pSpline, xV1[i], pAccel );
-                }
-
-                bReturn = true;
-              }
-              gsl_spline_free( pSpline );
-            }
-            gsl_interp_accel_free( pAccel );
-          }
-        }
-        gsl_interp_free( pInterp );
+  if (pPlan->spline && pPlan->type == pType && pPlan->length == iLengthData &&
+      xVector->serialOfLastChange() == pPlan->xSerial &&
+      yVector->serialOfLastChange() == pPlan->ySerial) {
+    dKeepBelow = INFINITY;
+  } else {
+    const int iReach = interpolation_reach( pType );
+    if (iKept > 0 && iReach > 0 && pPlan->spline && pPlan->type == pType &&
+        iLengthData >= pPlan->length && pPlan->length > iReach &&
+        interpolation_keeps( xVector, pPlan->xSerial, pPlan->length ) &&
+        interpolation_keeps( yVector, pPlan->ySerial, pPlan->length ) &&
+        !xVector->hasNaN() && !yVector->hasNaN()) {
+      dKeepBelow = pPlan->spline->x[pPlan->length - iReach];
+    }
+
+    if (!pPlan->spline || pPlan->type != pType || pPlan->length != iLengthData) {
+      pPlan->reset();
+      pPlan->spline = gsl_spline_alloc( pType, iLengthData );
+      if (pPlan->spline == NULL) {
+        return false;
       }
+      pPlan->type = pType;
+      pPlan->length = iLengthData;
+    }
+
+    if (gsl_spline_init( pPlan->spline, xVector->noNanValue(), yVector->noNanValue(), iLengthData )) {
+      pPlan->reset();
+      return false;
+    }
+    pPlan->xSerial = xVector->serialOfLastChange();
+    pPlan->ySerial = yVector->serialOfLastChange();
+  }
+
+  if (yOutVector->length() != iLengthInterp) {
+    yOutVector->resize(iLengthInterp, true);
+  }
+
+  double const *xV1 = x1Vector->noNanValue();
+  double *yVout = yOutVector->raw_V_ptr();
+  const bool bRising = x1Vector->isRising();
+
+  qint64 iFirst = 0;
+  if (dKeepBelow == INFINITY) {
+    iFirst = iKept;
+  } else if (bRising && iKept > 0) {
+    iFirst = std::lower_bound(xV1, xV1 + iKept, dKeepBelow) - xV1;
+  }
+
+  //
+  // evaluate, in blocks across threads for long outputs...
+  //
+  if (iLengthInterp - iFirst > 4*INTERPOLATION_BLOCK) {
+    QVector<qint64> blocks;
+    for (qint64 i0 = iFirst; i0 < iLengthInterp; i0 += INTERPOLATION_BLOCK) {
+      blocks.append(i0);
     }
+    const gsl_spline *pSpline = pPlan->spline;
+    QtConcurrent::blockingMap(blocks, [=](qint64 i0) {
+      interpolation_evaluate( pSpline, xV1, yVout, i0, qMin(i0 + INTERPOLATION_BLOCK, iLengthInterp),
+                              bRising, iKept, dKeepBelow );
+    });
+  } else {
+    interpolation_evaluate( pPlan->spline, xV1, yVout, iFirst, iLengthInterp, bRising, iKept, dKeepBelow );
   }
 
-  return bReturn;
+  pPlan->x1Serial = x1Vector->serialOfLastChange();
+  pPlan->outputs = iLengthInterp;
+
+  return true;
 }
 
 #endif
@@ -125,10 +125,12 @@ class ConfigWidgetPolynomialPlugin : public Kst::DataObjectConfigWidget, public
 
 PolynomialSource::PolynomialSource(Kst::ObjectStore *store)
 : Kst::BasicPlugin(store) {
+  _plan = new InterpolationPlan;
 }
 
 
 PolynomialSource::~PolynomialSource() {
+  delete _plan;
 }
 
 
@@ -142,6 +144,7 @@ void PolynomialSource::change(Kst::DataObjectConfigWidget *configWidget) {
     setInputVector(VECTOR_IN_X, config->selectedVectorX());
     setInputVector(VECTOR_IN_Y, config->selectedVectorY());
     setInputVector(VECTOR_IN_X1, config->selectedVectorX1());
+    _plan->reset();
   }
 }
 
@@ -157,7 +160,7 @@ bool PolynomialSource::algorithm() {
   Kst::VectorPtr inputVectorX1 = _inputVectors[VECTOR_IN_X1];
   Kst::VectorPtr outputVector = _outputVectors[VECTOR_OUT];
 
-  return interpolate( inputVectorX, inputVectorY, inputVectorX1, outputVector, gsl_interp_polynomial);
+  return interpolate( inputVectorX, inputVectorY, inputVectorX1, outputVector, gsl_interp_polynomial, _plan);
 }
 
 
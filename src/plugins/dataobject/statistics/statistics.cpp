@@ -14,9 +14,13 @@
 
 
 #include "statistics.h"
+#include "math_kst.h"
 #include "objectstore.h"
+#include "quantiles.h"
 #include "ui_statisticsconfig.h"
 
+#include <algorithm>
+
 static const QString& VECTOR_IN = "Vector In";
 static const QString& SCALAR_OUT_MEAN = "Mean";
 static const QString& SCALAR_OUT_MINIMUM = "Minimum";
@@ -101,7 +105,7 @@ class ConfigWidgetStatisticsPlugin : public Kst::DataObjectConfigWidget, public
 
 
 StatisticsSource::StatisticsSource(Kst::ObjectStore *store)
-: Kst::BasicPlugin(store) {
+: Kst::BasicPlugin(store), _orderedKept(false), _orderedSorted(false), _orderedSerial(Kst::Object::Forced), _orderedSamples(0) {
 }
 
 
@@ -152,7 +156,6 @@ bool StatisticsSource::algorithm() {
     return false;
   }
 
-  double* pCopy;
   double dMean = 0.0;
   double dMedian = 0.0;
   double dStandardDeviation = 0.0;
@@ -164,17 +167,18 @@ bool StatisticsSource::algorithm() {
   double dAbsoluteDeviation = 0.0;
   double dSkewness = 0.0;
   double dKurtosis = 0.0;
-  int iLength = inputVector->length();
+  qint64 iLength = inputVector->length();
+  const double *v = inputVector->value();
 
-  for (int i=0; i<iLength; i++) {
-    if (i == 0 || inputVector->value()[i] < dMinimum) {
-      dMinimum = inputVector->value()[i];
+  for (qint64 i=0; i<iLength; i++) {
+    if (i == 0 || v[i] < dMinimum) {
+      dMinimum = v[i];
     }
-    if (i == 0 || inputVector->value()[i] > dMaximum) {
-      dMaximum = inputVector->value()[i];
+    if (i == 0 || v[i] > dMaximum) {
+      dMaximum = v[i];
     }
-    dTotal += inputVector->value()[i];
-    dSquaredTotal += inputVector->value()[i] * inputVector->value()[i];
+    dTotal += v[i];
+    dSquaredTotal += v[i] * v[i];
   }
 
   dMean = dTotal / (double)iLength;
@@ -189,27 +193,17 @@ bool StatisticsSource::algorithm() {
     }
   }
 
-  for (int i=0; i<iLength; i++) {
-    dAbsoluteDeviation += fabs( inputVector->value()[i] - dMean );
-    dSkewness               += pow( inputVector->value()[i] - dMean, 3.0 );
-    dKurtosis               += pow( inputVector->value()[i] - dMean, 4.0 );
+  for (qint64 i=0; i<iLength; i++) {
+    dAbsoluteDeviation += fabs( v[i] - dMean );
+    dSkewness               += pow( v[i] - dMean, 3.0 );
+    dKurtosis               += pow( v[i] - dMean, 4.0 );
   }
   dAbsoluteDeviation /= (double)iLength;
   dSkewness                 /= (double)iLength * pow( dStandardDeviation, 3.0 );
   dKurtosis                 /= (double)iLength * pow( dStandardDeviation, 4.0 );
   dKurtosis                 -= 3.0;
 
-  /*
-  sort by phase...
-  */
-  pCopy = (double*)calloc( iLength, sizeof( double ) );
-  if (pCopy != NULL) {
-    memcpy( pCopy, inputVector->value(), iLength * sizeof( double ) );
-    quicksort( pCopy, 0, iLength-1 );
-    dMedian = pCopy[ iLength / 2 ];
-
-    free( pCopy );
-  }
+  dMedian = median(inputVector);
 
   outputScalarMean->setValue(dMean);
   outputScalarMin->setValue(dMinimum);
@@ -225,42 +219,64 @@ bool StatisticsSource::algorithm() {
 }
 
 
-void StatisticsSource::swap( double* pData, int iOne, int iTwo) {
-  double dTemp;
-
-  dTemp = pData[iOne];
-  pData[iOne] = pData[iTwo];
-  pData[iTwo] = dTemp;
-}
-
-
-void StatisticsSource::quicksort( double* pData, int iLeft, int iRight) {
-
-  double dVal = pData[iRight];
-  int i = iLeft - 1;
-  int j = iRight;
-
-  if (iRight <= iLeft) {
-    return;
-  }
-
-  while (1) {
-    while (pData[++i] < dVal) {
+// The median is selected rather than sorted for, unless the input only
+// grew since the last update: then the new samples are merged into those
+// kept from it, which are sorted once.  The copy of the samples is only
+// kept while the input grows: a vector that doesn't would hold it twice.
+double StatisticsSource::median( Kst::VectorPtr inputVector ) {
+  const double *v = inputVector->value();
+  const qint64 iLength = inputVector->length();
+
+  const bool grew = _orderedSerial != Kst::Object::Forced &&
+                    inputVector->numUnchangedSince() == _orderedSerial &&
+                    inputVector->serialOfLastChange() != _orderedSerial &&
+                    inputVector->numUnchanged() >= _orderedSamples &&
+                    iLength >= _orderedSamples;
+  const bool appended = grew && _orderedKept;
+
+  qint64 i0 = 0;
+  if (appended) {
+    i0 = _orderedSamples;
+    if (!_orderedSorted) {
+      std::sort(_ordered.begin(), _ordered.end());
+      _orderedSorted = true;
     }
+  } else {
+    _ordered.clear();
+    _orderedSorted = false;
+  }
 
-    while(dVal < pData[--j]) {
-      if (j == iLeft) {
-        break;
-      }
+  const qint64 iOld = _ordered.size();
+  _ordered.reserve(iOld + iLength - i0);
+  for (qint64 i = i0; i < iLength; i++) {
+    if (v[i] == v[i]) {
+      _ordered.append(v[i]);
     }
-    if (i >= j) {
-      break;
+  }
+  _orderedSerial = inputVector->serialOfLastChange();
+  _orderedSamples = iLength;
+
+  const qint64 iCount = _ordered.size();
+  const qint64 iRank = iCount / 2;
+  double dMedian = Kst::NOPOINT;
+
+  if (iCount > 0) {
+    if (_orderedSorted) {
+      std::sort(_ordered.begin() + iOld, _ordered.end());
+      std::inplace_merge(_ordered.begin(), _ordered.begin() + iOld, _ordered.end());
+      dMedian = _ordered[iRank];
+    } else {
+      Kst::selectRanksParallel(_ordered.constData(), iCount, &iRank, 1, &dMedian);
     }
-    swap( pData, i, j );
   }
-  swap( pData, i, iRight );
-  quicksort( pData, iLeft, i-1 );
-  quicksort( pData, i+1, iRight );
+
+  // kept for the next update if the input is growing
+  _orderedKept = grew;
+  if (!_orderedKept) {
+    _ordered = QVector<double>();
+    _orderedSorted = false;
+  }
+  return dMedian;
 }
 
 
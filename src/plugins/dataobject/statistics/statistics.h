@@ -16,6 +16,7 @@
 #define STATISTICSPLUGIN_H
 
 #include <QFile>
+#include <QVector>
 
 #include <basicplugin.h>
 #include <dataobjectplugin.h>
@@ -47,8 +48,16 @@ class StatisticsSource : public Kst::BasicPlugin {
     ~StatisticsSource();
 
   private:
-    void swap( double* pData, int iOne, int iTwo );
-    void quicksort( double* pData, int iLeft, int iRight );
+    double median( Kst::VectorPtr inputVector );
+
+    // the input's samples, less NaNs, kept between updates only while the
+    // input is seen to grow: then they are kept sorted, and the new ones
+    // merged in.  Otherwise they are let go after each update.
+    QVector<double> _ordered;
+    bool _orderedKept;
+    bool _orderedSorted;
+    qint64 _orderedSerial;
+    qint64 _orderedSamples;
 
   friend class Kst::ObjectStore;
 
@@ -59,7 +68,7 @@ class StatisticsSource : public Kst::BasicPlugin {
 class StatisticsPlugin : public QObject, public Kst::DataObjectPluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataObjectPluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.1")
   public:
     virtual ~StatisticsPlugin() {}
 
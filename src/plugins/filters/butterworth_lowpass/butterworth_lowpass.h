@@ -57,7 +57,7 @@ class FilterButterworthLowPassSource : public Kst::BasicPlugin {
 class ButterworthLowPassPlugin : public QObject, public Kst::DataObjectPluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataObjectPluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.1")
   public:
     virtual ~ButterworthLowPassPlugin() {}
 
@@ -22,6 +22,7 @@
 
 #include <gsl/gsl_fit.h>
 #include "../non_linear.h"
+#include "../fitrangewidget.h"
 
 static const QString& VECTOR_IN_X = "X Vector";
 static const QString& VECTOR_IN_Y = "Y Vector";
@@ -36,6 +37,7 @@ class ConfigWidgetFitExponentialUnweightedPlugin : public Kst::DataObjectConfigW
     ConfigWidgetFitExponentialUnweightedPlugin(QSettings* cfg) : DataObjectConfigWidget(cfg), Ui_FitExponential_UnweightedConfig() {
       _store = 0;
       setupUi(this);
+      _fitRangeWidget = new FitRangeWidget(this);
     }
 
     ~ConfigWidgetFitExponentialUnweightedPlugin() {}
@@ -48,6 +50,7 @@ class ConfigWidgetFitExponentialUnweightedPlugin : public Kst::DataObjectConfigW
 
     void setupSlots(QWidget* dialog) {
       if (dialog) {
+        _fitRangeWidget->setupSlots(dialog);
         connect(_vectorX, SIGNAL(selectionChanged(QString)), dialog, SIGNAL(modified()));
         connect(_vectorY, SIGNAL(selectionChanged(QString)), dialog, SIGNAL(modified()));
       }
@@ -77,12 +80,12 @@ class ConfigWidgetFitExponentialUnweightedPlugin : public Kst::DataObjectConfigW
       if (FitExponentialUnweightedSource* source = static_cast<FitExponentialUnweightedSource*>(dataObject)) {
         setSelectedVectorX(source->vectorX());
         setSelectedVectorY(source->vectorY());
+        _fitRangeWidget->setRange(source->_fit->range);
       }
     }
 
     virtual bool configurePropertiesFromXml(Kst::ObjectStore *store, QXmlStreamAttributes& attrs) {
       Q_UNUSED(store);
-      Q_UNUSED(attrs);
 
       bool validTag = true;
 
@@ -92,6 +95,10 @@ class ConfigWidgetFitExponentialUnweightedPlugin : public Kst::DataObjectConfigW
 //         _configValue = QVariant(av.toString()).toBool();
 //       }
 
+      FitRange range;
+      range.load(attrs);
+      _fitRangeWidget->setRange(range);
+
       return validTag;
     }
 
@@ -124,6 +131,9 @@ class ConfigWidgetFitExponentialUnweightedPlugin : public Kst::DataObjectConfigW
       }
     }
 
+  public:
+    FitRangeWidget *_fitRangeWidget;
+
   private:
     Kst::ObjectStore *_store;
 
@@ -132,10 +142,12 @@ class ConfigWidgetFitExponentialUnweightedPlugin : public Kst::DataObjectConfigW
 
 FitExponentialUnweightedSource::FitExponentialUnweightedSource(Kst::ObjectStore *store)
 : Kst::BasicPlugin(store) {
+  _fit = new NonLinearFit;
 }
 
 
 FitExponentialUnweightedSource::~FitExponentialUnweightedSource() {
+  delete _fit;
 }
 
 
@@ -148,6 +160,8 @@ void FitExponentialUnweightedSource::change(Kst::DataObjectConfigWidget *configW
   if (ConfigWidgetFitExponentialUnweightedPlugin* config = static_cast<ConfigWidgetFitExponentialUnweightedPlugin*>(configWidget)) {
     setInputVector(VECTOR_IN_X, config->selectedVectorX());
     setInputVector(VECTOR_IN_Y, config->selectedVectorY());
+    _fit->range = config->_fitRangeWidget->range();
+    _fit->reset();
   }
 }
 
@@ -326,7 +340,8 @@ bool FitExponentialUnweightedSource::algorithm() {
 
   bReturn = kstfit_nonlinear( inputVectorX, inputVectorY,
                               outputVectorYFitted, outputVectorYResiduals, outputVectorYParameters,
-                              outputVectorYCovariance, outputScalar );
+                              outputVectorYCovariance, outputScalar,
+                              _fit, this, maxInputSerialOfLastChange() );
 
   outputVectorYParameters->raw_V_ptr()[1] = 1.0/outputVectorYParameters->raw_V_ptr()[1];
   outputVectorYParameters->raw_V_ptr()[3] = _X0;
@@ -383,8 +398,8 @@ QStringList FitExponentialUnweightedSource::outputStringList() const {
 
 
 void FitExponentialUnweightedSource::saveProperties(QXmlStreamWriter &s) {
-  Q_UNUSED(s);
 //   s.writeAttribute("value", _configValue);
+  _fit->range.save(s);
 }
 
 
@@ -430,6 +445,7 @@ Kst::DataObject *FitExponentialUnweightedPlugin::create(Kst::ObjectStore *store,
     }
 
     object->setPluginName(pluginName());
+    object->_fit->range = config->_fitRangeWidget->range();
 
     object->writeLock();
     object->registerChange();
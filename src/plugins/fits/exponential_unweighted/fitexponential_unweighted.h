@@ -20,6 +20,8 @@
 #include <basicplugin.h>
 #include <dataobjectplugin.h>
 
+class NonLinearFit;
+
 class FitExponentialUnweightedSource : public Kst::BasicPlugin {
   Q_OBJECT
 
@@ -43,6 +45,8 @@ class FitExponentialUnweightedSource : public Kst::BasicPlugin {
 
     virtual void saveProperties(QXmlStreamWriter &s);
 
+    NonLinearFit *_fit;
+
   protected:
     FitExponentialUnweightedSource(Kst::ObjectStore *store);
     ~FitExponentialUnweightedSource();
@@ -58,7 +62,7 @@ class FitExponentialUnweightedSource : public Kst::BasicPlugin {
 class FitExponentialUnweightedPlugin : public QObject, public Kst::DataObjectPluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataObjectPluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.1")
   public:
     virtual ~FitExponentialUnweightedPlugin() {}
 
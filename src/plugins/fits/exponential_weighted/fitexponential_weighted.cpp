@@ -22,6 +22,7 @@
 
 #include <gsl/gsl_fit.h>
 #include "../non_linear_weighted.h"
+#include "../fitrangewidget.h"
 
 static const QString& VECTOR_IN_X = "X Vector";
 static const QString& VECTOR_IN_Y = "Y Vector";
@@ -37,6 +38,7 @@ class ConfigWidgetFitExponentialWeightedPlugin : public Kst::DataObjectConfigWid
     ConfigWidgetFitExponentialWeightedPlugin(QSettings* cfg) : DataObjectConfigWidget(cfg), Ui_FitExponential_WeightedConfig() {
       _store = 0;
       setupUi(this);
+      _fitRangeWidget = new FitRangeWidget(this);
     }
 
     ~ConfigWidgetFitExponentialWeightedPlugin() {}
@@ -50,6 +52,7 @@ class ConfigWidgetFitExponentialWeightedPlugin : public Kst::DataObjectConfigWid
 
     void setupSlots(QWidget* dialog) {
       if (dialog) {
+        _fitRangeWidget->setupSlots(dialog);
         connect(_vectorX, SIGNAL(selectionChanged(QString)), dialog, SIGNAL(modified()));
         connect(_vectorY, SIGNAL(selectionChanged(QString)), dialog, SIGNAL(modified()));
         connect(_vectorWeights, SIGNAL(selectionChanged(QString)), dialog, SIGNAL(modified()));
@@ -83,12 +86,12 @@ class ConfigWidgetFitExponentialWeightedPlugin : public Kst::DataObjectConfigWid
         setSelectedVectorX(source->vectorX());
         setSelectedVectorY(source->vectorY());
         setSelectedVectorWeights(source->vectorWeights());
+        _fitRangeWidget->setRange(source->_fit->range);
       }
     }
 
     virtual bool configurePropertiesFromXml(Kst::ObjectStore *store, QXmlStreamAttributes& attrs) {
       Q_UNUSED(store);
-      Q_UNUSED(attrs);
 
       bool validTag = true;
 
@@ -98,6 +101,10 @@ class ConfigWidgetFitExponentialWeightedPlugin : public Kst::DataObjectConfigWid
 //         _configValue = QVariant(av.toString()).toBool();
 //       }
 
+      FitRange range;
+      range.load(attrs);
+      _fitRangeWidget->setRange(range);
+
       return validTag;
     }
 
@@ -137,6 +144,9 @@ class ConfigWidgetFitExponentialWeightedPlugin : public Kst::DataObjectConfigWid
       }
     }
 
+  public:
+    FitRangeWidget *_fitRangeWidget;
+
   private:
     Kst::ObjectStore *_store;
 
@@ -145,10 +155,12 @@ class ConfigWidgetFitExponentialWeightedPlugin : public Kst::DataObjectConfigWid
 
 FitExponentialWeightedSource::FitExponentialWeightedSource(Kst::ObjectStore *store)
 : Kst::BasicPlugin(store) {
+  _fit = new NonLinearFit;
 }
 
 
 FitExponentialWeightedSource::~FitExponentialWeightedSource() {
+  delete _fit;
 }
 
 
@@ -162,6 +174,8 @@ void FitExponentialWeightedSource::change(Kst::DataObjectConfigWidget *configWid
     setInputVector(VECTOR_IN_X, config->selectedVectorX());
     setInputVector(VECTOR_IN_Y, config->selectedVectorY());
     setInputVector(VECTOR_IN_WEIGHTS, config->selectedVectorWeights());
+    _fit->range = config->_fitRangeWidget->range();
+    _fit->reset();
   }
 }
 
@@ -344,7 +358,8 @@ bool FitExponentialWeightedSource::algorithm() {
 
   bReturn = kstfit_nonlinear_weighted( inputVectorX, inputVectorY, inputVectorWeights,
                               outputVectorYFitted, outputVectorYResiduals, outputVectorYParameters,
-                              outputVectorYCovariance, outputScalar );
+                              outputVectorYCovariance, outputScalar,
+                              _fit, this, maxInputSerialOfLastChange() );
 
   outputVectorYParameters->raw_V_ptr()[1] = 1.0/outputVectorYParameters->raw_V_ptr()[1];
   outputVectorYParameters->raw_V_ptr()[3] = _X0;
@@ -407,8 +422,8 @@ QStringList FitExponentialWeightedSource::outputStringList() const {
 
 
 void FitExponentialWeightedSource::saveProperties(QXmlStreamWriter &s) {
-  Q_UNUSED(s);
 //   s.writeAttribute("value", _configValue);
+  _fit->range.save(s);
 }
 
 
@@ -455,6 +470,7 @@ Kst::DataObject *FitExponentialWeightedPlugin::create(Kst::ObjectStore *store, K
     }
 
     object->setPluginName(pluginName());
+    object->_fit->range = config->_fitRangeWidget->range();
 
     object->writeLock();
     object->registerChange();
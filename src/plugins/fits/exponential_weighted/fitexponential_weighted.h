@@ -20,6 +20,8 @@
 #include <basicplugin.h>
 #include <dataobjectplugin.h>
 
+class NonLinearFit;
+
 class FitExponentialWeightedSource : public Kst::BasicPlugin {
   Q_OBJECT
 
@@ -44,6 +46,8 @@ class FitExponentialWeightedSource : public Kst::BasicPlugin {
 
     virtual void saveProperties(QXmlStreamWriter &s);
 
+    NonLinearFit *_fit;
+
   protected:
     FitExponentialWeightedSource(Kst::ObjectStore *store);
     ~FitExponentialWeightedSource();
@@ -59,7 +63,7 @@ class FitExponentialWeightedSource : public Kst::BasicPlugin {
 class FitExponentialWeightedPlugin : public QObject, public Kst::DataObjectPluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataObjectPluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.1")
   public:
     virtual ~FitExponentialWeightedPlugin() {}
 
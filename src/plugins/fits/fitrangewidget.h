@@ -0,0 +1,83 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef FITRANGEWIDGET_H
+#define FITRANGEWIDGET_H
+
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QSpinBox>
+#include <QWidget>
+
+#include <limits.h>
+
+#include "non_linear_fit.h"
+
+// The window and stride of a FitRange, as a row added at the bottom of the
+// config widget of a non-linear fit.
+class FitRangeWidget : public QWidget {
+  public:
+    explicit FitRangeWidget(QWidget *config) : QWidget(config) {
+      QHBoxLayout *row = new QHBoxLayout(this);
+      row->setContentsMargins(0, 0, 0, 0);
+
+      _window = new QSpinBox(this);
+      _window->setRange(0, INT_MAX);
+      _window->setSingleStep(1000);
+      _window->setSpecialValueText(QObject::tr("all"));
+      _window->setToolTip(QObject::tr("Only the last samples are fitted.  The fitted curve still covers them all."));
+
+      _stride = new QSpinBox(this);
+      _stride->setRange(1, INT_MAX);
+      _stride->setToolTip(QObject::tr("Of the samples fitted, only every n'th is used."));
+
+      QLabel *window = new QLabel(QObject::tr("Fit the last"), this);
+      window->setBuddy(_window);
+      QLabel *stride = new QLabel(QObject::tr("samples, every"), this);
+      stride->setBuddy(_stride);
+      row->addWidget(window);
+      row->addWidget(_window, 1);
+      row->addWidget(stride);
+      row->addWidget(_stride, 1);
+
+      if (QGridLayout *grid = qobject_cast<QGridLayout*>(config->layout())) {
+        grid->addWidget(this, grid->rowCount(), 0, 1, grid->columnCount());
+      } else if (config->layout()) {
+        config->layout()->addWidget(this);
+      }
+    }
+
+    void setupSlots(QWidget *dialog) {
+      connect(_window, SIGNAL(valueChanged(int)), dialog, SIGNAL(modified()));
+      connect(_stride, SIGNAL(valueChanged(int)), dialog, SIGNAL(modified()));
+    }
+
+    FitRange range() const {
+      FitRange r;
+      r.window = _window->value();
+      r.stride = _stride->value();
+      return r;
+    }
+
+    void setRange(const FitRange &r) {
+      _window->setValue(int(qMin(r.window, qint64(INT_MAX))));
+      _stride->setValue(r.stride);
+    }
+
+  private:
+    QSpinBox *_window;
+    QSpinBox *_stride;
+};
+
+#endif
+
+// vim: ts=2 sw=2 et
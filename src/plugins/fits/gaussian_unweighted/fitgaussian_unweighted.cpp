@@ -22,6 +22,7 @@
 
 #include <gsl/gsl_fit.h>
 #include "../non_linear.h"
+#include "../fitrangewidget.h"
 
 static const QString& VECTOR_IN_X = "X Vector";
 static const QString& VECTOR_IN_Y = "Y Vector";
@@ -38,6 +39,7 @@ class ConfigWidgetFitGaussianUnweightedPlugin : public Kst::DataObjectConfigWidg
     ConfigWidgetFitGaussianUnweightedPlugin(QSettings* cfg) : DataObjectConfigWidget(cfg), Ui_FitGaussian_UnweightedConfig() {
       _store = 0;
       setupUi(this);
+      _fitRangeWidget = new FitRangeWidget(this);
     }
 
     ~ConfigWidgetFitGaussianUnweightedPlugin() {}
@@ -53,6 +55,7 @@ class ConfigWidgetFitGaussianUnweightedPlugin : public Kst::DataObjectConfigWidg
 
     void setupSlots(QWidget* dialog) {
       if (dialog) {
+        _fitRangeWidget->setupSlots(dialog);
         connect(_vectorX, SIGNAL(selectionChanged(QString)), dialog, SIGNAL(modified()));
         connect(_vectorY, SIGNAL(selectionChanged(QString)), dialog, SIGNAL(modified()));
         connect(_scalarOffset, SIGNAL(selectionChanged(QString)), dialog, SIGNAL(modified()));
@@ -91,6 +94,7 @@ class ConfigWidgetFitGaussianUnweightedPlugin : public Kst::DataObjectConfigWidg
         setSelectedVectorY(source->vectorY());
         _forceOffset->setChecked(source->_forceOffset);
         setScalarOffset(source->scalarOffset());
+        _fitRangeWidget->setRange(source->_fit->range);
       }
     }
 
@@ -117,6 +121,10 @@ class ConfigWidgetFitGaussianUnweightedPlugin : public Kst::DataObjectConfigWidg
 
 //      }
 
+      FitRange range;
+      range.load(attrs);
+      _fitRangeWidget->setRange(range);
+
       return validTag;
     }
 
@@ -163,6 +171,9 @@ class ConfigWidgetFitGaussianUnweightedPlugin : public Kst::DataObjectConfigWidg
       }
     }
 
+  public:
+    FitRangeWidget *_fitRangeWidget;
+
   private:
     Kst::ObjectStore *_store;
 
@@ -171,11 +182,13 @@ class ConfigWidgetFitGaussianUnweightedPlugin : public Kst::DataObjectConfigWidg
 
 FitGaussianUnweightedSource::FitGaussianUnweightedSource(Kst::ObjectStore *store)
 : Kst::BasicPlugin(store) {
+  _fit = new NonLinearFit;
   _forceOffset = false;
 }
 
 
 FitGaussianUnweightedSource::~FitGaussianUnweightedSource() {
+  delete _fit;
 }
 
 
@@ -191,6 +204,8 @@ void FitGaussianUnweightedSource::change(Kst::DataObjectConfigWidget *configWidg
     setInputScalar(SCALAR_IN_OFFSET, config->scalarOffset());
     _forceOffset = config->_forceOffset->isChecked();
 //    _offset = config->_scalarOffset->selectedScalar();
+    _fit->range = config->_fitRangeWidget->range();
+    _fit->reset();
   }
 }
 
@@ -332,7 +347,8 @@ bool FitGaussianUnweightedSource::algorithm() {
 
   bReturn = kstfit_nonlinear( inputVectorX, inputVectorY,
                               outputVectorYFitted, outputVectorYResiduals, outputVectorYParameters,
-                              outputVectorYCovariance, outputScalar );
+                              outputVectorYCovariance, outputScalar,
+                              _fit, this, maxInputSerialOfLastChange() );
   return bReturn;
 }
 
@@ -394,6 +410,7 @@ void FitGaussianUnweightedSource::saveProperties(QXmlStreamWriter &s) {
   QString force_offset;
   force_offset.setNum(_forceOffset);
   s.writeAttribute("ForceOffset", force_offset);
+  _fit->range.save(s);
 }
 
 
@@ -441,6 +458,7 @@ Kst::DataObject *FitGaussianUnweightedPlugin::create(Kst::ObjectStore *store, Ks
     }
 
     object->setPluginName(pluginName());
+    object->_fit->range = config->_fitRangeWidget->range();
 
     object->writeLock();
     object->registerChange();
@@ -20,6 +20,8 @@
 #include <basicplugin.h>
 #include <dataobjectplugin.h>
 
+class NonLinearFit;
+
 class FitGaussianUnweightedSource : public Kst::BasicPlugin {
   Q_OBJECT
 
@@ -44,6 +46,7 @@ class FitGaussianUnweightedSource : public Kst::BasicPlugin {
 
     virtual void saveProperties(QXmlStreamWriter &s);
     bool _forceOffset;
+    NonLinearFit *_fit;
 
   protected:
     FitGaussianUnweightedSource(Kst::ObjectStore *store);
@@ -60,7 +63,7 @@ class FitGaussianUnweightedSource : public Kst::BasicPlugin {
 class FitGaussianUnweightedPlugin : public QObject, public Kst::DataObjectPluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataObjectPluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.1")
   public:
     virtual ~FitGaussianUnweightedPlugin() {}
 
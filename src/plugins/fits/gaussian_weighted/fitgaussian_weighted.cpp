@@ -22,6 +22,7 @@
 
 #include <gsl/gsl_fit.h>
 #include "../non_linear_weighted.h"
+#include "../fitrangewidget.h"
 
 static const QString& VECTOR_IN_X = "X Vector";
 static const QString& VECTOR_IN_Y = "Y Vector";
@@ -39,6 +40,7 @@ class ConfigWidgetFitGaussianWeightedPlugin : public Kst::DataObjectConfigWidget
     ConfigWidgetFitGaussianWeightedPlugin(QSettings* cfg) : DataObjectConfigWidget(cfg), Ui_FitGaussian_WeightedConfig() {
       _store = 0;
       setupUi(this);
+      _fitRangeWidget = new FitRangeWidget(this);
     }
 
     ~ConfigWidgetFitGaussianWeightedPlugin() {}
@@ -57,6 +59,7 @@ class ConfigWidgetFitGaussianWeightedPlugin : public Kst::DataObjectConfigWidget
 
     void setupSlots(QWidget* dialog) {
       if (dialog) {
+        _fitRangeWidget->setupSlots(dialog);
         connect(_vectorX, SIGNAL(selectionChanged(QString)), dialog, SIGNAL(modified()));
         connect(_vectorY, SIGNAL(selectionChanged(QString)), dialog, SIGNAL(modified()));
         connect(_vectorWeights, SIGNAL(selectionChanged(QString)), dialog, SIGNAL(modified()));
@@ -99,6 +102,7 @@ class ConfigWidgetFitGaussianWeightedPlugin : public Kst::DataObjectConfigWidget
         setSelectedVectorWeights(source->vectorWeights());
         _forceOffset->setChecked(source->_forceOffset);
         setScalarOffset(source->scalarOffset());
+        _fitRangeWidget->setRange(source->_fit->range);
       }
     }
 
@@ -125,6 +129,10 @@ class ConfigWidgetFitGaussianWeightedPlugin : public Kst::DataObjectConfigWidget
 //        }
 //      }
 
+      FitRange range;
+      range.load(attrs);
+      _fitRangeWidget->setRange(range);
+
       return validTag;
     }
 
@@ -179,6 +187,9 @@ class ConfigWidgetFitGaussianWeightedPlugin : public Kst::DataObjectConfigWidget
       }
     }
 
+  public:
+    FitRangeWidget *_fitRangeWidget;
+
   private:
     Kst::ObjectStore *_store;
 
@@ -187,11 +198,13 @@ class ConfigWidgetFitGaussianWeightedPlugin : public Kst::DataObjectConfigWidget
 
 FitGaussianWeightedSource::FitGaussianWeightedSource(Kst::ObjectStore *store)
 : Kst::BasicPlugin(store) {
+  _fit = new NonLinearFit;
   _forceOffset = false;
 }
 
 
 FitGaussianWeightedSource::~FitGaussianWeightedSource() {
+  delete _fit;
 }
 
 
@@ -207,6 +220,8 @@ void FitGaussianWeightedSource::change(Kst::DataObjectConfigWidget *configWidget
     setInputVector(VECTOR_IN_WEIGHTS, config->selectedVectorWeights());
     setInputScalar(SCALAR_IN_OFFSET, config->scalarOffset());
     _forceOffset = config->_forceOffset->isChecked();
+    _fit->range = config->_fitRangeWidget->range();
+    _fit->reset();
   }
 }
 
@@ -350,7 +365,8 @@ bool FitGaussianWeightedSource::algorithm() {
 
   bReturn = kstfit_nonlinear_weighted( inputVectorX, inputVectorY, inputVectorWeights,
                               outputVectorYFitted, outputVectorYResiduals, outputVectorYParameters,
-                              outputVectorYCovariance, outputScalar );
+                              outputVectorYCovariance, outputScalar,
+                              _fit, this, maxInputSerialOfLastChange() );
   return bReturn;
 }
 
@@ -416,6 +432,7 @@ void FitGaussianWeightedSource::saveProperties(QXmlStreamWriter &s) {
   QString force_offset;
   force_offset.setNum(_forceOffset);
   s.writeAttribute("ForceOffset", force_offset);
+  _fit->range.save(s);
 }
 
 
@@ -464,6 +481,7 @@ Kst::DataObject *FitGaussianWeightedPlugin::create(Kst::ObjectStore *store, Kst:
     }
 
     object->setPluginName(pluginName());
+    object->_fit->range = config->_fitRangeWidget->range();
 
     object->writeLock();
     object->registerChange();
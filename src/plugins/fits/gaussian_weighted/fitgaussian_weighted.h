@@ -20,6 +20,8 @@
 #include <basicplugin.h>
 #include <dataobjectplugin.h>
 
+class NonLinearFit;
+
 class FitGaussianWeightedSource : public Kst::BasicPlugin {
   Q_OBJECT
 
@@ -45,6 +47,7 @@ class FitGaussianWeightedSource : public Kst::BasicPlugin {
 
     virtual void saveProperties(QXmlStreamWriter &s);
     bool _forceOffset;
+    NonLinearFit *_fit;
 
   protected:
     FitGaussianWeightedSource(Kst::ObjectStore *store);
@@ -61,7 +64,7 @@ class FitGaussianWeightedSource : public Kst::BasicPlugin {
 class FitGaussianWeightedPlugin : public QObject, public Kst::DataObjectPluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataObjectPluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.1")
   public:
     virtual ~FitGaussianWeightedPlugin() {}
 
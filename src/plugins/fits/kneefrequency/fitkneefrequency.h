@@ -61,7 +61,7 @@ class FitKneeFrequencySource : public Kst::BasicPlugin {
 class FitKneeFrequencyPlugin : public QObject, public Kst::DataObjectPluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataObjectPluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.1")
   public:
     virtual ~FitKneeFrequencyPlugin() {}
 
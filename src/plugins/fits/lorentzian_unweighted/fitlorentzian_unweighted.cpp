@@ -22,6 +22,7 @@
 
 #include <gsl/gsl_fit.h>
 #include "../non_linear.h"
+#include "../fitrangewidget.h"
 
 static const QString& VECTOR_IN_X = "X Vector";
 static const QString& VECTOR_IN_Y = "Y Vector";
@@ -36,6 +37,7 @@ class ConfigWidgetFitLorentzianUnweightedPlugin : public Kst::DataObjectConfigWi
     ConfigWidgetFitLorentzianUnweightedPlugin(QSettings* cfg) : DataObjectConfigWidget(cfg), Ui_FitLorentzian_UnweightedConfig() {
       _store = 0;
       setupUi(this);
+      _fitRangeWidget = new FitRangeWidget(this);
     }
 
     ~ConfigWidgetFitLorentzianUnweightedPlugin() {}
@@ -48,6 +50,7 @@ class ConfigWidgetFitLorentzianUnweightedPlugin : public Kst::DataObjectConfigWi
 
     void setupSlots(QWidget* dialog) {
       if (dialog) {
+        _fitRangeWidget->setupSlots(dialog);
         connect(_vectorX, SIGNAL(selectionChanged(QString)), dialog, SIGNAL(modified()));
         connect(_vectorY, SIGNAL(selectionChanged(QString)), dialog, SIGNAL(modified()));
       }
@@ -77,12 +80,12 @@ class ConfigWidgetFitLorentzianUnweightedPlugin : public Kst::DataObjectConfigWi
       if (FitLorentzianUnweightedSource* source = static_cast<FitLorentzianUnweightedSource*>(dataObject)) {
         setSelectedVectorX(source->vectorX());
         setSelectedVectorY(source->vectorY());
+        _fitRangeWidget->setRange(source->_fit->range);
       }
     }
 
     virtual bool configurePropertiesFromXml(Kst::ObjectStore *store, QXmlStreamAttributes& attrs) {
       Q_UNUSED(store);
-      Q_UNUSED(attrs);
 
       bool validTag = true;
 
@@ -92,6 +95,10 @@ class ConfigWidgetFitLorentzianUnweightedPlugin : public Kst::DataObjectConfigWi
 //         _configValue = QVariant(av.toString()).toBool();
 //       }
 
+      FitRange range;
+      range.load(attrs);
+      _fitRangeWidget->setRange(range);
+
       return validTag;
     }
 
@@ -124,6 +131,9 @@ class ConfigWidgetFitLorentzianUnweightedPlugin : public Kst::DataObjectConfigWi
       }
     }
 
+  public:
+    FitRangeWidget *_fitRangeWidget;
+
   private:
     Kst::ObjectStore *_store;
 
@@ -132,10 +142,12 @@ class ConfigWidgetFitLorentzianUnweightedPlugin : public Kst::DataObjectConfigWi
 
 FitLorentzianUnweightedSource::FitLorentzianUnweightedSource(Kst::ObjectStore *store)
 : Kst::BasicPlugin(store) {
+  _fit = new NonLinearFit;
 }
 
 
 FitLorentzianUnweightedSource::~FitLorentzianUnweightedSource() {
+  delete _fit;
 }
 
 
@@ -148,6 +160,8 @@ void FitLorentzianUnweightedSource::change(Kst::DataObjectConfigWidget *configWi
   if (ConfigWidgetFitLorentzianUnweightedPlugin* config = static_cast<ConfigWidgetFitLorentzianUnweightedPlugin*>(configWidget)) {
     setInputVector(VECTOR_IN_X, config->selectedVectorX());
     setInputVector(VECTOR_IN_Y, config->selectedVectorY());
+    _fit->range = config->_fitRangeWidget->range();
+    _fit->reset();
   }
 }
 
@@ -270,7 +284,8 @@ bool FitLorentzianUnweightedSource::algorithm() {
 
   bReturn = kstfit_nonlinear( inputVectorX, inputVectorY,
                               outputVectorYFitted, outputVectorYResiduals, outputVectorYParameters,
-                              outputVectorYCovariance, outputScalar );
+                              outputVectorYCovariance, outputScalar,
+                              _fit, this, maxInputSerialOfLastChange() );
   return bReturn;
 }
 
@@ -323,8 +338,8 @@ QStringList FitLorentzianUnweightedSource::outputStringList() const {
 
 
 void FitLorentzianUnweightedSource::saveProperties(QXmlStreamWriter &s) {
-  Q_UNUSED(s);
 //   s.writeAttribute("value", _configValue);
+  _fit->range.save(s);
 }
 
 
@@ -367,6 +382,7 @@ Kst::DataObject *FitLorentzianUnweightedPlugin::create(Kst::ObjectStore *store,
     }
 
     object->setPluginName(pluginName());
+    object->_fit->range = config->_fitRangeWidget->range();
 
     object->writeLock();
     object->registerChange();
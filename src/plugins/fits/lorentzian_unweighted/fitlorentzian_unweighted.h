@@ -20,6 +20,8 @@
 #include <basicplugin.h>
 #include <dataobjectplugin.h>
 
+class NonLinearFit;
+
 class FitLorentzianUnweightedSource : public Kst::BasicPlugin {
   Q_OBJECT
 
@@ -43,6 +45,8 @@ class FitLorentzianUnweightedSource : public Kst::BasicPlugin {
 
     virtual void saveProperties(QXmlStreamWriter &s);
 
+    NonLinearFit *_fit;
+
   protected:
     FitLorentzianUnweightedSource(Kst::ObjectStore *store);
     ~FitLorentzianUnweightedSource();
@@ -58,7 +62,7 @@ class FitLorentzianUnweightedSource : public Kst::BasicPlugin {
 class FitLorentzianUnweightedPlugin : public QObject, public Kst::DataObjectPluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataObjectPluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.1")
   public:
     virtual ~FitLorentzianUnweightedPlugin() {}
 
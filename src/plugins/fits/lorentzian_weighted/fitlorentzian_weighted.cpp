@@ -22,6 +22,7 @@
 
 #include <gsl/gsl_fit.h>
 #include "../non_linear_weighted.h"
+#include "../fitrangewidget.h"
 
 static const QString& VECTOR_IN_X = "X Vector";
 static const QString& VECTOR_IN_Y = "Y Vector";
@@ -37,6 +38,7 @@ class ConfigWidgetFitLorentzianWeightedPlugin : public Kst::DataObjectConfigWidg
     ConfigWidgetFitLorentzianWeightedPlugin(QSettings* cfg) : DataObjectConfigWidget(cfg), Ui_FitLorentzian_WeightedConfig() {
       _store = 0;
       setupUi(this);
+      _fitRangeWidget = new FitRangeWidget(this);
     }
 
     ~ConfigWidgetFitLorentzianWeightedPlugin() {}
@@ -50,6 +52,7 @@ class ConfigWidgetFitLorentzianWeightedPlugin : public Kst::DataObjectConfigWidg
 
     void setupSlots(QWidget* dialog) {
       if (dialog) {
+        _fitRangeWidget->setupSlots(dialog);
         connect(_vectorX, SIGNAL(selectionChanged(QString)), dialog, SIGNAL(modified()));
         connect(_vectorY, SIGNAL(selectionChanged(QString)), dialog, SIGNAL(modified()));
         connect(_vectorWeights, SIGNAL(selectionChanged(QString)), dialog, SIGNAL(modified()));
@@ -83,12 +86,12 @@ class ConfigWidgetFitLorentzianWeightedPlugin : public Kst::DataObjectConfigWidg
         setSelectedVectorX(source->vectorX());
         setSelectedVectorY(source->vectorY());
         setSelectedVectorWeights(source->vectorWeights());
+        _fitRangeWidget->setRange(source->_fit->range);
       }
     }
 
     virtual bool configurePropertiesFromXml(Kst::ObjectStore *store, QXmlStreamAttributes& attrs) {
       Q_UNUSED(store);
-      Q_UNUSED(attrs);
 
       bool validTag = true;
 
@@ -98,6 +101,10 @@ class ConfigWidgetFitLorentzianWeightedPlugin : public Kst::DataObjectConfigWidg
 //         _configValue = QVariant(av.toString()).toBool();
 //       }
 
+      FitRange range;
+      range.load(attrs);
+      _fitRangeWidget->setRange(range);
+
       return validTag;
     }
 
@@ -137,6 +144,9 @@ class ConfigWidgetFitLorentzianWeightedPlugin : public Kst::DataObjectConfigWidg
       }
     }
 
+  public:
+    FitRangeWidget *_fitRangeWidget;
+
   private:
     Kst::ObjectStore *_store;
 
@@ -145,10 +155,12 @@ class ConfigWidgetFitLorentzianWeightedPlugin : public Kst::DataObjectConfigWidg
 
 FitLorentzianWeightedSource::FitLorentzianWeightedSource(Kst::ObjectStore *store)
 : Kst::BasicPlugin(store) {
+  _fit = new NonLinearFit;
 }
 
 
 FitLorentzianWeightedSource::~FitLorentzianWeightedSource() {
+  delete _fit;
 }
 
 
@@ -162,6 +174,8 @@ void FitLorentzianWeightedSource::change(Kst::DataObjectConfigWidget *configWidg
     setInputVector(VECTOR_IN_X, config->selectedVectorX());
     setInputVector(VECTOR_IN_Y, config->selectedVectorY());
     setInputVector(VECTOR_IN_WEIGHTS, config->selectedVectorWeights());
+    _fit->range = config->_fitRangeWidget->range();
+    _fit->reset();
   }
 }
 
@@ -244,7 +258,8 @@ bool FitLorentzianWeightedSource::algorithm() {
 
   bReturn = kstfit_nonlinear_weighted( inputVectorX, inputVectorY, inputVectorWeights,
                               outputVectorYFitted, outputVectorYResiduals, outputVectorYParameters,
-                              outputVectorYCovariance, outputScalar );
+                              outputVectorYCovariance, outputScalar,
+                              _fit, this, maxInputSerialOfLastChange() );
   return bReturn;
 }
 
@@ -303,8 +318,8 @@ QStringList FitLorentzianWeightedSource::outputStringList() const {
 
 
 void FitLorentzianWeightedSource::saveProperties(QXmlStreamWriter &s) {
-  Q_UNUSED(s);
 //   s.writeAttribute("value", _configValue);
+  _fit->range.save(s);
 }
 
 
@@ -345,6 +360,7 @@ Kst::DataObject *FitLorentzianWeightedPlugin::create(Kst::ObjectStore *store, Ks
     }
 
     object->setPluginName(pluginName());
+    object->_fit->range = config->_fitRangeWidget->range();
 
     object->writeLock();
     object->registerChange();
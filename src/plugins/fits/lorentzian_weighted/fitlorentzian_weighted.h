@@ -20,6 +20,8 @@
 #include <basicplugin.h>
 #include <dataobjectplugin.h>
 
+class NonLinearFit;
+
 class FitLorentzianWeightedSource : public Kst::BasicPlugin {
   Q_OBJECT
 
@@ -44,6 +46,8 @@ class FitLorentzianWeightedSource : public Kst::BasicPlugin {
 
     virtual void saveProperties(QXmlStreamWriter &s);
 
+    NonLinearFit *_fit;
+
   protected:
     FitLorentzianWeightedSource(Kst::ObjectStore *store);
     ~FitLorentzianWeightedSource();
@@ -59,7 +63,7 @@ class FitLorentzianWeightedSource : public Kst::BasicPlugin {
 class FitLorentzianWeightedPlugin : public QObject, public Kst::DataObjectPluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataObjectPluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.1")
   public:
     virtual ~FitLorentzianWeightedPlugin() {}
 
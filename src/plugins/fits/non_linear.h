@@ -23,6 +23,7 @@
 #include <gsl/gsl_statistics.h>
 #include <gsl/gsl_version.h>
 #include "common.h"
+#include "non_linear_fit.h"
 
 struct data {
   int	n;
@@ -30,8 +31,9 @@ struct data {
   const double* pdY;
 };
 
-int n_params = NUM_PARAMS;
-double offset_ = 0.0;
+// per thread, as a fit may run in a worker thread (see NonLinearFit)
+thread_local int n_params = NUM_PARAMS;
+thread_local double offset_ = 0.0;
 
 void function_initial_estimate( const double* pdX, const double* pdY, int iLength, double* pdParameterEstimates );
 double function_calculate( double dX, double* pdParameters );
@@ -43,7 +45,7 @@ bool kstfit_nonlinear(
   Kst::VectorPtr xVector, Kst::VectorPtr yVector,
   Kst::VectorPtr vectorOutYFitted, Kst::VectorPtr vectorOutYResiduals,
   Kst::VectorPtr vectorOutYParameters, Kst::VectorPtr vectorOutYCovariance,
-  Kst::ScalarPtr scalarOutChi );
+  Kst::ScalarPtr scalarOutChi, NonLinearFit* pFit, Kst::Object* pOwner, qint64 iStamp );
 
 
 int function_f( const gsl_vector* pVectorX, void* pParams, gsl_vector* pVectorF ) {
@@ -96,161 +98,183 @@ int function_fdf( const gsl_vector* pVectorX, void* pParams, gsl_vector* pVector
 }
 
 
+bool kstfit_nonlinear_solve( NonLinearFit* pFit, const double* pdX, const double* pdY, int iLength,
+                             NonLinearFit::Result* pResult ) {
+  gsl_multifit_function_fdf function;
+  struct data d;
+  double dXInitial[NUM_PARAMS];
+
+  d.n      = iLength;
+  d.pdX    = pdX;
+  d.pdY    = pdY;
+
+  function.f      = function_f;
+  function.df     = function_df;
+  function.fdf    = function_fdf;
+  function.n      = iLength;
+  function.p      = n_params;
+  function.params = &d;
+
+  function_initial_estimate( pdX, pdY, iLength, dXInitial );
+
+  return pFit->solve( &function, dXInitial, 1.0e-6, MAX_NUM_ITERATIONS, pResult );
+}
+
+
 bool kstfit_nonlinear(
   Kst::VectorPtr xVector, Kst::VectorPtr yVector,
   Kst::VectorPtr vectorOutYFitted, Kst::VectorPtr vectorOutYResiduals,
   Kst::VectorPtr vectorOutYParameters, Kst::VectorPtr vectorOutYCovariance,
-  Kst::ScalarPtr scalarOutChi ) {
-
-  const gsl_multifit_fdfsolver_type* pType;
-  gsl_multifit_fdfsolver* pSolver;
-  gsl_multifit_function_fdf	function;
-  gsl_vector_view vectorViewInitial;
-  gsl_matrix* pMatrixCovariance;
-  gsl_matrix *pMatrixJacobian;
-  struct data d;  
-  double dXInitial[NUM_PARAMS];
-  double* pInputX;
-  double* pInputY;
-  int iIterations = 0;
+  Kst::ScalarPtr scalarOutChi, NonLinearFit* pFit, Kst::Object* pOwner, qint64 iStamp ) {
+
+  NonLinearFit::Result result;
+  double dParameters[NUM_PARAMS];
+  const double* pdX;
+  const double* pdY;
+  qint64 iFirst;
+  qint64 iCount;
   int iLength;
-  bool bReturn = false;
-  int iStatus;
   int i;
   int j;
 
-  if (xVector->length() >= 2 &&
-      yVector->length() >= 2 ) {
-    iLength = yVector->length();
-    if( xVector->length() > iLength ) {
-      iLength = xVector->length();
+  if (xVector->length() < 2 ||
+      yVector->length() < 2 ) {
+    return false;
+  }
+
+  iLength = yVector->length();
+  if( xVector->length() > iLength ) {
+    iLength = xVector->length();
+  }
+  if( iLength <= NUM_PARAMS ) {
+    return false;
+  }
+
+  pFit->x.resize(iLength);
+  pFit->y.resize(iLength);
+  double* pInputX = pFit->x.data();
+  double* pInputY = pFit->y.data();
+
+  double const *v_x = xVector->noNanValue();
+  double const *v_y = yVector->noNanValue();
+
+  if (xVector->length() == iLength) {
+    for( i=0; i<iLength; i++) {
+      pInputX[i] = v_x[i];
+    }
+  } else {
+    for( i=0; i<iLength; i++) {
+      pInputX[i] = interpolate( i, iLength, v_x, xVector->length() );
     }
+  }
 
-    pInputX = (double*)malloc(iLength * sizeof( double ));
+  if (yVector->length() == iLength) {
+    for( i=0; i<iLength; i++) {
+      pInputY[i] = v_y[i];
+    }
+  } else {
+    for( i=0; i<iLength; i++) {
+      pInputY[i] = interpolate( i, iLength, v_y, yVector->length() );
+    }
+  }
 
-    double const *v_x = xVector->noNanValue();
-    double const *v_y = yVector->noNanValue();
+  //
+  // pick the samples to fit...
+  //
+  pFit->select( iLength, n_params, &iFirst, &iCount );
+  if (pFit->range.stride > 1 && iCount < iLength) {
+    pFit->fitX.resize(iCount);
+    pFit->fitY.resize(iCount);
+    for( i=0; i<iCount; i++ ) {
+      pFit->fitX[i] = pInputX[iFirst + i*pFit->range.stride];
+      pFit->fitY[i] = pInputY[iFirst + i*pFit->range.stride];
+    }
+    pdX = pFit->fitX.constData();
+    pdY = pFit->fitY.constData();
+  } else {
+    pdX = pInputX + iFirst;
+    pdY = pInputY + iFirst;
+  }
 
-    if (xVector->length() == iLength) {
-      for( i=0; i<iLength; i++) {
-        pInputX[i] = v_x[i];
-      }
-    } else {
-      for( i=0; i<iLength; i++) {
-        pInputX[i] = interpolate( i, iLength, v_x, xVector->length() );
+  //
+  // long fits run in a worker thread: until one is done, the last fit stays
+  // up, and the fit is then redone if the inputs have changed since it began...
+  //
+  if (pOwner && (pFit->busy() || iCount >= NonLinearFit::BackgroundSamples)) {
+    bool bTaken = false;
+    if (pFit->busy()) {
+      if (!pFit->finished()) {
+        return true;
       }
+      bTaken = pFit->take( &result ) && result.parameters.size() == n_params;
+    }
+    if (pFit->stale(iStamp) && iCount >= NonLinearFit::BackgroundSamples) {
+      const QVector<double> fitX(pdX, pdX + iCount);
+      const QVector<double> fitY(pdY, pdY + iCount);
+      const int iParams = n_params;
+      const double dOffset = offset_;
+      pFit->start( [pFit, fitX, fitY, iParams, dOffset](NonLinearFit::Result* pResult) {
+        n_params = iParams;
+        offset_ = dOffset;
+        return kstfit_nonlinear_solve( pFit, fitX.constData(), fitY.constData(), fitX.size(), pResult );
+      }, pOwner, iStamp );
     }
+    if (!bTaken) {
+      return true;
+    }
+  } else if (!kstfit_nonlinear_solve( pFit, pdX, pdY, iCount, &result )) {
+    return false;
+  }
 
-    pInputY = (double*)malloc(iLength * sizeof( double ));
-    if (yVector->length() == iLength) {
-      for( i=0; i<iLength; i++) {
-        pInputY[i] = v_y[i];
-      }
+  //
+  // keep the last fit up rather than one that didn't converge...
+  //
+  if (!result.converged && pFit->good()) {
+    return true;
+  }
+  pFit->setGood( result.converged );
+
+  vectorOutYFitted->resize(iLength);
+  vectorOutYResiduals->resize(iLength);
+  vectorOutYParameters->resize(NUM_PARAMS);
+  vectorOutYCovariance->resize(NUM_PARAMS * NUM_PARAMS);
+
+  //
+  // determine the fitted values...
+  //
+  for( i=0; i<n_params; i++ ) {
+    dParameters[i] = result.parameters[i];
+  }
+
+  for( i=0; i<iLength; i++ ) {
+    vectorOutYFitted->raw_V_ptr()[i] = function_calculate( pInputX[i], dParameters );
+    vectorOutYResiduals->raw_V_ptr()[i] = pInputY[i] - vectorOutYFitted->raw_V_ptr()[i];
+  }
+
+  //
+  // fill in the parameter values and covariance matrix...
+  //
+  for( i=0; i<NUM_PARAMS; i++ ) {
+    if (i<n_params) {
+      vectorOutYParameters->raw_V_ptr()[i] = result.parameters[i];
     } else {
-      for( i=0; i<iLength; i++) {
-        pInputY[i] = interpolate( i, iLength, v_y, yVector->length() );
-      }
+      vectorOutYParameters->raw_V_ptr()[i] = offset_;
     }
-
-    if( iLength > NUM_PARAMS ) {
-      vectorOutYFitted->resize(iLength);
-      vectorOutYResiduals->resize(iLength);
-      vectorOutYParameters->resize(NUM_PARAMS);
-      vectorOutYCovariance->resize(NUM_PARAMS * NUM_PARAMS);
-
-      pType   = gsl_multifit_fdfsolver_lmsder;
-      pSolver = gsl_multifit_fdfsolver_alloc( pType, iLength, n_params );
-      if( pSolver != NULL ) {
-        d.n      = iLength;
-        d.pdX	   = pInputX;
-        d.pdY    = pInputY;
-
-        function.f   	  = function_f;
-        function.df  	  = function_df;
-        function.fdf 	  = function_fdf;
-        function.n   	  = iLength;
-        function.p   	  = n_params;
-        function.params = &d;
-
-        pMatrixCovariance = gsl_matrix_alloc( n_params, n_params );
-        if( pMatrixCovariance != NULL ) {
-          function_initial_estimate( pInputX, pInputY, iLength, dXInitial );
-          vectorViewInitial = gsl_vector_view_array( dXInitial, n_params );
-
-          gsl_multifit_fdfsolver_set( pSolver, &function, &vectorViewInitial.vector );
-
-          //
-          // iterate to a solution...
-          //
-          do {
-            iStatus = gsl_multifit_fdfsolver_iterate( pSolver );
-            if( iStatus == GSL_SUCCESS ) {
-              iStatus = gsl_multifit_test_delta( pSolver->dx, pSolver->x, 1.0e-6, 1.0e-6 );
-            }
-            iIterations++;
-          } while( iStatus == GSL_CONTINUE && iIterations < MAX_NUM_ITERATIONS );
-#if GSL_MAJOR_VERSION >= 2
-          pMatrixJacobian = gsl_matrix_alloc( iLength, n_params );
-#else
-          pMatrixJacobian = pSolver->J;
-#endif
-          if ( pMatrixJacobian != NULL) {
-#if GSL_MAJOR_VERSION >= 2
-            gsl_multifit_fdfsolver_jac( pSolver, pMatrixJacobian );
-#endif
-            gsl_multifit_covar( pMatrixJacobian, 0.0, pMatrixCovariance );
-
-            //
-            // determine the fitted values...
-            //
-            for( i=0; i<n_params; i++ ) {
-              dXInitial[i] = gsl_vector_get( pSolver->x, i );
-            }
-
-            for( i=0; i<iLength; i++ ) {
-              vectorOutYFitted->raw_V_ptr()[i] = function_calculate( pInputX[i], dXInitial );
-              vectorOutYResiduals->raw_V_ptr()[i] = pInputY[i] - vectorOutYFitted->raw_V_ptr()[i];
-            }
-
-            //
-            // fill in the parameter values and covariance matrix...
-            //
-            for( i=0; i<NUM_PARAMS; i++ ) {
-              if (i<n_params) {
-                vectorOutYParameters->raw_V_ptr()[i] = gsl_vector_get( pSolver->x, i );
-              } else {
-                vectorOutYParameters->raw_V_ptr()[i] = offset_;
-              }
-              for( j=0; j<NUM_PARAMS; j++ ) {
-                if ((i<n_params) && (j<n_params)) {
-                  vectorOutYCovariance->raw_V_ptr()[(i*n_params)+j] = gsl_matrix_get( pMatrixCovariance, i, j );
-                } else {
-                  vectorOutYCovariance->raw_V_ptr()[(i*n_params)+j] = 0.0;
-                }
-              }
-            }
-
-            //
-            // determine the value of chi^2/nu
-            //
-            scalarOutChi->setValue(gsl_blas_dnrm2( pSolver->f ));
-
-            bReturn = true;
-            
-#if GSL_MAJOR_VERSION >= 2
-            gsl_matrix_free( pMatrixJacobian );
-#endif
-          }
-          gsl_matrix_free( pMatrixCovariance );
-        }
-        gsl_multifit_fdfsolver_free( pSolver );
+    for( j=0; j<NUM_PARAMS; j++ ) {
+      if ((i<n_params) && (j<n_params)) {
+        vectorOutYCovariance->raw_V_ptr()[(i*n_params)+j] = result.covariance[(i*n_params)+j];
+      } else {
+        vectorOutYCovariance->raw_V_ptr()[(i*n_params)+j] = 0.0;
       }
     }
-    free( pInputX );
-    free( pInputY );
   }
 
-  return bReturn;
+  //
+  // determine the value of chi^2/nu
+  //
+  scalarOutChi->setValue(result.chi);
+
+  return true;
 }
 
 #endif
@@ -0,0 +1,274 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef NON_LINEAR_FIT_H
+#define NON_LINEAR_FIT_H
+
+#include <QCoreApplication>
+#include <QFuture>
+#include <QMutex>
+#include <QPointer>
+#include <QVector>
+#include <QXmlStreamAttributes>
+#include <QXmlStreamWriter>
+#include <QtConcurrentRun>
+
+#include <gsl/gsl_blas.h>
+#include <gsl/gsl_multifit_nlin.h>
+#include <gsl/gsl_version.h>
+
+#include "object.h"
+#include "updatemanager.h"
+
+// Which samples a non-linear fit uses: only the last window of them (0: all
+// of them), and of those every stride'th.  The fitted curve still covers
+// them all.
+struct FitRange {
+  FitRange() : window(0), stride(1) {}
+
+  void load(const QXmlStreamAttributes &attrs) {
+    QStringView av = attrs.value("FitWindow");
+    if (!av.isNull()) {
+      window = qMax(av.toString().toLongLong(), qint64(0));
+    }
+    av = attrs.value("FitStride");
+    if (!av.isNull()) {
+      stride = qMax(av.toString().toInt(), 1);
+    }
+  }
+
+  // left out when all samples are fitted
+  void save(QXmlStreamWriter &s) const {
+    if (window > 0) {
+      s.writeAttribute("FitWindow", QString::number(window));
+    }
+    if (stride > 1) {
+      s.writeAttribute("FitStride", QString::number(stride));
+    }
+  }
+
+  qint64 window;
+  int stride;
+};
+
+
+// What a non-linear fit keeps from one update to the next: the solver and
+// its matrices, reused while the size of the problem holds; the parameters
+// of the last fit that converged, from which the next one starts; and the
+// fit running in a worker thread, when there are too many samples to fit
+// in the update.
+class NonLinearFit {
+  public:
+    struct Result {
+      QVector<double> parameters;
+      QVector<double> covariance; // p x p, row major
+      double chi;
+      bool converged;
+    };
+
+    // fits of more samples than this run in a worker thread
+    static const qint64 BackgroundSamples = 1 << 16;
+
+    NonLinearFit() : _solver(0), _covariance(0), _jacobian(0),
+                     _n(0), _p(0), _busy(false), _started(false), _ok(false), _stamp(0), _good(false) {}
+
+    ~NonLinearFit() {
+      _job.waitForFinished();
+      release();
+    }
+
+    FitRange range;
+
+    // the inputs, interpolated to a common length, and the strided samples
+    // to fit; kept to save allocating them every update
+    QVector<double> x, y, weights;
+    QVector<double> fitX, fitY, fitWeights;
+
+    // The first sample to fit, and how many, of length; all of them if what
+    // is left would not pin down p parameters.
+    void select(qint64 length, int p, qint64 *first, qint64 *count) const {
+      const int step = qMax(range.stride, 1);
+      *first = (range.window > 0 && range.window < length) ? length - range.window : 0;
+      *count = (length - *first + step - 1) / step;
+      if (*count <= p) {
+        *first = 0;
+        *count = length;
+      }
+    }
+
+    // Iterates to a solution of function: from the last converged parameters
+    // if there are as many, otherwise from initial.  A warm start that does
+    // not converge is tried again from initial.
+    bool solve(gsl_multifit_function_fdf *function, const double *initial,
+               double tolerance, int maxIterations, Result *result) {
+      const size_t p = function->p;
+      if (!allocate(function->n, p)) {
+        return false;
+      }
+
+      bool warm = _last.size() == int(p);
+      int status;
+      for (;;) {
+        gsl_vector_const_view start = gsl_vector_const_view_array(warm ? _last.constData() : initial, p);
+        gsl_multifit_fdfsolver_set(_solver, function, &start.vector);
+
+        int iterations = 0;
+        do {
+          status = gsl_multifit_fdfsolver_iterate(_solver);
+          if (status == GSL_SUCCESS) {
+            status = gsl_multifit_test_delta(_solver->dx, _solver->x, tolerance, tolerance);
+          }
+          iterations++;
+        } while (status == GSL_CONTINUE && iterations < maxIterations);
+
+        if (status == GSL_SUCCESS || !warm) {
+          break;
+        }
+        warm = false;
+      }
+
+#if GSL_MAJOR_VERSION >= 2
+      gsl_multifit_fdfsolver_jac(_solver, _jacobian);
+      gsl_multifit_covar(_jacobian, 0.0, _covariance);
+#else
+      gsl_multifit_covar(_solver->J, 0.0, _covariance);
+#endif
+
+      result->parameters.resize(p);
+      result->covariance.resize(p*p);
+      for (size_t i = 0; i < p; ++i) {
+        result->parameters[i] = gsl_vector_get(_solver->x, i);
+        for (size_t j = 0; j < p; ++j) {
+          result->covariance[i*p + j] = gsl_matrix_get(_covariance, i, j);
+        }
+      }
+      result->chi = gsl_blas_dnrm2(_solver->f);
+      result->converged = status == GSL_SUCCESS;
+
+      if (result->converged) {
+        _last = result->parameters;
+      } else {
+        _last.clear();
+      }
+      return true;
+    }
+
+    // Runs fit(Result*) in a worker thread, and once it is done forces an
+    // update of owner, which can then take() the result.  stamp identifies
+    // the inputs it was started on.
+    template <typename F>
+    void start(F fit, Kst::Object *owner, qint64 stamp) {
+      _busy = true;
+      _started = true;
+      _stamp = stamp;
+      QPointer<Kst::Object> guard(owner);
+      _job = QtConcurrent::run([this, fit, guard]() {
+        Result result;
+        const bool ok = fit(&result);
+        {
+          QMutexLocker locker(&_mutex);
+          _result = result;
+          _ok = ok;
+        }
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [guard]() {
+          if (guard) {
+            guard->registerChange();
+            Kst::UpdateManager::self()->doUpdates();
+          }
+        }, Qt::QueuedConnection);
+      });
+    }
+
+    // a job was started and its result has not been taken yet
+    bool busy() const { return _busy; }
+    bool finished() const { return !_busy || _job.isFinished(); }
+
+    // whether a job needs starting for the inputs stamp identifies
+    bool stale(qint64 stamp) const { return !_started || stamp != _stamp; }
+
+    // the settings have changed: the next update fits again
+    void reset() { _started = false; }
+
+    // false while the job runs, or if it failed
+    bool take(Result *result) {
+      if (!_busy || !_job.isFinished()) {
+        return false;
+      }
+      _busy = false;
+      QMutexLocker locker(&_mutex);
+      *result = _result;
+      return _ok;
+    }
+
+    // whether the outputs hold a fit that converged, to be kept in place of
+    // one that didn't
+    bool good() const { return _good; }
+    void setGood(bool good) { _good = good; }
+
+  private:
+    bool allocate(size_t n, size_t p) {
+      if (_solver && n == _n && p == _p) {
+        return true;
+      }
+      release();
+      _solver = gsl_multifit_fdfsolver_alloc(gsl_multifit_fdfsolver_lmsder, n, p);
+      _covariance = gsl_matrix_alloc(p, p);
+#if GSL_MAJOR_VERSION >= 2
+      _jacobian = gsl_matrix_alloc(n, p);
+#endif
+      if (!_solver || !_covariance
+#if GSL_MAJOR_VERSION >= 2
+          || !_jacobian
+#endif
+          ) {
+        release();
+        return false;
+      }
+      _n = n;
+      _p = p;
+      return true;
+    }
+
+    void release() {
+      if (_solver) {
+        gsl_multifit_fdfsolver_free(_solver);
+      }
+      if (_covariance) {
+        gsl_matrix_free(_covariance);
+      }
+      if (_jacobian) {
+        gsl_matrix_free(_jacobian);
+      }
+      _solver = 0;
+      _covariance = 0;
+      _jacobian = 0;
+      _n = _p = 0;
+    }
+
+    gsl_multifit_fdfsolver *_solver;
+    gsl_matrix *_covariance;
+    gsl_matrix *_jacobian;
+    size_t _n;
+    size_t _p;
+    QVector<double> _last;
+
+    QFuture<void> _job;
+    QMutex _mutex;
+    Result _result;
+    bool _busy;
+    bool _started;
+    bool _ok;
+    qint64 _stamp;
+    bool _good;
+};
+
+#endif
+// vim: ts=2 sw=2 et
@@ -23,6 +23,7 @@
 #include <gsl/gsl_statistics.h>
 #include <gsl/gsl_version.h>
 #include "common.h"
+#include "non_linear_fit.h"
 
 struct data {
   size_t	n;
@@ -31,8 +32,9 @@ struct data {
   const double* pdWeight;
 };
 
-int n_params = NUM_PARAMS;
-double offset_ = 0.0;
+// per thread, as a fit may run in a worker thread (see NonLinearFit)
+thread_local int n_params = NUM_PARAMS;
+thread_local double offset_ = 0.0;
 
 void function_initial_estimate( const double* pdX, const double* pdY, int iLength, double* pdParameterEstimates );
 double function_calculate( double dX, double* pdParameters );
@@ -44,7 +46,7 @@ bool kstfit_nonlinear_weighted(
   Kst::VectorPtr xVector, Kst::VectorPtr yVector, Kst::VectorPtr weightedVector,
   Kst::VectorPtr vectorOutYFitted, Kst::VectorPtr vectorOutYResiduals,
   Kst::VectorPtr vectorOutYParameters, Kst::VectorPtr vectorOutYCovariance,
-  Kst::ScalarPtr scalarOutChi );
+  Kst::ScalarPtr scalarOutChi, NonLinearFit* pFit, Kst::Object* pOwner, qint64 iStamp );
 
 
 int function_f( const gsl_vector* pVectorX, void* pParams, gsl_vector* pVectorF ) {
@@ -97,175 +99,206 @@ int function_fdf( const gsl_vector* pVectorX, void* pParams, gsl_vector* pVector
 }
 
 
+bool kstfit_nonlinear_weighted_solve( NonLinearFit* pFit, const double* pdX, const double* pdY,
+                                      const double* pdWeight, int iLength, NonLinearFit::Result* pResult ) {
+  gsl_multifit_function_fdf function;
+  struct data d;
+  double dXInitial[NUM_PARAMS];
+
+  d.n        = iLength;
+  d.pdX      = pdX;
+  d.pdY      = pdY;
+  d.pdWeight = pdWeight;
+
+  function.f      = function_f;
+  function.df     = function_df;
+  function.fdf    = function_fdf;
+  function.n      = iLength;
+  function.p      = n_params;
+  function.params = &d;
+
+  function_initial_estimate( pdX, pdY, iLength, dXInitial );
+
+  return pFit->solve( &function, dXInitial, 1.0e-4, MAX_NUM_ITERATIONS, pResult );
+}
+
+
 bool kstfit_nonlinear_weighted(
   Kst::VectorPtr xVector, Kst::VectorPtr yVector, Kst::VectorPtr weightsVector,
   Kst::VectorPtr vectorOutYFitted, Kst::VectorPtr vectorOutYResiduals,
   Kst::VectorPtr vectorOutYParameters, Kst::VectorPtr vectorOutYCovariance,
-  Kst::ScalarPtr scalarOutChi ) {
-
-  const gsl_multifit_fdfsolver_type* pType;
-  gsl_multifit_fdfsolver* pSolver;
-  gsl_multifit_function_fdf	function;
-  gsl_vector_view vectorViewInitial;
-  gsl_matrix* pMatrixCovariance;
-  gsl_matrix *pMatrixJacobian;
-  struct data d;  
-  double dXInitial[NUM_PARAMS];
+  Kst::ScalarPtr scalarOutChi, NonLinearFit* pFit, Kst::Object* pOwner, qint64 iStamp ) {
+
+  NonLinearFit::Result result;
+  double dParameters[NUM_PARAMS];
   double* pInputs[3];
-  int iIterations = 0;
+  const double* pdX;
+  const double* pdY;
+  const double* pdWeight;
+  qint64 iFirst;
+  qint64 iCount;
   int iLength;
-  int bReturn = false;
-  int iStatus;
   int i;
   int j;
 
-  if (xVector->length() >= 2 &&
-      yVector->length() >= 2 &&
-      weightsVector->length() >= 2) {
-    iLength = yVector->length();
-    if( xVector->length() > iLength ) {
-      iLength = xVector->length();
-    }
+  if (xVector->length() < 2 ||
+      yVector->length() < 2 ||
+      weightsVector->length() < 2) {
+    return false;
+  }
 
-    // do any necessary interpolation...
-    pInputs[XVALUES] = (double*)malloc(iLength * sizeof( double ));
+  iLength = yVector->length();
+  if( xVector->length() > iLength ) {
+    iLength = xVector->length();
+  }
+  if( iLength <= NUM_PARAMS ) {
+    return false;
+  }
 
-    double const *v_x = xVector->noNanValue();
-    double const *v_y = yVector->noNanValue();
+  // do any necessary interpolation...
+  pFit->x.resize(iLength);
+  pFit->y.resize(iLength);
+  pFit->weights.resize(iLength);
+  pInputs[XVALUES] = pFit->x.data();
+  pInputs[YVALUES] = pFit->y.data();
+  pInputs[WEIGHTS] = pFit->weights.data();
 
-    if (xVector->length() == iLength) {
-      for( i=0; i<iLength; i++) {
-        pInputs[XVALUES][i] = v_x[i];
-      }
-    } else {
-      for( i=0; i<iLength; i++) {
-        pInputs[XVALUES][i] = interpolate( i, iLength, v_x, xVector->length() );
-      }
+  double const *v_x = xVector->noNanValue();
+  double const *v_y = yVector->noNanValue();
+
+  if (xVector->length() == iLength) {
+    for( i=0; i<iLength; i++) {
+      pInputs[XVALUES][i] = v_x[i];
     }
+  } else {
+    for( i=0; i<iLength; i++) {
+      pInputs[XVALUES][i] = interpolate( i, iLength, v_x, xVector->length() );
+    }
+  }
 
-    pInputs[YVALUES] = (double*)malloc(iLength * sizeof( double ));
-    if (yVector->length() == iLength) {
-      for( i=0; i<iLength; i++) {
-        pInputs[YVALUES][i] = v_y[i];
-      }
-    } else {
-      for( i=0; i<iLength; i++) {
-        pInputs[YVALUES][i] = interpolate( i, iLength, v_y, yVector->length() );
-      }
+  if (yVector->length() == iLength) {
+    for( i=0; i<iLength; i++) {
+      pInputs[YVALUES][i] = v_y[i];
+    }
+  } else {
+    for( i=0; i<iLength; i++) {
+      pInputs[YVALUES][i] = interpolate( i, iLength, v_y, yVector->length() );
     }
+  }
 
-    pInputs[WEIGHTS] = (double*)malloc(iLength * sizeof( double ));
-    if (weightsVector->length() == iLength) {
-      for( i=0; i<iLength; i++) {
-        pInputs[WEIGHTS][i] = weightsVector->value()[i];
-      }
-    } else {
-      for( i=0; i<iLength; i++) {
-        pInputs[WEIGHTS][i] = interpolate( i, iLength, weightsVector->value(), weightsVector->length() );
+  if (weightsVector->length() == iLength) {
+    for( i=0; i<iLength; i++) {
+      pInputs[WEIGHTS][i] = weightsVector->value()[i];
+    }
+  } else {
+    for( i=0; i<iLength; i++) {
+      pInputs[WEIGHTS][i] = interpolate( i, iLength, weightsVector->value(), weightsVector->length() );
+    }
+  }
+
+  //
+  // pick the samples to fit...
+  //
+  pFit->select( iLength, n_params, &iFirst, &iCount );
+  if (pFit->range.stride > 1 && iCount < iLength) {
+    pFit->fitX.resize(iCount);
+    pFit->fitY.resize(iCount);
+    pFit->fitWeights.resize(iCount);
+    for( i=0; i<iCount; i++ ) {
+      pFit->fitX[i] = pInputs[XVALUES][iFirst + i*pFit->range.stride];
+      pFit->fitY[i] = pInputs[YVALUES][iFirst + i*pFit->range.stride];
+      pFit->fitWeights[i] = pInputs[WEIGHTS][iFirst + i*pFit->range.stride];
+    }
+    pdX = pFit->fitX.constData();
+    pdY = pFit->fitY.constData();
+    pdWeight = pFit->fitWeights.constData();
+  } else {
+    pdX = pInputs[XVALUES] + iFirst;
+    pdY = pInputs[YVALUES] + iFirst;
+    pdWeight = pInputs[WEIGHTS] + iFirst;
+  }
+
+  //
+  // long fits run in a worker thread: until one is done, the last fit stays
+  // up, and the fit is then redone if the inputs have changed since it began...
+  //
+  if (pOwner && (pFit->busy() || iCount >= NonLinearFit::BackgroundSamples)) {
+    bool bTaken = false;
+    if (pFit->busy()) {
+      if (!pFit->finished()) {
+        return true;
       }
+      bTaken = pFit->take( &result ) && result.parameters.size() == n_params;
+    }
+    if (pFit->stale(iStamp) && iCount >= NonLinearFit::BackgroundSamples) {
+      const QVector<double> fitX(pdX, pdX + iCount);
+      const QVector<double> fitY(pdY, pdY + iCount);
+      const QVector<double> fitWeights(pdWeight, pdWeight + iCount);
+      const int iParams = n_params;
+      const double dOffset = offset_;
+      pFit->start( [pFit, fitX, fitY, fitWeights, iParams, dOffset](NonLinearFit::Result* pResult) {
+        n_params = iParams;
+        offset_ = dOffset;
+        return kstfit_nonlinear_weighted_solve( pFit, fitX.constData(), fitY.constData(),
+                                                fitWeights.constData(), fitX.size(), pResult );
+      }, pOwner, iStamp );
     }
+    if (!bTaken) {
+      return true;
+    }
+  } else if (!kstfit_nonlinear_weighted_solve( pFit, pdX, pdY, pdWeight, iCount, &result )) {
+    return false;
+  }
 
-    if( iLength > NUM_PARAMS ) {
-      vectorOutYFitted->resize(iLength);
-      vectorOutYResiduals->resize(iLength);
-      vectorOutYParameters->resize(NUM_PARAMS);
-      vectorOutYCovariance->resize(NUM_PARAMS * NUM_PARAMS);
-
-      pType   = gsl_multifit_fdfsolver_lmsder;
-      pSolver = gsl_multifit_fdfsolver_alloc( pType, iLength, n_params );
-      if( pSolver != NULL ) {
-        d.n        = iLength;
-        d.pdX	     = pInputs[XVALUES];
-        d.pdY      = pInputs[YVALUES];
-        d.pdWeight = pInputs[WEIGHTS];
-
-        function.f   	  = function_f;
-        function.df  	  = function_df;
-        function.fdf 	  = function_fdf;
-        function.n   	  = iLength;
-        function.p   	  = n_params;
-        function.params = &d;
-
-        pMatrixCovariance = gsl_matrix_alloc( n_params, n_params );
-        if( pMatrixCovariance != NULL ) {
-          function_initial_estimate( pInputs[XVALUES], pInputs[YVALUES], iLength, dXInitial );
-          vectorViewInitial = gsl_vector_view_array( dXInitial, n_params );
-
-          gsl_multifit_fdfsolver_set( pSolver, &function, &vectorViewInitial.vector );
-
-          //
-          // iterate to a solution...
-          //
-          do {
-            iStatus = gsl_multifit_fdfsolver_iterate( pSolver );
-            if( iStatus == GSL_SUCCESS ) {
-              iStatus = gsl_multifit_test_delta( pSolver->dx, pSolver->x, 1.0e-4, 1.0e-4 );
-            }
-            iIterations++;
-          }
-          while( iStatus == GSL_CONTINUE && iIterations < MAX_NUM_ITERATIONS );
-
-#if GSL_MAJOR_VERSION >= 2
-          pMatrixJacobian = gsl_matrix_alloc( iLength, n_params );
-#else
-          pMatrixJacobian = pSolver->J;
-#endif
+  //
+  // keep the last fit up rather than one that didn't converge...
+  //
+  if (!result.converged && pFit->good()) {
+    return true;
+  }
+  pFit->setGood( result.converged );
 
-          if ( pMatrixJacobian != NULL) {
-#if GSL_MAJOR_VERSION >= 2
-            gsl_multifit_fdfsolver_jac( pSolver, pMatrixJacobian );
-#endif
-            gsl_multifit_covar( pMatrixJacobian, 0.0, pMatrixCovariance );
-
-            //
-            // determine the fitted values...
-            //
-            for( i=0; i<n_params; i++ ) {
-              dXInitial[i] = gsl_vector_get( pSolver->x, i );
-            }
-
-            for( i=0; i<iLength; i++ ) {
-              vectorOutYFitted->raw_V_ptr()[i] = function_calculate( pInputs[XVALUES][i], dXInitial );
-              vectorOutYResiduals->raw_V_ptr()[i] = pInputs[YVALUES][i] - vectorOutYFitted->raw_V_ptr()[i];
-            }
-
-            //
-            // fill in the parameter values and covariance matrix...
-            //
-            for( i=0; i<NUM_PARAMS; i++ ) {
-              if (i<n_params) {
-                vectorOutYParameters->raw_V_ptr()[i] = gsl_vector_get( pSolver->x, i );
-              } else {
-                vectorOutYParameters->raw_V_ptr()[i] = offset_;
-              }
-              for( j=0; j<NUM_PARAMS; j++ ) {
-                if ((i<n_params) && (j<n_params)) {
-                  vectorOutYCovariance->raw_V_ptr()[(i*NUM_PARAMS)+j] = gsl_matrix_get( pMatrixCovariance, i, j );
-                } else {
-                  vectorOutYCovariance->raw_V_ptr()[(i*NUM_PARAMS)+j] = 0.0;
-                }
-              }
-            }
-
-            //
-            // determine the value of chi^2/nu
-            //
-            scalarOutChi->setValue(gsl_blas_dnrm2( pSolver->f ));
-
-            bReturn = true;
-
-#if GSL_MAJOR_VERSION >= 2
-            gsl_matrix_free( pMatrixJacobian );
-#endif
-          }
-          gsl_matrix_free( pMatrixCovariance );
-        }
-        gsl_multifit_fdfsolver_free( pSolver );
+  vectorOutYFitted->resize(iLength);
+  vectorOutYResiduals->resize(iLength);
+  vectorOutYParameters->resize(NUM_PARAMS);
+  vectorOutYCovariance->resize(NUM_PARAMS * NUM_PARAMS);
+
+  //
+  // determine the fitted values...
+  //
+  for( i=0; i<n_params; i++ ) {
+    dParameters[i] = result.parameters[i];
+  }
+
+  for( i=0; i<iLength; i++ ) {
+    vectorOutYFitted->raw_V_ptr()[i] = function_calculate( pInputs[XVALUES][i], dParameters );
+    vectorOutYResiduals->raw_V_ptr()[i] = pInputs[YVALUES][i] - vectorOutYFitted->raw_V_ptr()[i];
+  }
+
+  //
+  // fill in the parameter values and covariance matrix...
+  //
+  for( i=0; i<NUM_PARAMS; i++ ) {
+    if (i<n_params) {
+      vectorOutYParameters->raw_V_ptr()[i] = result.parameters[i];
+    } else {
+      vectorOutYParameters->raw_V_ptr()[i] = offset_;
+    }
+    for( j=0; j<NUM_PARAMS; j++ ) {
+      if ((i<n_params) && (j<n_params)) {
+        vectorOutYCovariance->raw_V_ptr()[(i*NUM_PARAMS)+j] = result.covariance[(i*n_params)+j];
+      } else {
+        vectorOutYCovariance->raw_V_ptr()[(i*NUM_PARAMS)+j] = 0.0;
       }
     }
-    postcursor(true, pInputs);
   }
-  return bReturn;
+
+  //
+  // determine the value of chi^2/nu
+  //
+  scalarOutChi->setValue(result.chi);
+
+  return true;
 }
 
 #endif
@@ -58,7 +58,7 @@ class FitPolynomialUnweightedSource : public Kst::BasicPlugin {
 class FitPolynomialUnweightedPlugin : public QObject, public Kst::DataObjectPluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataObjectPluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.1")
   public:
     virtual ~FitPolynomialUnweightedPlugin() {}
 
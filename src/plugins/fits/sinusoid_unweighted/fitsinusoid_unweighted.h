@@ -60,7 +60,7 @@ class FitSinusoidUnweightedSource : public Kst::BasicPlugin {
 class FitSinusoidUnweightedPlugin : public QObject, public Kst::DataObjectPluginInterface {
     Q_OBJECT
     Q_INTERFACES(Kst::DataObjectPluginInterface)
-    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.0")
+    Q_PLUGIN_METADATA(IID "com.kst.DataObjectPluginInterface/2.1")
   public:
     virtual ~FitSinusoidUnweightedPlugin() {}
 
@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+"""Compare two kst-benchmarks runs.
+
+    compare.py before.csv after.csv [threshold_percent]
+
+The files are the csv output of kst-benchmarks (-o file.csv,csv).  Prints
+every benchmark with the change in its per iteration result, and exits
+with status 1 if any got slower by more than the threshold (default 10%).
+"""
+
+import csv
+import sys
+
+
+def load(name):
+    results = {}
+    with open(name, newline="") as f:
+        for row in csv.reader(f):
+            if len(row) < 4:
+                continue
+            try:
+                value = float(row[3])
+            except ValueError:
+                continue  # a header line
+            results[(row[0], row[1], row[2])] = value
+    return results
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit(__doc__)
+    before = load(sys.argv[1])
+    after = load(sys.argv[2])
+    threshold = float(sys.argv[3]) if len(sys.argv) > 3 else 10.0
+
+    slower = 0
+    for key in sorted(before.keys() & after.keys()):
+        old, new = before[key], after[key]
+        change = 100.0 * (new - old) / old if old else 0.0
+        mark = ""
+        if change > threshold:
+            mark = "  <-- slower"
+            slower += 1
+        elif change < -threshold:
+            mark = "  faster"
+        function, tag, metric = key
+        print("%-24s %-14s %12.4g %12.4g %+7.1f%% %s%s"
+              % (function, tag, old, new, change, metric, mark))
+
+    for key in sorted(before.keys() - after.keys()):
+        print("%-24s %-14s only in %s" % (key[0], key[1], sys.argv[1]))
+    for key in sorted(after.keys() - before.keys()):
+        print("%-24s %-14s only in %s" % (key[0], key[1], sys.argv[2]))
+
+    sys.exit(1 if slower else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,614 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "kstbenchmarks.h"
+#include "syntheticdata.h"
+
+#include <QtTest>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QThread>
+
+#include <basicplugin.h>
+#include <csd.h>
+#include <curve.h>
+#include <dataobject.h>
+#include <datasource.h>
+#include <datasourcepluginmanager.h>
+#include <datavector.h>
+#include <equation.h>
+#include <generatedmatrix.h>
+#include <histogram.h>
+#include <image.h>
+#include <livestream.h>
+#include <objectstore.h>
+#include <palette.h>
+#include <psd.h>
+#include <scalar.h>
+#include <vector.h>
+
+static Kst::ObjectStore _store;
+
+static const int RenderWidth = 1600;
+static const int RenderHeight = 1000;
+
+
+// a vector of n samples of the synthetic y field
+static Kst::VectorPtr makeVector(qint64 n) {
+  Kst::VectorPtr v = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  v->writeLock();
+  v->resize(n);
+  double *p = v->raw_V_ptr();
+  for (qint64 i = 0; i < n; ++i) {
+    p[i] = SyntheticData::y(i);
+  }
+  v->updateScalars();
+  v->unlock();
+  return v;
+}
+
+
+static Kst::VectorPtr makeRamp(qint64 n) {
+  Kst::VectorPtr v = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  v->writeLock();
+  v->resize(n);
+  double *p = v->raw_V_ptr();
+  for (qint64 i = 0; i < n; ++i) {
+    p[i] = SyntheticData::x(i);
+  }
+  v->updateScalars();
+  v->unlock();
+  return v;
+}
+
+
+// the synthetic x and y, frames [first, first+count) of them
+static QVector<double> liveFrames(qint64 first, qint64 count) {
+  QVector<double> frames(2*count);
+  for (qint64 i = 0; i < count; ++i) {
+    frames[2*i] = SyntheticData::x(first + i);
+    frames[2*i + 1] = SyntheticData::y(first + i);
+  }
+  return frames;
+}
+
+
+// Sends frames of the synthetic x and y as a producer would, once source
+// has connected, and waits for source to have them all.
+static bool streamFrames(Kst::LiveStreamProducer *producer, Kst::DataSourcePtr source, const QString &field, qint64 frames) {
+  QElapsedTimer timer;
+  timer.start();
+  while (producer->readers() == 0) {
+    if (timer.elapsed() > 10000) {
+      return false;
+    }
+    QCoreApplication::processEvents();
+  }
+
+  const qint64 batch = 4096;
+  for (qint64 i = 0; i < frames; i += batch) {
+    const QVector<double> sent = liveFrames(i, qMin(batch, frames - i));
+    producer->send(sent.constData(), sent.size()/2);
+    QCoreApplication::processEvents();
+  }
+
+  while (timer.elapsed() < 10000) {
+    QCoreApplication::processEvents();
+    source->writeLock();
+    source->internalDataSourceUpdate();
+    const double received = source->vector().dataInfo(field).frameCount;
+    source->unlock();
+    if (received == frames) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+static Kst::ScalarPtr makeScalar(double value) {
+  Kst::ScalarPtr s = Kst::kst_cast<Kst::Scalar>(_store.createObject<Kst::Scalar>());
+  s->setValue(value);
+  return s;
+}
+
+
+// the same transform CartesianRenderItem sets up for a linear plot
+static Kst::CurveRenderContext renderContext(QPainter *painter, double xMin, double xMax, double yMin, double yMax) {
+  Kst::CurveRenderContext context;
+  context.painter = painter;
+  context.penWidth = painter->pen().width();
+  context.xLogBase = 10.0;
+  context.yLogBase = 10.0;
+  context.foregroundColor = Qt::black;
+  context.backgroundColor = Qt::white;
+  context.XMin = context.x_min = xMin;
+  context.XMax = context.x_max = xMax;
+  context.YMin = context.y_min = yMin;
+  context.YMax = context.y_max = yMax;
+  context.Lx = 0;
+  context.Hx = RenderWidth;
+  context.Ly = 0;
+  context.Hy = RenderHeight;
+  context.m_X = double(RenderWidth)/(xMax - xMin);
+  context.m_Y = -double(RenderHeight)/(yMax - yMin);
+  context.b_X = context.Lx - context.m_X * xMin;
+  context.b_Y = context.Ly - context.m_Y * yMax;
+  return context;
+}
+
+
+void KstBenchmarks::initTestCase() {
+  _dataDir = qEnvironmentVariable("KST_BENCHMARK_DATA", QDir::temp().filePath("kst-benchmarks"));
+  QVERIFY(QDir().mkpath(_dataDir));
+  Kst::DataSourcePluginManager::init();
+  Kst::DataObject::init();
+}
+
+
+void KstBenchmarks::cleanupTestCase() {
+  _store.clear();
+}
+
+
+// 10k to 1M samples; set KST_BENCHMARK_LARGE for 10M as well
+void KstBenchmarks::sizes() {
+  QTest::addColumn<qint64>("samples");
+  QTest::newRow("10k") << qint64(10000);
+  QTest::newRow("100k") << qint64(100000);
+  QTest::newRow("1M") << qint64(1000000);
+  if (!qEnvironmentVariableIsEmpty("KST_BENCHMARK_LARGE")) {
+    QTest::newRow("10M") << qint64(10000000);
+  }
+}
+
+
+void KstBenchmarks::dataVectorRead_data() {
+  QTest::addColumn<QString>("format");
+  QTest::addColumn<qint64>("samples");
+  const char *formats[] = { "ascii", "dirfile", "hdf5", "livestream" };
+  for (const char *format : formats) {
+    QTest::newRow(qPrintable(QString("%1/10k").arg(format))) << QString(format) << qint64(10000);
+    QTest::newRow(qPrintable(QString("%1/1M").arg(format))) << QString(format) << qint64(1000000);
+    if (!qEnvironmentVariableIsEmpty("KST_BENCHMARK_LARGE")) {
+      QTest::newRow(qPrintable(QString("%1/10M").arg(format))) << QString(format) << qint64(10000000);
+    }
+  }
+}
+
+
+void KstBenchmarks::dataVectorRead() {
+  QFETCH(QString, format);
+  QFETCH(qint64, samples);
+
+  QString fileName;
+  QString field;
+  QScopedPointer<Kst::LiveStreamProducer> producer;
+  if (format == "ascii") {
+    fileName = QDir(_dataDir).filePath(QString("ascii-%1.txt").arg(samples));
+    QVERIFY(SyntheticData::writeAscii(fileName, samples));
+    field = "Column 2";
+  } else if (format == "dirfile") {
+    fileName = QDir(_dataDir).filePath(QString("dirfile-%1").arg(samples));
+    QVERIFY(SyntheticData::writeDirfile(fileName, samples));
+    field = "y";
+  } else if (format == "livestream") {
+    if (samples > Kst::LiveHistory::DefaultCapacity) {
+      QSKIP("more frames than a live stream keeps");
+    }
+    fileName = QDir(_dataDir).filePath(QString("live-%1").arg(samples));
+    producer.reset(new Kst::LiveStreamProducer(QStringList() << "x" << "y"));
+    QVERIFY(producer->listen(fileName));
+    field = "y";
+  } else {
+    if (!SyntheticData::haveHdf5()) {
+      QSKIP("built without HDF5");
+    }
+    fileName = QDir(_dataDir).filePath(QString("hdf5-%1.h5").arg(samples));
+    QVERIFY(SyntheticData::writeHdf5(fileName, samples));
+    field = "y";
+  }
+
+  Kst::DataSourcePtr source = Kst::DataSourcePluginManager::findOrLoadSource(&_store, fileName);
+  if (!source || !source->isValid()) {
+    QSKIP(qPrintable(QString("no %1 data source plugin").arg(format)));
+  }
+  if (producer) {
+    QVERIFY(streamFrames(producer.data(), source, field, samples));
+  }
+  source->writeLock();
+  source->internalDataSourceUpdate();
+  source->unlock();
+
+  // every iteration reads the whole field into a new vector
+  QBENCHMARK {
+    Kst::DataVectorPtr dv = Kst::kst_cast<Kst::DataVector>(_store.createObject<Kst::DataVector>());
+    dv->writeLock();
+    dv->change(source, field, 0, false, -1, true, 0, false, false);
+    dv->internalUpdate();
+    dv->unlock();
+    QCOMPARE(dv->length(), samples);
+    _store.removeObject(dv);
+  }
+}
+
+
+void KstBenchmarks::asciiTailRead_data() {
+  QTest::addColumn<QString>("compression");
+  QTest::newRow("plain/1M") << QString("plain");
+  QTest::newRow("gzip/1M") << QString("gzip");
+}
+
+
+// The last 10k rows of a 1M row ascii file, as a count from end vector
+// reads them: the source opens the file anew for every read, so for a
+// compressed file this is a first seek on a fresh device.
+void KstBenchmarks::asciiTailRead() {
+  QFETCH(QString, compression);
+  const qint64 rows = 1000000;
+  const qint64 tail = 10000;
+
+  QString fileName;
+  if (compression == "gzip") {
+    if (!SyntheticData::haveGzip()) {
+      QSKIP("built without zlib");
+    }
+    fileName = QDir(_dataDir).filePath(QString("ascii-%1.txt.gz").arg(rows));
+    QVERIFY(SyntheticData::writeAsciiGzip(fileName, rows));
+  } else {
+    fileName = QDir(_dataDir).filePath(QString("ascii-%1.txt").arg(rows));
+    QVERIFY(SyntheticData::writeAscii(fileName, rows));
+  }
+
+  Kst::DataSourcePtr source = Kst::DataSourcePluginManager::findOrLoadSource(&_store, fileName);
+  if (!source || !source->isValid()) {
+    QSKIP("no ascii data source plugin, or one without compression support");
+  }
+  source->writeLock();
+  source->internalDataSourceUpdate();
+  source->unlock();
+
+  QBENCHMARK {
+    Kst::DataVectorPtr dv = Kst::kst_cast<Kst::DataVector>(_store.createObject<Kst::DataVector>());
+    dv->writeLock();
+    dv->change(source, "Column 2", 0, true, tail, false, 0, false, false);
+    dv->internalUpdate();
+    dv->unlock();
+    QCOMPARE(dv->length(), tail);
+    QVERIFY(qAbs(dv->value(tail - 1) - SyntheticData::y(rows - 1)) < 1e-6);
+    _store.removeObject(dv);
+  }
+}
+
+
+void KstBenchmarks::vectorStatistics_data() {
+  sizes();
+}
+
+
+void KstBenchmarks::vectorStatistics() {
+  QFETCH(qint64, samples);
+  Kst::VectorPtr v = makeVector(samples);
+
+  v->writeLock();
+  QBENCHMARK {
+    v->updateScalars();
+  }
+  v->unlock();
+  _store.removeObject(v);
+}
+
+
+void KstBenchmarks::equation_data() {
+  sizes();
+}
+
+
+void KstBenchmarks::equation() {
+  QFETCH(qint64, samples);
+  Kst::VectorPtr x = makeRamp(samples);
+
+  Kst::EquationPtr eq = Kst::kst_cast<Kst::Equation>(_store.createObject<Kst::Equation>());
+  eq->writeLock();
+  eq->setEquation("sin(x)*x^2 + 3*cos(x/2) - sqrt(abs(x))");
+  eq->setExistingXVector(x, false);
+  QBENCHMARK {
+    eq->internalUpdate();
+  }
+  QCOMPARE(eq->vY()->length(), samples);
+  eq->unlock();
+  _store.removeObject(eq);
+  _store.removeObject(x);
+}
+
+
+void KstBenchmarks::psd_data() {
+  sizes();
+}
+
+
+void KstBenchmarks::psd() {
+  QFETCH(qint64, samples);
+  Kst::VectorPtr v = makeVector(samples);
+
+  Kst::PSDPtr psd = Kst::kst_cast<Kst::PSD>(_store.createObject<Kst::PSD>());
+  psd->writeLock();
+  psd->change(v, 100.0, true, 12, true, true, QString(), QString(), WindowOriginal, 3.0, PSDPowerSpectralDensity);
+  QBENCHMARK {
+    psd->internalUpdate();
+  }
+  psd->unlock();
+  _store.removeObject(psd);
+  _store.removeObject(v);
+}
+
+
+void KstBenchmarks::csd_data() {
+  sizes();
+}
+
+
+void KstBenchmarks::csd() {
+  QFETCH(qint64, samples);
+  Kst::VectorPtr v = makeVector(samples);
+
+  Kst::CSDPtr csd = Kst::kst_cast<Kst::CSD>(_store.createObject<Kst::CSD>());
+  csd->writeLock();
+  csd->change(v, 100.0, true, true, true, WindowOriginal, int(qMax(samples/50, qint64(64))), 8, 3.0, PSDPowerSpectralDensity, QString(), QString());
+  QBENCHMARK {
+    csd->internalUpdate();
+  }
+  csd->unlock();
+  _store.removeObject(csd);
+  _store.removeObject(v);
+}
+
+
+void KstBenchmarks::histogram_data() {
+  sizes();
+}
+
+
+void KstBenchmarks::histogram() {
+  QFETCH(qint64, samples);
+  Kst::VectorPtr v = makeVector(samples);
+
+  Kst::HistogramPtr h = Kst::kst_cast<Kst::Histogram>(_store.createObject<Kst::Histogram>());
+  h->writeLock();
+  h->change(v, -1.2, 1.2, 1000, Kst::Histogram::Number);
+  QBENCHMARK {
+    h->internalUpdate();
+  }
+  h->unlock();
+  _store.removeObject(h);
+  _store.removeObject(v);
+}
+
+
+void KstBenchmarks::lowPassFilter_data() {
+  sizes();
+}
+
+
+void KstBenchmarks::lowPassFilter() {
+  QFETCH(qint64, samples);
+
+  // created the way a session file is loaded
+  const QString name("Low Pass Filter");
+  Kst::DataObjectConfigWidget *configWidget = Kst::DataObject::pluginWidget(name);
+  Kst::BasicPluginPtr filter = Kst::kst_cast<Kst::BasicPlugin>(Kst::DataObject::createPlugin(name, &_store, configWidget, false));
+  if (!filter) {
+    QSKIP("the butterworth filter plugins were not found");
+  }
+  Kst::VectorPtr v = makeVector(samples);
+  filter->writeLock();
+  filter->setInputVector("Y Vector", v);
+  filter->setInputScalar("Order Scalar", makeScalar(4));
+  filter->setInputScalar("Cutoff / Spacing Scalar", makeScalar(0.05));
+  filter->setOutputVector("Y", QString());
+  QBENCHMARK {
+    filter->internalUpdate();
+  }
+  filter->unlock();
+  _store.removeObject(filter);
+  _store.removeObject(v);
+}
+
+
+void KstBenchmarks::curvePaintObjects_data() {
+  sizes();
+}
+
+
+void KstBenchmarks::curvePaintObjects() {
+  QFETCH(qint64, samples);
+  Kst::VectorPtr x = makeRamp(samples);
+  Kst::VectorPtr y = makeVector(samples);
+
+  Kst::CurvePtr curve = Kst::kst_cast<Kst::Curve>(_store.createObject<Kst::Curve>());
+  curve->writeLock();
+  curve->setXVector(x);
+  curve->setYVector(y);
+  curve->setHasLines(true);
+  curve->setHasPoints(false);
+  curve->internalUpdate();
+
+  QImage target(RenderWidth, RenderHeight, QImage::Format_ARGB32_Premultiplied);
+  QPainter painter(&target);
+  const Kst::CurveRenderContext context = renderContext(&painter, x->min(), x->max(), -1.2, 1.2);
+  QBENCHMARK {
+    curve->updatePaintObjects(context);
+  }
+  curve->unlock();
+  painter.end();
+
+  _store.removeObject(curve);
+  _store.removeObject(x);
+  _store.removeObject(y);
+}
+
+
+void KstBenchmarks::imageRasterize_data() {
+  QTest::addColumn<qint64>("samples");
+  QTest::newRow("100x100") << qint64(100);
+  QTest::newRow("1000x1000") << qint64(1000);
+  QTest::newRow("3000x3000") << qint64(3000);
+}
+
+
+void KstBenchmarks::imageRasterize() {
+  QFETCH(qint64, samples);   // per side
+
+  Kst::GeneratedMatrixPtr m = Kst::kst_cast<Kst::GeneratedMatrix>(_store.createObject<Kst::GeneratedMatrix>());
+  m->writeLock();
+  m->change(uint(samples), uint(samples), 0, 0, 1, 1, 0, 1, true);
+  m->internalUpdate();
+  m->unlock();
+
+  Kst::ImagePtr image = Kst::kst_cast<Kst::Image>(_store.createObject<Kst::Image>());
+  image->writeLock();
+  image->changeToColorOnly(m, 0, 1, false, Kst::DefaultPalette);
+  image->internalUpdate();
+
+  QImage target(RenderWidth, RenderHeight, QImage::Format_ARGB32_Premultiplied);
+  QPainter painter(&target);
+  const Kst::CurveRenderContext context = renderContext(&painter, 0, samples, 0, samples);
+  QBENCHMARK {
+    image->updatePaintObjects(context);
+  }
+  image->unlock();
+  painter.end();
+
+  _store.removeObject(image);
+  _store.removeObject(m);
+}
+
+
+void KstBenchmarks::liveStream_data() {
+  QTest::addColumn<qint64>("batch");
+  QTest::newRow("1 frame") << qint64(1);
+  QTest::newRow("64 frames") << qint64(64);
+  QTest::newRow("4096 frames") << qint64(4096);
+}
+
+
+// 100k frames of two fields from the stand-in producer to a reader, sent
+// batch frames at a time, until the last of them is in the history.
+void KstBenchmarks::liveStream() {
+  QFETCH(qint64, batch);
+  const qint64 frames = 100000;
+
+  const QString server = QDir(_dataDir).filePath("live-ingest");
+  Kst::LiveStreamProducer producer(QStringList() << "x" << "y");
+  QVERIFY(producer.listen(server));
+  Kst::LiveStreamReader reader(producer.fullServerName());
+  QTRY_VERIFY(reader.hasHeader());
+
+  const QVector<double> sent = liveFrames(0, frames);
+  qint64 expected = 0;
+  QBENCHMARK {
+    for (qint64 i = 0; i < frames; i += batch) {
+      producer.send(sent.constData() + 2*i, qMin(batch, frames - i));
+      QCoreApplication::processEvents();
+    }
+    expected += frames;
+    while (reader.history().frames() < expected) {
+      QCoreApplication::processEvents();
+    }
+  }
+}
+
+
+void KstBenchmarks::primitiveAccess_data() {
+  QTest::addColumn<QString>("access");
+  QTest::addColumn<int>("threads");
+  const char *accesses[] = { "copy", "borrow", "writeLock" };
+  for (const char *access : accesses) {
+    QTest::newRow(qPrintable(QString("%1/1 thread").arg(access))) << QString(access) << 1;
+    QTest::newRow(qPrintable(QString("%1/4 threads").arg(access))) << QString(access) << 4;
+  }
+}
+
+
+// One pass over 10k scalars as an update would make: read locking each, as
+// a copied SharedPtr or borrowed; or write locking each, as doUpdates()
+// does.  The other threads read the same scalars all the while.
+void KstBenchmarks::primitiveAccess() {
+  QFETCH(QString, access);
+  QFETCH(int, threads);
+
+  QList<Kst::ScalarPtr> scalars;
+  for (int i = 0; i < 10000; ++i) {
+    scalars.append(makeScalar(i));
+  }
+
+  QAtomicInt stop;
+  QList<QThread*> readers;
+  for (int i = 1; i < threads; ++i) {
+    readers.append(QThread::create([&scalars, &stop]() {
+      double sum = 0.0;
+      while (!stop.loadRelaxed()) {
+        for (Kst::Borrowed<Kst::Scalar> s : Kst::borrow<Kst::Scalar>(scalars)) {
+          s->readLock();
+          sum += s->value();
+          s->unlock();
+        }
+      }
+      Q_UNUSED(sum)
+    }));
+    readers.last()->start();
+  }
+
+  double sum = 0.0;
+  if (access == "copy") {
+    QBENCHMARK {
+      foreach (Kst::ScalarPtr s, scalars) {
+        s->readLock();
+        sum += s->value();
+        s->unlock();
+      }
+    }
+  } else if (access == "borrow") {
+    QBENCHMARK {
+      for (Kst::Borrowed<Kst::Scalar> s : Kst::borrow<Kst::Scalar>(scalars)) {
+        s->readLock();
+        sum += s->value();
+        s->unlock();
+      }
+    }
+  } else {
+    QBENCHMARK {
+      for (Kst::Borrowed<Kst::Scalar> s : Kst::borrow<Kst::Scalar>(scalars)) {
+        s->writeLock();
+        sum += s->value();
+        s->unlock();
+      }
+    }
+  }
+  QVERIFY(sum >= 0.0);
+
+  stop.storeRelaxed(1);
+  foreach (QThread *reader, readers) {
+    reader->wait();
+    delete reader;
+  }
+  foreach (Kst::ScalarPtr s, scalars) {
+    _store.removeObject(s);
+  }
+}
+
+
+QTEST_MAIN(KstBenchmarks)
+
+// vim: ts=2 sw=2 et
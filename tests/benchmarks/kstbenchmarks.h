@@ -0,0 +1,72 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef KSTBENCHMARKS_H
+#define KSTBENCHMARKS_H
+
+#include <QObject>
+#include <QString>
+
+// Timings of the read, compute and render hot paths, each at several
+// sizes, and of locking the objects they go through.  Run with "-csv" or
+// "-o results.xml,xml" for machine readable output; compare.py diffs two
+// csv runs.
+class KstBenchmarks : public QObject
+{
+  Q_OBJECT
+  private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void dataVectorRead_data();
+    void dataVectorRead();
+
+    void asciiTailRead_data();
+    void asciiTailRead();
+
+    void vectorStatistics_data();
+    void vectorStatistics();
+
+    void equation_data();
+    void equation();
+
+    void psd_data();
+    void psd();
+
+    void csd_data();
+    void csd();
+
+    void histogram_data();
+    void histogram();
+
+    void lowPassFilter_data();
+    void lowPassFilter();
+
+    void curvePaintObjects_data();
+    void curvePaintObjects();
+
+    void imageRasterize_data();
+    void imageRasterize();
+
+    void liveStream_data();
+    void liveStream();
+
+    void primitiveAccess_data();
+    void primitiveAccess();
+
+  private:
+    void sizes();
+    QString _dataDir;
+};
+
+#endif
+
+// vim: ts=2 sw=2 et
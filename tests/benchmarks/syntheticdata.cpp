@@ -0,0 +1,200 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "syntheticdata.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QVector>
+
+#include <math.h>
+
+#ifdef KST_BENCHMARK_HDF5
+#include <H5Cpp.h>
+#endif
+#ifdef KST_BENCHMARK_ZLIB
+#include <zlib.h>
+#endif
+
+namespace SyntheticData {
+
+double x(qint64 i) {
+  return i * 0.01;
+}
+
+
+// a cheap deterministic noise, so every run reads the same numbers
+double y(qint64 i) {
+  const quint32 h = quint32(i) * 2654435761u;
+  return sin(x(i)) + (h >> 8) * (0.1 / 16777216.0);
+}
+
+
+static void appendAsciiRow(QByteArray& block, qint64 i) {
+  block += QByteArray::number(x(i), 'g', 10);
+  block += ' ';
+  block += QByteArray::number(y(i), 'g', 10);
+  block += ' ';
+  block += QByteArray::number(i % 97);
+  block += '\n';
+}
+
+
+bool writeAscii(const QString& fileName, qint64 rows) {
+  if (QFileInfo(fileName).exists()) {
+    return true;
+  }
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return false;
+  }
+
+  QByteArray block;
+  block.reserve(1 << 20);
+  for (qint64 i = 0; i < rows; ++i) {
+    appendAsciiRow(block, i);
+    if (block.size() > (1 << 20) - 64) {
+      file.write(block);
+      block.clear();
+    }
+  }
+  file.write(block);
+  return true;
+}
+
+
+bool haveGzip() {
+#ifdef KST_BENCHMARK_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+bool writeAsciiGzip(const QString& fileName, qint64 rows) {
+#ifdef KST_BENCHMARK_ZLIB
+  if (QFileInfo(fileName).exists()) {
+    return true;
+  }
+  gzFile file = gzopen(QFile::encodeName(fileName).constData(), "wb");
+  if (!file) {
+    return false;
+  }
+
+  bool ok = true;
+  QByteArray block;
+  block.reserve(1 << 20);
+  for (qint64 i = 0; i < rows && ok; ++i) {
+    appendAsciiRow(block, i);
+    if (block.size() > (1 << 20) - 64 || i == rows - 1) {
+      ok = gzwrite(file, block.constData(), unsigned(block.size())) == block.size();
+      block.clear();
+    }
+  }
+  if (gzclose(file) != Z_OK || !ok) {
+    QFile::remove(fileName);
+    return false;
+  }
+  return true;
+#else
+  Q_UNUSED(fileName)
+  Q_UNUSED(rows)
+  return false;
+#endif
+}
+
+
+static bool writeRaw(const QString& fileName, double (*f)(qint64), qint64 n) {
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return false;
+  }
+  QVector<double> block(65536);
+  for (qint64 i0 = 0; i0 < n; i0 += block.size()) {
+    const qint64 count = qMin(qint64(block.size()), n - i0);
+    for (qint64 i = 0; i < count; ++i) {
+      block[i] = f(i0 + i);
+    }
+    if (file.write(reinterpret_cast<const char*>(block.constData()), count * sizeof(double)) != qint64(count * sizeof(double))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+bool writeDirfile(const QString& dirName, qint64 frames) {
+  QDir dir(dirName);
+  if (dir.exists("format")) {
+    return true;
+  }
+  if (!dir.mkpath(".")) {
+    return false;
+  }
+  if (!writeRaw(dir.filePath("x"), x, frames) || !writeRaw(dir.filePath("y"), y, frames)) {
+    return false;
+  }
+
+  // written last: an interrupted run leaves no format file, and is redone
+  QFile format(dir.filePath("format"));
+  if (!format.open(QIODevice::WriteOnly)) {
+    return false;
+  }
+  format.write("x RAW FLOAT64 1\ny RAW FLOAT64 1\n");
+  return true;
+}
+
+
+bool haveHdf5() {
+#ifdef KST_BENCHMARK_HDF5
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+bool writeHdf5(const QString& fileName, qint64 rows) {
+#ifdef KST_BENCHMARK_HDF5
+  if (QFileInfo(fileName).exists()) {
+    return true;
+  }
+  try {
+    H5::H5File file(QFile::encodeName(fileName).constData(), H5F_ACC_TRUNC);
+    hsize_t dims[1] = { hsize_t(rows) };
+    H5::DataSpace space(1, dims);
+
+    QVector<double> data(rows);
+    for (qint64 i = 0; i < rows; ++i) {
+      data[i] = x(i);
+    }
+    file.createDataSet("x", H5::PredType::NATIVE_DOUBLE, space).write(data.constData(), H5::PredType::NATIVE_DOUBLE);
+    for (qint64 i = 0; i < rows; ++i) {
+      data[i] = y(i);
+    }
+    file.createDataSet("y", H5::PredType::NATIVE_DOUBLE, space).write(data.constData(), H5::PredType::NATIVE_DOUBLE);
+  } catch (const H5::Exception&) {
+    QFile::remove(fileName);
+    return false;
+  }
+  return true;
+#else
+  Q_UNUSED(fileName)
+  Q_UNUSED(rows)
+  return false;
+#endif
+}
+
+}
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,43 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SYNTHETICDATA_H
+#define SYNTHETICDATA_H
+
+#include <QString>
+
+// Inputs for the benchmarks, written locally so the numbers don't depend
+// on what happens to be lying around.  Every format holds the same two
+// fields: x, a ramp, and y, a noisy sine of x.  As in datagenerator.pl and
+// dirfile_maker, the files are regenerated only if missing.
+namespace SyntheticData {
+
+  double x(qint64 i);
+  double y(qint64 i);
+
+  // three columns (x, y, i%97); fields "Column 1" and "Column 2"
+  bool writeAscii(const QString& fileName, qint64 rows);
+
+  // the same, gzip compressed.  Returns false if built without zlib.
+  bool writeAsciiGzip(const QString& fileName, qint64 rows);
+  bool haveGzip();
+
+  // a directory with FLOAT64 RAW fields x and y, 1 sample per frame
+  bool writeDirfile(const QString& dirName, qint64 frames);
+
+  // 1D datasets x and y.  Returns false if built without HDF5.
+  bool writeHdf5(const QString& fileName, qint64 rows);
+  bool haveHdf5();
+}
+
+#endif
+
+// vim: ts=2 sw=2 et
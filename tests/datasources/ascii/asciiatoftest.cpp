@@ -18,6 +18,8 @@
 #include <QtTest>
 #include <QTime>
 
+#include <string.h>
+
 
 class kst_atofTest: public QObject
 {
@@ -99,6 +101,87 @@ private slots:
   }
 
 
+  void isoDateAndTime()
+  {
+      // the fixed width fast path must agree with QDateTime
+      LexicalCast::instance().setUseDotAsDecimalSeparator(true);
+      LexicalCast::instance().setNaNMode(LexicalCast::NaNValue);
+      const char* times[] = { "2011-11-11T12:00:00.123", "1970-01-01T00:00:00.000", "1900-03-01T23:59:59.999",
+                              "2000-02-29T06:07:08.009", "2024-12-31T00:00:01.500", "1969-07-20T20:17:40.000" };
+      setFormat("yyyy-MM-ddThh:mm:ss.zzz");
+      for (const char* t : times) {
+        QCOMPARE(LexicalCast::instance().toDouble(t), msecsToDate(t, "yyyy-MM-ddThh:mm:ss.zzz"));
+      }
+      QVERIFY(KST_ISNAN(LexicalCast::instance().toDouble("2001-02-29T00:00:00.000")));
+      QVERIFY(KST_ISNAN(LexicalCast::instance().toDouble("2011-11-11T24:00:00.000")));
+      QVERIFY(KST_ISNAN(LexicalCast::instance().toDouble("2011-11-11 12:00:00.000")));
+  }
+
+
+  void doubleAccuracy()
+  {
+      LexicalCast::instance().setUseDotAsDecimalSeparator(true);
+      LexicalCast::instance().setTimeFormat(QString());
+
+      const char* edges[] = { "0", "-0", "1", "0.1", "0.3", "1e23", "9007199254740993", "4.9e-324",
+                              "2.4703282292062328e-324", "2.2250738585072011e-308", "1.7976931348623157e308",
+                              "1.7976931348623159e308", "12345678901234567890", "7.3177701707893310e+15",
+                              "1.00000000000000011102230246251565404236316680908203125" };
+      for (const char* e : edges) {
+        QCOMPARE(LexicalCast::instance().fromDouble(e), strtod(e, 0));
+      }
+
+      // every double, printed with from 1 to 17 digits
+      quint64 bits = 0x9E3779B97F4A7C15ULL;
+      char buf[64];
+      for (int i = 0; i < 200000; i++) {
+        bits ^= bits << 13; bits ^= bits >> 7; bits ^= bits << 17;
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        if (KST_ISNAN(d) || d - d != 0) {
+          continue;
+        }
+        qsnprintf(buf, sizeof(buf), "%.*e", 1 + i % 17, d);
+        const double a = LexicalCast::instance().fromDouble(buf);
+        const double b = strtod(buf, 0);
+        if (memcmp(&a, &b, sizeof(a)) != 0) {
+          QFAIL(qPrintable(QString("%1 parsed as %2").arg(buf).arg(a, 0, 'g', 17)));
+        }
+      }
+  }
+
+
+  void benchmarkDouble()
+  {
+      LexicalCast::instance().setUseDotAsDecimalSeparator(true);
+      QVector<QByteArray> values;
+      for (int i = 0; i < 10000; i++) {
+        values << QByteArray::number(i * 12.345678, 'f', 6);
+      }
+      double sum = 0;
+      QBENCHMARK {
+        for (const QByteArray& v : values) {
+          sum += LexicalCast::instance().fromDouble(v.constData());
+        }
+      }
+      QVERIFY(sum > 0);
+  }
+
+
+  void benchmarkIsoTime()
+  {
+      setFormat("yyyy-MM-ddThh:mm:ss.zzz");
+      const QByteArray t = "2011-11-11T12:00:00.123";
+      double sum = 0;
+      QBENCHMARK {
+        for (int i = 0; i < 10000; i++) {
+          sum += LexicalCast::instance().toDouble(t.constData());
+        }
+      }
+      QVERIFY(sum > 0);
+  }
+
+
 };
 
 
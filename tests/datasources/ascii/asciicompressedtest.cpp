@@ -0,0 +1,132 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "asciicompressedfile.h"
+#include "asciifilebuffer.h"
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+#ifdef KST_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+
+class AsciiCompressedTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void initTestCase()
+    {
+      QVERIFY(dir.isValid());
+      plainName = dir.filePath("data.txt");
+      gzipName = dir.filePath("data.txt.gz");
+
+      // ~10 MB of three columns
+      QFile plain(plainName);
+      QVERIFY(plain.open(QIODevice::WriteOnly));
+      for (int row = 0; row < 400000; row++) {
+        plain.write(QString("%1 %2 %3\n").arg(row).arg(row * 0.25).arg(row % 97).toLatin1());
+      }
+      plain.close();
+
+#ifdef KST_HAVE_ZLIB
+      QVERIFY(plain.open(QIODevice::ReadOnly));
+      const QByteArray contents = plain.readAll();
+      gzFile gz = gzopen(QFile::encodeName(gzipName).constData(), "wb6");
+      QVERIFY(gz);
+      QCOMPARE(gzwrite(gz, contents.constData(), unsigned(contents.size())), int(contents.size()));
+      gzclose(gz);
+#endif
+    }
+
+    void format()
+    {
+      QCOMPARE(AsciiCompressedFile::format(plainName), AsciiCompressedFile::Plain);
+#ifdef KST_HAVE_ZLIB
+      QCOMPARE(AsciiCompressedFile::format(gzipName), AsciiCompressedFile::Gzip);
+#endif
+    }
+
+#ifdef KST_HAVE_ZLIB
+    void sizeAndIndex()
+    {
+      AsciiCompressedFile gz(gzipName);
+      QVERIFY(gz.open(QIODevice::ReadOnly));
+      QCOMPARE(gz.size(), QFileInfo(plainName).size());
+      QVERIFY(gz.seekPoints() > 5);
+    }
+
+    void readRanges()
+    {
+      QFile plain(plainName);
+      QVERIFY(plain.open(QIODevice::ReadOnly));
+      QScopedPointer<QIODevice> gz(AsciiFileBuffer::createFile(gzipName));
+      QVERIFY(AsciiFileBuffer::openFile(*gz));
+
+      // backwards, forwards, and across seek points
+      const qint64 size = plain.size();
+      const qint64 starts[] = { size - 1000, 0, size / 2, size / 2 + 100, 3 * 1024 * 1024 - 10, 17, size / 3 };
+      for (qint64 start : starts) {
+        QVERIFY(plain.seek(start));
+        QVERIFY(gz->seek(start));
+        QCOMPARE(gz->read(200000), plain.read(200000));
+      }
+      QVERIFY(gz->seek(size));
+      QVERIFY(gz->atEnd());
+    }
+
+    void headerLines()
+    {
+      // reading lines from the start must not need the index
+      AsciiCompressedFile gz(gzipName);
+      QVERIFY(gz.open(QIODevice::ReadOnly));
+      QCOMPARE(gz.readLine(), QByteArray("0 0 0\n"));
+      QCOMPARE(gz.readLine(), QByteArray("1 0.25 1\n"));
+      QVERIFY(!gz.atEnd());
+      QCOMPARE(gz.pos(), qint64(15));
+    }
+
+    void benchmarkPlain()
+    {
+      QFile plain(plainName);
+      QVERIFY(plain.open(QIODevice::ReadOnly));
+      QBENCHMARK {
+        plain.seek(plain.size() * 3 / 4);
+        plain.read(1024 * 1024);
+      }
+    }
+
+    void benchmarkGzip()
+    {
+      AsciiCompressedFile gz(gzipName);
+      QVERIFY(gz.open(QIODevice::ReadOnly));
+      gz.size(); // index once, as AsciiSource does on update
+      QBENCHMARK {
+        gz.seek(gz.size() * 3 / 4);
+        gz.read(1024 * 1024);
+      }
+    }
+#endif
+
+private:
+    QTemporaryDir dir;
+    QString plainName;
+    QString gzipName;
+};
+
+
+
+QTEST_MAIN(AsciiCompressedTest)
+
+#include "moc_asciicompressedtest.cpp"
@@ -0,0 +1,98 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef FAKESOURCE_H
+#define FAKESOURCE_H
+
+#include <QAtomicInt>
+#include <QThread>
+
+#include <datasource.h>
+#include <datavector.h>
+
+// A source with one vector field, for the tests.  Sample i of the field is
+// value(i), or i.  The test sets frames; the source reports them on its
+// next update, so that setting them grows it.  Nothing is stored, so any
+// number of frames can be read.
+class FakeSource : public Kst::DataSource {
+  public:
+    typedef double (*Generator)(qint64 sample);
+
+    explicit FakeSource(const QString& field, Kst::ObjectStore *store = 0, const QString& fileName = QString()) :
+      Kst::DataSource(store, 0, fileName, QString()), field(field), value(0),
+      frames(0), reported(0), delay(0), readDelay(0), batches(0), updateThread(0) {
+      setInterface(new Vector(*this));
+      _valid = true;
+    }
+
+    UpdateType internalDataSourceUpdate() {
+      updateThread = QThread::currentThread();
+      QThread::msleep(delay);
+      const bool grew = frames != reported;
+      reported = frames;
+      return grew ? Updated : NoChange;
+    }
+
+    QString field;
+    Generator value;
+    qint64 frames;
+    qint64 reported;
+    int delay;        // ms each update takes
+    int readDelay;    // ms each read takes
+    QAtomicInt reads;
+    QAtomicInt reading;    // reads running now
+    QAtomicInt maxReading; // the most reads which ever ran at once
+    int batches;
+    QThread *updateThread;
+
+  private:
+    struct Vector : public Kst::DataSource::DataInterface<Kst::DataVector> {
+      explicit Vector(FakeSource &s) : source(s) {}
+      void prepareRead(int) { source.batches++; }
+      qint64 read(const QString&, Kst::DataVector::ReadInfo &p) {
+        source.reads.ref();
+        const int now = source.reading.fetchAndAddOrdered(1) + 1;
+        int most = source.maxReading.loadAcquire();
+        while (now > most && !source.maxReading.testAndSetOrdered(most, now)) {
+          most = source.maxReading.loadAcquire();
+        }
+        QThread::msleep(source.readDelay);
+
+        qint64 n;
+        if (p.singleSample || p.numberOfFrames < 0) {
+          n = qint64(p.startingFrame) < source.reported ? 1 : 0;
+        } else {
+          n = qMax(qMin(qint64(p.numberOfFrames), source.reported - qint64(p.startingFrame)), qint64(0));
+        }
+        for (qint64 i = 0; i < n; ++i) {
+          const qint64 sample = qint64(p.startingFrame) + i;
+          p.data[i] = source.value ? source.value(sample) : double(sample);
+        }
+        source.reading.deref();
+        return n;
+      }
+      QStringList list() const { return QStringList(source.field); }
+      bool isListComplete() const { return true; }
+      bool isValid(const QString& field) const { return field == source.field; }
+      const Kst::DataVector::DataInfo dataInfo(const QString&, double frame = 0) const {
+        Q_UNUSED(frame)
+        return Kst::DataVector::DataInfo(double(source.reported), 1);
+      }
+      void setDataInfo(const QString&, const Kst::DataVector::DataInfo&) {}
+      QMap<QString, double> metaScalars(const QString&) { return QMap<QString, double>(); }
+      QMap<QString, QString> metaStrings(const QString&) { return QMap<QString, QString>(); }
+      FakeSource &source;
+    };
+};
+
+#endif
+
+// vim: ts=2 sw=2 et
@@ -19,6 +19,7 @@
 #include <eparse-eh.h>
 #include <objectstore.h>
 #include <generatedvector.h>
+#include <equation.h>
 
 KSTMATH_EXPORT extern /*"C"*/ int yyparse(Kst::ObjectStore *store);
 KSTMATH_EXPORT extern /*"C"*/ void *ParsedEquation;
@@ -157,6 +158,17 @@ bool TestEqParser::validateParserFailures(const char *equation) {
 
 
 
+bool TestEqParser::isPointwise(const char *equation) {
+  yy_scan_string(equation);
+  int rc = yyparse(&_store);
+  Equations::Node *eq = static_cast<Equations::Node*>(ParsedEquation);
+  ParsedEquation = 0L;
+  const bool pointwise = rc == 0 && eq && eq->isPointwise();
+  delete eq;
+  return pointwise;
+}
+
+
 void TestEqParser::testEqParser() {
 
   // Base cases
@@ -633,6 +645,95 @@ void TestEqParser::testEqParser() {
   QVERIFY(validateParserFailures("2*sin(x)()"));
 }
 
+// uses the vectors testEqParser() made
+void TestEqParser::testPointwise() {
+  QVERIFY(isPointwise("x"));
+  QVERIFY(isPointwise("2*sin([gvector6]) + x^2"));
+  QVERIFY(isPointwise("[gvector3] - [gvector2]"));
+  QVERIFY(isPointwise("-x > 1 && !(x < 3)"));
+  QVERIFY(isPointwise("atan2(x, [gvector3])"));
+  QVERIFY(isPointwise("pi*[sdf]"));
+  QVERIFY(!isPointwise("[gvector3[9]]"));
+  QVERIFY(!isPointwise("x + [gvector3[5+4]]"));
+  QVERIFY(!isPointwise("[=10+10]*x"));
+}
+
+
+static void update(Kst::ObjectPtr object, qint64 serial) {
+  object->writeLock();
+  object->objectUpdate(serial);
+  object->unlock();
+}
+
+
+// An equation over inputs that have only grown evaluates the new samples
+// only, unless its expression reaches beyond the sample it is on.
+void TestEqParser::testAppendedSamples() {
+  Kst::VectorPtr v = _store.createObject<Kst::Vector>();
+  v->setDescriptiveName("appended");
+  v->writeLock();
+  v->resize(10);
+  for (int i = 0; i < 10; ++i) {
+    v->raw_V_ptr()[i] = i;
+  }
+  v->registerChange();
+  v->unlock();
+
+  Kst::EquationPtr pointwise = _store.createObject<Kst::Equation>();
+  pointwise->setEquation("2*x");
+  pointwise->setExistingXVector(v, false);
+  Kst::EquationPtr indexed = _store.createObject<Kst::Equation>();
+  indexed->setEquation("x + [appended[1]]");
+  indexed->setExistingXVector(v, false);
+  pointwise->registerChange();
+  indexed->registerChange();
+
+  update(v, 1);
+  update(pointwise, 1);
+  update(indexed, 1);
+  QCOMPARE(pointwise->vY()->length(), qint64(10));
+  QCOMPARE(pointwise->vY()->value(3), 6.0);
+  QCOMPARE(indexed->vY()->value(3), 4.0);
+
+  // ten samples appended; the first is changed behind the equations' backs
+  // to show which samples they evaluate
+  v->writeLock();
+  v->resize(20);
+  for (int i = 10; i < 20; ++i) {
+    v->raw_V_ptr()[i] = i;
+  }
+  v->raw_V_ptr()[0] = 100.0;
+  v->raw_V_ptr()[1] = 50.0;
+  v->setUnchanged(10, v->serialOfLastChange());
+  v->registerChange();
+  v->unlock();
+
+  update(v, 2);
+  update(pointwise, 2);
+  update(indexed, 2);
+  QCOMPARE(pointwise->vY()->length(), qint64(20));
+  QCOMPARE(pointwise->vY()->value(0), 0.0);
+  QCOMPARE(pointwise->vY()->value(15), 30.0);
+  QCOMPARE(pointwise->vY()->numUnchanged(), qint64(10));
+  QCOMPARE(indexed->vY()->value(0), 150.0);
+  QCOMPARE(indexed->vY()->numUnchanged(), qint64(0));
+
+  // a new expression starts over
+  pointwise->writeLock();
+  pointwise->setEquation("3*x");
+  pointwise->registerChange();
+  pointwise->unlock();
+  update(v, 3);
+  update(pointwise, 3);
+  QCOMPARE(pointwise->vY()->value(0), 300.0);
+  QCOMPARE(pointwise->vY()->numUnchanged(), qint64(0));
+
+  _store.removeObject(pointwise);
+  _store.removeObject(indexed);
+  _store.removeObject(v);
+}
+
+
 QTEST_MAIN(TestEqParser)
 
 // vim: ts=2 sw=2 et
@@ -21,10 +21,13 @@ class TestEqParser : public QObject
     bool validateText(const char *equation, const char *expect);
     bool validateParserFailures(const char *equation);
     bool validateEquation(const char *equation, double x, double result, const double tol = 0.00000000001);
+    bool isPointwise(const char *equation);
   private Q_SLOTS:
     void cleanupTestCase();
 
     void testEqParser();
+    void testPointwise();
+    void testAppendedSamples();
 };
 
 #endif
@@ -13,16 +13,70 @@
 
 #include <QtTest>
 
+#include <math.h>
+
 #include <generatedvector.h>
 #include <datacollection.h>
+#include <datasource.h>
+#include <datavector.h>
+#include <editablevector.h>
 #include <objectstore.h>
 
 
 #include <histogram.h>
 
+#include "fakesource.h"
 
 static Kst::ObjectStore _store;
 
+// sample i of field "x": repeats every 1009 samples, with a NaN now and then
+static double sampleValue(qint64 i) {
+  if (i % 997 == 500) {
+    return NAN;
+  }
+  return double((i * 37) % 1009) / 100.0;
+}
+
+
+// the histogram binned one sample at a time, as it always was
+static QVector<double> referenceCounts(Kst::HistogramPtr h) {
+  QVector<double> counts(h->numberOfBins(), 0.0);
+  Kst::VectorPtr v = h->vector();
+  const double w = (h->xMax() - h->xMin())/double(h->numberOfBins());
+  for (qint64 i = 0; i < v->length(); ++i) {
+    const double y = v->value(i);
+    const int i_bin = (int)floor((y - h->xMin())/w);
+    if (y == y && i_bin >= 0 && i_bin < h->numberOfBins()) {
+      counts[i_bin]++;
+    } else if (y == h->xMax()) {
+      counts[h->numberOfBins()-1]++;
+    }
+  }
+  return counts;
+}
+
+
+static void compareCounts(Kst::HistogramPtr h) {
+  const QVector<double> expected = referenceCounts(h);
+  QCOMPARE(h->vY()->length(), qint64(expected.size()));
+  for (int i = 0; i < expected.size(); ++i) {
+    QCOMPARE(h->vY()->value(i), expected[i]);
+  }
+}
+
+
+static void updateAll(qint64 serial, Kst::DataSourcePtr ds, Kst::DataVectorPtr dv, Kst::HistogramPtr h) {
+  ds->writeLock();
+  ds->objectUpdate(serial);
+  ds->unlock();
+  dv->writeLock();
+  dv->objectUpdate(serial);
+  dv->unlock();
+  h->writeLock();
+  h->objectUpdate(serial);
+  h->unlock();
+}
+
 void TestHistogram::cleanupTestCase() {
   _store.clear();
 }
@@ -143,6 +197,89 @@ void TestHistogram::testHistogram() {
   QCOMPARE(h1->xMax(), 10.0);
 }
 
+void TestHistogram::testParallelBinning() {
+  // big enough to be split between threads
+  const qint64 ns = 3000001;
+  Kst::EditableVectorPtr vp = Kst::kst_cast<Kst::EditableVector>(_store.createObject<Kst::EditableVector>());
+  vp->resize(ns);
+  double *v = vp->raw_V_ptr();
+  for (qint64 i = 0; i < ns; ++i) {
+    v[i] = sampleValue(i);
+  }
+  v[ns-1] = 8.0; // exactly the top of the range
+
+  Kst::HistogramPtr h = Kst::kst_cast<Kst::Histogram>(_store.createObject<Kst::Histogram>());
+  h->change(Kst::VectorPtr(vp), 1.0, 8.0, 37, Kst::Histogram::Number);
+  h->writeLock();
+  h->internalUpdate();
+  h->unlock();
+  compareCounts(h);
+
+  // and serially
+  vp->resize(1000);
+  h->writeLock();
+  h->internalUpdate();
+  h->unlock();
+  compareCounts(h);
+}
+
+
+void TestHistogram::testAppend() {
+  Kst::SharedPtr<FakeSource> source = new FakeSource("x");
+  source->value = sampleValue;
+  source->frames = 500;
+  Kst::DataSourcePtr ds(source);
+
+  Kst::DataVectorPtr dv = Kst::kst_cast<Kst::DataVector>(_store.createObject<Kst::DataVector>());
+  dv->writeLock();
+  dv->change(ds, "x", 0, false, -1, true, 1, false, false);
+  dv->unlock();
+
+  Kst::HistogramPtr h = Kst::kst_cast<Kst::Histogram>(_store.createObject<Kst::Histogram>());
+  h->change(Kst::VectorPtr(dv), 0.0, 10.0, 20, Kst::Histogram::Number);
+
+  qint64 serial = 1;
+  updateAll(serial, ds, dv, h);
+  QCOMPARE(dv->length(), qint64(500));
+  compareCounts(h);
+
+  // appended: the vector says its first samples are as they were
+  source->frames = 2000;
+  updateAll(++serial, ds, dv, h);
+  QCOMPARE(dv->length(), qint64(2000));
+  QCOMPARE(dv->numUnchanged(), qint64(500));
+  compareCounts(h);
+
+  // nothing new
+  updateAll(++serial, ds, dv, h);
+  compareCounts(h);
+
+  source->frames = 2001;
+  updateAll(++serial, ds, dv, h);
+  compareCounts(h);
+
+  // the bins move: everything is binned again
+  h->setXRange(2.0, 9.0);
+  source->frames = 4000;
+  updateAll(++serial, ds, dv, h);
+  compareCounts(h);
+
+  // auto-binned, with the new samples inside the old range
+  h->setRealTimeAutoBin(true);
+  source->frames = 5000;
+  updateAll(++serial, ds, dv, h);
+  compareCounts(h);
+  const double x_min = h->xMin();
+  const double x_max = h->xMax();
+  source->frames = 8000;
+  updateAll(++serial, ds, dv, h);
+  QCOMPARE(h->xMin(), x_min);
+  QCOMPARE(h->xMax(), x_max);
+  QCOMPARE(dv->numUnchanged(), qint64(5000));
+  compareCounts(h);
+}
+
+
 QTEST_MAIN(TestHistogram)
 
 // vim: ts=2 sw=2 et
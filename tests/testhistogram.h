@@ -21,6 +21,8 @@ class TestHistogram : public QObject
     void cleanupTestCase();
 
     void testHistogram();
+    void testParallelBinning();
+    void testAppend();
 };
 
 #endif
@@ -0,0 +1,180 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "testlivestream.h"
+
+#include <QtTest>
+
+#include <QTemporaryDir>
+
+#include <livestream.h>
+#include <math_kst.h>
+
+using namespace Kst;
+
+// count frames of fields doubles: field f of frame i is 1000*f + first + i
+static QVector<double> frames(int fields, qint64 first, qint64 count) {
+  QVector<double> v;
+  for (qint64 i = 0; i < count; ++i) {
+    for (int f = 0; f < fields; ++f) {
+      v.append(1000*f + first + i);
+    }
+  }
+  return v;
+}
+
+
+void TestLiveStream::testHeader() {
+  const QStringList fields = QStringList() << "time" << "temperature" << QString(40, 'x');
+  const QByteArray header = LiveStream::header(fields);
+  QCOMPARE(header.size(), 16 + 3*LiveStream::NameBytes);
+
+  QStringList parsed;
+  QCOMPARE(LiveStream::parseHeader(header + QByteArray(8, '\0'), &parsed), header.size());
+  QCOMPARE(parsed[0], QString("time"));
+  QCOMPARE(parsed[1], QString("temperature"));
+  // names are cut to fit
+  QCOMPARE(parsed[2], QString(LiveStream::NameBytes - 1, 'x'));
+
+  // more is needed
+  QCOMPARE(LiveStream::parseHeader(header.left(5), &parsed), 0);
+  QCOMPARE(LiveStream::parseHeader(header.left(12), &parsed), 0);
+  QCOMPARE(LiveStream::parseHeader(header.left(header.size() - 1), &parsed), 0);
+
+  // not a stream
+  QCOMPARE(LiveStream::parseHeader(QByteArray("1 2 3\n"), &parsed), -1);
+  QCOMPARE(LiveStream::parseHeader(LiveStream::header(QStringList()), &parsed), -1);
+}
+
+
+void TestLiveStream::testHistory() {
+  LiveHistory history(100);
+  history.reset(QStringList() << "a" << "b");
+  const QVector<double> in = frames(2, 0, 10);
+  history.append(in.constData(), 4);
+  history.append(in.constData() + 8, 6);
+  QCOMPARE(history.frames(), qint64(10));
+
+  QVector<double> out(20, -1.0);
+  QCOMPARE(history.read(1, 3, 5, out.data()), qint64(5));
+  for (int i = 0; i < 5; ++i) {
+    QCOMPARE(out[i], 1003.0 + i);
+  }
+
+  // only what has come in
+  QCOMPARE(history.read(0, 8, 10, out.data()), qint64(2));
+  QCOMPARE(out[1], 9.0);
+  QCOMPARE(history.read(0, 10, 10, out.data()), qint64(0));
+  QCOMPARE(history.read(2, 0, 10, out.data()), qint64(-1));
+
+  history.reset(QStringList() << "c");
+  QCOMPARE(history.frames(), qint64(0));
+  QCOMPARE(history.read(1, 0, 10, out.data()), qint64(-1));
+}
+
+
+void TestLiveStream::testHistoryWraps() {
+  LiveHistory history(8);
+  history.reset(QStringList() << "a" << "b");
+  const QVector<double> in = frames(2, 0, 13);
+  history.append(in.constData(), 13);
+  QCOMPARE(history.frames(), qint64(13));
+
+  // frames 0 to 4 are gone; 5 to 7 are at the end of the ring, 8 to 12 at
+  // its start
+  QVector<double> out(13, -1.0);
+  QCOMPARE(history.read(1, 0, 13, out.data()), qint64(13));
+  for (int i = 0; i < 5; ++i) {
+    QVERIFY(KST_ISNAN(out[i]));
+  }
+  for (int i = 5; i < 13; ++i) {
+    QCOMPARE(out[i], 1000.0 + i);
+  }
+
+  QCOMPARE(history.read(0, 11, 2, out.data()), qint64(2));
+  QCOMPARE(out[0], 11.0);
+  QCOMPARE(out[1], 12.0);
+}
+
+
+void TestLiveStream::testStream() {
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const QString server = dir.filePath("telemetry");
+
+  LiveStreamProducer producer(QStringList() << "t" << "v");
+  QVERIFY(producer.listen(server));
+
+  LiveStreamReader reader(producer.fullServerName(), 1000);
+  QSignalSpy arrived(&reader, SIGNAL(framesArrived()));
+  QTRY_COMPARE(producer.readers(), 1);
+  QTRY_VERIFY(reader.hasHeader());
+  QCOMPARE(reader.history().fields(), QStringList() << "t" << "v");
+
+  // frames come in as they are sent, whatever the pieces they arrive in
+  const QVector<double> in = frames(2, 0, 3000);
+  producer.send(in.constData(), 1);
+  QTRY_COMPARE(reader.history().frames(), qint64(1));
+  QVERIFY(arrived.count() >= 1);
+  producer.send(in.constData() + 2, 2999);
+  QTRY_COMPARE(reader.history().frames(), qint64(3000));
+
+  // the last 1000 are kept
+  QVector<double> out(3000);
+  QCOMPARE(reader.history().read(1, 0, 3000, out.data()), qint64(3000));
+  QVERIFY(KST_ISNAN(out[1999]));
+  for (int i = 2000; i < 3000; ++i) {
+    QCOMPARE(out[i], 1000.0 + i);
+  }
+}
+
+
+void TestLiveStream::testProducerReturns() {
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const QString server = dir.filePath("telemetry");
+
+  LiveStreamProducer *producer = new LiveStreamProducer(QStringList() << "a");
+  QVERIFY(producer->listen(server));
+  LiveStreamReader reader(producer->fullServerName());
+  QTRY_VERIFY(reader.hasHeader());
+  const QVector<double> in = frames(1, 0, 10);
+  producer->send(in.constData(), 10);
+  QTRY_COMPARE(reader.history().frames(), qint64(10));
+
+  // the same fields carry on where they were
+  const QString name = producer->fullServerName();
+  delete producer;
+  QTRY_VERIFY(!reader.hasHeader());
+  producer = new LiveStreamProducer(QStringList() << "a");
+  QVERIFY(producer->listen(server));
+  QTRY_VERIFY_WITH_TIMEOUT(reader.hasHeader(), 3*LiveStreamReader::RetryPeriod);
+  producer->send(in.constData(), 5);
+  QTRY_COMPARE(reader.history().frames(), qint64(15));
+
+  // other fields start again
+  delete producer;
+  QTRY_VERIFY(!reader.hasHeader());
+  QSignalSpy changed(&reader, SIGNAL(fieldsChanged()));
+  producer = new LiveStreamProducer(QStringList() << "b" << "c");
+  QVERIFY(producer->listen(server));
+  QTRY_VERIFY_WITH_TIMEOUT(reader.hasHeader(), 3*LiveStreamReader::RetryPeriod);
+  QCOMPARE(changed.count(), 1);
+  QCOMPARE(reader.history().fields(), QStringList() << "b" << "c");
+  QCOMPARE(reader.history().frames(), qint64(0));
+  QCOMPARE(producer->fullServerName(), name);
+  delete producer;
+}
+
+
+QTEST_MAIN(TestLiveStream)
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,30 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TESTLIVESTREAM_H
+#define TESTLIVESTREAM_H
+
+#include <QObject>
+
+class TestLiveStream : public QObject
+{
+  Q_OBJECT
+  private Q_SLOTS:
+    void testHeader();
+    void testHistory();
+    void testHistoryWraps();
+    void testStream();
+    void testProducerReturns();
+};
+
+#endif
+
+// vim: ts=2 sw=2 et
@@ -17,6 +17,7 @@
 #include <datavector.h>
 #include <objectstore.h>
 #include <scalar.h>
+#include <updatemanager.h>
 #include <vector.h>
 
 using namespace Kst;
@@ -60,6 +61,50 @@ void TestObjectStore::testObjectStore() {
   QVERIFY(!p);  // make sure object gets deleted when last reference is gone
 }
 
+void TestObjectStore::testTransaction() {
+  ObjectStore store;
+  UpdateManager::self()->setStore(&store);
+  const qint64 serial = UpdateManager::self()->serial();
+
+  ObjectTransaction transaction(&store);
+  QVERIFY(store.inTransaction());
+  QVERIFY(UpdateManager::self()->inTransaction());
+  VectorPtr vec = store.createObject<Vector>();
+  UpdateManager::self()->doUpdates(true);
+  QCOMPARE(UpdateManager::self()->serial(), serial); // held back
+
+  store.beginTransaction(); // nested
+  UpdateManager::self()->doUpdates(true);
+  store.endTransaction();
+  QVERIFY(store.inTransaction());
+  QCOMPARE(UpdateManager::self()->serial(), serial);
+
+  transaction.commit();
+  QVERIFY(!store.inTransaction());
+  QCOMPARE(UpdateManager::self()->serial(), serial + 1); // one update for all of it
+  QCOMPARE(vec->serial(), serial + 1);
+
+  // nothing made, nothing asked for: nothing to do
+  store.beginTransaction();
+  store.endTransaction();
+  QCOMPARE(UpdateManager::self()->serial(), serial + 1);
+
+  UpdateManager::self()->setStore(0);
+}
+
+void TestObjectStore::testSortedByInputs() {
+  ObjectStore store;
+  VectorPtr vec = store.createObject<Vector>();
+
+  // the vector's scalars are made, and listed, before it
+  const QList<ObjectPtr> objects = store.objectList();
+  QVERIFY(objects.indexOf(ObjectPtr(vec.data())) > 0);
+
+  const QList<ObjectPtr> sorted = UpdateManager::sortedByInputs(objects);
+  QCOMPARE(sorted.count(), objects.count());
+  QVERIFY(sorted.first() == ObjectPtr(vec.data()));
+}
+
 QTEST_MAIN(TestObjectStore)
 
 // vim: ts=2 sw=2 et
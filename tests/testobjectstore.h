@@ -22,6 +22,8 @@ class TestObjectStore : public QObject
     void cleanupTestCase();
 
     void testObjectStore();
+    void testTransaction();
+    void testSortedByInputs();
 };
 
 #endif
@@ -0,0 +1,116 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "testpluginregistry.h"
+
+#include <QtTest>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <pluginregistry.h>
+
+using Kst::PluginRegistry;
+
+static QString writeFile(const QTemporaryDir &dir, const QString &name, const QByteArray &contents) {
+  const QString path = dir.filePath(name);
+  QFile f(path);
+  if (f.open(QIODevice::WriteOnly)) {
+    f.write(contents);
+  }
+  return path;
+}
+
+
+void TestPluginRegistry::testNoSignatures() {
+  PluginRegistry::Probe probe("/no/such/file.dat");
+  QVERIFY(PluginRegistry::matches(QStringList(), &probe));
+  QVERIFY(!probe.read);
+}
+
+
+void TestPluginRegistry::testPatterns() {
+  const QStringList signatures = QStringList() << "*.h5" << "*.hdf5";
+
+  PluginRegistry::Probe h5("/data/run1.h5");
+  QVERIFY(PluginRegistry::matches(signatures, &h5));
+  PluginRegistry::Probe upper("/data/RUN1.HDF5");
+  QVERIFY(PluginRegistry::matches(signatures, &upper));
+  PluginRegistry::Probe ascii("/data/run1.dat");
+  QVERIFY(!PluginRegistry::matches(signatures, &ascii));
+  // patterns are matched against the name, not the directory
+  PluginRegistry::Probe dir("/data/x.h5/run1.dat");
+  QVERIFY(!PluginRegistry::matches(signatures, &dir));
+  QVERIFY(!ascii.read);
+}
+
+
+void TestPluginRegistry::testMagic() {
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const QString fits = writeFile(dir, "image", QByteArray("SIMPLE  =                    T"));
+  const QString ascii = writeFile(dir, "table", QByteArray("1 2 3\n4 5 6\n"));
+  const QString offset = writeFile(dir, "offset", QByteArray(8, '\0') + QByteArray::fromHex("cafe"));
+
+  const QStringList signatures = QStringList() << "magic:0:53494d504c45" << "magic:0:1f8b";
+  PluginRegistry::Probe fitsProbe(fits);
+  QVERIFY(PluginRegistry::matches(signatures, &fitsProbe));
+  PluginRegistry::Probe asciiProbe(ascii);
+  QVERIFY(!PluginRegistry::matches(signatures, &asciiProbe));
+
+  PluginRegistry::Probe offsetProbe(offset);
+  QVERIFY(PluginRegistry::matches(QStringList() << "magic:8:cafe", &offsetProbe));
+  QVERIFY(!PluginRegistry::matches(QStringList() << "magic:7:cafe", &offsetProbe));
+
+  // a name pattern is enough, whatever the contents
+  QVERIFY(!PluginRegistry::matches(QStringList() << "magic:0:1f8b" << "*.dat", &asciiProbe));
+  PluginRegistry::Probe named(writeFile(dir, "table.dat", "1 2 3\n"));
+  QVERIFY(PluginRegistry::matches(QStringList() << "magic:0:1f8b" << "*.dat", &named));
+}
+
+
+void TestPluginRegistry::testUnreadable() {
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  // only understands() can tell about these
+  const QStringList signatures = QStringList() << "magic:0:53494d504c45";
+  PluginRegistry::Probe missing(dir.filePath("image.fits[1]"));
+  QVERIFY(PluginRegistry::matches(signatures, &missing));
+  PluginRegistry::Probe directory(dir.path());
+  QVERIFY(PluginRegistry::matches(signatures, &directory));
+
+  PluginRegistry::Probe beyond(writeFile(dir, "short", "x"));
+  QVERIFY(PluginRegistry::matches(QStringList() << QString("magic:%1:00").arg(PluginRegistry::HeadBytes), &beyond));
+  PluginRegistry::Probe bad(writeFile(dir, "bad", "x"));
+  QVERIFY(PluginRegistry::matches(QStringList() << "magic:zero:00", &bad));
+}
+
+
+void TestPluginRegistry::testProbeReadOnce() {
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const QString path = writeFile(dir, "data", QByteArray::fromHex("b0e60400"));
+
+  PluginRegistry::Probe probe(path);
+  QVERIFY(PluginRegistry::matches(QStringList() << "magic:0:b0e6", &probe));
+  QVERIFY(probe.read);
+
+  // the next plugin asked sees the same head, even if the file changes
+  QFile::remove(path);
+  QVERIFY(!PluginRegistry::matches(QStringList() << "magic:0:e6b0", &probe));
+  QVERIFY(PluginRegistry::matches(QStringList() << "magic:2:0400", &probe));
+}
+
+
+QTEST_MAIN(TestPluginRegistry)
+
+// vim: ts=2 sw=2 et
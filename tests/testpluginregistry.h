@@ -0,0 +1,30 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TESTPLUGINREGISTRY_H
+#define TESTPLUGINREGISTRY_H
+
+#include <QObject>
+
+class TestPluginRegistry : public QObject
+{
+  Q_OBJECT
+  private Q_SLOTS:
+    void testNoSignatures();
+    void testPatterns();
+    void testMagic();
+    void testUnreadable();
+    void testProbeReadOnce();
+};
+
+#endif
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,192 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "testreadahead.h"
+
+#include <QtTest>
+
+#include <datasource.h>
+#include <datavector.h>
+#include <readahead.h>
+
+#include "fakesource.h"
+
+using namespace Kst;
+
+static ReadAhead::Request request(double f0, double nf, double reqF0, double reqNF, bool readToEnd) {
+  ReadAhead::Request r;
+  r.field = "ramp";
+  r.f0 = f0;
+  r.nf = nf;
+  r.reqF0 = reqF0;
+  r.reqNF = reqNF;
+  r.readToEnd = readToEnd;
+  r.countFromEnd = !readToEnd;
+  return r;
+}
+
+
+void TestReadAhead::cleanup() {
+  // the jobs let go of their sources through the event loop
+  QCoreApplication::processEvents();
+}
+
+
+void TestReadAhead::testReadToEnd() {
+  SharedPtr<FakeSource> source = new FakeSource("ramp");
+  source->reported = 50;
+  source->frames = 100;
+  ReadAhead readAhead(source);
+
+  readAhead.start(QList<ReadAhead::Request>() << request(0, 50, 0, -1, true));
+  Object::UpdateType result = Object::NoChange;
+  QVERIFY(readAhead.collect(5000, &result));
+  QCOMPARE(result, Object::Updated);
+
+  // only the new frames were read
+  double v[50];
+  QCOMPARE(readAhead.take("ramp", 50, 50, v), qint64(50));
+  QCOMPARE(v[0], 50.0);
+  QCOMPARE(v[49], 99.0);
+  QCOMPARE(readAhead.take("ramp", 60, 10, v), qint64(10));
+  QCOMPARE(v[0], 60.0);
+  QCOMPARE(readAhead.take("ramp", 0, 10, v), qint64(-1));
+  QCOMPARE(readAhead.take("ramp", 90, 20, v), qint64(-1));
+  QCOMPARE(readAhead.take("other", 50, 10, v), qint64(-1));
+  readAhead.clear();
+}
+
+
+void TestReadAhead::testCountFromEnd() {
+  SharedPtr<FakeSource> source = new FakeSource("ramp");
+  source->reported = 100;
+  source->frames = 110;
+  ReadAhead readAhead(source);
+
+  // a window of 20 that moves by 10: keeps 10 frames, reads 10
+  readAhead.start(QList<ReadAhead::Request>() << request(80, 20, 0, 20, false));
+  Object::UpdateType result;
+  QVERIFY(readAhead.collect(5000, &result));
+  double v[10];
+  QCOMPARE(readAhead.take("ramp", 100, 10, v), qint64(10));
+  QCOMPARE(v[9], 109.0);
+  QCOMPARE(readAhead.take("ramp", 90, 10, v), qint64(-1));
+  readAhead.clear();
+
+  // a jump past the window starts it over
+  source->frames = 200;
+  readAhead.start(QList<ReadAhead::Request>() << request(90, 20, 0, 20, false));
+  QVERIFY(readAhead.collect(5000, &result));
+  QCOMPARE(readAhead.take("ramp", 180, 10, v), qint64(10));
+  QCOMPARE(v[0], 180.0);
+  readAhead.clear();
+}
+
+
+void TestReadAhead::testSharedField() {
+  SharedPtr<FakeSource> source = new FakeSource("ramp");
+  source->reported = 50;
+  source->frames = 100;
+  ReadAhead readAhead(source);
+
+  readAhead.start(QList<ReadAhead::Request>() << request(0, 50, 0, -1, true) << request(20, 30, 20, -1, true) << request(70, 20, 0, 20, false));
+  Object::UpdateType result;
+  QVERIFY(readAhead.collect(5000, &result));
+  QCOMPARE(source->reads.loadRelaxed(), 1);
+  double v[50];
+  QCOMPARE(readAhead.take("ramp", 50, 50, v), qint64(50));
+  QCOMPARE(readAhead.take("ramp", 90, 10, v), qint64(10));
+  readAhead.clear();
+}
+
+
+void TestReadAhead::testNoChange() {
+  SharedPtr<FakeSource> source = new FakeSource("ramp");
+  source->reported = source->frames = 100;
+  ReadAhead readAhead(source);
+
+  readAhead.start(QList<ReadAhead::Request>() << request(0, 100, 0, -1, true));
+  Object::UpdateType result = Object::Updated;
+  QVERIFY(readAhead.collect(5000, &result));
+  QCOMPARE(result, Object::NoChange);
+  QCOMPARE(source->reads.loadRelaxed(), 0);
+  readAhead.clear();
+}
+
+
+void TestReadAhead::testTimeout() {
+  SharedPtr<FakeSource> source = new FakeSource("ramp");
+  source->frames = 10;
+  source->delay = 300;
+  ReadAhead readAhead(source);
+
+  readAhead.start(QList<ReadAhead::Request>() << request(0, 0, 0, -1, true));
+  Object::UpdateType result;
+  QVERIFY(!readAhead.collect(20, &result));
+  QVERIFY(readAhead.isRunning());
+  double v[10];
+  QCOMPARE(readAhead.take("ramp", 0, 10, v), qint64(-1));
+
+  // starting again while it runs changes nothing
+  readAhead.start(QList<ReadAhead::Request>());
+
+  QVERIFY(readAhead.collect(5000, &result));
+  QCOMPARE(result, Object::Updated);
+  QCOMPARE(readAhead.take("ramp", 0, 10, v), qint64(10));
+  readAhead.clear();
+}
+
+
+void TestReadAhead::testClear() {
+  SharedPtr<FakeSource> source = new FakeSource("ramp");
+  source->frames = 10;
+  ReadAhead readAhead(source);
+
+  readAhead.start(QList<ReadAhead::Request>() << request(0, 0, 0, -1, true));
+  Object::UpdateType result;
+  QVERIFY(readAhead.collect(5000, &result));
+  readAhead.clear();
+  double v[10];
+  QCOMPARE(readAhead.take("ramp", 0, 10, v), qint64(-1));
+
+  source->frames = 20;
+  readAhead.start(QList<ReadAhead::Request>() << request(0, 10, 0, -1, true));
+  QVERIFY(readAhead.collect(5000, &result));
+  QCOMPARE(result, Object::Updated);
+  QCOMPARE(readAhead.take("ramp", 10, 10, v), qint64(10));
+  readAhead.clear();
+}
+
+
+void TestReadAhead::testInline() {
+  SharedPtr<FakeSource> source = new FakeSource("ramp");
+  source->frames = 30;
+  ReadAhead readAhead(source);
+
+  // done by the time start() returns, and read as one batch
+  readAhead.start(QList<ReadAhead::Request>() << request(0, 0, 0, -1, true) << request(0, 0, 0, 10, false), false);
+  QVERIFY(!readAhead.isRunning());
+  QCOMPARE(source->updateThread, QThread::currentThread());
+  QCOMPARE(source->batches, 1);
+
+  Object::UpdateType result;
+  QVERIFY(readAhead.collect(0, &result));
+  QCOMPARE(result, Object::Updated);
+  double v[30];
+  QCOMPARE(readAhead.take("ramp", 0, 30, v), qint64(30));
+  QCOMPARE(v[29], 29.0);
+  readAhead.clear();
+}
+
+
+QTEST_MAIN(TestReadAhead)
+
+// vim: ts=2 sw=2 et
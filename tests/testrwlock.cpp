@@ -0,0 +1,265 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "testrwlock.h"
+
+#include <QtTest>
+
+#include <QAtomicInt>
+#include <QSemaphore>
+#include <QThread>
+
+#include <rwlock.h>
+#include <sharedptr.h>
+
+using Kst::Borrowed;
+using Kst::Shared;
+using Kst::SharedPtr;
+
+// a lock that tells when a writer is waiting for it
+class WatchedLock : public KstRWLock {
+  public:
+    bool writerWaiting() const { return _state.loadAcquire() & WriterWaiting; }
+};
+
+
+class Counted : public Shared {
+  public:
+    explicit Counted(QAtomicInt *deleted) : _deleted(deleted) {}
+    ~Counted() { _deleted->ref(); }
+    int value() const { return 1; }
+  private:
+    QAtomicInt *_deleted;
+};
+
+typedef SharedPtr<Counted> CountedPtr;
+
+
+void TestRWLock::testRecursion() {
+  KstRWLock lock;
+  QCOMPARE(lock.myLockStatus(), KstRWLock::UNLOCKED);
+
+  lock.readLock();
+  lock.readLock();
+  QCOMPARE(lock.lockStatus(), KstRWLock::READLOCKED);
+  QCOMPARE(lock.myLockStatus(), KstRWLock::READLOCKED);
+  lock.unlock();
+  QCOMPARE(lock.myLockStatus(), KstRWLock::READLOCKED);
+  lock.unlock();
+  QCOMPARE(lock.lockStatus(), KstRWLock::UNLOCKED);
+
+  lock.writeLock();
+  lock.writeLock();
+  lock.readLock();
+  QCOMPARE(lock.myLockStatus(), KstRWLock::READLOCKED);
+  lock.unlock();
+  QCOMPARE(lock.myLockStatus(), KstRWLock::WRITELOCKED);
+  lock.unlock();
+  QCOMPARE(lock.lockStatus(), KstRWLock::WRITELOCKED);
+  lock.unlock();
+  QCOMPARE(lock.lockStatus(), KstRWLock::UNLOCKED);
+  QCOMPARE(lock.myLockStatus(), KstRWLock::UNLOCKED);
+
+  // not this thread's
+  QThread *other = QThread::create([&lock]() {
+    lock.writeLock();
+  });
+  other->start();
+  other->wait();
+  delete other;
+  QCOMPARE(lock.lockStatus(), KstRWLock::WRITELOCKED);
+  QCOMPARE(lock.myLockStatus(), KstRWLock::UNLOCKED);
+}
+
+
+void TestRWLock::testReadersShare() {
+  const int threads = 4;
+  KstRWLock lock;
+  QSemaphore inside;
+  QSemaphore leave;
+  QList<QThread*> readers;
+  for (int i = 0; i < threads; ++i) {
+    readers.append(QThread::create([&]() {
+      lock.readLock();
+      inside.release();
+      leave.acquire();
+      lock.unlock();
+    }));
+    readers.last()->start();
+  }
+
+  // every reader holds the lock at once
+  QVERIFY(inside.tryAcquire(threads, 5000));
+  QCOMPARE(lock.lockStatus(), KstRWLock::READLOCKED);
+  leave.release(threads);
+  foreach (QThread *reader, readers) {
+    reader->wait();
+    delete reader;
+  }
+  QCOMPARE(lock.lockStatus(), KstRWLock::UNLOCKED);
+}
+
+
+// A writer waiting behind a reader goes in before the readers that come
+// after it, which would otherwise keep it out for as long as they overlap.
+void TestRWLock::testWriterPreference() {
+  WatchedLock lock;
+  QAtomicInt order;
+  QAtomicInt writerTurn;
+  QAtomicInt readerTurn;
+
+  lock.readLock();
+
+  QThread *writer = QThread::create([&]() {
+    lock.writeLock();
+    writerTurn.storeRelease(order.fetchAndAddOrdered(1) + 1);
+    lock.unlock();
+  });
+  writer->start();
+  QTRY_VERIFY(lock.writerWaiting());
+
+  QThread *reader = QThread::create([&]() {
+    lock.readLock();
+    readerTurn.storeRelease(order.fetchAndAddOrdered(1) + 1);
+    lock.unlock();
+  });
+  reader->start();
+  QTest::qWait(50);
+  QCOMPARE(readerTurn.loadAcquire(), 0);
+  QCOMPARE(writerTurn.loadAcquire(), 0);
+
+  lock.unlock();
+  QVERIFY(writer->wait(5000));
+  QVERIFY(reader->wait(5000));
+  delete writer;
+  delete reader;
+
+  QCOMPARE(writerTurn.loadAcquire(), 1);
+  QCOMPARE(readerTurn.loadAcquire(), 2);
+  QCOMPARE(lock.lockStatus(), KstRWLock::UNLOCKED);
+}
+
+
+// Writers keep two counts equal; readers, nested two deep, must never see
+// them differ.
+void TestRWLock::testContention() {
+  const int readerThreads = 6;
+  const int writerThreads = 2;
+  const int rounds = 20000;
+
+  KstRWLock lock;
+  volatile qint64 a = 0;
+  volatile qint64 b = 0;
+  QAtomicInt torn;
+  QAtomicInt reads;
+
+  QList<QThread*> threads;
+  for (int i = 0; i < readerThreads; ++i) {
+    threads.append(QThread::create([&]() {
+      for (int j = 0; j < rounds; ++j) {
+        lock.readLock();
+        const qint64 first = a;
+        lock.readLock();
+        if (first != b) {
+          torn.ref();
+        }
+        lock.unlock();
+        lock.unlock();
+        reads.ref();
+      }
+    }));
+  }
+  for (int i = 0; i < writerThreads; ++i) {
+    threads.append(QThread::create([&]() {
+      for (int j = 0; j < rounds / 10; ++j) {
+        lock.writeLock();
+        a = a + 1;
+        QThread::yieldCurrentThread();
+        b = b + 1;
+        lock.unlock();
+      }
+    }));
+  }
+  foreach (QThread *thread, threads) {
+    thread->start();
+  }
+  foreach (QThread *thread, threads) {
+    QVERIFY(thread->wait(60000));
+    delete thread;
+  }
+
+  QCOMPARE(torn.loadRelaxed(), 0);
+  QCOMPARE(reads.loadRelaxed(), readerThreads * rounds);
+  QCOMPARE(qint64(a), qint64(writerThreads * (rounds / 10)));
+  QCOMPARE(qint64(b), qint64(a));
+  QCOMPARE(lock.lockStatus(), KstRWLock::UNLOCKED);
+}
+
+
+void TestRWLock::testSharedCount() {
+  const int threads = 8;
+  const int copies = 100000;
+  QAtomicInt deleted;
+
+  {
+    CountedPtr p = new Counted(&deleted);
+    QList<QThread*> copiers;
+    for (int i = 0; i < threads; ++i) {
+      copiers.append(QThread::create([&p]() {
+        for (int j = 0; j < copies; ++j) {
+          CountedPtr copy = p;
+          Q_UNUSED(copy)
+        }
+      }));
+      copiers.last()->start();
+    }
+    foreach (QThread *copier, copiers) {
+      copier->wait();
+      delete copier;
+    }
+    QCOMPARE(p.count(), 1);
+    QCOMPARE(deleted.loadRelaxed(), 0);
+  }
+  QCOMPARE(deleted.loadRelaxed(), 1);
+}
+
+
+void TestRWLock::testBorrowed() {
+  QAtomicInt deleted;
+  QList<CountedPtr> list;
+  for (int i = 0; i < 3; ++i) {
+    list.append(CountedPtr(new Counted(&deleted)));
+  }
+
+  int sum = 0;
+  for (Borrowed<Counted> c : Kst::borrow<Counted>(list)) {
+    QCOMPARE(c->_KShared_count(), 1);
+    sum += c->value();
+  }
+  QCOMPARE(sum, 3);
+
+  Borrowed<Counted> first = list.first();
+  Borrowed<Shared> base = first;
+  QVERIFY(base.data() == static_cast<Shared*>(first.data()));
+  QCOMPARE(list.first().count(), 1);
+  {
+    CountedPtr kept = first.keep();
+    QCOMPARE(list.first().count(), 2);
+  }
+
+  list.clear();
+  QCOMPARE(deleted.loadRelaxed(), 3);
+}
+
+
+QTEST_MAIN(TestRWLock)
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,31 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TESTRWLOCK_H
+#define TESTRWLOCK_H
+
+#include <QObject>
+
+class TestRWLock : public QObject
+{
+  Q_OBJECT
+  private Q_SLOTS:
+    void testRecursion();
+    void testReadersShare();
+    void testWriterPreference();
+    void testContention();
+    void testSharedCount();
+    void testBorrowed();
+};
+
+#endif
+
+// vim: ts=2 sw=2 et
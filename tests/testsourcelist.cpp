@@ -0,0 +1,96 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "testsourcelist.h"
+
+#include <QtTest>
+
+#include <QDomElement>
+#include <QSettings>
+#include <QTemporaryDir>
+
+#include <objectstore.h>
+
+#include <sourcelist.h>
+
+#include "fakesource.h"
+
+using namespace Kst;
+
+static double offsetSample(qint64 i) {
+  return 1000.0 + i;
+}
+
+
+void TestSourceList::testDuplicateEntry() {
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const QString a = dir.filePath("a.dat");
+  const QString b = dir.filePath("b.dat");
+  const QString listName = dir.filePath("list.txt");
+  QFile list(listName);
+  QVERIFY(list.open(QIODevice::WriteOnly));
+  list.write(QString(a + '\n' + b + '\n' + a + '\n').toUtf8());
+  list.close();
+
+  // the listed files are found in the store, so no plugin is needed for them
+  ObjectStore store;
+  SharedPtr<FakeSource> sourceA = new FakeSource("ramp", &store, a);
+  SharedPtr<FakeSource> sourceB = new FakeSource("ramp", &store, b);
+  sourceA->frames = sourceA->reported = 100;
+  sourceB->frames = sourceB->reported = 100;
+  sourceB->value = offsetSample;
+  sourceA->readDelay = sourceB->readDelay = 20;
+  store.addObject(sourceA.data());
+  store.addObject(sourceB.data());
+
+  QSettings cfg(dir.filePath("kstdata"), QSettings::IniFormat);
+  SharedPtr<SourceListSource> sourceList = new SourceListSource(&store, &cfg, listName, QString(), QDomElement());
+  QVERIFY(sourceList->isValid());
+
+  // a.dat twice, for the same frames: read once
+  QVector<double> v(300);
+  DataVector::ReadInfo p;
+  p.data = v.data();
+  p.startingFrame = 0;
+  p.numberOfFrames = 300;
+  p.skipFrame = -1;
+  p.singleSample = false;
+  QCOMPARE(sourceList->readField("ramp", p), qint64(300));
+  QCOMPARE(sourceA->reads.loadRelaxed(), 1);
+  QCOMPARE(v[0], 0.0);
+  QCOMPARE(v[99], 99.0);
+  QCOMPARE(v[100], 1000.0);
+  QCOMPARE(v[199], 1099.0);
+  QCOMPARE(v[200], 0.0);
+  QCOMPARE(v[299], 99.0);
+
+  // different frames of a.dat: read one after the other
+  p.startingFrame = 50;
+  p.numberOfFrames = 250;
+  sourceA->reads.storeRelaxed(0);
+  QCOMPARE(sourceList->readField("ramp", p), qint64(250));
+  QCOMPARE(sourceA->reads.loadRelaxed(), 2);
+  QCOMPARE(sourceA->maxReading.loadRelaxed(), 1);
+  QCOMPARE(v[0], 50.0);
+  QCOMPARE(v[49], 99.0);
+  QCOMPARE(v[50], 1000.0);
+  QCOMPARE(v[150], 0.0);
+  QCOMPARE(v[249], 99.0);
+
+  sourceList = 0;
+  store.clear();
+}
+
+
+QTEST_MAIN(TestSourceList)
+
+// vim: ts=2 sw=2 et
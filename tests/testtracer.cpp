@@ -0,0 +1,159 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "testtracer.h"
+
+#include <QtTest>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+#include <tracer.h>
+
+using Kst::Tracer;
+using Kst::TraceSpan;
+
+
+void TestTracer::init() {
+  Tracer::self()->setEnabled(true);
+  Tracer::self()->clear();
+}
+
+
+void TestTracer::testSpan() {
+  {
+    TraceSpan span("read", QString("V1"));
+    span.setSamples(10);
+    span.setBytes(80);
+    QThread::msleep(2);
+  }
+
+  const QList<Tracer::Span> spans = Tracer::self()->spans();
+  QCOMPARE(spans.size(), 1);
+  QCOMPARE(spans[0].category, QByteArray("read"));
+  QCOMPARE(spans[0].name, QString("V1"));
+  QCOMPARE(spans[0].samples, qint64(10));
+  QCOMPARE(spans[0].bytes, qint64(80));
+  QVERIFY(spans[0].duration >= 2000000);
+}
+
+
+void TestTracer::testSummary() {
+  Tracer *tracer = Tracer::self();
+  for (int i = 0; i < 3; ++i) {
+    tracer->record("read", "V1", tracer->now(), 100, 800);
+  }
+  tracer->record("paint", "C1", tracer->now(), 5);
+
+  const QList<Tracer::Summary> summary = tracer->summary();
+  QCOMPARE(summary.size(), 2);
+  foreach (const Tracer::Summary &s, summary) {
+    if (s.name == "V1") {
+      QCOMPARE(s.count, 3);
+      QCOMPARE(s.samples, qint64(300));
+      QCOMPARE(s.bytes, qint64(2400));
+    } else {
+      QCOMPARE(s.category, QByteArray("paint"));
+      QCOMPARE(s.count, 1);
+    }
+  }
+}
+
+
+void TestTracer::testWrapAround() {
+  Tracer *tracer = Tracer::self();
+  for (int i = 0; i < 20000; ++i) {
+    tracer->record("update", QString::number(i), tracer->now());
+  }
+
+  // the oldest spans are dropped, the newest kept in order
+  const QList<Tracer::Span> spans = tracer->spans();
+  QVERIFY(spans.size() < 20000);
+  QVERIFY(spans.size() > 10000);
+  QCOMPARE(spans.last().name, QString("19999"));
+  QCOMPARE(spans.first().name.toInt() + spans.size(), 20000);
+
+  // names longer than a slot are cut
+  tracer->clear();
+  tracer->record("update", QString(200, 'x'), tracer->now());
+  QCOMPARE(tracer->spans()[0].name, QString(64, 'x'));
+}
+
+
+void TestTracer::testConcurrent() {
+  const int threads = 4;
+  const int perThread = 2000;
+
+  QList<QThread*> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.append(QThread::create([t]() {
+      for (int i = 0; i < perThread; ++i) {
+        TraceSpan span("update", QString("T%1").arg(t));
+        span.setSamples(1);
+      }
+    }));
+  }
+  foreach (QThread *worker, workers) {
+    worker->start();
+  }
+  // reading while writing must only ever see complete spans
+  while (workers.last()->isRunning()) {
+    foreach (const Tracer::Span &span, Tracer::self()->spans()) {
+      QVERIFY(span.name.startsWith('T'));
+      QCOMPARE(span.samples, qint64(1));
+    }
+  }
+  foreach (QThread *worker, workers) {
+    worker->wait();
+    delete worker;
+  }
+
+  qint64 total = 0;
+  foreach (const Tracer::Summary &s, Tracer::self()->summary()) {
+    QCOMPARE(s.count, perThread);
+    total += s.samples;
+  }
+  QCOMPARE(total, qint64(threads * perThread));
+}
+
+
+void TestTracer::testChromeTrace() {
+  Tracer *tracer = Tracer::self();
+  tracer->record("render", "P1", tracer->now(), 0, 4096);
+
+  QJsonParseError error;
+  const QJsonDocument doc = QJsonDocument::fromJson(tracer->chromeTrace(), &error);
+  QCOMPARE(error.error, QJsonParseError::NoError);
+  const QJsonArray events = doc.object().value("traceEvents").toArray();
+  QCOMPARE(events.size(), 1);
+  const QJsonObject event = events[0].toObject();
+  QCOMPARE(event.value("ph").toString(), QString("X"));
+  QCOMPARE(event.value("name").toString(), QString("P1"));
+  QCOMPARE(event.value("cat").toString(), QString("render"));
+  QCOMPARE(event.value("args").toObject().value("bytes").toDouble(), 4096.0);
+}
+
+
+void TestTracer::testDisabled() {
+  Tracer::self()->setEnabled(false);
+  {
+    TraceSpan span("read", QString("V1"));
+  }
+  Tracer::self()->setEnabled(true);
+  QVERIFY(Tracer::self()->spans().isEmpty());
+}
+
+
+QTEST_MAIN(TestTracer)
+
+// vim: ts=2 sw=2 et
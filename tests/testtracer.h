@@ -0,0 +1,33 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TESTTRACER_H
+#define TESTTRACER_H
+
+#include <QObject>
+
+class TestTracer : public QObject
+{
+  Q_OBJECT
+  private Q_SLOTS:
+    void init();
+
+    void testSpan();
+    void testSummary();
+    void testWrapAround();
+    void testConcurrent();
+    void testChromeTrace();
+    void testDisabled();
+};
+
+#endif
+
+// vim: ts=2 sw=2 et
@@ -12,13 +12,24 @@
 #include "testvector.h"
 
 #include <vector.h>
+#include <datavector.h>
+#include <datasource.h>
 #include <datacollection.h>
 #include <objectstore.h>
+#include <samplebuffer.h>
+#include <memorymanager.h>
+#include <quantiles.h>
+
+#include <algorithm>
+#include <cmath>
 
 #include "ksttest.h"
+#include "fakesource.h"
 
 static Kst::ObjectStore _store;
 
+// More frames than an int can count
+static const qint64 SparseFrames = (qint64(1) << 33) + 17;
 
 
 void TestVector::cleanupTestCase() {
@@ -67,6 +78,300 @@ void TestVector::testVector()
   QCOMPARE(v2->interpolate(4, 5), 3.0);
 }
 
+void TestVector::testSampleBuffer()
+{
+  Kst::SampleBuffer buf;
+  QCOMPARE(buf.length(), 0);
+  QVERIFY(buf.resize(6));
+  QCOMPARE(buf.type(), Kst::SampleBuffer::Int16);
+
+  double in[6] = {1, -2, 3, 32767, -32768, 0};
+  QVERIFY(buf.write(0, in, 6));
+  QCOMPARE(buf.type(), Kst::SampleBuffer::Int16);
+  QCOMPARE(buf.bytes(), qint64(6*sizeof(qint16)));
+
+  double out[6];
+  buf.read(0, 6, out);
+  for (int i = 0; i < 6; ++i) {
+    QCOMPARE(out[i], in[i]);
+  }
+
+  // float32-exact value: promote, keeping old samples
+  double half = 0.5;
+  QVERIFY(buf.write(5, &half, 1));
+  QCOMPARE(buf.type(), Kst::SampleBuffer::Float32);
+  QCOMPARE(buf.at(3), 32767.0);
+  QCOMPARE(buf.at(5), 0.5);
+
+  // NaN fits in float32
+  QVERIFY(buf.write(2, &Kst::NOPOINT, 1));
+  QCOMPARE(buf.type(), Kst::SampleBuffer::Float32);
+  QVERIFY(buf.at(2) != buf.at(2));
+
+  // not representable in float32: go to double
+  double third = 1.0/3.0;
+  QVERIFY(buf.write(0, &third, 1));
+  QCOMPARE(buf.type(), Kst::SampleBuffer::Float64);
+  QCOMPARE(buf.at(0), 1.0/3.0);
+  QCOMPARE(buf.at(4), -32768.0);
+
+  buf.shift(4);
+  QCOMPARE(buf.length(), 2);
+  QCOMPARE(buf.at(0), -32768.0);
+  QCOMPARE(buf.at(1), 0.5);
+
+  // int32 and float32 need double
+  Kst::SampleBuffer buf2;
+  QVERIFY(buf2.resize(2));
+  double big = 100000;
+  QVERIFY(buf2.write(0, &big, 1));
+  QCOMPARE(buf2.type(), Kst::SampleBuffer::Int32);
+  QVERIFY(buf2.write(1, &half, 1));
+  QCOMPARE(buf2.type(), Kst::SampleBuffer::Float64);
+  QCOMPARE(buf2.at(0), 100000.0);
+}
+
+void TestVector::testSampleBufferSliding()
+{
+  // a window of 100 samples moving forward by 10 each update
+  Kst::SampleBuffer buf;
+  buf.setSliding(true);
+  QVERIFY(buf.resize(100));
+  double in[100];
+  for (int i = 0; i < 100; ++i) {
+    in[i] = i;
+  }
+  QVERIFY(buf.write(0, in, 100));
+  const qint64 bytes = buf.bytes();
+  QVERIFY(bytes > qint64(100*sizeof(qint16)));
+
+  for (int step = 1; step <= 20; ++step) {
+    buf.shift(10);
+    QVERIFY(buf.resize(100));
+    for (int i = 0; i < 10; ++i) {
+      in[i] = 10*step + 90 + i;
+    }
+    QVERIFY(buf.write(90, in, 10));
+    QCOMPARE(buf.length(), 100);
+    QCOMPARE(buf.at(0), double(10*step));
+    QCOMPARE(buf.at(89), double(10*step + 89));
+    QCOMPARE(buf.at(99), double(10*step + 99));
+    QCOMPARE(buf.bytes(), bytes); // no reallocation
+  }
+
+  // promotion keeps the window
+  double half = 0.5;
+  QVERIFY(buf.write(99, &half, 1));
+  QCOMPARE(buf.type(), Kst::SampleBuffer::Float32);
+  QCOMPARE(buf.at(0), 200.0);
+  QCOMPARE(buf.at(99), 0.5);
+}
+
+void TestVector::testMemoryManager()
+{
+  Kst::MemoryManager *mm = Kst::MemoryManager::self();
+  mm->setStore(&_store);
+
+  Kst::VectorPtr v = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  QVERIFY(v->resize(100000));
+  QVERIFY(mm->used() >= qint64(100000*sizeof(double)));
+
+  // kept up to date as vectors resize, and when they go away
+  const qint64 held = mm->used();
+  QVERIFY(v->resize(50000));
+  QCOMPARE(mm->used(), held - qint64(50000*sizeof(double)));
+
+  // no limit
+  QCOMPARE(mm->ceiling(), qint64(0));
+  QVERIFY(mm->reserve(qint64(1) << 40));
+
+  mm->setCeiling(mm->used() + 8000);
+  QVERIFY(mm->reserve(8000));
+  QVERIFY(!mm->reserve(8001));
+  QCOMPARE(mm->available(), qint64(8000));
+
+  const QList<Kst::MemoryManager::Usage> usage = mm->usage();
+  QVERIFY(!usage.isEmpty());
+  QCOMPARE(usage.first().name, v->Name());
+  QCOMPARE(usage.first().bytes, v->memoryUsage());
+  for (int i = 1; i < usage.count(); ++i) {
+    QVERIFY(usage[i-1].bytes >= usage[i].bytes);
+  }
+
+  mm->setCeiling(0);
+  mm->setStore(0);
+}
+
+void TestVector::testLargeIndices()
+{
+  // stretching 5 samples over 2^33 + 1 gives sample 2 at index 2^32
+  double data[5] = { 0.0, 10.0, 20.0, 30.0, 40.0 };
+  const qint64 ns = (qint64(1) << 33) + 1;
+  QCOMPARE(Kst::kstInterpolate(data, 5, qint64(1) << 32, ns), 20.0);
+  QCOMPARE(Kst::kstInterpolate(data, 5, (qint64(1) << 32) + (qint64(1) << 30), ns), 25.0);
+  QCOMPARE(Kst::kstInterpolate(data, 5, ns - 1, ns), 40.0);
+
+  Kst::VectorPtr v = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  QVERIFY(v->resize(5));
+  for (int i = 0; i < 5; ++i) {
+    v->raw_V_ptr()[i] = data[i];
+  }
+  QCOMPARE(v->interpolate(qint64(3) << 31, ns), 30.0);
+}
+
+void TestVector::testSparseDataVector()
+{
+  Kst::SharedPtr<FakeSource> source = new FakeSource("FRAME", &_store);
+  source->frames = source->reported = SparseFrames;
+
+  // 1 sample every 2^28 frames: frame numbers go well past 2^31
+  Kst::DataVectorPtr dv = Kst::kst_cast<Kst::DataVector>(_store.createObject<Kst::DataVector>());
+  dv->writeLock();
+  dv->change(source, "FRAME", 0, false, double(SparseFrames), false, 1 << 28, true, false);
+  dv->internalUpdate();
+  dv->unlock();
+  QCOMPARE(dv->length(), qint64(32));
+  for (qint64 i = 0; i < dv->length(); ++i) {
+    QCOMPARE(dv->value(i), double(i << 28));
+  }
+
+  // the last 1000 frames
+  dv->writeLock();
+  dv->change(source, "FRAME", 0, true, 1000, false, 0, false, false);
+  dv->internalUpdate();
+  dv->unlock();
+  QCOMPARE(dv->length(), qint64(1000));
+  QCOMPARE(dv->value(0), double(SparseFrames - 1000));
+  QCOMPARE(dv->value(999), double(SparseFrames - 1));
+  QCOMPARE(dv->startFrame(), double(SparseFrames - 1000));
+}
+
+void TestVector::testLargeVector()
+{
+  // 2^31 samples need 4 GB as int16, then 16 GB as doubles
+  if (qEnvironmentVariableIsEmpty("KST_TEST_LARGE_MEMORY")) {
+    QSKIP("set KST_TEST_LARGE_MEMORY to run");
+  }
+
+  const qint64 n = (qint64(1) << 31) + 10;
+  {
+    Kst::SampleBuffer buf;
+    QVERIFY(buf.resize(n));
+    QCOMPARE(buf.length(), n);
+    double in[4] = { 1.0, 2.0, 3.0, 4.0 };
+    QVERIFY(buf.write(n - 4, in, 4));
+    QCOMPARE(buf.type(), Kst::SampleBuffer::Int16);
+    double out[4];
+    buf.read(n - 4, 4, out);
+    QCOMPARE(out[3], 4.0);
+    QCOMPARE(buf.at(n - 5), 0.0);
+  }
+
+  Kst::VectorPtr v = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  QVERIFY(v->resize(n));
+  QCOMPARE(v->length(), n);
+  v->raw_V_ptr()[n - 1] = 7.0;
+  QCOMPARE(v->value(n - 1), 7.0);
+  // the samples resize added are blank
+  QVERIFY(std::isnan(v->interpolate(n - 2, n)));
+  QVERIFY(v->resize(1));
+}
+
+void TestVector::testSelectRanks()
+{
+  // random, sorted, reversed and constant inputs, against a full sort
+  for (int kind = 0; kind < 4; ++kind) {
+    const qint64 n = 20011;
+    QVector<double> v(n);
+    for (qint64 i = 0; i < n; ++i) {
+      switch (kind) {
+        case 0: v[i] = double((i * 7919) % 10007) - 5000.0; break;
+        case 1: v[i] = i; break;
+        case 2: v[i] = n - i; break;
+        default: v[i] = 3.0; break;
+      }
+    }
+    QVector<double> sorted = v;
+    std::sort(sorted.begin(), sorted.end());
+
+    const qint64 ranks[] = { n - 1, 0, n/2, 1, n/2, 17, n - 2, n/3 };
+    const int n_ranks = int(sizeof(ranks)/sizeof(ranks[0]));
+    double out[n_ranks];
+    Kst::selectRanks(v.data(), n, ranks, n_ranks, out);
+    for (int i = 0; i < n_ranks; ++i) {
+      QCOMPARE(out[i], sorted[ranks[i]]);
+    }
+  }
+}
+
+void TestVector::testSelectRanksParallel()
+{
+  // big enough to be split: a sorted time vector, heavy duplicates, a
+  // spike that squeezes the rest into one bucket
+  for (int kind = 0; kind < 3; ++kind) {
+    const qint64 n = (qint64(1) << 21) + 13;
+    QVector<double> v(n);
+    for (qint64 i = 0; i < n; ++i) {
+      switch (kind) {
+        case 0: v[i] = 1.5e9 + i*0.01; break;
+        case 1: v[i] = double(i % 3); break;
+        default: v[i] = (i == n/3) ? 1e300 : double((i * 7919) % 10007); break;
+      }
+    }
+    const QVector<double> in = v;
+    QVector<double> sorted = v;
+    std::sort(sorted.begin(), sorted.end());
+
+    const qint64 ranks[] = { n/2, 0, n - 1, n/2, 12345, n - 2 };
+    const int n_ranks = int(sizeof(ranks)/sizeof(ranks[0]));
+    double out[n_ranks];
+    Kst::selectRanksParallel(v.constData(), n, ranks, n_ranks, out);
+    for (int i = 0; i < n_ranks; ++i) {
+      QCOMPARE(out[i], sorted[ranks[i]]);
+    }
+    QVERIFY(v == in);
+  }
+}
+
+void TestVector::testSpikeInsensitiveRange()
+{
+  const int n = 5000;
+  Kst::VectorPtr v = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  QVERIFY(v->resize(n));
+  double *data = v->raw_V_ptr();
+  for (int i = 0; i < n; ++i) {
+    data[i] = double((i * 37) % 1009);
+  }
+  data[10] = 1e9;
+  data[20] = -1e9;
+  data[30] = NAN;
+  v->internalUpdate();
+
+  QVector<double> sorted;
+  for (int i = 0; i < n; ++i) {
+    if (data[i] == data[i]) {
+      sorted.append(data[i]);
+    }
+  }
+  std::sort(sorted.begin(), sorted.end());
+  const int m = sorted.size();
+
+  const int fraction[] = { 0, 333, 100, 33, 10 };
+  for (int level = 0; level < 5; ++level) {
+    const int drop = fraction[level] ? m/fraction[level] : 0;
+    QCOMPARE(v->ns_min(level), sorted[drop + 1]);
+    QCOMPARE(v->ns_max(level), sorted[m - drop - 1]);
+  }
+  // asked again, and past the last level
+  QCOMPARE(v->ns_max(0), 1e9);
+  QCOMPARE(v->ns_min(7), v->ns_min(4));
+
+  // a change is seen
+  data[10] = 2e9;
+  v->internalUpdate();
+  QCOMPARE(v->ns_max(0), 2e9);
+}
+
 QTEST_MAIN(TestVector)
 
 // vim: ts=2 sw=2 et
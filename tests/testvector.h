@@ -21,6 +21,15 @@ class TestVector : public QObject
     void cleanupTestCase();
 
     void testVector();
+    void testSampleBuffer();
+    void testSampleBufferSliding();
+    void testMemoryManager();
+    void testLargeIndices();
+    void testSparseDataVector();
+    void testLargeVector();
+    void testSelectRanks();
+    void testSelectRanksParallel();
+    void testSpikeInsensitiveRange();
 };
 
 #endif
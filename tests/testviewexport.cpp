@@ -0,0 +1,76 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2026 The Kst developers                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "testviewexport.h"
+
+#include <QtTest>
+
+#include <QGraphicsScene>
+#include <QImage>
+#include <QPainter>
+
+#include <plotitem.h>
+#include <view.h>
+
+using namespace Kst;
+
+// a plot that notes where it was laid out when it was drawn
+class ProbePlot : public PlotItem {
+  public:
+    explicit ProbePlot(View *view) : PlotItem(view) {}
+    void paint(QPainter *painter) {
+      Q_UNUSED(painter)
+      drawn = mapToScene(rect()).boundingRect();
+    }
+    QRectF drawn;
+};
+
+
+static bool near(const QRectF &a, const QRectF &b) {
+  const qreal slack = 2.0;
+  return qAbs(a.left() - b.left()) < slack && qAbs(a.top() - b.top()) < slack &&
+         qAbs(a.width() - b.width()) < slack && qAbs(a.height() - b.height()) < slack;
+}
+
+
+// An export at another shape than the window's is laid out at its own
+// size, not the window's layout scaled, and the window is left as it was.
+void TestViewExport::testRenderAtSize() {
+  View view(0);
+  view.resize(400, 300);
+  view.processResize(QSize(400, 300));
+
+  ProbePlot *plot = new ProbePlot(&view);
+  plot->setPos(40, 30);
+  plot->setViewRect(0, 0, 200, 150);
+  view.scene()->addItem(plot);
+  plot->updateRelativeSize();
+  const QRectF before = plot->mapToScene(plot->rect()).boundingRect();
+
+  QImage image(800, 300, QImage::Format_ARGB32);
+  image.fill(Qt::transparent);
+  QPainter painter(&image);
+  view.renderAtSize(&painter, image.size());
+  painter.end();
+
+  QCOMPARE(image.size(), QSize(800, 300));
+  QVERIFY2(near(plot->drawn, QRectF(80, 30, 400, 150)),
+           qPrintable(QString("drawn at %1,%2 %3x%4").arg(plot->drawn.x()).arg(plot->drawn.y())
+                      .arg(plot->drawn.width()).arg(plot->drawn.height())));
+
+  QCOMPARE(view.size(), QSize(400, 300));
+  QVERIFY(near(plot->mapToScene(plot->rect()).boundingRect(), before));
+}
+
+
+QTEST_MAIN(TestViewExport)
+
+// vim: ts=2 sw=2 et